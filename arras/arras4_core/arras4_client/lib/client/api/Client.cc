@@ -410,6 +410,13 @@ void Client::enableMessageChunking(size_t minChunkingSize,size_t chunkSize)
      if (chunkSize) mChunkingConfig.chunkSize = chunkSize;
 }
 
+void Client::enableStreamingMessageChunking(size_t minChunkingSize,size_t chunkSize)
+{
+     mChunkingConfig.enableStreaming();
+     if (minChunkingSize) mChunkingConfig.minChunkingSize = minChunkingSize;
+     if (chunkSize) mChunkingConfig.chunkSize = chunkSize;
+}
+
 void
 Client::postConnect()
 {
@@ -161,6 +161,9 @@ public:
     void disableMessageChunking();
     void enableMessageChunking(size_t minChunkingSize = 0,
                                size_t chunkSize = 0);
+    // 0 means use the streaming default
+    void enableStreamingMessageChunking(size_t minChunkingSize = 0,
+                                        size_t chunkSize = 0);
 
  
     /// make the request body for a create request
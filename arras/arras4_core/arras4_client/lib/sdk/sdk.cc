@@ -262,6 +262,12 @@ Impl::enableMessageChunking(size_t minChunkingSize, size_t chunkSize)
     mClient->enableMessageChunking(minChunkingSize,chunkSize);
 }
 
+void 
+Impl::enableStreamingMessageChunking(size_t minChunkingSize, size_t chunkSize)
+{
+    mClient->enableStreamingMessageChunking(minChunkingSize,chunkSize);
+}
+
 void 
 Impl::makeCreateRequest(const client::SessionDefinition& aDefinition, 
                         const client::SessionOptions& aSessionOptions,
@@ -474,6 +480,12 @@ SDK::enableMessageChunking(size_t minChunkingSize, size_t chunkSize)
     mImpl->enableMessageChunking(minChunkingSize,chunkSize);
 }
 
+void 
+SDK::enableStreamingMessageChunking(size_t minChunkingSize, size_t chunkSize)
+{
+    mImpl->enableStreamingMessageChunking(minChunkingSize,chunkSize);
+}
+
 bool
 SDK::sessionExists(const std::string& sessionId, const std::string& datacenter, const std::string& environment) const
 {
@@ -177,6 +177,16 @@ public:
     void enableMessageChunking(size_t minChunkingSize = 0,
                                size_t chunkSize = 0);
 
+    /** 
+     * Enable streaming message chunking : large messages are sent
+     * in small chunks as they are serialized, and deserialized
+     * incrementally by the receiver, limiting peak memory use on
+     * both sides. The computations must also support streaming chunks.
+     * 0 for either value means use the streaming default
+     **/
+    void enableStreamingMessageChunking(size_t minChunkingSize = 0,
+                                        size_t chunkSize = 0);
+
     /**
      * Query if a given session exists.
      * using local server if datacenter or environment is empty
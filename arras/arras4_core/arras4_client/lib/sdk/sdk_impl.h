@@ -51,6 +51,7 @@ public:
     void setEngineReadyCallback(SDK::EngineReadyCallback handler);
     void disableMessageChunking();
     void enableMessageChunking(size_t minChunkingSize,size_t chunkSize);
+    void enableStreamingMessageChunking(size_t minChunkingSize,size_t chunkSize);
 
     static bool configAthenaLogger(const std::string& athenaEnv = "prod",
                                    bool useColor=true,
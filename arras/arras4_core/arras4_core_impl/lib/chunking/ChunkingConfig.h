@@ -17,6 +17,25 @@ public:
     // these are not supported by Arras 3
     size_t minChunkingSize =  2047 * 1024  * 1024ull; // 2GB - 1MB
     size_t chunkSize =  1024 * 1024  * 1024ull; // 1GB
+
+    // in streaming mode, chunks are sent as soon as they have been
+    // serialized and the receiver deserializes them as they arrive,
+    // so that neither side holds the complete serialized message in
+    // memory. Much smaller chunks are used, allowing other messages
+    // to be interleaved with them on the way to the destination.
+    // The receiver must also support streaming chunks.
+    bool streaming = false;
+
+    static constexpr size_t STREAMING_MIN_CHUNKING_SIZE = 64 * 1024 * 1024ull; // 64MB
+    static constexpr size_t STREAMING_CHUNK_SIZE = 8 * 1024 * 1024ull; // 8MB
+
+    // switch to streaming mode, with the default streaming chunk sizes
+    void enableStreaming() {
+        enabled = true;
+        streaming = true;
+        minChunkingSize = STREAMING_MIN_CHUNKING_SIZE;
+        chunkSize = STREAMING_CHUNK_SIZE;
+    }
 };
 
 }
@@ -4,6 +4,7 @@
 #include "ChunkingMessageEndpoint.h"
 #include "MessageChunk.h"
 #include "MessageUnchunker.h"
+#include "StreamingUnchunker.h"
 
 #include <message_api/ObjectContent.h>
 #include <message_impl/StreamImpl.h>
@@ -15,12 +16,106 @@
 #include <exceptions/InternalError.h>
 #include <message_impl/Envelope.h>
 
+#include <algorithm>
+#include <limits.h>
+#include <string.h> // memcpy
+
 using namespace arras4::api;
 using namespace arras4::network;
 
 namespace arras4 {
     namespace impl {
 
+namespace {
+
+// DataSink that sends content as streaming chunks while it is
+// being serialized. A chunk is only sent once more data is written
+// after it is full, so that the final chunk can be marked as the last.
+class ChunkStreamSink : public DataSink
+{
+public:
+    ChunkStreamSink(MessageEndpoint& aTarget,
+                    const Envelope& aEnvelope,
+                    size_t aChunkSize) :
+        mTarget(aTarget), mEnvelope(aEnvelope), mChunkSize(aChunkSize)
+        {}
+
+    size_t write(const unsigned char* aBuf, size_t aLen)
+    {
+        size_t offset = 0;
+        while (offset < aLen) {
+            if (!mChunk || mChunk->mPayloadLength == mChunkSize) {
+                if (mChunk) sendChunk(false);
+                newChunk();
+            }
+            size_t toWrite = std::min(aLen - offset, mChunkSize - mChunk->mPayloadLength);
+            memcpy(mChunk->mPayload + mChunk->mPayloadLength, aBuf + offset, toWrite);
+            mChunk->mPayloadLength += static_cast<unsigned>(toWrite);
+            mBytesWritten += toWrite;
+            offset += toWrite;
+        }
+        return aLen;
+    }
+
+    void flush() {}
+    size_t bytesWritten() const { return mBytesWritten; }
+
+    // send the final chunk, containing the totals
+    void finish()
+    {
+        if (!mChunk) newChunk();
+        sendChunk(true);
+    }
+
+    uint16_t chunkCount() const { return mIndex; }
+
+private:
+    void newChunk()
+    {
+        if (mIndex == UINT16_MAX)
+            throw InternalError("[ChunkingMessageEndpoint/putEnvelope] Message is too large for chunking");
+
+        mChunk = std::make_shared<MessageChunk>();
+        mChunk->mChunkingMethod = MessageChunk::METHOD_STREAMING;
+        mChunk->mNumberOfChunks = 0;
+        mChunk->mChunkIndex = mIndex;
+        mChunk->mOffset = mBytesWritten;
+        mChunk->mUnchunkedSize = 0;
+        mChunk->internalId = mEnvelope.classId();
+        mChunk->internalRoutingName = mEnvelope.metadata()->routingName();
+        mChunk->internalInstanceId = mEnvelope.metadata()->instanceId();
+        mChunk->internalOriginId = mEnvelope.metadata()->sourceId();
+        mChunk->internalClassVersion = mEnvelope.classVersion();
+        mChunk->mPayloadLength = 0;
+        mChunk->mPayload = new unsigned char[mChunkSize];
+    }
+
+    void sendChunk(bool aLast)
+    {
+        if (aLast) {
+            mChunk->mNumberOfChunks = mIndex + 1;
+            mChunk->mUnchunkedSize = mBytesWritten;
+        }
+        Envelope chunkEnv(mChunk);
+        chunkEnv.metadata() = mEnvelope.metadata();
+        chunkEnv.to() = mEnvelope.to();
+        mTarget.putEnvelope(chunkEnv);
+
+        // free the payload as soon as it has been sent
+        mChunk.reset();
+        mIndex++;
+    }
+
+    MessageEndpoint& mTarget;
+    const Envelope& mEnvelope;
+    const size_t mChunkSize;
+    MessageChunk::Ptr mChunk;
+    uint16_t mIndex = 0;
+    size_t mBytesWritten = 0;
+};
+
+}
+
  
 Envelope ChunkingMessageEndpoint::getEnvelope()
 {
@@ -34,6 +129,25 @@ Envelope ChunkingMessageEndpoint::getEnvelope()
         }
 
         MessageChunk::ConstPtr chunk = envelope.contentAs<MessageChunk>();
+        if (chunk->mChunkingMethod == MessageChunk::METHOD_STREAMING) {
+            // streamed messages are deserialized on a separate thread as the
+            // chunks arrive, so other messages can still be returned meanwhile
+            StreamingUnchunkerMap::iterator sit = mStreamingUnchunkers.find(chunk->internalInstanceId);
+            if (sit == mStreamingUnchunkers.end()) {
+                StreamingUnchunker::Ptr unchunker = std::make_shared<StreamingUnchunker>(chunk);
+                sit = mStreamingUnchunkers.insert(StreamingUnchunkerMap::value_type(chunk->internalInstanceId,
+                                                                                    unchunker))
+                    .first;
+            } else {
+                sit->second->addChunk(chunk);
+            }
+            if (sit->second->getUnchunked(envelope)) {
+                mStreamingUnchunkers.erase(sit);
+                return envelope;
+            }
+            continue;
+        }
+
         UnchunkerMap::iterator it = mUnchunkers.find(chunk->internalInstanceId);
         MessageUnchunker* unchunker;
         if (it == mUnchunkers.end()) {
@@ -76,6 +190,11 @@ void ChunkingMessageEndpoint::putEnvelope(const Envelope& envelope)
         return;
     }
 
+    if (mConfig.streaming) {
+        putStreamingEnvelope(envelope, *content);
+        return;
+    }
+
     // serialize the content into a MultiBuffer that will
     // split it into chunks
     MultiBuffer mb(mConfig.chunkSize,mConfig.chunkSize);
@@ -121,7 +240,26 @@ void ChunkingMessageEndpoint::putEnvelope(const Envelope& envelope)
     }
 }
 
-}
+void ChunkingMessageEndpoint::putStreamingEnvelope(const Envelope& envelope,
+                                                   const ObjectContent& content)
+{
+    if (mConfig.chunkSize == 0 || mConfig.chunkSize > UINT_MAX)
+        throw InternalError("[ChunkingMessageEndpoint/putEnvelope] Invalid chunk size for streaming");
+
+    ARRAS_DEBUG("Message " << envelope.metadata()->instanceId().toString() <<
+                " will be streamed in chunks of size <= " << mConfig.chunkSize);
+
+    // chunks are sent from inside serialize(), as they fill up
+    ChunkStreamSink sink(mSource, envelope, mConfig.chunkSize);
+    OutStreamImpl stream(sink);
+    content.serialize(stream);
+    stream.flush();
+    sink.finish();
+
+    ARRAS_INFO("Message " << envelope.metadata()->instanceId().toString() <<
+               " length " << sink.bytesWritten() << " was streamed in " <<
+               sink.chunkCount() << " chunks");
 }
 
-  
+}
+}
@@ -14,6 +14,7 @@ namespace arras4 {
     namespace impl {
 
 class MessageUnchunker;
+class StreamingUnchunker;
 class Envelope;
 
 class ChunkingMessageEndpoint : public MessageEndpoint
@@ -30,10 +31,15 @@ public:
     void shutdown() { mSource.shutdown(); }
 
 private:
+    void putStreamingEnvelope(const Envelope& env, 
+                              const api::ObjectContent& content);
+
     ChunkingConfig mConfig;
     MessageEndpoint& mSource;
     typedef std::map<api::UUID,std::shared_ptr<MessageUnchunker>> UnchunkerMap;
     UnchunkerMap mUnchunkers;
+    typedef std::map<api::UUID,std::shared_ptr<StreamingUnchunker>> StreamingUnchunkerMap;
+    StreamingUnchunkerMap mStreamingUnchunkers;
 };
 
 }
@@ -19,6 +19,17 @@ public:
 
     void serialize(arras4::api::DataOutStream& to) const;
     void deserialize(arras4::api::DataInStream& from, unsigned version);
+
+    // values of mChunkingMethod :
+    //   METHOD_WHOLE : message is serialized in full, then split into chunks.
+    //                  Every chunk carries the total chunk count and size
+    //   METHOD_STREAMING : chunks are sent as they are serialized, in order.
+    //                  mNumberOfChunks and mUnchunkedSize are 0 except in
+    //                  the last chunk, where they give the final totals
+    static constexpr uint16_t METHOD_WHOLE = 0;
+    static constexpr uint16_t METHOD_STREAMING = 1;
+
+    bool isLastStreamingChunk() const { return mNumberOfChunks != 0; }
     
     uint16_t mProtocolVersion = 0;
     uint16_t mChunkingMethod = 0;
@@ -0,0 +1,206 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "StreamingUnchunker.h"
+#include "MessageChunk.h"
+
+#include <arras4_log/Logger.h>
+#include <arras4_log/LogEventStream.h>
+#include <exceptions/InternalError.h>
+#include <message_api/ContentRegistry.h>
+#include <message_api/ObjectContent.h>
+#include <message_impl/Envelope.h>
+#include <message_impl/StreamImpl.h>
+
+#include <algorithm>
+#include <string.h> // memcpy
+
+using namespace arras4::api;
+
+namespace arras4 {
+namespace impl {
+
+    // create a new unchunker, from the first chunk of a given message
+    StreamingUnchunker::StreamingUnchunker(const std::shared_ptr<const MessageChunk>& chunk) :
+        mNextIndex(0), mReceivedSize(0), mLastAdded(false),
+        mClassVersion(chunk->internalClassVersion),
+        mCurrentOffset(0), mBytesRead(0),
+        mDone(false), mAborted(false)
+    {
+        ARRAS_DEBUG("Beginning streaming of chunked message " <<
+                    chunk->internalInstanceId.toString());
+        if (chunk->mChunkIndex != 0) {
+            ARRAS_ERROR(log::Id("invalidMessageChunk") << "Streaming message chunk " <<
+                        chunk->mChunkIndex << " received before the first chunk");
+            throw InternalError("[StreamingUnchunker] First chunk missing");
+        }
+        mInstanceId = chunk->internalInstanceId;
+
+        ClassID classId = chunk->internalId;
+        mContent.reset(ContentRegistry::singleton()->create(classId,mClassVersion));
+        if (!mContent) {
+            ARRAS_ERROR(log::Id("chunkingClassError") <<
+                        "Couldn't recreate chunked message : message class " <<
+                        classId.toString() << " could not be instantiated");
+
+            throw InternalError("[StreamingUnchunker] Failed to instantiate message class :" +
+                                classId.toString());
+        }
+
+        addChunk(chunk);
+        mThread = std::thread(&StreamingUnchunker::deserializeProc,this);
+    }
+
+    StreamingUnchunker::~StreamingUnchunker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mAborted = true;
+        }
+        mCondition.notify_all();
+        if (mThread.joinable()) mThread.join();
+    }
+
+    // call to add subsequent chunks (not the first)
+    void StreamingUnchunker::addChunk(const std::shared_ptr<const MessageChunk>& chunk)
+    {
+        ARRAS_DEBUG("Processing streaming chunk " <<  chunk->mChunkIndex << " of message " <<
+                    chunk->internalInstanceId.toString() << " (len " <<
+                    chunk->mPayloadLength << " bytes)");
+        if (chunk->internalInstanceId != mInstanceId || mLastAdded) {
+            ARRAS_ERROR(log::Id("invalidMessageChunk") << "Message chunk contained incorrect data");
+            throw InternalError("[StreamingUnchunker/addChunk] Chunk data mismatch");
+        }
+        if (chunk->mChunkIndex != mNextIndex || chunk->mOffset != mReceivedSize) {
+            ARRAS_ERROR(log::Id("invalidMessageChunk") << "Streaming message chunk " <<
+                        chunk->mChunkIndex << " received out of order (expected " << mNextIndex << ")");
+            throw InternalError("[StreamingUnchunker/addChunk] Chunk out of order");
+        }
+        mNextIndex++;
+        mReceivedSize += chunk->mPayloadLength;
+
+        bool last = chunk->isLastStreamingChunk();
+        if (last) {
+            if (chunk->mNumberOfChunks != mNextIndex ||
+                chunk->mUnchunkedSize != mReceivedSize) {
+                ARRAS_ERROR(log::Id("chunkingSizeError") <<
+                            "Streamed message size mismatch : expected " << chunk->mUnchunkedSize <<
+                            " bytes in " << chunk->mNumberOfChunks << " chunks, but received " <<
+                            mReceivedSize << " bytes in " << mNextIndex << " chunks");
+                throw InternalError("[StreamingUnchunker/addChunk] Chunk size mismatch");
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mPending.size() >= MAX_PENDING_CHUNKS && !mDone && !mAborted) {
+                mCondition.wait(lock);
+            }
+            // if deserialization has already ended, the remaining
+            // data isn't needed
+            if (!mDone) {
+                mPending.push_back(chunk);
+            }
+            mLastAdded = last;
+        }
+        mCondition.notify_all();
+    }
+
+    // if message is complete, update envout and return true
+    bool StreamingUnchunker::getUnchunked(Envelope& envOut)
+    {
+        if (!mLastAdded) {
+            return false;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (!mDone) {
+                mCondition.wait(lock);
+            }
+        }
+        mThread.join();
+        if (mError) {
+            std::rethrow_exception(mError);
+        }
+
+        ARRAS_INFO("Streamed message " << mInstanceId.toString() <<
+                   " is complete, deserialized from " << mNextIndex << " chunks");
+        envOut.setContent(mContent.release());
+        return true;
+    }
+
+    bool StreamingUnchunker::nextChunk()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        // release the consumed chunk before waiting for another
+        mCurrent.reset();
+        mCurrentOffset = 0;
+        while (mPending.empty()) {
+            if (mAborted)
+                throw InternalError("[StreamingUnchunker] Streaming of message was aborted");
+            if (mLastAdded)
+                return false;
+            mCondition.wait(lock);
+        }
+        mCurrent = mPending.front();
+        mPending.pop_front();
+        lock.unlock();
+        mCondition.notify_all();
+        return true;
+    }
+
+    size_t StreamingUnchunker::read(unsigned char* aBuf, size_t aLen)
+    {
+        size_t offset = 0;
+        while (offset < aLen) {
+            if (!mCurrent || mCurrentOffset == mCurrent->mPayloadLength) {
+                if (!nextChunk()) break;
+                continue;
+            }
+            size_t toRead = std::min(aLen - offset,
+                                     mCurrent->mPayloadLength - mCurrentOffset);
+            memcpy(aBuf + offset, mCurrent->mPayload + mCurrentOffset, toRead);
+            mCurrentOffset += toRead;
+            offset += toRead;
+        }
+        mBytesRead += offset;
+        return offset;
+    }
+
+    size_t StreamingUnchunker::skip(size_t aLen)
+    {
+        size_t skipped = 0;
+        while (skipped < aLen) {
+            if (!mCurrent || mCurrentOffset == mCurrent->mPayloadLength) {
+                if (!nextChunk()) break;
+                continue;
+            }
+            size_t toSkip = std::min(aLen - skipped,
+                                     mCurrent->mPayloadLength - mCurrentOffset);
+            mCurrentOffset += toSkip;
+            skipped += toSkip;
+        }
+        mBytesRead += skipped;
+        return skipped;
+    }
+
+    void StreamingUnchunker::deserializeProc()
+    {
+        log::Logger::instance().setThreadName("unchunker");
+        try {
+            InStreamImpl stream(*this);
+            mContent->deserialize(stream,mClassVersion);
+        } catch (...) {
+            mError = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDone = true;
+            mCurrent.reset();
+            mPending.clear();
+        }
+        mCondition.notify_all();
+    }
+}
+}
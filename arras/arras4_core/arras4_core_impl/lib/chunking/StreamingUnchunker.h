@@ -0,0 +1,96 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __ARRAS4_STREAMINGUNCHUNKER_H__
+#define __ARRAS4_STREAMINGUNCHUNKER_H__
+
+#include <message_api/messageapi_types.h>
+#include <message_api/UUID.h>
+#include <network/DataSource.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace arras4 {
+    namespace api {
+        class ObjectContent;
+    }
+    namespace impl {
+
+class MessageChunk;
+class Envelope;
+
+// Reassembles a message sent in streaming chunks (MessageChunk::METHOD_STREAMING).
+//
+// Rather than collecting all the chunks and deserializing at the end,
+// the message content is deserialized on a separate thread as the chunks
+// arrive. The deserializer reads through a DataSource that hands out
+// the chunk payloads in order, releasing each chunk once it has been
+// consumed. Only a few chunks are ever held in memory, and the caller
+// can continue to deliver other messages while a streaming message is
+// in progress.
+class StreamingUnchunker : private network::DataSource
+{
+public:
+    // create a new unchunker, from the first chunk (index 0)
+    // of a given message. Starts the deserialization thread
+    StreamingUnchunker(const std::shared_ptr<const MessageChunk>& chunk);
+
+    // aborts deserialization if it is still in progress
+    ~StreamingUnchunker();
+
+    // call to add subsequent chunks (not the first). Chunks
+    // must be added in order. Blocks if the deserializer has
+    // fallen too far behind.
+    void addChunk(const std::shared_ptr<const MessageChunk>& chunk);
+
+    // if the last chunk has been added, wait for deserialization to
+    // complete, update envOut and return true
+    bool getUnchunked(Envelope& envOut);
+
+    typedef std::shared_ptr<StreamingUnchunker> Ptr;
+
+    // maximum number of received chunks waiting for the deserializer.
+    // addChunk() blocks when this is reached, so that memory use stays
+    // bounded if the deserializer is slower than the connection
+    static constexpr size_t MAX_PENDING_CHUNKS = 4;
+
+private:
+    // DataSource interface, used by the deserialization thread
+    size_t read(unsigned char* aBuf, size_t aLen);
+    size_t skip(size_t aLen);
+    size_t bytesRead() const { return mBytesRead; }
+
+    // make the next chunk current. Returns false if there are
+    // no more chunks
+    bool nextChunk();
+    void deserializeProc();
+
+    api::UUID mInstanceId;
+    uint16_t mNextIndex;
+    uint64_t mReceivedSize;
+    bool mLastAdded;
+    unsigned mClassVersion;
+    std::unique_ptr<api::ObjectContent> mContent;
+
+    // owned by the deserialization thread
+    std::shared_ptr<const MessageChunk> mCurrent;
+    size_t mCurrentOffset;
+    size_t mBytesRead;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<std::shared_ptr<const MessageChunk>> mPending;
+    bool mDone;
+    bool mAborted;
+    std::exception_ptr mError;
+    std::thread mThread;
+};
+
+}
+}
+#endif
@@ -0,0 +1,395 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TestStreamingChunking.h"
+
+#include <chunking/ChunkingMessageEndpoint.h>
+#include <chunking/MessageChunk.h>
+#include <chunking/StreamingUnchunker.h>
+#include <exceptions/InternalError.h>
+#include <message_api/ContentMacros.h>
+#include <message_impl/Envelope.h>
+#include <message_impl/MessageEndpoint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string.h> // memcpy
+#include <thread>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestStreamingChunking);
+
+using namespace arras4::api;
+using namespace arras4::impl;
+
+namespace {
+
+// 160008 bytes serialized : 40 chunks of 4096 bytes, the last one partial
+const size_t VALUE_COUNT = 40000;
+const size_t CHUNK_SIZE = 4096;
+
+// time given to blocked threads to reach a steady state
+const std::chrono::milliseconds PARK_TIME(200);
+
+// lets a test hold up deserialization of StreamTestContent
+class DeserializeGate
+{
+public:
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOpen = false;
+    }
+    void open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mOpen = true;
+        }
+        mCondition.notify_all();
+    }
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (!mOpen) mCondition.wait(lock);
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mOpen = true;
+};
+
+DeserializeGate gDeserializeGate;
+
+// content that is written in several pieces, so that writes
+// and reads span chunk boundaries
+class StreamTestContent : public ObjectContent
+{
+public:
+    ARRAS_CONTENT_CLASS(StreamTestContent,"7debcbda-54ef-4c84-b0ab-8d86957d3dea",0);
+
+    size_t serializedLength() const
+    {
+        return sizeof(uint64_t) + mValues.size() * sizeof(uint32_t);
+    }
+
+    void serialize(DataOutStream& to) const
+    {
+        uint64_t count = mValues.size();
+        to.write(count);
+        for (size_t i = 0; i < mValues.size(); i += 1000) {
+            size_t n = std::min<size_t>(1000, mValues.size() - i);
+            to.write(&mValues[i], n * sizeof(uint32_t));
+        }
+    }
+
+    void deserialize(DataInStream& from, unsigned)
+    {
+        uint64_t count = 0;
+        from.read(count);
+        gDeserializeGate.wait();
+        mValues.resize(count);
+        from.read(mValues.data(), count * sizeof(uint32_t));
+    }
+
+    std::vector<uint32_t> mValues;
+};
+
+ARRAS_CONTENT_IMPL(StreamTestContent);
+
+// endpoint that queues everything put to it, to be read back in order
+class QueueEndpoint : public MessageEndpoint
+{
+public:
+    Envelope getEnvelope()
+    {
+        if (mEnvelopes.empty())
+            throw InternalError("[QueueEndpoint] No more envelopes");
+        Envelope env = mEnvelopes.front();
+        mEnvelopes.pop_front();
+        return env;
+    }
+    void putEnvelope(const Envelope& env) { mEnvelopes.push_back(env); }
+    void shutdown() {}
+
+    std::deque<Envelope> mEnvelopes;
+};
+
+Envelope makeEnvelope()
+{
+    StreamTestContent* content = new StreamTestContent;
+    content->mValues.resize(VALUE_COUNT);
+    for (size_t i = 0; i < VALUE_COUNT; i++) {
+        content->mValues[i] = static_cast<uint32_t>(i * 2654435761u);
+    }
+    return Envelope(content);
+}
+
+ChunkingConfig chunkingConfig(bool streaming)
+{
+    ChunkingConfig config;
+    config.streaming = streaming;
+    config.minChunkingSize = 1;
+    config.chunkSize = CHUNK_SIZE;
+    return config;
+}
+
+// streams the envelope, returning the chunks in the order they were sent
+std::vector<MessageChunk::ConstPtr> streamChunks(const Envelope& env)
+{
+    QueueEndpoint target;
+    ChunkingMessageEndpoint sender(target, chunkingConfig(true));
+    sender.putEnvelope(env);
+
+    std::vector<MessageChunk::ConstPtr> chunks;
+    for (const Envelope& chunkEnv : target.mEnvelopes) {
+        chunks.push_back(chunkEnv.contentAs<MessageChunk>());
+    }
+    return chunks;
+}
+
+// sends the envelope through a pair of chunking endpoints
+std::vector<uint32_t> roundTrip(const Envelope& env, bool streaming)
+{
+    QueueEndpoint link;
+    ChunkingMessageEndpoint sender(link, chunkingConfig(streaming));
+    ChunkingMessageEndpoint receiver(link);
+    sender.putEnvelope(env);
+    CPPUNIT_ASSERT(link.mEnvelopes.size() > 1);
+
+    Envelope out = receiver.getEnvelope();
+    CPPUNIT_ASSERT(link.mEnvelopes.empty());
+    CPPUNIT_ASSERT(out.classId() == StreamTestContent::ID);
+    return out.contentAs<StreamTestContent>()->mValues;
+}
+
+// copy of a chunk that can be altered
+MessageChunk::Ptr copyChunk(const MessageChunk& chunk)
+{
+    MessageChunk::Ptr copy = std::make_shared<MessageChunk>();
+    copy->mChunkingMethod = chunk.mChunkingMethod;
+    copy->mNumberOfChunks = chunk.mNumberOfChunks;
+    copy->mChunkIndex = chunk.mChunkIndex;
+    copy->mOffset = chunk.mOffset;
+    copy->mUnchunkedSize = chunk.mUnchunkedSize;
+    copy->internalId = chunk.internalId;
+    copy->internalRoutingName = chunk.internalRoutingName;
+    copy->internalInstanceId = chunk.internalInstanceId;
+    copy->internalOriginId = chunk.internalOriginId;
+    copy->internalClassVersion = chunk.internalClassVersion;
+    copy->mPayloadLength = chunk.mPayloadLength;
+    copy->mPayload = new unsigned char[chunk.mPayloadLength];
+    memcpy(copy->mPayload, chunk.mPayload, chunk.mPayloadLength);
+    return copy;
+}
+
+bool addChunkThrows(StreamingUnchunker& unchunker, const MessageChunk::ConstPtr& chunk)
+{
+    try {
+        unchunker.addChunk(chunk);
+    } catch (const InternalError&) {
+        return true;
+    }
+    return false;
+}
+
+}
+
+void TestStreamingChunking::testStreamedChunks()
+{
+    Envelope env = makeEnvelope();
+    size_t size = env.contentAs<StreamTestContent>()->serializedLength();
+    std::vector<MessageChunk::ConstPtr> chunks = streamChunks(env);
+    CPPUNIT_ASSERT(chunks.size() == (size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    // chunks are contiguous and in order. Only the last one carries the totals
+    uint64_t offset = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const MessageChunk& chunk = *chunks[i];
+        CPPUNIT_ASSERT(chunk.mChunkingMethod == MessageChunk::METHOD_STREAMING);
+        CPPUNIT_ASSERT(chunk.mChunkIndex == i);
+        CPPUNIT_ASSERT(chunk.mOffset == offset);
+        CPPUNIT_ASSERT(chunk.mPayloadLength > 0 && chunk.mPayloadLength <= CHUNK_SIZE);
+        CPPUNIT_ASSERT(chunk.internalId == StreamTestContent::ID);
+        CPPUNIT_ASSERT(chunk.internalInstanceId == env.metadata()->instanceId());
+        CPPUNIT_ASSERT(chunk.isLastStreamingChunk() == (i + 1 == chunks.size()));
+        offset += chunk.mPayloadLength;
+    }
+    CPPUNIT_ASSERT(offset == size);
+    CPPUNIT_ASSERT(chunks.back()->mNumberOfChunks == chunks.size());
+    CPPUNIT_ASSERT(chunks.back()->mUnchunkedSize == size);
+}
+
+void TestStreamingChunking::testReassembly()
+{
+    Envelope env = makeEnvelope();
+    const std::vector<uint32_t>& values = env.contentAs<StreamTestContent>()->mValues;
+
+    std::vector<uint32_t> whole = roundTrip(env, false);
+    std::vector<uint32_t> streamed = roundTrip(env, true);
+    CPPUNIT_ASSERT(whole == values);
+    CPPUNIT_ASSERT(streamed == whole);
+
+    // directly through the unchunker
+    std::vector<MessageChunk::ConstPtr> chunks = streamChunks(env);
+    StreamingUnchunker unchunker(chunks[0]);
+    Envelope out;
+    for (size_t i = 1; i < chunks.size(); i++) {
+        CPPUNIT_ASSERT(!unchunker.getUnchunked(out));
+        unchunker.addChunk(chunks[i]);
+    }
+    CPPUNIT_ASSERT(unchunker.getUnchunked(out));
+    CPPUNIT_ASSERT(out.contentAs<StreamTestContent>()->mValues == values);
+}
+
+void TestStreamingChunking::testOutOfOrder()
+{
+    Envelope env = makeEnvelope();
+    std::vector<MessageChunk::ConstPtr> chunks = streamChunks(env);
+
+    // first chunk missing
+    bool threw = false;
+    try {
+        StreamingUnchunker unchunker(chunks[1]);
+    } catch (const InternalError&) {
+        threw = true;
+    }
+    CPPUNIT_ASSERT(threw);
+
+    StreamingUnchunker unchunker(chunks[0]);
+    unchunker.addChunk(chunks[1]);
+    // skipped, repeated and misplaced chunks
+    CPPUNIT_ASSERT(addChunkThrows(unchunker, chunks[3]));
+    CPPUNIT_ASSERT(addChunkThrows(unchunker, chunks[1]));
+    MessageChunk::Ptr moved = copyChunk(*chunks[2]);
+    moved->mOffset++;
+    CPPUNIT_ASSERT(addChunkThrows(unchunker, moved));
+
+    // chunk of a different message
+    Envelope other = makeEnvelope();
+    CPPUNIT_ASSERT(addChunkThrows(unchunker, streamChunks(other)[2]));
+
+    // the receiving endpoint reports the error too
+    QueueEndpoint link;
+    ChunkingMessageEndpoint receiver(link);
+    link.putEnvelope(Envelope(chunks[0]));
+    link.putEnvelope(Envelope(chunks[2]));
+    threw = false;
+    try {
+        receiver.getEnvelope();
+    } catch (const InternalError&) {
+        threw = true;
+    }
+    CPPUNIT_ASSERT(threw);
+}
+
+void TestStreamingChunking::testSizeMismatch()
+{
+    Envelope env = makeEnvelope();
+    std::vector<MessageChunk::ConstPtr> chunks = streamChunks(env);
+    size_t last = chunks.size() - 1;
+
+    for (int field = 0; field < 2; field++) {
+        MessageChunk::Ptr bad = copyChunk(*chunks[last]);
+        if (field == 0) bad->mUnchunkedSize++;
+        else            bad->mNumberOfChunks++;
+
+        StreamingUnchunker unchunker(chunks[0]);
+        for (size_t i = 1; i < last; i++) {
+            unchunker.addChunk(chunks[i]);
+        }
+        CPPUNIT_ASSERT(addChunkThrows(unchunker, bad));
+        Envelope out;
+        CPPUNIT_ASSERT(!unchunker.getUnchunked(out));
+    }
+
+    // totals in a chunk that doesn't end the message
+    MessageChunk::Ptr early = copyChunk(*chunks[1]);
+    early->mNumberOfChunks = 2;
+    early->mUnchunkedSize = chunks[last]->mUnchunkedSize;
+    StreamingUnchunker unchunker(chunks[0]);
+    CPPUNIT_ASSERT(addChunkThrows(unchunker, early));
+}
+
+void TestStreamingChunking::testAbort()
+{
+    Envelope env = makeEnvelope();
+    std::vector<MessageChunk::ConstPtr> chunks = streamChunks(env);
+
+    // the deserializer waits for more data, and has to be stopped by
+    // the destructor. A hang here shows up as a test timeout
+    StreamingUnchunker::Ptr unchunker = std::make_shared<StreamingUnchunker>(chunks[0]);
+    unchunker->addChunk(chunks[1]);
+    unchunker->addChunk(chunks[2]);
+    std::this_thread::sleep_for(PARK_TIME);
+    Envelope out;
+    CPPUNIT_ASSERT(!unchunker->getUnchunked(out));
+    unchunker.reset();
+
+    // destroyed before the deserializer has taken any chunk
+    unchunker = std::make_shared<StreamingUnchunker>(chunks[0]);
+    unchunker.reset();
+
+    // a stream that was abandoned doesn't affect the next message
+    // through the same endpoint
+    QueueEndpoint link;
+    ChunkingMessageEndpoint sender(link, chunkingConfig(true));
+    sender.putEnvelope(env);
+    CPPUNIT_ASSERT(link.mEnvelopes.size() == chunks.size());
+    {
+        ChunkingMessageEndpoint receiver(link);
+        link.mEnvelopes.resize(3);
+        bool threw = false;
+        try {
+            receiver.getEnvelope();
+        } catch (const InternalError&) {
+            threw = true; // QueueEndpoint ran out
+        }
+        CPPUNIT_ASSERT(threw);
+    }
+    link.mEnvelopes.clear();
+    sender.putEnvelope(env);
+    ChunkingMessageEndpoint receiver(link);
+    Envelope complete = receiver.getEnvelope();
+    CPPUNIT_ASSERT(complete.contentAs<StreamTestContent>()->mValues ==
+                   env.contentAs<StreamTestContent>()->mValues);
+}
+
+void TestStreamingChunking::testBackpressure()
+{
+    Envelope env = makeEnvelope();
+    std::vector<MessageChunk::ConstPtr> chunks = streamChunks(env);
+    CPPUNIT_ASSERT(chunks.size() > StreamingUnchunker::MAX_PENDING_CHUNKS + 2);
+
+    // the deserializer takes the first chunk, then stalls
+    gDeserializeGate.close();
+    StreamingUnchunker unchunker(chunks[0]);
+
+    std::atomic<size_t> added(0);
+    std::thread producer([&]() {
+        for (size_t i = 1; i < chunks.size(); i++) {
+            unchunker.addChunk(chunks[i]);
+            added++;
+        }
+    });
+
+    // producer can only get as far as filling the pending chunks
+    std::this_thread::sleep_for(PARK_TIME);
+    size_t addedWhileStalled = added;
+
+    gDeserializeGate.open();
+    producer.join();
+    CPPUNIT_ASSERT(addedWhileStalled == StreamingUnchunker::MAX_PENDING_CHUNKS);
+    CPPUNIT_ASSERT(added == chunks.size() - 1);
+
+    Envelope out;
+    CPPUNIT_ASSERT(unchunker.getUnchunked(out));
+    CPPUNIT_ASSERT(out.contentAs<StreamTestContent>()->mValues ==
+                   env.contentAs<StreamTestContent>()->mValues);
+}
@@ -0,0 +1,35 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __ARRAS_TESTSTREAMINGCHUNKING_H_
+#define __ARRAS_TESTSTREAMINGCHUNKING_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestStreamingChunking: public CppUnit::TestFixture
+{
+public:
+    TestStreamingChunking()
+        : CppUnit::TestFixture()
+    {}
+
+    void testStreamedChunks();
+    void testReassembly();
+    void testOutOfOrder();
+    void testSizeMismatch();
+    void testAbort();
+    void testBackpressure();
+
+    CPPUNIT_TEST_SUITE(TestStreamingChunking);
+        CPPUNIT_TEST(testStreamedChunks);
+        CPPUNIT_TEST(testReassembly);
+        CPPUNIT_TEST(testOutOfOrder);
+        CPPUNIT_TEST(testSizeMismatch);
+        CPPUNIT_TEST(testAbort);
+        CPPUNIT_TEST(testBackpressure);
+    CPPUNIT_TEST_SUITE_END();
+
+};
+
+
+#endif // __ARRAS_TESTSTREAMINGCHUNKING_H_
@@ -181,6 +181,11 @@ CompEnvironmentImpl::initializeComputation(ExecutionLimits& limits,
 void
 CompEnvironmentImpl::applyChunkingConfig(api::ObjectRef config)
 {
+    // streaming chunks use smaller default sizes, which can still
+    // be overridden by the settings below
+    if (config["chunkStreaming"].isBool() &&
+        config["chunkStreaming"].asBool())
+        mChunkingConfig.enableStreaming();
     if (config["chunking"].isBool())
         mChunkingConfig.enabled = config["chunking"].asBool();
     size_t minChunkingSize = 0;
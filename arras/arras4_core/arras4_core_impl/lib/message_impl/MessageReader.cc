@@ -83,7 +83,21 @@ Envelope MessageReader::read(bool useRegistry)
     if (frameSize == 0) {
         return Envelope(); // timeout
     }
+    return readFrame(frameSize, useRegistry);
+}
 
+Envelope MessageReader::readPartial(bool useRegistry)
+{
+    size_t frameSize = mSource.nextFramePartial();
+    if (frameSize == 0) {
+        return Envelope(); // message is incomplete
+    }
+    return readFrame(frameSize, useRegistry);
+}
+
+// interpret the frame that has just arrived in the source as a message
+Envelope MessageReader::readFrame(size_t frameSize, bool useRegistry)
+{
     if (mIsAutosaving)
         doAutosave();
 
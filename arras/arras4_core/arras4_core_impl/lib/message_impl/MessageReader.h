@@ -32,6 +32,11 @@ public:
     // will be delivered as an OpaqueContent instance
     Envelope read(bool useRegistry);
 
+    // version of read() for event driven readers, which never
+    // waits for data (see FramedSource::nextFramePartial()).
+    // Returns an empty envelope until a whole message has arrived
+    Envelope readPartial(bool useRegistry);
+
     // if you received a message with OpaqueContent because you
     // specified 'useRegistry=false', call this to convert to
     // deserialized content. Use this to selectively deserialize
@@ -46,6 +51,7 @@ public:
     void disableAutosave();
 
 private:
+    Envelope readFrame(size_t frameSize, bool useRegistry);
     void doAutosave();
 
     network::DetachableBufferSource& mSource;
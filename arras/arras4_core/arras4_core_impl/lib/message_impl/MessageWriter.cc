@@ -67,6 +67,24 @@ MessageWriter::~MessageWriter()
 // additional copy operation.
 void MessageWriter::write(const Envelope& env)
 {  
+    serialize(env);
+    mSink.closeFrame();       
+}
+
+bool MessageWriter::writePartial(const Envelope& env)
+{
+    serialize(env);
+    return mSink.closeFramePartial();
+}
+
+bool MessageWriter::continueWrite()
+{
+    return mSink.continueFramePartial();
+}
+
+// serialize the message into a new frame, ready to be closed
+void MessageWriter::serialize(const Envelope& env)
+{
    
     // start a new message frame. Autoframed allows us to leave out the frame size, 
     // since it can fill in the size itself when it sends on the frame
@@ -128,8 +146,6 @@ void MessageWriter::write(const Envelope& env)
 
     if (mIsAutosaving)
         doAutosave();
-
-    mSink.closeFrame();       
 }
  
 void MessageWriter::doAutosave()
@@ -34,7 +34,17 @@ public:
 
     void write(const Envelope& env);
 
+    // versions of write() for event driven writers, which
+    // never wait for the sink (see AttachableBufferSink::closeFramePartial()).
+    // writePartial() returns true if the whole message has been
+    // written, otherwise continueWrite() must be called when the sink
+    // can take more data, until it returns true. No other message can
+    // be written until then.
+    bool writePartial(const Envelope& env);
+    bool continueWrite();
+
 private:
+    void serialize(const Envelope& env);
     void doAutosave();
 
     network::AttachableBufferSink& mSink;
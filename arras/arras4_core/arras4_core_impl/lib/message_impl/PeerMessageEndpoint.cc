@@ -55,6 +55,44 @@ void  PeerMessageEndpoint::putEnvelope(const Envelope& env)
     }
 }
 
+Envelope PeerMessageEndpoint::getEnvelopePartial() 
+{
+    if (mShutdown)
+        throw ShutdownException("PeerMessageEndpoint was shut down");
+    try {
+        return mReader.readPartial(mUseRegistry);
+    } catch (network::PeerDisconnectException&) {
+        if (mShutdown)
+            throw ShutdownException("PeerMessageEndpoint was shut down");
+        throw;
+    }
+}
+
+bool PeerMessageEndpoint::putEnvelopePartial(const Envelope& env) 
+{
+    if (mShutdown)
+        throw ShutdownException("PeerMessageEndpoint was shut down");
+    try {
+        return mWriter.writePartial(env);
+    } catch (network::PeerDisconnectException&) {
+        if (mShutdown)
+            throw ShutdownException("PeerMessageEndpoint was shut down");
+        throw;
+    }
+}
+
+bool PeerMessageEndpoint::continuePutEnvelope() 
+{
+    if (mShutdown)
+        throw ShutdownException("PeerMessageEndpoint was shut down");
+    try {
+        return mWriter.continueWrite();
+    } catch (network::PeerDisconnectException&) {
+        if (mShutdown)
+            throw ShutdownException("PeerMessageEndpoint was shut down");
+        throw;
+    }
+}
 
 void  PeerMessageEndpoint::shutdown() {
     // terminate any blocked calls to getEnvelope() or 
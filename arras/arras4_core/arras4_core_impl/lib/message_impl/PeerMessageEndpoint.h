@@ -33,6 +33,17 @@ public:
     ~PeerMessageEndpoint() {}
     Envelope getEnvelope();
     void putEnvelope(const Envelope& env);
+
+    // versions of getEnvelope() and putEnvelope() for event driven
+    // i/o, which never wait for the socket. getEnvelopePartial() returns an 
+    // empty envelope until a whole message has arrived. putEnvelopePartial()
+    // returns false if the message couldn't all be sent yet : then
+    // continuePutEnvelope() must be called when the socket is writable,
+    // until it returns true, before another message is sent. 
+    // See MessageReader::readPartial() and MessageWriter::writePartial()
+    Envelope getEnvelopePartial();
+    bool putEnvelopePartial(const Envelope& env);
+    bool continuePutEnvelope();
     
     void shutdown(); 
 
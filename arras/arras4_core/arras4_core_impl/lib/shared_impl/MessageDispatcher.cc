@@ -4,7 +4,12 @@
 #include "MessageDispatcher.h"
 #include "DispatcherExitReason.h"
 
+#include <core_messages/ControlMessage.h>
+#include <core_messages/EngineReadyMessage.h>
 #include <core_messages/ExecutorHeartbeat.h>
+#include <core_messages/PingMessage.h>
+#include <core_messages/PongMessage.h>
+#include <core_messages/SessionStatusMessage.h>
 #include <exceptions/ShutdownException.h>
 #include <message_api/Message.h>
 #include <network/PeerException.h>
@@ -17,6 +22,30 @@
 
 using namespace arras4::network;
 
+namespace {
+
+// queue lanes
+constexpr unsigned LANE_CONTROL = 0;
+constexpr unsigned LANE_DATA = 1;
+
+// Arras infrastructure messages are small and latency sensitive, so
+// they are queued ahead of regular computation/client messages
+unsigned queueLane(const arras4::impl::Envelope& envelope)
+{
+    using namespace arras4::impl;
+    const arras4::api::ClassID& id = envelope.classId();
+    if (id == ControlMessage::CLASS_ID() ||
+        id == ExecutorHeartbeat::CLASS_ID() ||
+        id == PingMessage::CLASS_ID() ||
+        id == PongMessage::CLASS_ID() ||
+        id == SessionStatusMessage::CLASS_ID() ||
+        id == EngineReadyMessage::CLASS_ID())
+        return LANE_CONTROL;
+    return LANE_DATA;
+}
+
+}
+
 namespace arras4 {
     namespace impl {
 
@@ -32,7 +61,7 @@ bool MessageDispatcher::send(const Envelope& envelope)
 {
     bool ok = true;
     try {
-        mOutgoingQueue.push(envelope);
+        mOutgoingQueue.push(envelope,queueLane(envelope));
     } catch (ShutdownException&) {
         ok = false;
     }  catch (std::exception& e) {
@@ -54,7 +83,7 @@ void MessageDispatcher::incomingThreadProc()
         try {
             Envelope envelope = mSource->getEnvelope(); 
                        // mSource is valid while thread is running..
-            mIncomingQueue.push(envelope);
+            mIncomingQueue.push(envelope,queueLane(envelope));
         } catch (ShutdownException&) {
             // queue has been unblocked to give us a chance to exit
         } catch (network::PeerDisconnectException&) {
@@ -53,11 +53,15 @@ namespace arras4 {
 // longer than this time in onIdle will not displace message handling. 
 // Passing in zero (or NO_IDLE) for 'idleInterval' prevents idle callback altogether.
 //
-// Note: The dispatch queues are unbounded, which means if the send rate
+// The dispatch queues are lock-free MPSC queues with two priority lanes.
+// Arras control messages (ControlMessage, ExecutorHeartbeat, ping/pong,
+// status...) go in the high priority lane, so they overtake a backlog of
+// bulk data such as frame messages in either direction.
+//
+// Note: The dispatch queues are bounded by message count. If the send rate
 // is too high, or handle rate is too low, over a sustained period, then
-// transmission delay will grow indefinitely, together with the queue size.
-// There is an open task to allow these queues to be bounded by some measure
-// (count or total queued message size...)
+// send() blocks when the outgoing queue is full, and the incoming thread
+// stops reading from the endpoint when the incoming queue is full.
 
 class DispatcherObserver 
 {
@@ -91,7 +95,9 @@ public:
 
     // Place a message on the outgoing queue. Can be called any time after 
     // construction. It will be sent as soon as possible, once startDispatching() 
-    // has called.
+    // has called. Blocks while the outgoing queue is full, i.e. until
+    // the writer thread has made room. Returns false if the dispatcher
+    // was shut down or the message couldn't be queued.
     bool send(const Envelope& message);
 
     // startQueuing() begins running the reader thread, so that incoming
@@ -138,8 +144,8 @@ private:
     std::chrono::microseconds mIdleInterval;
     DispatcherObserver* mObserver;
 
-    MessageQueue mOutgoingQueue;
-    MessageQueue mIncomingQueue;
+    PriorityMessageQueue mOutgoingQueue;
+    PriorityMessageQueue mIncomingQueue;
 
     std::thread mMasterThread;
 
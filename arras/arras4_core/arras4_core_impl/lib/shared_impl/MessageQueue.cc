@@ -3,12 +3,14 @@
 
 #include "MessageQueue.h"
 #include "ThreadsafeQueue_impl.h"
+#include "MpscPriorityQueue_impl.h"
 #include <message_impl/Envelope.h>
 
 namespace arras4 {
     namespace impl {
 
 template class ThreadsafeQueue<Envelope>;
+template class MpscPriorityQueue<Envelope>;
 
 
 }
@@ -5,6 +5,7 @@
 #define __ARRAS4_MESSAGE_QUEUEH__
 
 #include "ThreadsafeQueue.h"
+#include "MpscPriorityQueue.h"
 namespace arras4 {
     namespace impl {
 
@@ -12,6 +13,9 @@ namespace arras4 {
         
     using MessageQueue = ThreadsafeQueue<Envelope>;
 
+    // lock-free queue with priority lanes, for a single consumer thread
+    using PriorityMessageQueue = MpscPriorityQueue<Envelope>;
+
 }
 }
 
@@ -0,0 +1,126 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __ARRAS4_MPSC_PRIORITY_QUEUEH__
+#define __ARRAS4_MPSC_PRIORITY_QUEUEH__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace arras4 {
+    namespace impl {
+
+// Bounded multi-producer/single-consumer queue with priority lanes.
+//
+// Each lane is a fixed size ring buffer. push() and pop() are lock-free
+// while the queue is neither empty nor full: producers claim a slot with
+// a compare-and-swap on the lane's tail, and the single consumer releases
+// slots in order. Lane 0 has the highest priority : pop() always takes from
+// the lowest numbered non-empty lane, so messages in a high priority lane
+// overtake any backlog in the lower priority lanes.
+//
+// When the consumer finds the queue empty, or a producer finds its lane
+// full, it spins for a while before parking on a condition variable. The
+// spin limit adapts : it grows while spinning succeeds and shrinks when the
+// thread ends up parking anyway. The mutexes are only taken to park and to
+// wake a parked thread.
+//
+// Only one thread may call pop(), tryPop() and empty() at a time. Any
+// number of threads may call push(). Semantics otherwise follow
+// ThreadsafeQueue, which remains available for the general case.
+template<typename T>
+class MpscPriorityQueue
+{
+public:
+    static constexpr unsigned DEFAULT_LANES = 2;
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    // capacity is per lane, and is rounded up to a power of 2
+    MpscPriorityQueue(const std::string& label="Queue",
+                      unsigned numLanes = DEFAULT_LANES,
+                      size_t capacity = DEFAULT_CAPACITY);
+    ~MpscPriorityQueue();
+
+    MpscPriorityQueue(const MpscPriorityQueue&) = delete;
+    MpscPriorityQueue& operator=(const MpscPriorityQueue&) = delete;
+
+    // push onto the given lane (clamped to the lowest priority lane).
+    // Blocks while the lane is full.
+    void push(const T& t, unsigned lane = 0);
+
+    // pop waits for a maximum period of 'timeout'
+    // for an item to be available on the queue for popping.
+    // It returns true if an item was available before the timeout
+    // and was placed in 't', or false if the timeout expired
+    // and 't' was left unchanged..
+    //
+    // passing a timeout of zero blocks indefinitely until an
+    // item is available, and therefore always returns true
+    bool pop(T& t,
+             const std::chrono::microseconds& timeout =
+             std::chrono::microseconds::zero());
+
+    // tryPop never waits : it returns true and places the
+    // front item in 't' if the queue is not empty, otherwise
+    // it returns false and leaves 't' unchanged
+    bool tryPop(T& t);
+
+    bool empty();
+
+    // when shutdown is called, waiting push and pop
+    // calls will unblock and throw ShutdownException
+    // soon after the shutdown call.
+    // future calls to push/pop will immediately throw
+    // the exception
+    void shutdown();
+
+    unsigned numLanes() const { return mNumLanes; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> mSequence;
+        T mValue;
+    };
+
+    struct Lane {
+        std::unique_ptr<Cell[]> mCells;
+        alignas(64) std::atomic<size_t> mTail; // next slot for producers
+        alignas(64) size_t mHead;              // next slot for the consumer
+    };
+
+    bool tryPush(Lane& lane, T& t);
+    bool tryPopLane(Lane& lane, T& t);
+    bool tryPopAny(T& t);
+    bool anyReady();
+    void wakeConsumer();
+    void wakeProducers();
+
+    std::string mLabel; // helps debugging
+    const unsigned mNumLanes;
+    size_t mMask;
+    std::unique_ptr<Lane[]> mLanes;
+
+    std::atomic<bool> mShutdown;
+
+    // parking : the consumer parks on mPopMutex/mNotEmptyCondition,
+    // producers on mPushMutex/mNotFullCondition
+    std::mutex mPopMutex;
+    std::mutex mPushMutex;
+    std::condition_variable mNotEmptyCondition;
+    std::condition_variable mNotFullCondition;
+    std::atomic<bool> mConsumerParked;
+    std::atomic<unsigned> mProducersParked;
+
+    // adaptive spin limits
+    std::atomic<unsigned> mPopSpin;
+    std::atomic<unsigned> mPushSpin;
+};
+
+}
+}
+#endif
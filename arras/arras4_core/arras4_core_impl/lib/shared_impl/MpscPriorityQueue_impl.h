@@ -0,0 +1,313 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __ARRAS4_MPSC_PRIORITY_QUEUE_IMPLH__
+#define __ARRAS4_MPSC_PRIORITY_QUEUE_IMPLH__
+
+#include "MpscPriorityQueue.h"
+#include <exceptions/ShutdownException.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace arras4 {
+    namespace impl {
+
+namespace mpscqueue {
+
+// bounds of the adaptive spin limit, in iterations
+constexpr unsigned MIN_SPIN = 16;
+constexpr unsigned MAX_SPIN = 4096;
+
+// spin iterations after which the spinning thread also yields
+constexpr unsigned YIELD_AFTER = 64;
+
+inline void spinPause(unsigned iteration)
+{
+    if (iteration >= YIELD_AFTER) {
+        std::this_thread::yield();
+        return;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// spinning succeeded : allow longer spins
+inline void spinSucceeded(std::atomic<unsigned>& limit)
+{
+    unsigned l = limit.load(std::memory_order_relaxed);
+    if (l < MAX_SPIN) limit.store(l * 2, std::memory_order_relaxed);
+}
+
+// spinning was wasted : spin less next time
+inline void spinFailed(std::atomic<unsigned>& limit)
+{
+    unsigned l = limit.load(std::memory_order_relaxed);
+    if (l > MIN_SPIN) limit.store(l / 2, std::memory_order_relaxed);
+}
+
+}
+
+template<typename T>
+MpscPriorityQueue<T>::MpscPriorityQueue(const std::string& label,
+                                        unsigned numLanes,
+                                        size_t capacity) :
+    mLabel(label),
+    mNumLanes(std::max(numLanes, 1u)),
+    mShutdown(false),
+    mConsumerParked(false),
+    mProducersParked(0),
+    mPopSpin(mpscqueue::MIN_SPIN),
+    mPushSpin(mpscqueue::MIN_SPIN)
+{
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+    mMask = size - 1;
+
+    mLanes.reset(new Lane[mNumLanes]);
+    for (unsigned l = 0; l < mNumLanes; l++) {
+        Lane& lane = mLanes[l];
+        lane.mCells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            lane.mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+        lane.mTail.store(0, std::memory_order_relaxed);
+        lane.mHead = 0;
+    }
+}
+
+template<typename T>
+MpscPriorityQueue<T>::~MpscPriorityQueue()
+{
+    shutdown();
+}
+
+// claim the slot at the lane's tail and publish t into it.
+// returns false if the lane is full
+template<typename T>
+bool MpscPriorityQueue<T>::tryPush(Lane& lane, T& t)
+{
+    size_t pos = lane.mTail.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = lane.mCells[pos & mMask];
+        size_t seq = cell.mSequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (lane.mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.mValue = std::move(t);
+                cell.mSequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            // pos was updated by the failed compare_exchange
+        } else if (diff < 0) {
+            return false; // slot not yet released by the consumer
+        } else {
+            pos = lane.mTail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T>
+bool MpscPriorityQueue<T>::tryPopLane(Lane& lane, T& t)
+{
+    Cell& cell = lane.mCells[lane.mHead & mMask];
+    if (cell.mSequence.load(std::memory_order_acquire) != lane.mHead + 1) {
+        return false;
+    }
+    t = std::move(cell.mValue);
+    cell.mValue = T(); // don't hold on to the item's resources
+    cell.mSequence.store(lane.mHead + mMask + 1, std::memory_order_release);
+    lane.mHead++;
+    return true;
+}
+
+template<typename T>
+bool MpscPriorityQueue<T>::tryPopAny(T& t)
+{
+    for (unsigned l = 0; l < mNumLanes; l++) {
+        if (tryPopLane(mLanes[l], t)) return true;
+    }
+    return false;
+}
+
+template<typename T>
+bool MpscPriorityQueue<T>::anyReady()
+{
+    for (unsigned l = 0; l < mNumLanes; l++) {
+        const Lane& lane = mLanes[l];
+        if (lane.mCells[lane.mHead & mMask].mSequence.load(std::memory_order_acquire) ==
+            lane.mHead + 1)
+            return true;
+    }
+    return false;
+}
+
+// the fences pair with the ones in the parking code : either the parked
+// thread sees the change to the queue, or we see that it is parked
+template<typename T>
+void MpscPriorityQueue<T>::wakeConsumer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mConsumerParked.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mPopMutex);
+        mNotEmptyCondition.notify_one();
+    }
+}
+
+template<typename T>
+void MpscPriorityQueue<T>::wakeProducers()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mProducersParked.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mPushMutex);
+        mNotFullCondition.notify_all();
+    }
+}
+
+template<typename T>
+void MpscPriorityQueue<T>::push(const T& t, unsigned laneIndex)
+{
+    if (mShutdown) {
+        throw ShutdownException("Queue was shut down");
+    }
+    Lane& lane = mLanes[std::min(laneIndex, mNumLanes - 1)];
+
+    // copy before claiming a slot, so that a throwing copy
+    // can't leave a claimed slot unpublished
+    T item(t);
+    if (tryPush(lane, item)) {
+        wakeConsumer();
+        return;
+    }
+
+    // lane is full : spin for a while, waiting for the consumer
+    unsigned spin = mPushSpin.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < spin; i++) {
+        mpscqueue::spinPause(i);
+        if (tryPush(lane, item)) {
+            mpscqueue::spinSucceeded(mPushSpin);
+            wakeConsumer();
+            return;
+        }
+        if (mShutdown) {
+            throw ShutdownException("Queue was shut down");
+        }
+    }
+    mpscqueue::spinFailed(mPushSpin);
+
+    // then park until the consumer frees a slot
+    {
+        std::unique_lock<std::mutex> lock(mPushMutex);
+        mProducersParked++;
+        while (true) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tryPush(lane, item)) break;
+            if (mShutdown) {
+                mProducersParked--;
+                throw ShutdownException("Queue was shut down");
+            }
+            mNotFullCondition.wait(lock);
+        }
+        mProducersParked--;
+    }
+    wakeConsumer();
+}
+
+template<typename T>
+bool MpscPriorityQueue<T>::pop(T& t,
+                               const std::chrono::microseconds& timeout)
+{
+    if (mShutdown) {
+        throw ShutdownException("Queue was shut down");
+    }
+    if (tryPopAny(t)) {
+        wakeProducers();
+        return true;
+    }
+
+    // queue is empty : spin for a while, waiting for a producer
+    unsigned spin = mPopSpin.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < spin; i++) {
+        mpscqueue::spinPause(i);
+        if (tryPopAny(t)) {
+            mpscqueue::spinSucceeded(mPopSpin);
+            wakeProducers();
+            return true;
+        }
+        if (mShutdown) {
+            throw ShutdownException("Queue was shut down");
+        }
+    }
+    mpscqueue::spinFailed(mPopSpin);
+
+    // then park until a producer pushes something
+    bool popped = false;
+    {
+        std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mPopMutex);
+        mConsumerParked.store(true);
+        while (true) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tryPopAny(t)) {
+                popped = true;
+                break;
+            }
+            if (mShutdown) {
+                mConsumerParked.store(false);
+                throw ShutdownException("Queue was shut down");
+            }
+            if (timeout == std::chrono::microseconds::zero()) {
+                mNotEmptyCondition.wait(lock);
+            } else if (mNotEmptyCondition.wait_until(lock, deadline) == std::cv_status::timeout) {
+                popped = tryPopAny(t);
+                break;
+            }
+        }
+        mConsumerParked.store(false);
+    }
+    if (popped) {
+        wakeProducers();
+    }
+    return popped;
+}
+
+template<typename T>
+bool MpscPriorityQueue<T>::tryPop(T& t)
+{
+    if (mShutdown) {
+        throw ShutdownException("Queue was shut down");
+    }
+    if (!tryPopAny(t)) {
+        return false;
+    }
+    wakeProducers();
+    return true;
+}
+
+template<typename T>
+bool MpscPriorityQueue<T>::empty()
+{
+    return !anyReady();
+}
+
+template<typename T>
+void MpscPriorityQueue<T>::shutdown()
+{
+    mShutdown = true;
+    {
+        std::lock_guard<std::mutex> lock(mPopMutex);
+        mNotEmptyCondition.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mPushMutex);
+        mNotFullCondition.notify_all();
+    }
+}
+
+}
+}
+#endif
@@ -35,6 +35,11 @@ public:
              const std::chrono::microseconds& timeout =
              std::chrono::microseconds::zero());
 
+    // tryPop never waits : it returns true and places the
+    // front item in 't' if the queue is not empty, otherwise
+    // it returns false and leaves 't' unchanged
+    bool tryPop(T& t);
+
     // blocks until the next time the queue is empty, the
     // timeout has expired or shutdown is called. Returns
     // true if terminated because queue was empty.
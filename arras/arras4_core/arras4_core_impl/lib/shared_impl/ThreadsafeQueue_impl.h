@@ -49,6 +49,23 @@ bool ThreadsafeQueue<T>::pop(T& t,
     return true;
 }
 
+template<typename T>
+bool ThreadsafeQueue<T>::tryPop(T& t)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mShutdown) {
+        throw ShutdownException("Queue was shut down");
+    }
+    if (mQueue.empty()) {
+        return false;
+    }
+    t = mQueue.front();
+    mQueue.pop();
+    if (mQueue.empty())
+        mEmptyCondition.notify_all();
+    return true;
+}
+
 template<typename T>
 bool ThreadsafeQueue<T>::waitUntilEmpty(const std::chrono::microseconds& timeout)
 {
@@ -0,0 +1,227 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TestMpscPriorityQueue.h"
+
+#include <shared_impl/MpscPriorityQueue_impl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMpscPriorityQueue);
+
+using arras4::impl::MpscPriorityQueue;
+using arras4::impl::ShutdownException;
+
+namespace {
+
+typedef MpscPriorityQueue<uint64_t> Queue;
+
+// time given to blocked threads to finish spinning and park
+const std::chrono::milliseconds PARK_TIME(200);
+
+// guards against a hang if an item goes missing
+const std::chrono::microseconds POP_TIMEOUT(std::chrono::seconds(10));
+
+uint64_t makeItem(uint64_t producer, uint64_t seq)
+{
+    return (producer << 32) | seq;
+}
+
+// spread each producer's items over both lanes in short runs
+unsigned laneOf(uint64_t seq)
+{
+    return (seq / 3) % 2;
+}
+
+}
+
+void TestMpscPriorityQueue::testLaneOrder()
+{
+    // capacity 4 : three passes wrap around each lane twice
+    Queue queue("test", 2, 4);
+    uint64_t item;
+    CPPUNIT_ASSERT(queue.empty());
+    CPPUNIT_ASSERT(!queue.tryPop(item));
+
+    for (uint64_t pass = 0; pass < 3; pass++) {
+        for (uint64_t i = 0; i < 4; i++) {
+            queue.push(100 + pass * 4 + i, 1);
+            queue.push(pass * 4 + i, 0);
+        }
+        // the high priority lane drains first, each lane in FIFO order
+        for (uint64_t i = 0; i < 4; i++) {
+            CPPUNIT_ASSERT(queue.pop(item));
+            CPPUNIT_ASSERT(item == pass * 4 + i);
+        }
+        for (uint64_t i = 0; i < 4; i++) {
+            CPPUNIT_ASSERT(queue.tryPop(item));
+            CPPUNIT_ASSERT(item == 100 + pass * 4 + i);
+        }
+        CPPUNIT_ASSERT(queue.empty());
+    }
+
+    // lanes past the last are clamped to the lowest priority lane
+    queue.push(1, 7);
+    queue.push(0, 0);
+    CPPUNIT_ASSERT(queue.pop(item) && item == 0);
+    CPPUNIT_ASSERT(queue.pop(item) && item == 1);
+}
+
+void TestMpscPriorityQueue::testConcurrentProducers()
+{
+    // small lanes, so that producers keep filling them, parking
+    // and wrapping around
+    const uint64_t numProducers = 4;
+    const uint64_t itemsPerProducer = 50000;
+    Queue queue("test", 2, 8);
+
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < numProducers; p++) {
+        producers.emplace_back([&queue, p, itemsPerProducer]() {
+            for (uint64_t seq = 0; seq < itemsPerProducer; seq++) {
+                queue.push(makeItem(p, seq), laneOf(seq));
+            }
+        });
+    }
+
+    // items from one producer in one lane must arrive in the order
+    // they were pushed, and every item must arrive exactly once
+    std::vector<std::vector<int64_t>> lastSeq(numProducers, std::vector<int64_t>(2, -1));
+    std::vector<std::vector<bool>> seen(numProducers, std::vector<bool>(itemsPerProducer, false));
+    bool ok = true;
+    for (uint64_t n = 0; n < numProducers * itemsPerProducer && ok; n++) {
+        uint64_t item;
+        if (!queue.pop(item, POP_TIMEOUT)) {
+            ok = false;
+            break;
+        }
+        uint64_t p = item >> 32;
+        uint64_t seq = item & 0xffffffff;
+        if (p >= numProducers || seq >= itemsPerProducer || seen[p][seq]) {
+            ok = false;
+            break;
+        }
+        unsigned lane = laneOf(seq);
+        if (static_cast<int64_t>(seq) <= lastSeq[p][lane]) {
+            ok = false;
+            break;
+        }
+        lastSeq[p][lane] = seq;
+        seen[p][seq] = true;
+    }
+
+    // unblock any producer left waiting if the check failed
+    queue.shutdown();
+    for (std::thread& t : producers) {
+        t.join();
+    }
+    CPPUNIT_ASSERT(ok);
+    for (uint64_t p = 0; p < numProducers; p++) {
+        for (uint64_t seq = 0; seq < itemsPerProducer; seq++) {
+            CPPUNIT_ASSERT(seen[p][seq]);
+        }
+    }
+}
+
+void TestMpscPriorityQueue::testShutdownWakesProducers()
+{
+    const unsigned numProducers = 3;
+    Queue queue("test", 1, 2);
+    queue.push(0);
+    queue.push(1);
+
+    std::atomic<unsigned> returned(0);
+    std::atomic<unsigned> threw(0);
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < numProducers; p++) {
+        producers.emplace_back([&]() {
+            try {
+                queue.push(2);
+                returned++;
+            } catch (ShutdownException&) {
+                threw++;
+            }
+        });
+    }
+
+    // the lane is full, so all the producers end up parked
+    std::this_thread::sleep_for(PARK_TIME);
+    CPPUNIT_ASSERT(returned == 0 && threw == 0);
+
+    queue.shutdown();
+    for (std::thread& t : producers) {
+        t.join();
+    }
+    CPPUNIT_ASSERT(returned == 0);
+    CPPUNIT_ASSERT(threw == numProducers);
+
+    try {
+        queue.push(3);
+        CPPUNIT_ASSERT(false && "didn't get exception for push after shutdown");
+    } catch (ShutdownException&) {
+    }
+}
+
+void TestMpscPriorityQueue::testShutdownWakesConsumer()
+{
+    Queue queue("test");
+
+    std::atomic<bool> returned(false);
+    std::atomic<bool> threw(false);
+    std::thread consumer([&]() {
+        try {
+            uint64_t item;
+            queue.pop(item);
+            returned = true;
+        } catch (ShutdownException&) {
+            threw = true;
+        }
+    });
+
+    // the queue is empty, so the consumer ends up parked
+    std::this_thread::sleep_for(PARK_TIME);
+    CPPUNIT_ASSERT(!returned && !threw);
+
+    queue.shutdown();
+    consumer.join();
+    CPPUNIT_ASSERT(!returned);
+    CPPUNIT_ASSERT(threw);
+
+    try {
+        uint64_t item;
+        queue.pop(item);
+        CPPUNIT_ASSERT(false && "didn't get exception for pop after shutdown");
+    } catch (ShutdownException&) {
+    }
+}
+
+void TestMpscPriorityQueue::testPopTimeout()
+{
+    Queue queue("test");
+    uint64_t item = 42;
+
+    // times out on an empty queue, leaving the item unchanged
+    const std::chrono::milliseconds timeout(100);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    CPPUNIT_ASSERT(!queue.pop(item, timeout));
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    CPPUNIT_ASSERT(elapsed >= timeout);
+    CPPUNIT_ASSERT(elapsed < std::chrono::seconds(5));
+    CPPUNIT_ASSERT(item == 42);
+
+    // returns as soon as an item is pushed, well before the timeout
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        queue.push(7);
+    });
+    start = std::chrono::steady_clock::now();
+    CPPUNIT_ASSERT(queue.pop(item, POP_TIMEOUT));
+    elapsed = std::chrono::steady_clock::now() - start;
+    producer.join();
+    CPPUNIT_ASSERT(item == 7);
+    CPPUNIT_ASSERT(elapsed < std::chrono::seconds(5));
+}
@@ -0,0 +1,33 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __ARRAS_TESTMPSCPRIORITYQUEUE_H_
+#define __ARRAS_TESTMPSCPRIORITYQUEUE_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestMpscPriorityQueue: public CppUnit::TestFixture
+{
+public:
+    TestMpscPriorityQueue()
+        : CppUnit::TestFixture()
+    {}
+
+    void testLaneOrder();
+    void testConcurrentProducers();
+    void testShutdownWakesProducers();
+    void testShutdownWakesConsumer();
+    void testPopTimeout();
+
+    CPPUNIT_TEST_SUITE(TestMpscPriorityQueue);
+        CPPUNIT_TEST(testLaneOrder);
+        CPPUNIT_TEST(testConcurrentProducers);
+        CPPUNIT_TEST(testShutdownWakesProducers);
+        CPPUNIT_TEST(testShutdownWakesConsumer);
+        CPPUNIT_TEST(testPopTimeout);
+    CPPUNIT_TEST_SUITE_END();
+
+};
+
+
+#endif // __ARRAS_TESTMPSCPRIORITYQUEUE_H_
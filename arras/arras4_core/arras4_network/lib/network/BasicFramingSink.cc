@@ -6,6 +6,7 @@
 #include "Frame.h"
 
 #include <limits>
+#include <vector>
 
 namespace arras4 {
     namespace network {
@@ -66,6 +67,85 @@ bool BasicFramingSink::closeFrame()
     return true;
 }
 
+bool BasicFramingSink::writeFrame(const struct iovec* aBlocks, size_t aCount)
+{
+    size_t frameSize = 0;
+    for (size_t i = 0; i < aCount; i++) 
+        frameSize += aBlocks[i].iov_len;
+    if (frameSize > std::numeric_limits<unsigned int>::max())
+        throw FramingError("Data is too long for the framing protocol. Limit is ~2Gb");
+
+    Frame frameHdr;
+    frameHdr.mType = Frame::FRAME_BINARY;
+    frameHdr.mLength = (unsigned)frameSize;
+    frameHdr.mReserved1 = frameHdr.mReserved2 = 0;
+
+    // header goes in front of the data blocks, so that the 
+    // whole frame can be passed on in one operation
+    std::vector<struct iovec> blocks;
+    blocks.reserve(aCount + 1);
+    blocks.push_back({&frameHdr, sizeof(frameHdr)});
+    blocks.insert(blocks.end(), aBlocks, aBlocks + aCount);
+
+    size_t w = mOutputSink.writeBlocks(blocks.data(), blocks.size());
+    mFrameSize = 0;
+    mBytesWritten = 0;
+    return w;
+}
+
+
+bool BasicFramingSink::writeFramePartial(const struct iovec* aBlocks, size_t aCount)
+{
+    if (!mPartialBlocks.empty())
+        throw FramingError("Previous frame has not been completely written");
+
+    size_t frameSize = 0;
+    for (size_t i = 0; i < aCount; i++) 
+        frameSize += aBlocks[i].iov_len;
+    if (frameSize > std::numeric_limits<unsigned int>::max())
+        throw FramingError("Data is too long for the framing protocol. Limit is ~2Gb");
+
+    mPartialHeader.mType = Frame::FRAME_BINARY;
+    mPartialHeader.mLength = (unsigned)frameSize;
+    mPartialHeader.mReserved1 = mPartialHeader.mReserved2 = 0;
+
+    mPartialBlocks.reserve(aCount + 1);
+    mPartialBlocks.push_back({&mPartialHeader, sizeof(mPartialHeader)});
+    for (size_t i = 0; i < aCount; i++) {
+        if (aBlocks[i].iov_len == 0) continue;
+        mPartialBlocks.push_back(aBlocks[i]);
+    }
+    mPartialFirst = 0;
+    return continueFramePartial();
+}
+
+bool BasicFramingSink::continueFramePartial()
+{
+    while (mPartialFirst < mPartialBlocks.size()) {
+        size_t w = mOutputSink.writeBlocksPartial(&mPartialBlocks[mPartialFirst],
+                                                  mPartialBlocks.size() - mPartialFirst);
+        if (w == 0) {
+            // output can't take any more yet
+            return false;
+        }
+
+        // skip over the blocks that were completely written, and
+        // adjust the first remaining block for a partial write
+        while (mPartialFirst < mPartialBlocks.size() && 
+               w >= mPartialBlocks[mPartialFirst].iov_len) {
+            w -= mPartialBlocks[mPartialFirst].iov_len;
+            mPartialFirst++;
+        }
+        if (w > 0) {
+            struct iovec& block = mPartialBlocks[mPartialFirst];
+            block.iov_base = static_cast<unsigned char*>(block.iov_base) + w;
+            block.iov_len -= w;
+        }
+    }
+    mPartialBlocks.clear();
+    mPartialFirst = 0;
+    return true;
+}
 
 }
 }
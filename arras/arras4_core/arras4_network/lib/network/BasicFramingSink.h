@@ -5,6 +5,9 @@
 #define __ARRAS4_BASIC_FRAMING_SINKH__
 
 #include "DataSink.h"
+#include "Frame.h"
+
+#include <vector>
 
 namespace arras4 {
     namespace network {
@@ -26,6 +29,15 @@ public:
     bool openFrame(size_t frameSize);
     bool closeFrame();
 
+    // sends the frame header and all the blocks to the
+    // output sink with a single writeBlocks() call
+    bool writeFrame(const struct iovec* aBlocks, size_t aCount);
+
+    // writes the frame header and blocks using the output sink's
+    // writeBlocksPartial(), keeping track of how much has been written
+    bool writeFramePartial(const struct iovec* aBlocks, size_t aCount);
+    bool continueFramePartial();
+
 private:
 
     size_t remaining() { return mFrameSize - mBytesWritten; }
@@ -33,6 +45,12 @@ private:
     DataSink& mOutputSink;
     size_t mBytesWritten = 0;
     size_t mFrameSize = 0;
+
+    // frame being written by writeFramePartial() : the header, and
+    // what remains to be written from mPartialBlocks[mPartialFirst] on
+    Frame mPartialHeader;
+    std::vector<struct iovec> mPartialBlocks;
+    size_t mPartialFirst = 0;
 };
 
 }
@@ -32,6 +32,15 @@ size_t BasicFramingSource::read(unsigned char* aBuf, size_t aLen)
     return read;
 }
 
+size_t BasicFramingSource::readPartial(unsigned char* aBuf, size_t aLen)
+{
+    if (aLen > remaining())
+        throw FramingError("Attempt to read beyond end of data frame");
+    size_t read = mInputSource.readPartial(aBuf, aLen);
+    mBytesRead += read;
+    return read;
+}
+
 size_t BasicFramingSource::skip(size_t aLen)
 { 
     if (aLen > remaining())
@@ -56,6 +65,24 @@ size_t BasicFramingSource::nextFrame()
    }
 }
 
+size_t BasicFramingSource::nextFramePartial()
+{
+    unsigned char* hdr = reinterpret_cast<unsigned char*>(&mPartialHeader);
+    while (mHeaderBytesRead < sizeof(mPartialHeader)) {
+        size_t r = mInputSource.readPartial(hdr + mHeaderBytesRead,
+                                            sizeof(mPartialHeader) - mHeaderBytesRead);
+        if (r == 0) {
+            // rest of the header hasn't arrived yet
+            return 0;
+        }
+        mHeaderBytesRead += r;
+    }
+    mHeaderBytesRead = 0;
+    mFrameSize = mPartialHeader.mLength;
+    mBytesRead = 0;
+    return mFrameSize;
+}
+
 void BasicFramingSource::endFrame()
 {
     mFrameSize = 0;
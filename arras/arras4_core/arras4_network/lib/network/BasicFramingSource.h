@@ -5,6 +5,7 @@
 #define __ARRAS4_BASIC_FRAMING_SOURCEH__
 
 #include "DataSource.h"
+#include "Frame.h"
 
 namespace arras4 {
     namespace network {
@@ -12,6 +13,10 @@ namespace arras4 {
 // Adds framing to an unframed source, using the Arras BasicFraming protocol
 // Propagates timeouts in the input source (e.g. if input source read returns
 // 0, BFS::nextFrame will return 0, and can be called again)
+//
+// nextFramePartial() and readPartial() never wait for the input source :
+// a frame header that arrives in pieces is accumulated over several
+// nextFramePartial() calls
 class BasicFramingSource : public FramedSource
 {
 public:
@@ -27,6 +32,9 @@ public:
     size_t nextFrame();
     void endFrame();
 
+    size_t readPartial(unsigned char* aBuf, size_t aLen);
+    size_t nextFramePartial();
+
 private:
 
     size_t remaining() { return mFrameSize - mBytesRead; }
@@ -34,6 +42,10 @@ private:
     DataSource& mInputSource;
     size_t mBytesRead = 0;
     size_t mFrameSize = 0;
+
+    // frame header being read by nextFramePartial()
+    Frame mPartialHeader;
+    size_t mHeaderBytesRead = 0;
 };
 
 }
@@ -49,23 +49,55 @@ bool BufferedSink::openFrame()
     return true;
 }
 
-bool BufferedSink::closeFrame()
+// the whole frame is handed over to the output sink as a list
+// of blocks, so that large appended buffers (e.g. opaque content
+// being forwarded) go out together with the message header in one
+// gathered write, without being copied
+std::vector<struct iovec> BufferedSink::frameBlocks()
 {
-    // now the frame is ended, we can send it to our output sink
-    bool ok = mOutputSink.openFrame(bytesWritten());
-    if (!ok) return false; // timeout
+    std::vector<struct iovec> blocks;
+    blocks.reserve(mMultiBuffer.bufferCount() + mAppendedBuffers.size());
 
     for (size_t i = 0; i < mMultiBuffer.bufferCount(); i++) {
         const BufferUniquePtr& buf = mMultiBuffer.buffer(i);
-        mOutputSink.write(buf->start(),buf->remaining());
+        if (buf->remaining() == 0) continue;
+        blocks.push_back({const_cast<unsigned char*>(buf->start()), buf->remaining()});
     }                    
         
     for (size_t i = 0; i < mAppendedBuffers.size(); i++) {
         const BufferConstPtr& buf = mAppendedBuffers[i];
-        mOutputSink.write(buf->start(),buf->remaining());
+        if (buf->remaining() == 0) continue;
+        blocks.push_back({const_cast<unsigned char*>(buf->start()), buf->remaining()});
     }
-                    
-    mOutputSink.closeFrame();
+    return blocks;
+}
+
+bool BufferedSink::closeFrame()
+{
+    // now the frame is ended, we can send it to our output sink.
+    std::vector<struct iovec> blocks = frameBlocks();
+    bool ok = mOutputSink.writeFrame(blocks.data(), blocks.size());
+    if (!ok) return false; // timeout
+
+    reset();
+    return true;
+}
+
+bool BufferedSink::closeFramePartial()
+{
+    std::vector<struct iovec> blocks = frameBlocks();
+    if (!mOutputSink.writeFramePartial(blocks.data(), blocks.size())) 
+        return false;
+
+    reset();
+    return true;
+}
+
+bool BufferedSink::continueFramePartial()
+{
+    if (!mOutputSink.continueFramePartial()) 
+        return false;
+
     reset();
     return true;
 }
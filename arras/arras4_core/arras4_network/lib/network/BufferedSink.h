@@ -53,6 +53,11 @@ public:
     bool openFrame();
     bool closeFrame();
 
+    // the frame buffers are kept until the output sink
+    // has taken the whole frame
+    bool closeFramePartial();
+    bool continueFramePartial();
+
     // has the additional ability to append an existing
     // buffer to the frame : used for efficient transfer 
     // of opaque messages
@@ -69,6 +74,7 @@ public:
   
 private:
     void reset();
+    std::vector<struct iovec> frameBlocks();
 
     FramedSink& mOutputSink;    
     MultiBuffer mMultiBuffer;
@@ -87,6 +87,27 @@ size_t BufferedSource::nextFrame()
     return frameSize;
 }
 
+size_t BufferedSource::nextFramePartial()
+{
+    if (!mIsFilling) {
+        size_t frameSize = mInputSource.nextFramePartial();
+        if (frameSize == 0) return 0; // frame header hasn't arrived yet
+        mFillPtr = prepForFill(frameSize);
+        mFillSize = frameSize;
+        mFilled = 0;
+        mIsFilling = true;
+    }
+    while (mFilled < mFillSize) {
+        size_t r = mInputSource.readPartial(mFillPtr + mFilled, mFillSize - mFilled);
+        if (r == 0) return 0; // rest of the frame hasn't arrived yet
+        mFilled += r;
+    }
+    mInputSource.endFrame();
+    mIsFilling = false;
+    mIsInFrame = true;
+    return mFillSize;
+}
+
 // enables the internal buffer to be freed
 void BufferedSource::endFrame()
 {
@@ -95,7 +116,7 @@ void BufferedSource::endFrame()
 
 void BufferedSource::shrinkTo(size_t maxCapacity)
 {
-    if (!mIsInFrame && 
+    if (!mIsInFrame && !mIsFilling &&
         mBuffer && 
         (mBuffer->capacity() > maxCapacity)) {
         mBuffer.reset();
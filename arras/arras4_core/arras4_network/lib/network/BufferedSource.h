@@ -25,6 +25,11 @@ namespace arras4 {
 // i.e. if inputSource.nextFrame() returns 0, then 
 // BS::nextFrame will return 0 and can be called again.
 //
+// nextFramePartial() fills the buffer with whatever part of the frame
+// has arrived, and returns the frame size once the whole frame is
+// in the buffer. This lets an event loop service many sources without
+// waiting on any one of them.
+//
 class BufferedSource : public DetachableBufferSource
 {
 public:
@@ -45,6 +50,7 @@ public:
     // BufferedSource supports framing : each frame is one message
     size_t nextFrame();
     void endFrame();
+    size_t nextFramePartial();
     
     // returns the internal buffer,
     // releasing it from use by this object
@@ -66,6 +72,12 @@ private:
     FramedSource& mInputSource;
     bool mIsInFrame = false;
 
+    // state of the frame being filled by nextFramePartial()
+    bool mIsFilling = false;
+    unsigned char* mFillPtr = nullptr;
+    size_t mFillSize = 0;
+    size_t mFilled = 0;
+
     BufferPtr mBuffer;
    
 };
@@ -6,6 +6,7 @@
 
 #include "network_types.h"
 #include <cstddef>
+#include <sys/uio.h>
 
 namespace arras4
 {
@@ -22,6 +23,29 @@ public:
     virtual void flush() = 0;
     virtual size_t bytesWritten() const=0;
 
+    // write out a sequence of blocks as if they were a single
+    // contiguous block. Sinks that can transfer several blocks
+    // in one operation (e.g. a gathered socket write) override this.
+    // Returns number of bytes written, or 0 on timeout.
+    virtual size_t writeBlocks(const struct iovec* aBlocks, size_t aCount) {
+        size_t total = 0;
+        for (size_t i = 0; i < aCount; i++) {
+            if (aBlocks[i].iov_len == 0) continue;
+            size_t w = write(static_cast<const unsigned char*>(aBlocks[i].iov_base),
+                             aBlocks[i].iov_len);
+            if (w == 0 && total == 0) return 0;
+            total += w;
+        }
+        return total;
+    }
+
+    // write out as much of a sequence of blocks as the sink can take
+    // without waiting. Returns number of bytes written, which may be 0.
+    // Sinks that can't tell what they can take write all the blocks,
+    // like writeBlocks()
+    virtual size_t writeBlocksPartial(const struct iovec* aBlocks, size_t aCount) {
+        return writeBlocks(aBlocks, aCount);
+    }
 };
 
 // a sink that delivers data within a framing protocol.
@@ -47,6 +71,33 @@ public:
     // occurs before the frame can be closed, and may then be called
     // again.
     virtual bool closeFrame()=0;
+
+    // write a complete frame made up of a sequence of blocks :
+    // equivalent to openFrame(total size), write of every block
+    // and closeFrame(). Subclasses may override this to pass the
+    // blocks on to their output in a single operation. Returns false
+    // if a timeout occurs before the frame can be opened.
+    virtual bool writeFrame(const struct iovec* aBlocks, size_t aCount) {
+        size_t total = 0;
+        for (size_t i = 0; i < aCount; i++) total += aBlocks[i].iov_len;
+        if (!openFrame(total)) return false;
+        writeBlocks(aBlocks, aCount);
+        return closeFrame();
+    }
+
+    // versions of writeFrame() for event driven writers, which never
+    // wait for the output. writeFramePartial() starts a frame
+    // made up of a sequence of blocks, and writes what the output can take
+    // right away. continueFramePartial() writes more of it, when the
+    // output can take more. Both return true once the whole frame has been
+    // written, and the blocks must remain valid until then. A new frame
+    // can't be started before the previous one is complete. Sinks that
+    // can't tell what their output can take write the whole frame
+    // in writeFramePartial()
+    virtual bool writeFramePartial(const struct iovec* aBlocks, size_t aCount) {
+        return writeFrame(aBlocks, aCount);
+    }
+    virtual bool continueFramePartial() { return true; }
 };
 
 // Similar to a framed sink, but it is not necessary to specify
@@ -71,6 +122,15 @@ public:
     // again.
     virtual bool closeFrame()=0;
 
+    // version of closeFrame() for event driven writers, which
+    // never waits for the output (see FramedSink::writeFramePartial()).
+    // Returns true if the whole frame has been written, otherwise
+    // continueFramePartial() must be called when the output can take
+    // more, until it returns true. openFrame() can't be called before
+    // then. The defaults wait for the whole frame to be written
+    virtual bool closeFramePartial() { return closeFrame(); }
+    virtual bool continueFramePartial() { return true; }
+
     virtual void appendBuffer(const BufferConstPtr& buf)=0;
 
     // writes all buffers to file. Returns false if write fails.
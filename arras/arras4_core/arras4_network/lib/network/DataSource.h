@@ -20,6 +20,11 @@ public:
     // consume a block of data, copying it to aBuf. Returns
     // number of bytes read, or 0 on timeout.
     virtual size_t read(unsigned char* aBuf, size_t aLen)=0;
+    // consume up to aLen bytes that are available without
+    // waiting, copying them to aBuf. Returns number of bytes
+    // read, which may be 0. Sources that can't tell what is
+    // available read all aLen bytes, like read()
+    virtual size_t readPartial(unsigned char* aBuf, size_t aLen) { return read(aBuf, aLen); }
     // skip over and consume aLen bytes. Returns
     // number of bytes skipped, or 0 on timeout.
     virtual size_t skip(size_t aLen)=0;
@@ -43,6 +48,15 @@ public:
     // returns 0 if a timeout occurs before the next frame arrives
     virtual size_t nextFrame()=0;
 
+    // version of nextFrame() for event driven readers, which
+    // never waits for data : it consumes whatever has arrived and returns
+    // the size of the next frame once enough of it is available, and 0
+    // until then. The frame data is then read with readPartial().
+    // Don't mix nextFrame() and nextFramePartial() calls on a source
+    // while a frame is arriving. Sources that can't tell what is available
+    // wait for the frame, like nextFrame()
+    virtual size_t nextFramePartial() { return nextFrame(); }
+
     // indicate that no more data will be read 
     // from the current frame (may cause buffer release,
     // and/or check for excess unread data)
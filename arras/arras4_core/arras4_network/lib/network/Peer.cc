@@ -12,6 +12,11 @@ size_t PeerSourceAndSink::read(unsigned char* aBuf, size_t aLen)
     return aLen;
 }
 
+size_t PeerSourceAndSink::readPartial(unsigned char* aBuf, size_t aLen)
+{
+    return mPeer.receive_some(aBuf,aLen);
+}
+
 size_t PeerSourceAndSink::skip(size_t)
 {
     throw PeerException(PeerException::INVALID_OPERATION,"Skip not supported for Peer source");
@@ -28,6 +33,22 @@ size_t PeerSourceAndSink::write(const unsigned char* aBuf, size_t aLen)
     return aLen;
 }
 
+size_t PeerSourceAndSink::writeBlocks(const struct iovec* aBlocks, size_t aCount)
+{
+    if (!mPeer.sendv(aBlocks,aCount)) {
+        mPeer.throw_disconnect("Sink write");
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < aCount; i++) 
+        total += aBlocks[i].iov_len;
+    return total;
+}
+
+size_t PeerSourceAndSink::writeBlocksPartial(const struct iovec* aBlocks, size_t aCount)
+{
+    return mPeer.sendv_some(aBlocks,aCount);
+}
+
 void PeerSourceAndSink::flush()
 {
 }
@@ -37,5 +58,39 @@ size_t PeerSourceAndSink::bytesWritten() const
     return mPeer.bytesWritten();
 }
 
+bool Peer::sendv(const struct iovec* blocks, size_t count)
+{
+    bool sentAny = false;
+    for (size_t i = 0; i < count; i++) {
+        if (blocks[i].iov_len == 0) continue;
+        if (!send(blocks[i].iov_base, blocks[i].iov_len)) {
+            if (!sentAny) return false;
+            throw_disconnect("Peer::sendv partial message sent");
+        }
+        sentAny = true;
+    }
+    return true;
+}
+
+size_t Peer::sendv_some(const struct iovec* blocks, size_t count)
+{
+    if (!sendv(blocks, count)) {
+        throw_disconnect("Peer::sendv_some");
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) 
+        total += blocks[i].iov_len;
+    return total;
+}
+
+size_t Peer::receive_some(void* buffer, size_t nMaxBytesToRead)
+{
+    size_t r = receive(buffer, nMaxBytesToRead);
+    if (r == 0) {
+        throw_disconnect("Peer::receive_some");
+    }
+    return r;
+}
+
 }
 }
@@ -23,7 +23,10 @@ public:
     size_t read(unsigned char* aBuf, size_t aLen); 
     size_t skip(size_t aLen);
     size_t bytesRead() const;  
+    size_t readPartial(unsigned char* aBuf, size_t aLen);
     size_t write(const unsigned char* aBuf, size_t aLen);
+    size_t writeBlocks(const struct iovec* aBlocks, size_t aCount);
+    size_t writeBlocksPartial(const struct iovec* aBlocks, size_t aCount);
     void flush();
     size_t bytesWritten() const;
 
@@ -53,10 +56,27 @@ public:
         }
     }
 
+    // send a sequence of blocks as one contiguous piece of data (blocking).
+    // Returns false if the remote endpoint stopped accepting data before
+    // anything was sent. The default implementation calls send() for each block
+    virtual bool sendv(const struct iovec* blocks, size_t count);
+
+    // send as much of a sequence of blocks as the transport will accept
+    // without blocking, and return the number of bytes sent (0 if it can't
+    // take any more right now). Throws if the remote endpoint has disconnected.
+    // The default implementation blocks until all the blocks are sent
+    virtual size_t sendv_some(const struct iovec* blocks, size_t count);
+
     // receive data from the remote endpoint (blocking); returns number of bytes read
     // by 'src' will contain the IPv4/IPv6 address/port source system information
     virtual size_t receive(void* buffer, size_t nMaxBytesToRead) = 0;
 
+    // receive whatever data is available without blocking, up to nMaxBytesToRead,
+    // and return the number of bytes read (0 if nothing is available right now).
+    // Throws if the remote endpoint has disconnected. The default
+    // implementation blocks until some data arrives
+    virtual size_t receive_some(void* buffer, size_t nMaxBytesToRead);
+
     // receive all the data and return true, receive no data and return false, or throw an exception
     virtual bool receive_all(void* buffer, size_t nBytesToRead, unsigned int aTimeoutMs = 0) = 0;
     // convenience function for requiring success
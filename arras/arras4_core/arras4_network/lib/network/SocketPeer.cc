@@ -4,6 +4,7 @@
 #include "platform.h"
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <netdb.h>
@@ -13,6 +14,7 @@
 #include <sys/types.h>
 
 #include <poll.h>
+#include <algorithm>
 #include <chrono>
 
 #include "SocketPeer.h"
@@ -21,10 +23,12 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 #include <sys/stat.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sstream>
+#include <vector>
 
 #include <linux/un.h>
 
@@ -72,6 +76,18 @@ send_ignore_interrupts(int sockfd, const void* buf, size_t len, int flags)
     return status;
 }
 
+ssize_t
+sendmsg_ignore_interrupts(int sockfd, const struct msghdr* msg, int flags)
+{
+    ssize_t status = 0;
+
+    do {
+        status = ::sendmsg(sockfd, msg, flags);
+    } while ((status < 0) && (errno == EINTR));
+
+    return status;
+}
+
 // this version of poll won't handle the timeout properly since the
 // call will be remade with the entire timeout properly. 0 (return immediately)
 // and -1 (no timeout) will work the same though.
@@ -353,6 +369,151 @@ SocketPeer::send(const void *data, size_t nBytes)
     return true;
 }
 
+// sends all the blocks with as few system calls as possible, so that
+// a message made of a header and several large buffers goes out in one
+// gathered write rather than one send() per buffer
+bool
+SocketPeer::sendv(const struct iovec* blocks, size_t count)
+{
+    if (mIsListening) {
+        throw InvalidParameterError("SocketPeer::sendv on an listening socket");
+    }
+
+    // encryption works on one contiguous block at a time
+    if (mEncryption != nullptr) {
+        return Peer::sendv(blocks, count);
+    }
+
+    // sendmsg may partially write the blocks, so work on a copy 
+    // that can be advanced past the data already sent
+    std::vector<struct iovec> iov;
+    iov.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (blocks[i].iov_len == 0) continue;
+        if (blocks[i].iov_base == nullptr) {
+            throw InvalidParameterError("SocketPeer::sendv invalid null data ptr");
+        }
+        iov.push_back(blocks[i]);
+    }
+
+    size_t first = 0;
+    size_t total = 0;
+    while (first < iov.size()) {
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov[first];
+        msg.msg_iovlen = std::min(iov.size() - first, static_cast<size_t>(IOV_MAX));
+
+        ssize_t status = sendmsg_ignore_interrupts(mSocket, &msg, MSG_NOSIGNAL);
+        if (status < 0) {
+            // save errno before doing anything else
+            int save_errno = getSocketError();
+
+            // throw an exception
+            std::string err("SocketPeer::sendv: ");
+            err += getErrorString(save_errno);
+            throw PeerException(save_errno, getCodeFromSocketError(save_errno), err);
+        }
+
+        // if the remote endpoint has stopped accepting data
+        // before anything has been sent then return false
+        // if a partial message is sent then throw an exception
+        if (status == 0) {
+            if (total == 0) {
+                return false;
+            } else {
+                throw_disconnect("SocketPeer::sendv partial message sent");
+            }
+        }
+
+        total += status;
+
+        // skip over the blocks that were completely sent, and
+        // adjust the first remaining block for a partial send
+        size_t sent = static_cast<size_t>(status);
+        while (first < iov.size() && sent >= iov[first].iov_len) {
+            sent -= iov[first].iov_len;
+            first++;
+        }
+        if (sent > 0) {
+            iov[first].iov_base = static_cast<uint8_t*>(iov[first].iov_base) + sent;
+            iov[first].iov_len -= sent;
+        }
+    }
+    mBytesWritten += total;
+    return true;
+}
+
+// non-blocking version of sendv() for event driven writers : sends what
+// the socket buffer can take right now, and returns the number of bytes sent.
+// The socket itself stays in blocking mode for the other functions
+size_t
+SocketPeer::sendv_some(const struct iovec* blocks, size_t count)
+{
+    if (mIsListening) {
+        throw InvalidParameterError("SocketPeer::sendv_some on an listening socket");
+    }
+
+    // encryption works on one contiguous block at a time
+    if (mEncryption != nullptr) {
+        return Peer::sendv_some(blocks, count);
+    }
+
+    std::vector<struct iovec> iov;
+    iov.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (blocks[i].iov_len == 0) continue;
+        if (blocks[i].iov_base == nullptr) {
+            throw InvalidParameterError("SocketPeer::sendv_some invalid null data ptr");
+        }
+        iov.push_back(blocks[i]);
+    }
+
+    size_t first = 0;
+    size_t total = 0;
+    while (first < iov.size()) {
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov[first];
+        msg.msg_iovlen = std::min(iov.size() - first, static_cast<size_t>(IOV_MAX));
+
+        ssize_t status = sendmsg_ignore_interrupts(mSocket, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (status < 0) {
+            // save errno before doing anything else
+            int save_errno = getSocketError();
+
+            // socket buffer is full : the rest has to wait
+            if ((save_errno == EWOULDBLOCK) || (save_errno == EAGAIN)) break;
+
+            // throw an exception
+            std::string err("SocketPeer::sendv_some: ");
+            err += getErrorString(save_errno);
+            throw PeerException(save_errno, getCodeFromSocketError(save_errno), err);
+        }
+        if (status == 0) {
+            throw_disconnect("SocketPeer::sendv_some");
+        }
+
+        total += status;
+
+        // skip over the blocks that were completely sent, and
+        // adjust the first remaining block for a partial send
+        size_t sent = static_cast<size_t>(status);
+        while (first < iov.size() && sent >= iov[first].iov_len) {
+            sent -= iov[first].iov_len;
+            first++;
+        }
+        if (sent > 0) {
+            iov[first].iov_base = static_cast<uint8_t*>(iov[first].iov_base) + sent;
+            iov[first].iov_len -= sent;
+        }
+    }
+    mBytesWritten += total;
+    return total;
+}
+
 size_t
 SocketPeer::receive(void *buffer, size_t nMaxBytesToRead)
 {
@@ -403,6 +564,47 @@ SocketPeer::receive(void *buffer, size_t nMaxBytesToRead)
     return rtn;
 }
 
+// non-blocking version of receive() for event driven readers : returns 0
+// when no data is available, rather than for a disconnect, which throws
+size_t
+SocketPeer::receive_some(void *buffer, size_t nMaxBytesToRead)
+{
+    if (nMaxBytesToRead == 0) {
+        throw InvalidParameterError("SocketPeer::receive_some invalid byte count of 0");
+    }
+    if (mIsListening) {
+        throw InvalidParameterError("SocketPeer::receive_some on an listening socket");
+    }
+    if (buffer == nullptr) {
+        throw InvalidParameterError("SocketPeer::receive_some invalid null data ptr");
+    }
+
+    // the encrypted stream can't be read partially
+    if (mEncryption) {
+        return Peer::receive_some(buffer, nMaxBytesToRead);
+    }
+
+    ssize_t rtn = recv_ignore_interrupts(mSocket, (char*)buffer, nMaxBytesToRead,
+                                         MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (rtn < 0) {
+        // save errno before doing anything else
+        int save_errno = getSocketError();
+
+        // nothing to read yet
+        if ((save_errno == EWOULDBLOCK) || (save_errno == EAGAIN)) return 0;
+
+        // throw an exception
+        std::string err("SocketPeer::receive_some: ");
+        err += getErrorString(save_errno);
+        throw PeerException(save_errno, getCodeFromSocketError(save_errno), err);
+    }
+    if (rtn == 0) {
+        throw_disconnect("SocketPeer::receive_some");
+    }
+    mBytesRead += rtn;
+    return rtn;
+}
+
 bool
 SocketPeer::receive_all(void* buffer, size_t nBytesToRead, unsigned int aTimeoutMs)
 {
@@ -51,7 +51,10 @@ public:
     void shutdown_send(); // this connection won't be sending me data
     void shutdown_receive(); // this connection will not accept more data
     bool send(const void* data, size_t nBytes);
+    bool sendv(const struct iovec* blocks, size_t count);
     size_t receive(void* buffer, size_t nMaxBytesToRead);
+    size_t sendv_some(const struct iovec* blocks, size_t count);
+    size_t receive_some(void* buffer, size_t nMaxBytesToRead);
     bool receive_all(void* buffer, size_t nBytesToRead, unsigned int aTimeoutMs = 0);
     size_t peek(void* buffer, size_t nMaxBytesToRead);
     bool poll(bool query_read, bool& read,
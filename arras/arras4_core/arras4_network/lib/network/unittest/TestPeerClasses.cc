@@ -4,6 +4,11 @@
 #include "TestPeerClasses.h"
 #include "TestTimer.h"
 
+#include <network/BasicFramingSink.h>
+#include <network/BasicFramingSource.h>
+#include <network/BufferedSink.h>
+#include <network/BufferedSource.h>
+#include <network/Frame.h>
 #include <network/Peer.h>
 #include <network/SocketPeer.h>
 #include <network/InetSocketPeer.h>
@@ -11,15 +16,18 @@
 #include <network/InvalidParameterError.h>
 
 #include <atomic>
+#include <climits>
 #include <fcntl.h>
 #include <limits>
 #include <signal.h>
 #include <string.h>
 #include <thread>
+#include <vector>
 
 #include <sys/resource.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #if defined(__ICC)
@@ -55,6 +63,7 @@ using arras4::network::InetSocketPeer;
 using arras4::network::SocketPeer;
 using arras4::network::InvalidParameterError;
 using arras4::network::PeerException;
+using arras4::network::PeerDisconnectException;
 using arras4::ARRAS_INVALID_SOCKET;
 
 bool serverDone = false;
@@ -910,6 +919,166 @@ void TestPeerClasses::testSocketPeerSend()
 }
 
 
+void TestPeerClasses::testSocketPeerSendv()
+{
+    int fds[2];
+    CPPUNIT_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    // keep the socket buffers small, so that sendmsg() has to
+    // return partial writes
+    int bufSize = 16 * 1024;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &bufSize, sizeof(bufSize));
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+
+    SocketPeer sender(fds[0]);
+    SocketPeer receiver(fds[1]);
+
+    //
+    // more than IOV_MAX blocks of varying (including zero) length,
+    // with one block much larger than the socket buffers in the middle.
+    // The blocks are laid out in reverse order in storage, so that
+    // resending or skipping part of a block can't go unnoticed
+    //
+    const size_t numBlocks = 2 * IOV_MAX + 7;
+    const size_t largeIndex = numBlocks / 2;
+    const size_t largeSize = 4 * 1024 * 1024;
+    std::vector<size_t> sizes(numBlocks);
+    size_t total = 0;
+    for (size_t i = 0; i < numBlocks; i++) {
+        sizes[i] = (i == largeIndex) ? largeSize : i % 13;
+        total += sizes[i];
+    }
+
+    std::vector<unsigned char> storage(total);
+    std::vector<unsigned char> expected;
+    expected.reserve(total);
+    std::vector<struct iovec> blocks(numBlocks);
+    size_t offset = total;
+    for (size_t i = 0; i < numBlocks; i++) {
+        offset -= sizes[i];
+        for (size_t j = 0; j < sizes[i]; j++) {
+            unsigned char c = static_cast<unsigned char>((i * 31 + j * 7) & 0xff);
+            storage[offset + j] = c;
+            expected.push_back(c);
+        }
+        blocks[i].iov_base = storage.data() + offset;
+        blocks[i].iov_len = sizes[i];
+    }
+
+    std::vector<unsigned char> received(total);
+    std::atomic<bool> receivedAll(false);
+    std::thread receiveThread([&]() {
+        try {
+            receivedAll = receiver.receive_all(received.data(), total, 20000);
+        } catch (PeerException&) {
+        }
+        // unblocks the sender if the receive failed
+        if (!receivedAll) receiver.shutdown();
+    });
+
+    bool sent = false;
+    try {
+        sent = sender.sendv(blocks.data(), numBlocks);
+    } catch (...) {
+        receiver.shutdown();
+        receiveThread.join();
+        throw;
+    }
+    receiveThread.join();
+
+    CPPUNIT_ASSERT(sent);
+    CPPUNIT_ASSERT(receivedAll);
+    CPPUNIT_ASSERT(sender.bytesWritten() == total);
+    CPPUNIT_ASSERT(received == expected);
+}
+
+void TestPeerClasses::testPartialFraming()
+{
+    using namespace arras4::network;
+
+    int fds[2];
+    CPPUNIT_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    // keep the socket buffers small, so that frames can't 
+    // be written in one go
+    int bufSize = 16 * 1024;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &bufSize, sizeof(bufSize));
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+
+    SocketPeer sender(fds[0]);
+    SocketPeer receiver(fds[1]);
+
+    BasicFramingSink framedSink(sender.sink());
+    BufferedSink bufferedSink(framedSink);
+    BasicFramingSource framedSource(receiver.source());
+    BufferedSource bufferedSource(framedSource);
+
+    // nothing has been sent yet
+    CPPUNIT_ASSERT(bufferedSource.nextFramePartial() == 0);
+
+    //
+    // frames much larger than the socket buffers. Writing and reading
+    // are interleaved on this one thread, so this would hang if
+    // either side waited on the socket
+    //
+    const size_t frameSize = 1024 * 1024 + 5;
+    std::vector<unsigned char> data(frameSize);
+    for (size_t i = 0; i < frameSize; i++) {
+        data[i] = static_cast<unsigned char>((i * 7) & 0xff);
+    }
+
+    for (unsigned frame = 0; frame < 3; frame++) {
+        bufferedSink.openFrame();
+        bufferedSink.write(data.data(), frameSize);
+        bool written = bufferedSink.closeFramePartial();
+        CPPUNIT_ASSERT(!written);
+
+        size_t received = 0;
+        unsigned turns = 0;
+        while (!written || (received == 0)) {
+            if (!written) written = bufferedSink.continueFramePartial();
+            if (received == 0) received = bufferedSource.nextFramePartial();
+            CPPUNIT_ASSERT(++turns < 1000000);
+        }
+        CPPUNIT_ASSERT(received == frameSize);
+
+        std::vector<unsigned char> out(frameSize);
+        bufferedSource.read(out.data(), frameSize);
+        bufferedSource.endFrame();
+        CPPUNIT_ASSERT(out == data);
+    }
+    CPPUNIT_ASSERT(sender.bytesWritten() == 3 * (frameSize + sizeof(Frame)));
+
+    //
+    // a sender that stalls part way through the frame header,
+    // and then in the frame data
+    //
+    Frame hdr;
+    hdr.mType = Frame::FRAME_BINARY;
+    hdr.mLength = 4;
+    const unsigned char* hdrBytes = reinterpret_cast<const unsigned char*>(&hdr);
+    CPPUNIT_ASSERT(sender.send(hdrBytes, sizeof(hdr) / 2));
+    CPPUNIT_ASSERT(bufferedSource.nextFramePartial() == 0);
+    CPPUNIT_ASSERT(sender.send(hdrBytes + sizeof(hdr) / 2, sizeof(hdr) - sizeof(hdr) / 2));
+    CPPUNIT_ASSERT(sender.send("ab", 2));
+    CPPUNIT_ASSERT(bufferedSource.nextFramePartial() == 0);
+    CPPUNIT_ASSERT(sender.send("cd", 2));
+    CPPUNIT_ASSERT(bufferedSource.nextFramePartial() == 4);
+    char out[4];
+    bufferedSource.read(reinterpret_cast<unsigned char*>(out), 4);
+    bufferedSource.endFrame();
+    CPPUNIT_ASSERT(memcmp(out, "abcd", 4) == 0);
+
+    // a disconnect is reported, rather than looking like
+    // data that hasn't arrived yet
+    sender.shutdown();
+    try {
+        bufferedSource.nextFramePartial();
+        CPPUNIT_ASSERT(false && "didn't get exception for disconnected sender");
+    } catch (PeerDisconnectException&) {
+    }
+}
+
 void TestPeerClasses::testSocketPeerConstructAndPoll()
 {
 
@@ -1812,6 +1981,10 @@ void TestPeerClasses::testPeerClasses()
     TRACE;
     testSocketPeerSend();
     TRACE;
+    testSocketPeerSendv();
+    TRACE;
+    testPartialFraming();
+    TRACE;
     testSocketPeerReceive();
     TRACE;
     testSocketPeerPeek();
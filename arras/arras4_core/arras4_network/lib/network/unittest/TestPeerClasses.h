@@ -15,6 +15,8 @@ public:
 
     void testSocketPeerConstructAndPoll();
     void testSocketPeerSend();
+    void testSocketPeerSendv();
+    void testPartialFraming();
     void testSocketPeerPeek();
     void testSocketPeerReceive();
     void testSocketPeerAccept();
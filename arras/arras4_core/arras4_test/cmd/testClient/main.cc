@@ -194,6 +194,7 @@ void parseCmdLine(int argc, char* argv[],
         ("minChunkingBytes",bpo::value<unsigned>(),"Minimum message size for chunking (bytes)")
         ("chunkSizeMb",bpo::value<unsigned>(),"Chunk size (megabytes)")
         ("chunkSizeBytes",bpo::value<unsigned>(),"Chunk size (bytes)")
+        ("chunkStreaming","Send large messages as streaming chunks")
         ("disconnectImmediately","Test that disconnects immediately after connecting")
         ("prepend", bpo::value<std::string>(), "Path to prepend to packages path")
         ("local-only", "Only run on a local node")
@@ -517,7 +518,10 @@ initChunking(arras4::sdk::SDK& sdk,
         chunkSize = cmdOpts["chunkSizeMb"].as<unsigned>() * 1024 * 1024ull;
     if (cmdOpts.count("chunkSizeBytes"))
         chunkSize += cmdOpts["chunkSizeBytes"].as<unsigned>();   
-    sdk.enableMessageChunking(minChunkingSize,chunkSize);
+    if (cmdOpts.count("chunkStreaming"))
+        sdk.enableStreamingMessageChunking(minChunkingSize,chunkSize);
+    else
+        sdk.enableMessageChunking(minChunkingSize,chunkSize);
 }
 
 int
@@ -261,6 +261,10 @@ getSessionDefinition(const std::string& sessionName,
     if (def.has("merge")) 
         def["merge"]["traceThreshold"] = traceLevel;
 
+    // let merge know that ClientReceiverFb can decode compressed image buffers
+    if (def.has("merge"))
+        mcrt_dataio::ClientReceiverFb::advertiseDecodeCapability(def["merge"]);
+
     //  local/no-local
     //     Allowing both local-only and no-local flags to co-exist to allow for
     //     coordinator testing
@@ -0,0 +1,249 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pthread_create_interposer.h"
+#include "EndpointIoLoop.h"
+
+#include <arras4_log/Logger.h>
+#include <arras4_log/LogEventStream.h>
+#include <exceptions/InternalError.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+// registration id of the wake eventfd. Endpoint ids start at 1
+constexpr uint64_t WAKE_ID = 0;
+
+// the endpoint whose callbacks are running on this thread, if any
+thread_local uint64_t tCurrentId = 0;
+
+}
+
+namespace arras4 {
+namespace node {
+
+EndpointIoLoop::EndpointIoLoop(unsigned aNumThreads) :
+    mEpollFd(-1),
+    mWakeFd(-1),
+    mNextId(WAKE_ID + 1)
+{
+    mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (mEpollFd < 0) {
+        throw impl::InternalError(std::string("EndpointIoLoop failed to create epoll instance: ") +
+                                  std::strerror(errno));
+    }
+    mWakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (mWakeFd < 0) {
+        ::close(mEpollFd);
+        throw impl::InternalError(std::string("EndpointIoLoop failed to create eventfd: ") +
+                                  std::strerror(errno));
+    }
+
+    // level triggered and never read : once signalled, every thread wakes up
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_ID;
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeFd, &ev);
+
+    set_thread_stacksize(KB_256);
+    for (unsigned i = 0; i < aNumThreads; i++) {
+        mThreads.emplace_back(&EndpointIoLoop::threadProc, this);
+    }
+    set_thread_stacksize(0);
+}
+
+EndpointIoLoop::~EndpointIoLoop()
+{
+    uint64_t one = 1;
+    if (::write(mWakeFd, &one, sizeof(one)) != sizeof(one)) {
+        ARRAS_ERROR(log::Id("ioLoopWakeFailed") <<
+                    "EndpointIoLoop failed to wake i/o threads: " << std::string(std::strerror(errno)));
+    }
+
+    for (std::thread& t : mThreads) {
+        if (t.joinable()) t.join();
+    }
+
+    ::close(mWakeFd);
+    ::close(mEpollFd);
+}
+
+uint64_t
+EndpointIoLoop::add(Handler* aHandler, int aFd, bool aWatchRead)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    uint64_t id = mNextId++;
+    Entry& entry = mEntries[id];
+    entry = Entry{aHandler, aFd, aWatchRead, false, false, false, 0};
+
+    // the socket is registered even if it isn't watched yet,
+    // so that arm() can always use EPOLL_CTL_MOD
+    struct epoll_event ev;
+    ev.events = (aWatchRead ? EPOLLIN : 0) | EPOLLONESHOT;
+    ev.data.u64 = id;
+    if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, aFd, &ev) < 0) {
+        mEntries.erase(id);
+        throw impl::InternalError(std::string("EndpointIoLoop failed to watch endpoint socket: ") +
+                                  std::strerror(errno));
+    }
+    return id;
+}
+
+void
+EndpointIoLoop::remove(uint64_t aId)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto it = mEntries.find(aId);
+    if (it == mEntries.end()) return;
+
+    if (!it->second.mRemoved) {
+        it->second.mRemoved = true;
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, it->second.mFd, nullptr);
+    }
+
+    // a callback of this endpoint may be the caller itself : then
+    // release() erases the entry when the callback returns
+    if (tCurrentId == aId) return;
+
+    while (it->second.mBusy) {
+        mIdleCondition.wait(lock);
+        it = mEntries.find(aId);
+        if (it == mEntries.end()) return;
+    }
+    mEntries.erase(it);
+}
+
+void
+EndpointIoLoop::scheduleWrite(uint64_t aId)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mEntries.find(aId);
+    if (it == mEntries.end() || it->second.mRemoved) return;
+
+    Entry& entry = it->second;
+    entry.mWantWrite = true;
+    if (entry.mBusy) {
+        // the thread servicing the endpoint calls onWritable()
+        // before it re-arms the socket
+        entry.mPendingEvents |= EPOLLOUT;
+    } else {
+        arm(aId, entry);
+    }
+}
+
+// static
+EndpointIoLoop::Dispatch
+EndpointIoLoop::dispatchFor(const Entry& aEntry, uint32_t aEvents)
+{
+    // hangups and errors are reported by whichever callback
+    // next tries to use the socket
+    Dispatch dispatch;
+    dispatch.mRead = aEntry.mWatchRead && (aEvents & (EPOLLIN | EPOLLHUP | EPOLLERR));
+    dispatch.mWrite = (aEvents & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0;
+    return dispatch;
+}
+
+void
+EndpointIoLoop::arm(uint64_t aId, const Entry& aEntry)
+{
+    uint32_t events = (aEntry.mWatchRead ? EPOLLIN : 0) | (aEntry.mWantWrite ? EPOLLOUT : 0);
+    if (events == 0) return; // left disarmed until the next scheduleWrite()
+
+    struct epoll_event ev;
+    ev.events = events | EPOLLONESHOT;
+    ev.data.u64 = aId;
+    if (::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, aEntry.mFd, &ev) < 0) {
+        ARRAS_ERROR(log::Id("ioLoopArmFailed") <<
+                    "EndpointIoLoop failed to re-arm endpoint socket: " << std::string(std::strerror(errno)));
+    }
+}
+
+EndpointIoLoop::Handler*
+EndpointIoLoop::acquire(uint64_t aId, uint32_t aEvents, Dispatch& aDispatch)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mEntries.find(aId);
+    if (it == mEntries.end() || it->second.mRemoved) return nullptr;
+
+    Entry& entry = it->second;
+    if (entry.mBusy) {
+        // scheduleWrite() re-armed the socket before this event was
+        // taken : leave it to the thread that is servicing the endpoint
+        entry.mPendingEvents |= aEvents;
+        return nullptr;
+    }
+    entry.mBusy = true;
+    tCurrentId = aId;
+    aDispatch = dispatchFor(entry, aEvents);
+    return entry.mHandler;
+}
+
+bool
+EndpointIoLoop::release(uint64_t aId, Dispatch& aDispatch)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mEntries.find(aId);
+        if (it == mEntries.end()) return false; // can't happen : busy entries aren't erased
+
+        Entry& entry = it->second;
+        if (aDispatch.mRead && !aDispatch.mWatchRead) entry.mWatchRead = false;
+        if (aDispatch.mWrite) entry.mWantWrite = aDispatch.mWantWrite;
+
+        if (!entry.mRemoved && entry.mPendingEvents) {
+            aDispatch = dispatchFor(entry, entry.mPendingEvents);
+            entry.mPendingEvents = 0;
+            return true;
+        }
+
+        entry.mBusy = false;
+        tCurrentId = 0;
+        if (entry.mRemoved) {
+            // remove() was called from inside a callback, or is waiting
+            mEntries.erase(it);
+        } else {
+            arm(aId, entry);
+        }
+    }
+    mIdleCondition.notify_all();
+    return false;
+}
+
+void
+EndpointIoLoop::threadProc()
+{
+    log::Logger::instance().setThreadName("EP ioThread");
+
+    while (1) {
+        // take a single event at a time, so that ready endpoints
+        // are spread over all the threads
+        struct epoll_event ev;
+        int r = ::epoll_wait(mEpollFd, &ev, 1, -1);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            ARRAS_ERROR(log::Id("ioLoopWaitFailed") <<
+                        "EndpointIoLoop epoll_wait failed: " << std::string(std::strerror(errno)));
+            return;
+        }
+        if (r == 0) continue;
+        if (ev.data.u64 == WAKE_ID) return; // shutdown
+
+        uint64_t id = ev.data.u64;
+        Dispatch dispatch;
+        Handler* handler = acquire(id, ev.events, dispatch);
+        if (handler == nullptr) continue;
+
+        do {
+            if (dispatch.mRead) dispatch.mWatchRead = handler->onReadable();
+            if (dispatch.mWrite) dispatch.mWantWrite = handler->onWritable();
+        } while (release(id, dispatch));
+    }
+}
+
+} // end namespace node
+} // end namespace arras4
@@ -0,0 +1,117 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __ARRAS_ENDPOINTIOLOOP_H__
+#define __ARRAS_ENDPOINTIOLOOP_H__
+
+// EndpointIoLoop multiplexes the socket i/o of many endpoints onto
+// a small fixed pool of threads, rather than giving every endpoint
+// its own blocking receive and send threads.
+//
+// All the threads wait on one epoll instance. Sockets are registered
+// in EPOLLONESHOT mode, so at most one thread services an endpoint at a
+// time, and are re-armed once its Handler callback returns. The handlers
+// must never wait on their socket : they read and write with the
+// non-blocking framing functions (e.g. PeerMessageEndpoint::getEnvelopePartial()
+// and putEnvelopePartial()), so a peer that stalls in the middle of a
+// message, or stops reading, only holds up its own endpoint.
+//
+// Endpoints are referred to by a registration id rather than by pointer,
+// so that a stale event for a removed endpoint can never reach a new
+// endpoint allocated at the same address. remove() waits for any callback
+// in progress on the endpoint, after which the endpoint can safely be deleted.
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace arras4 {
+namespace node {
+
+class EndpointIoLoop {
+
+  public:
+    class Handler {
+      public:
+        virtual ~Handler() {}
+
+        // the socket has incoming data : read what has arrived, without
+        // waiting for more. Return false to stop watching the socket
+        // for input (e.g. because the peer disconnected)
+        virtual bool onReadable() = 0;
+
+        // the socket can take more data, or a write was requested with
+        // scheduleWrite() : write what is pending, without waiting.
+        // Return true if there is still data waiting to be written,
+        // so that onWritable() is called again when the socket has room
+        virtual bool onWritable() = 0;
+    };
+
+    explicit EndpointIoLoop(unsigned aNumThreads);
+    ~EndpointIoLoop();
+
+    // register the socket aFd of an endpoint and return its registration id.
+    // if aWatchRead is true, aHandler->onReadable() is called whenever
+    // the socket has incoming data
+    uint64_t add(Handler* aHandler, int aFd, bool aWatchRead);
+
+    // unregister an endpoint, waiting for any callback in progress on
+    // another thread to complete. Can be called from inside the
+    // endpoint's own callback.
+    void remove(uint64_t aId);
+
+    // request a call of onWritable(), e.g. because data has
+    // been queued for sending
+    void scheduleWrite(uint64_t aId);
+
+  private:
+    struct Entry {
+        Handler* mHandler;
+        int mFd;
+        bool mWatchRead;
+        bool mWantWrite;
+        bool mRemoved;
+        bool mBusy; // a thread is running the handler's callbacks
+        uint32_t mPendingEvents; // events that arrived while busy
+    };
+
+    // the callbacks to run for a set of events, and their results
+    struct Dispatch {
+        bool mRead = false;      // call onReadable()
+        bool mWrite = false;     // call onWritable()
+        bool mWatchRead = true;  // onReadable() result
+        bool mWantWrite = false; // onWritable() result
+    };
+    static Dispatch dispatchFor(const Entry& aEntry, uint32_t aEvents);
+
+    // acquire() returns nullptr if the endpoint has been removed or
+    // another thread is already servicing it, otherwise the endpoint
+    // is marked busy until release() returns false
+    Handler* acquire(uint64_t aId, uint32_t aEvents, Dispatch& aDispatch);
+    // release() records the results of the callbacks. If more events
+    // arrived while they were running, it returns true with the next
+    // callbacks to run in aDispatch, and the endpoint stays busy
+    bool release(uint64_t aId, Dispatch& aDispatch);
+    // re-enable the epoll registration of an idle entry
+    void arm(uint64_t aId, const Entry& aEntry);
+
+    void threadProc();
+
+    int mEpollFd;
+    int mWakeFd; // eventfd, signalled to stop the threads
+
+    std::mutex mMutex;
+    std::condition_variable mIdleCondition; // an entry stopped being busy
+    std::unordered_map<uint64_t, Entry> mEntries;
+    uint64_t mNextId;
+
+    std::vector<std::thread> mThreads;
+};
+
+} // end namespace node
+} // end namespace arras4
+
+#endif // __ARRAS_ENDPOINTIOLOOP_H__
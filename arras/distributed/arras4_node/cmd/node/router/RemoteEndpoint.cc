@@ -74,6 +74,52 @@ RemoteEndpoint::disconnect()
     flagForDestruction();
 }
 
+bool
+RemoteEndpoint::trySend(const std::function<void()>& aSend)
+{
+    try {
+        aSend();
+        return true;
+    }
+
+    catch (const PeerDisconnectException&){
+        ARRAS_WARN(log::Id("warnDisconnect") << 
+                            log::Session(mSessionId.toString()) <<
+                            describe() << "disconnected from node during message send");
+    } 
+
+    catch (const PeerException& e) {
+        PeerException::Code code = e.code(); 
+        if (code == PeerException::CONNECTION_RESET) {
+            ARRAS_WARN(log::Id("warnConnectionReset") << 
+                       log::Session(mSessionId.toString()) <<
+                       "The connection to " << describe() << " was reset during message send");
+        } else if (code == PeerException::CONNECTION_CLOSED) {
+            ARRAS_WARN(log::Id("warnConnectionClosed") << 
+                       log::Session(mSessionId.toString()) <<
+                       "The connection to " << describe() << " was closed during message send");
+        } else {
+            ARRAS_ERROR(log::Id("peerExceptionSend") << 
+                        log::Session(mSessionId.toString()) <<
+                        "PeerException (code " << (int) code << ") sending message to " <<
+                        describe() << std::string(e.what()));
+        }
+    } 
+
+    catch (const std::exception& e) {
+        ARRAS_ERROR(log::Id("sendException") << 
+                    log::Session(mSessionId.toString()) <<
+                    "Exception during message send: " << std::string(e.what()));
+    }
+        
+    catch (...) {
+        ARRAS_WARN(log::Id("warnSendException") << 
+                   log::Session(mSessionId.toString()) <<
+                   "Unknown exception caught while sending message");
+    }
+    return false;
+}
+
 // sendThread() simply gets messages off of the queue and sends them. We
 // already know that the message needs to go out on the socket associated
 // with this RemoveEndpoint.
@@ -86,66 +132,54 @@ RemoteEndpoint::sendThread()
 
     while (1) {
         impl::Envelope envelope;        
-        bool shouldDisconnect = false;
         try {  
             mMessageQueue->pop(envelope);
-            if (mShutdown) return;
-            sendEnvelope(envelope);
-        } 
-
-        catch (const impl::ShutdownException &) {
+        } catch (const impl::ShutdownException &) {
             // RemoteEndpoint destructor shuts down the message queue, causing this thread to exit
             ARRAS_DEBUG(log::Session(mSessionId.toString()) <<
                        "[RemoteEndpoint::sendThread] send queue was shutdown, terminating send thread");
             return;
         } 
+        if (mShutdown) return;
 
-        catch (const PeerDisconnectException&){
-            ARRAS_WARN(log::Id("warnDisconnect") << 
-                                log::Session(mSessionId.toString()) <<
-                                describe() << "disconnected from node during message send");
-            shouldDisconnect = true;
-        } 
+        if (!trySend([&]() { sendEnvelope(envelope); })) {
+            disconnect();
+            return; // exit thread
+        }
+    }
+}
 
-        catch (const PeerException& e) {
-            PeerException::Code code = e.code(); 
-            if (code == PeerException::CONNECTION_RESET) {
-                ARRAS_WARN(log::Id("warnConnectionReset") << 
-                           log::Session(mSessionId.toString()) <<
-                           "The connection to " << describe() << " was reset during message send");
-            } else if (code == PeerException::CONNECTION_CLOSED) {
-                ARRAS_WARN(log::Id("warnConnectionClosed") << 
-                           log::Session(mSessionId.toString()) <<
-                           "The connection to " << describe() << " was closed during message send");
-            } else {
-                ARRAS_ERROR(log::Id("peerExceptionSend") << 
-                            log::Session(mSessionId.toString()) <<
-                            "PeerException (code " << (int) code << ") sending message to " <<
-                            describe() << std::string(e.what()));
-            }
-            shouldDisconnect = true;
-        } 
+// maximum number of messages received or sent by one
+// EndpointIoLoop callback
+constexpr unsigned MAX_MESSAGES_PER_TURN = 16;
 
-        catch (const std::exception& e) {
-            ARRAS_ERROR(log::Id("sendException") << 
-                        log::Session(mSessionId.toString()) <<
-                        "Exception during message send: " << std::string(e.what()));
-        
-            shouldDisconnect = true;
-        }
-        
-        catch (...) {
-            ARRAS_WARN(log::Id("warnSendException") << 
-                       log::Session(mSessionId.toString()) <<
-                       "Unknown exception caught while sending message");
-            shouldDisconnect = true;
-        }
+bool
+RemoteEndpoint::onWritable()
+{
+    if (mShutdown || mFlaggedForDestruction) return false;
 
-        if (shouldDisconnect) {
+    for (unsigned sent = 0; sent < MAX_MESSAGES_PER_TURN; sent++) {
+        bool ok;
+        if (mSendInProgress) {
+            ok = trySend([&]() { mSendInProgress = !mMessageEndpoint->continuePutEnvelope(); });
+        } else {
+            impl::Envelope envelope;
+            try {
+                if (!mMessageQueue->tryPop(envelope)) return false; // nothing left to send
+            } catch (const impl::ShutdownException &) {
+                return false; // the endpoint is being destroyed
+            }
+            ok = trySend([&]() { mSendInProgress = !mMessageEndpoint->putEnvelopePartial(envelope); });
+        }
+        if (!ok) {
             disconnect();
-            return; // exit thread
+            return false;
         }
+        // the socket is full : carry on when it has room
+        if (mSendInProgress) return true;
     }
+    // give the other endpoints a turn
+    return true;
 }
 
 void
@@ -203,13 +237,17 @@ RemoteEndpoint::sendThreadWithConnect()
 // timeout in milliseconds of reads
 const int ENDPOINT_POLL_TIMEOUT = 1000;
 
-int
-RemoteEndpoint::onEndpointActivity()
+bool
+RemoteEndpoint::onEndpointActivity(bool aWait)
 {
     // anything we do here that is on a disconnected or otherwise invalid endpoint, will
     // cause an exception to be raised, so let that bubble up the stack to be handled by
     // callers
-    receiveEnvelope();
+    if (aWait) {
+        receiveEnvelope();
+    } else if (!receiveEnvelopePartial()) {
+        return false;
+    }
 
     if (mPeerType == PeerManager::PEER_SERVICE) {
         mThreadedNodeRouter.pushServiceToRouterQueue(mLastEnvelope);
@@ -259,14 +297,55 @@ RemoteEndpoint::onEndpointActivity()
     }
 
     disposeEnvelope();
-    return 0;
+    return true;
+}
+
+bool
+RemoteEndpoint::tryReceive(const std::function<void()>& aReceive)
+{
+    // disconnect, reset and close can all happen during a
+    // node shutdown, so they are not logged as errors
+    std::string sessionIdStr = mSessionId.toString();
+    try {
+        aReceive();
+        return true;
+    } catch (const PeerDisconnectException&){
+        ARRAS_WARN(log::Id("warnDisconnected") <<
+                   log::Session(sessionIdStr) <<
+                   describe() << " disconnected from node");
+    } catch (const PeerException& e) {
+        PeerException::Code code = e.code();
+        if (code == PeerException::CONNECTION_RESET) {
+            ARRAS_WARN(log::Id("warnConnectionReset") <<
+                       log::Session(sessionIdStr) <<
+                       "The connection to " << describe() << " was reset");
+        } else if (code == PeerException::CONNECTION_CLOSED) {
+            ARRAS_WARN(log::Id("warnConnectionClosed") <<
+                       log::Session(sessionIdStr) <<
+                       "The connection to " << describe() << " was closed");
+        } else {
+            ARRAS_ERROR(log::Id("peerExceptionReceive") <<
+                        log::Session(sessionIdStr) <<
+                        "PeerException (code " << (int)code << "while receiving message from " <<
+                        describe() << ": "  << std::string(e.what()));
+        }
+    } catch (const std::exception& e) {
+        ARRAS_ERROR(log::Id("receiveException") <<
+                    log::Session(sessionIdStr) <<
+                    "Exception while receiving message from " <<
+                    describe() << ": "  << std::string(e.what()));
+    } catch (...) {
+        ARRAS_ERROR(log::Id("receiveException") <<
+                    log::Session(sessionIdStr) <<
+                    "Unknown exception while receiving message from " << describe());
+    }
+    return false;
 }
 
 void
 RemoteEndpoint::receiveThread()
 { 
     // set a thread specific prefix for log messages from this thread
-    std::string sessionIdStr = mSessionId.toString();
     std::string threadName = PeerManager::peerTypeName(mPeerType) + " EP receiveThread";
     log::Logger::instance().setThreadName(threadName);
 
@@ -295,47 +374,7 @@ RemoteEndpoint::receiveThread()
         if (mShutdown) return;
 
         if (r == 1) {
-            bool shouldDisconnect = false;
-            // disconnect, reset and close can all happen during a
-            // node shutdown, so they are not logged as errors
-            try {
-                onEndpointActivity();
-            } catch (const PeerDisconnectException&){
-                ARRAS_WARN(log::Id("warnDisconnected") <<
-                           log::Session(sessionIdStr) <<
-                           describe() << " disconnected from node");
-                shouldDisconnect = true;
-            } catch (const PeerException& e) {
-                PeerException::Code code = e.code();
-                if (code == PeerException::CONNECTION_RESET) {
-                    ARRAS_WARN(log::Id("warnConnectionReset") <<
-                               log::Session(sessionIdStr) <<
-                               "The connection to " << describe() << " was reset");
-                } else if (code == PeerException::CONNECTION_CLOSED) {
-                    ARRAS_WARN(log::Id("warnConnectionClosed") <<
-                               log::Session(sessionIdStr) <<
-                               "The connection to " << describe() << " was closed");
-                } else {
-                    ARRAS_ERROR(log::Id("peerExceptionReceive") <<
-                                log::Session(sessionIdStr) <<
-                                "PeerException (code " << (int)code << "while receiving message from " <<
-                                describe() << ": "  << std::string(e.what()));
-                }
-                shouldDisconnect = true;
-            } catch (const std::exception& e) {
-                ARRAS_ERROR(log::Id("receiveException") <<
-                            log::Session(sessionIdStr) <<
-                            "Exception while receiving message from " <<
-                            describe() << ": "  << std::string(e.what()));
-                shouldDisconnect = true;
-            } catch (...) {
-                ARRAS_ERROR(log::Id("receiveException") <<
-                            log::Session(sessionIdStr) <<
-                            "Unknown exception while receiving message from " << describe());
-                shouldDisconnect = true;
-            }
-
-            if (shouldDisconnect) {
+            if (!tryReceive([&]() { onEndpointActivity(true); })) {
                 disconnect();
                 return; // exit thread
             }
@@ -343,6 +382,24 @@ RemoteEndpoint::receiveThread()
    }
 }
 
+bool
+RemoteEndpoint::onReadable()
+{
+    if (mShutdown || mFlaggedForDestruction) return false;
+
+    for (unsigned received = 0; received < MAX_MESSAGES_PER_TURN; received++) {
+        bool handled = false;
+        if (!tryReceive([&]() { handled = onEndpointActivity(false); })) {
+            disconnect();
+            return false;
+        }
+        // the rest of the message hasn't arrived yet
+        if (!handled) return true;
+    }
+    // give the other endpoints a turn
+    return true;
+}
+
 RemoteEndpoint::RemoteEndpoint(
     Peer* aPeer,
     const PeerManager::PeerType aType,
@@ -381,13 +438,22 @@ RemoteEndpoint::RemoteEndpoint(
     
     std::string queueName = PeerManager::peerTypeName(mPeerType) + " Endpoint["+mUUID.toString() +"]";
     mMessageQueue = std::unique_ptr<impl::MessageQueue>(new impl::MessageQueue(queueName));
-    set_thread_stacksize(KB_256);
     // mRoutingData will never be used for PEER_NODE connections
-    if (mRoutingData || (aType == PeerManager::PEER_NODE) || (aType == PeerManager::PEER_SERVICE)) {
-        mReceiveThread = std::thread(&RemoteEndpoint::receiveThread, this);
+    bool receive = mRoutingData || (aType == PeerManager::PEER_NODE) || (aType == PeerManager::PEER_SERVICE);
+
+    if (aType == PeerManager::PEER_NODE) {
+        // node connections are few, and can have their peer replaced
+        // during connection negotiation (see setPeer()), so they keep
+        // their own threads
+        set_thread_stacksize(KB_256);
+        if (receive) {
+            mReceiveThread = std::thread(&RemoteEndpoint::receiveThread, this);
+        }
+        mSendThread = std::thread(&RemoteEndpoint::sendThread, this);
+        set_thread_stacksize(0);
+    } else {
+        mIoLoopId = mThreadedNodeRouter.ioLoop().add(this, fd(), receive);
     }
-    mSendThread = std::thread(&RemoteEndpoint::sendThread, this);
-    set_thread_stacksize(0);
 }
 
 RemoteEndpoint::RemoteEndpoint(
@@ -445,6 +511,9 @@ RemoteEndpoint::~RemoteEndpoint()
     if (mPeer != nullptr) mPeer->threadSafeShutdown();
     mMessageQueue->shutdown();
 
+    // wait for any i/o loop callback in progress to finish
+    if (mIoLoopId) mThreadedNodeRouter.ioLoop().remove(mIoLoopId);
+
     if (mSendThread.joinable()) mSendThread.join();
     if (mReceiveThread.joinable()) mReceiveThread.join();
 
@@ -457,7 +526,21 @@ RemoteEndpoint::receiveEnvelope()
 {
     // message is read as OpaqueContent to avoid deserialization cost
     mLastEnvelope = mMessageEndpoint->getEnvelope();
+    prepareReceivedEnvelope();
+}
+
+bool
+RemoteEndpoint::receiveEnvelopePartial()
+{
+    mLastEnvelope = mMessageEndpoint->getEnvelopePartial();
+    if (mLastEnvelope.isEmpty()) return false;
+    prepareReceivedEnvelope();
+    return true;
+}
 
+void
+RemoteEndpoint::prepareReceivedEnvelope()
+{
     // these three message types are handled directly by RemoteEndpoint,
     // and must always be fully deserialized (see onEndpointActivity)
     if ((mLastEnvelope.classId() == impl::ControlMessage::ID) || 
@@ -488,7 +571,9 @@ RemoteEndpoint::queueEnvelope(const Envelope& anEnvelope)
         // if queue has been shutdown, if means this RemoteEndpoint
         // is closing : simply fail to deliver the message
         ARRAS_DEBUG("Message undelivered due to endpoint shutdown: " << anEnvelope.describe());
+        return;
     }
+    if (mIoLoopId) mThreadedNodeRouter.ioLoop().scheduleWrite(mIoLoopId);
 }
 
 void
@@ -521,6 +606,9 @@ RemoteEndpoint::drain(const std::chrono::milliseconds& timeout)
 void
 RemoteEndpoint::close()
 {
+    // stop watching the socket before it is closed,
+    // since its file descriptor can then be reused
+    if (mIoLoopId) mThreadedNodeRouter.ioLoop().remove(mIoLoopId);
     mPeer->shutdown();
 }
 
@@ -4,6 +4,7 @@
 #ifndef __ARRAS_REMOTEENDPOINT_H__
 #define __ARRAS_REMOTEENDPOINT_H__
 
+#include "EndpointIoLoop.h"
 #include "PeerManager.h"
 #include "ThreadedNodeRouter.h"
 
@@ -16,6 +17,7 @@
 #include <shared_impl/MessageQueue.h>
 #include <core_messages/ExecutorHeartbeat.h>
 
+#include <functional>
 #include <mutex>
 #include <thread>
 
@@ -32,7 +34,10 @@ namespace arras4 {
 
         class SessionRoutingData;
 
-        class RemoteEndpoint
+        // Computation, client and service endpoints are serviced by the
+        // shared EndpointIoLoop owned by ThreadedNodeRouter, using non-blocking
+        // message framing. Node endpoints have their own receive and send threads.
+        class RemoteEndpoint : public EndpointIoLoop::Handler
         {
         public:
             
@@ -95,6 +100,12 @@ namespace arras4 {
 
             const api::UUID& sessionId() { return mSessionId; }
 
+            // EndpointIoLoop::Handler callbacks. Each call receives or sends
+            // a limited number of messages, so that a busy endpoint can't
+            // hold up the other endpoints sharing the loop
+            bool onReadable();
+            bool onWritable();
+
             // string description of the peer : e.g. "Computation(xxx)" or "Node(yyy)"
             std::string describe() const;
 
@@ -136,6 +147,13 @@ namespace arras4 {
             const PeerManager::PeerType mPeerType;
             const api::UUID mUUID;
 
+            // registration id in ThreadedNodeRouter's EndpointIoLoop,
+            // 0 if the endpoint uses its own receive and send threads
+            uint64_t mIoLoopId = 0;
+            // true while a message has only been partly sent 
+            // (only accessed by EndpointIoLoop callbacks)
+            bool mSendInProgress = false;
+
             // the send and receive threads can decide the RemoteEndpoint needs to
             // be destroyed while the main thread could be trying to destroy it based
             // on a kick. To prevent collisions on the destruction they get queued for
@@ -149,9 +167,22 @@ namespace arras4 {
             std::atomic<bool> mShutdown; 
             std::atomic<bool> mFlaggedForDestruction; 
           
-            int onEndpointActivity();
+            // receive and handle a message. If aWait is false, returns false
+            // without waiting if a whole message hasn't arrived yet
+            bool onEndpointActivity(bool aWait);
             void receiveThread();
             void sendThread();
+
+            // non-blocking receiveEnvelope() : returns false if a whole
+            // message hasn't arrived yet
+            bool receiveEnvelopePartial();
+            // processing of a message just received, for both of the above
+            void prepareReceivedEnvelope();
+
+            // run a receive or send operation, logging any exception it throws.
+            // Returns false if the endpoint should be disconnected
+            bool tryReceive(const std::function<void()>& aReceive);
+            bool trySend(const std::function<void()>& aSend);
             void sendThreadWithConnect();
 
             // queue this object for destruction
@@ -11,10 +11,19 @@
 
 using namespace arras4::api;
 
+namespace {
+
+// number of threads servicing the sockets of all the RemoteEndpoints.
+// They never wait on a socket, so a few are enough for any number of endpoints
+constexpr unsigned IO_LOOP_THREADS = 4;
+
+}
+
 namespace arras4 {
 namespace node {
 
 ThreadedNodeRouter::ThreadedNodeRouter(const UUID& aNodeId) :
+    mIoLoop(IO_LOOP_THREADS),
     mNodeId(aNodeId),
     mServiceEndpoint(nullptr),
     mServiceToRouterQueue(new impl::MessageQueue()),
@@ -7,6 +7,7 @@
 // this is NodeRouter state which will be used by multiple threads
 // at the same time
 
+#include "EndpointIoLoop.h"
 #include "PeerManager.h"
 #include "RoutingTable.h"
 #include "SessionRoutingData.h"
@@ -124,7 +125,16 @@ class ThreadedNodeRouter {
     void serviceDisconnected();
     void waitForServiceDisconnected();
 
+    // i/o threads shared by the RemoteEndpoints (thread safe)
+    EndpointIoLoop& ioLoop() {
+        return mIoLoop;
+    }
+
   private:
+    // declared first so that it is destroyed after all
+    // the RemoteEndpoints held by mPeerManager
+    EndpointIoLoop mIoLoop;
+
     RoutingTable mRoutingTable;
     PeerManager mPeerManager;
     const api::UUID mNodeId;
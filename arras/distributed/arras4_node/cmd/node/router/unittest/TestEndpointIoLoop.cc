@@ -0,0 +1,309 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TestEndpointIoLoop.h"
+
+#include <node/router/EndpointIoLoop.h>
+
+#include <message_impl/Envelope.h>
+#include <message_impl/MessageWriter.h>
+#include <message_impl/OpaqueContent.h>
+#include <message_impl/PeerMessageEndpoint.h>
+#include <network/BasicFramingSink.h>
+#include <network/Buffer.h>
+#include <network/BufferedSink.h>
+#include <network/SocketPeer.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestEndpointIoLoop);
+
+using namespace arras4;
+using arras4::node::EndpointIoLoop;
+
+namespace {
+
+const std::chrono::seconds TIMEOUT(20);
+
+// message with aSize bytes of opaque content, all set to aFill
+impl::Envelope makeMessage(size_t aSize, unsigned char aFill)
+{
+    std::vector<unsigned char> data(aSize, aFill);
+    network::BufferPtr buf(new network::Buffer(aSize));
+    buf->write(data.data(), aSize);
+    return impl::Envelope(new impl::OpaqueContent(api::ClassID(), 0, buf));
+}
+
+// true if the message has aSize bytes of content, all set to aFill
+bool checkMessage(const impl::Envelope& aEnvelope, size_t aSize, unsigned char aFill)
+{
+    impl::OpaqueContent::ConstPtr content = aEnvelope.contentAs<impl::OpaqueContent>();
+    if (!content || content->dataBuffer()->remaining() != aSize) return false;
+    const unsigned char* data = content->dataBuffer()->start();
+    for (size_t i = 0; i < aSize; i++) {
+        if (data[i] != aFill) return false;
+    }
+    return true;
+}
+
+// sink capturing the bytes of framed messages, so that they
+// can be sent out piecemeal by a misbehaving peer
+class CaptureSink : public network::DataSink
+{
+public:
+    size_t write(const unsigned char* aBuf, size_t aLen) {
+        mData.insert(mData.end(), aBuf, aBuf + aLen);
+        return aLen;
+    }
+    void flush() {}
+    size_t bytesWritten() const { return mData.size(); }
+
+    std::vector<unsigned char> mData;
+};
+
+// endpoint serviced by EndpointIoLoop, which sends and receives
+// messages on one end of a socket pair in the same way as RemoteEndpoint
+class LoopEndpoint : public EndpointIoLoop::Handler
+{
+public:
+    LoopEndpoint(EndpointIoLoop& aLoop, int aFd) :
+        mLoop(aLoop),
+        mPeer(aFd),
+        mEndpoint(mPeer, false, "test")
+    {
+        mId = mLoop.add(this, aFd, true);
+    }
+
+    ~LoopEndpoint()
+    {
+        mLoop.remove(mId);
+    }
+
+    void send(const impl::Envelope& aEnvelope)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mOutgoing.push_back(aEnvelope);
+        }
+        mLoop.scheduleWrite(mId);
+    }
+
+    // wait until aCount messages have been received
+    bool waitForReceived(size_t aCount)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mCondition.wait_for(lock, TIMEOUT, [&]() { return mReceived.size() >= aCount; });
+    }
+
+    bool waitForDisconnect()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mCondition.wait_for(lock, TIMEOUT, [&]() { return mDisconnected; });
+    }
+
+    std::vector<impl::Envelope> received()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mReceived;
+    }
+
+    unsigned readableCalls() const { return mReadableCalls; }
+
+    bool onReadable()
+    {
+        mReadableCalls++;
+        try {
+            while (1) {
+                impl::Envelope env = mEndpoint.getEnvelopePartial();
+                if (env.isEmpty()) return true;
+                std::lock_guard<std::mutex> lock(mMutex);
+                mReceived.push_back(env);
+                mCondition.notify_all();
+            }
+        } catch (const std::exception&) {
+            setDisconnected();
+            return false;
+        }
+    }
+
+    bool onWritable()
+    {
+        try {
+            while (1) {
+                if (mSendInProgress) {
+                    if (!mEndpoint.continuePutEnvelope()) return true;
+                    mSendInProgress = false;
+                }
+                impl::Envelope env;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (mOutgoing.empty()) return false;
+                    env = mOutgoing.front();
+                    mOutgoing.pop_front();
+                }
+                mSendInProgress = !mEndpoint.putEnvelopePartial(env);
+            }
+        } catch (const std::exception&) {
+            setDisconnected();
+            return false;
+        }
+    }
+
+private:
+    void setDisconnected()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDisconnected = true;
+        mCondition.notify_all();
+    }
+
+    EndpointIoLoop& mLoop;
+    uint64_t mId = 0;
+    network::SocketPeer mPeer;
+    impl::PeerMessageEndpoint mEndpoint;
+    bool mSendInProgress = false;
+    std::atomic<unsigned> mReadableCalls{0};
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<impl::Envelope> mOutgoing;
+    std::vector<impl::Envelope> mReceived;
+    bool mDisconnected = false;
+};
+
+// the other end of a LoopEndpoint's socket pair, using blocking i/o
+class RemotePeer
+{
+public:
+    RemotePeer(int aFd) :
+        mPeer(aFd),
+        mEndpoint(mPeer, false, "remote")
+    {}
+
+    // returns an empty envelope if no message starts arriving in time
+    impl::Envelope receive()
+    {
+        bool readable = false;
+        bool writable = false;
+        mPeer.poll(true, readable, false, writable,
+                   std::chrono::milliseconds(TIMEOUT).count());
+        if (!readable) return impl::Envelope();
+        return mEndpoint.getEnvelope();
+    }
+
+    network::SocketPeer mPeer;
+    impl::PeerMessageEndpoint mEndpoint;
+};
+
+void makeSocketPair(int aFds[2])
+{
+    CPPUNIT_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, aFds) == 0);
+
+    // keep the socket buffers small, so that large
+    // messages can't be sent in one go
+    int bufSize = 16 * 1024;
+    for (int i = 0; i < 2; i++) {
+        setsockopt(aFds[i], SOL_SOCKET, SO_SNDBUF, &bufSize, sizeof(bufSize));
+        setsockopt(aFds[i], SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+    }
+}
+
+}
+
+void TestEndpointIoLoop::testStalledPeers()
+{
+    // a single thread, so that an endpoint waiting on its
+    // socket would hold up all the others
+    EndpointIoLoop loop(1);
+
+    int fds[2];
+    makeSocketPair(fds);
+    LoopEndpoint stalledSender(loop, fds[0]);
+    network::SocketPeer stalledSenderRemote(fds[1]);
+    makeSocketPair(fds);
+    LoopEndpoint stalledReceiver(loop, fds[0]);
+    RemotePeer stalledReceiverRemote(fds[1]);
+    makeSocketPair(fds);
+    LoopEndpoint active(loop, fds[0]);
+    RemotePeer activeRemote(fds[1]);
+
+    //
+    // a peer that stops in the middle of a frame header
+    //
+    CaptureSink capture;
+    network::BasicFramingSink framedCapture(capture);
+    network::BufferedSink bufferedCapture(framedCapture);
+    impl::MessageWriter captureWriter(bufferedCapture, "capture");
+    captureWriter.write(makeMessage(1000, 1));
+    const std::vector<unsigned char>& bytes = capture.mData;
+    const size_t stallPoint = 5;
+    CPPUNIT_ASSERT(stalledSenderRemote.send(bytes.data(), stallPoint));
+
+    //
+    // a peer that doesn't read a message many times
+    // larger than the socket buffers
+    //
+    const size_t largeSize = 8 * 1024 * 1024;
+    stalledReceiver.send(makeMessage(largeSize, 2));
+
+    //
+    // messages still flow both ways on the other endpoint
+    //
+    const unsigned count = 10;
+    for (unsigned i = 0; i < count; i++) {
+        activeRemote.mEndpoint.putEnvelope(makeMessage(100 + i, i));
+    }
+    CPPUNIT_ASSERT(active.waitForReceived(count));
+    std::vector<impl::Envelope> received = active.received();
+    CPPUNIT_ASSERT(received.size() == count);
+    for (unsigned i = 0; i < count; i++) {
+        CPPUNIT_ASSERT(checkMessage(received[i], 100 + i, i));
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        active.send(makeMessage(200 + i, i));
+    }
+    for (unsigned i = 0; i < count; i++) {
+        CPPUNIT_ASSERT(checkMessage(activeRemote.receive(), 200 + i, i));
+    }
+
+    CPPUNIT_ASSERT(stalledSender.received().empty());
+
+    //
+    // the stalled peers resume, and their messages complete
+    //
+    CPPUNIT_ASSERT(stalledSenderRemote.send(bytes.data() + stallPoint, bytes.size() - stallPoint));
+    CPPUNIT_ASSERT(stalledSender.waitForReceived(1));
+    CPPUNIT_ASSERT(checkMessage(stalledSender.received()[0], 1000, 1));
+
+    CPPUNIT_ASSERT(checkMessage(stalledReceiverRemote.receive(), largeSize, 2));
+}
+
+void TestEndpointIoLoop::testDisconnect()
+{
+    EndpointIoLoop loop(2);
+
+    int fds[2];
+    makeSocketPair(fds);
+    LoopEndpoint endpoint(loop, fds[0]);
+    {
+        RemotePeer remote(fds[1]);
+        remote.mEndpoint.putEnvelope(makeMessage(10, 3));
+        CPPUNIT_ASSERT(endpoint.waitForReceived(1));
+    }
+
+    // the closed socket is reported once, and then no
+    // longer watched
+    CPPUNIT_ASSERT(endpoint.waitForDisconnect());
+    unsigned calls = endpoint.readableCalls();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CPPUNIT_ASSERT(endpoint.readableCalls() == calls);
+}
@@ -0,0 +1,27 @@
+// Copyright 2023-2024 DreamWorks Animation LLC and Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __ARRAS_TESTENDPOINTIOLOOP_H_
+#define __ARRAS_TESTENDPOINTIOLOOP_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TestEndpointIoLoop: public CppUnit::TestFixture
+{
+public:
+    TestEndpointIoLoop()
+        : CppUnit::TestFixture()
+    {}
+
+    void testStalledPeers();
+    void testDisconnect();
+
+    CPPUNIT_TEST_SUITE(TestEndpointIoLoop);
+        CPPUNIT_TEST(testStalledPeers);
+        CPPUNIT_TEST(testDisconnect);
+    CPPUNIT_TEST_SUITE_END();
+
+};
+
+
+#endif // __ARRAS_TESTENDPOINTIOLOOP_H_
@@ -177,7 +177,10 @@ ArrasSettings::getSessionDefinition()
         def["mcrt"]["fps"] = mMaxFps;
         def["mcrt"]["exec_mode"] = mExecMode;
     }
-    if (def.has("merge")) def["merge"]["fps"] = mMaxFps;
+    if (def.has("merge")) {
+        def["merge"]["fps"] = mMaxFps;
+        mcrt_dataio::ClientReceiverFb::advertiseDecodeCapability(def["merge"]);
+    }
     if (def.has("dispatch")) def["dispatch"]["fps"] = mMaxFps;
     return def;
 }
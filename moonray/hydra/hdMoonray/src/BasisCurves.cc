@@ -98,8 +98,7 @@ BasisCurves::Sync(pxr::HdSceneDelegate *sceneDelegate,
             pxr::HdBasisCurvesTopology topology(GetBasisCurvesTopology(sceneDelegate));
 
             curveVertexCounts = topology.GetCurveVertexCounts();
-            const int* p = reinterpret_cast<const int*>(&curveVertexCounts[0]);
-            geometry()->set("curves_vertex_count", scene_rdl2::rdl2::IntVector(p, p + curveVertexCounts.size()));
+            geometry()->set("curves_vertex_count", toIntVector(curveVertexCounts));
 
             if (topology.HasIndices()) {
                 // RdlCurveGeometry doesn't directly support indexed verts
@@ -168,16 +167,11 @@ BasisCurves::Sync(pxr::HdSceneDelegate *sceneDelegate,
 
             if (!updateCommonPrimvars(sceneDelegate, id, name, value, geometry())) {
                 if (name == stToken || name == uvToken) {
-                    const pxr::VtVec2fArray& v = value.Get<pxr::VtVec2fArray>();
-                    const scene_rdl2::rdl2::Vec2f* p = reinterpret_cast<const scene_rdl2::rdl2::Vec2f*>(&v[0]);
-                    geometry()->set("uv_list", scene_rdl2::rdl2::Vec2fVector(p, p + v.size()));
+                    geometry()->set("uv_list", toVec2fVector(value));
                     value = pxr::VtValue(); // remove it from UserData primvars
 
                 } else if (name ==  pxr::HdTokens->widths) {
-                    const pxr::VtFloatArray& v = value.Get<pxr::VtFloatArray>();
-                    scene_rdl2::rdl2::FloatVector w{v.begin(), v.end()};
-                    for (float& r : w) r /= 2;
-                    geometry()->set("radius_list", std::move(w));
+                    geometry()->set("radius_list", toFloatVector(value.Get<pxr::VtFloatArray>(), 0.5f));
                     value = pxr::VtValue(); // remove it from UserData primvars
 
                 }
@@ -13,6 +13,7 @@
 #include <scene_rdl2/scene/rdl2/UserData.h>
 
 #include <pxr/base/gf/vec2f.h>
+#include <pxr/base/work/loops.h>
 
 #include <iostream>
 
@@ -40,10 +41,27 @@ setMoonrayVec3fPrimvar(scene_rdl2::rdl2::Geometry& geometry,
                        const std::string& name,
                        const pxr::VtVec3fArray& values)
 {
-    const scene_rdl2::rdl2::Vec3f* p =
-        reinterpret_cast<const scene_rdl2::rdl2::Vec3f*>(&values[0]);
-    geometry.set(name,
-                 scene_rdl2::rdl2::Vec3fVector(p, p + values.size()));
+    geometry.set(name, hdMoonray::Geometry::toVec3fVector(values));
+}
+
+// Arrays with at least this many elements are converted by several threads
+constexpr size_t parallelConvertSize = 1 << 16;
+
+template <typename Dst, typename Src, typename Convert>
+std::vector<Dst>
+convertArray(const Src* src, size_t size, const Convert& convert)
+{
+    std::vector<Dst> dst(size);
+    Dst* out = dst.data();
+    auto loop = [src, out, &convert](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) out[i] = convert(src[i]);
+    };
+    if (size < parallelConvertSize) {
+        loop(0, size);
+    } else {
+        pxr::WorkParallelForN(size, loop);
+    }
+    return dst;
 }
 
 void
@@ -662,4 +680,39 @@ Geometry::updateCommonPrimvars(pxr::HdSceneDelegate *sceneDelegate,
     }
 }
 
+scene_rdl2::rdl2::IntVector
+Geometry::toIntVector(const pxr::VtIntArray& v)
+{
+    return convertArray<int>(v.cdata(), v.size(), [](int i) { return i; });
+}
+
+scene_rdl2::rdl2::FloatVector
+Geometry::toFloatVector(const pxr::VtFloatArray& v, float scale)
+{
+    return convertArray<float>(v.cdata(), v.size(), [scale](float f) { return f * scale; });
+}
+
+scene_rdl2::rdl2::Vec2fVector
+Geometry::toVec2fVector(const pxr::VtValue& value)
+{
+    if (value.IsHolding<pxr::VtVec3fArray>()) {
+        const pxr::VtVec3fArray& v = value.UncheckedGet<pxr::VtVec3fArray>();
+        return convertArray<scene_rdl2::rdl2::Vec2f>(v.cdata(), v.size(), [](const pxr::GfVec3f& p) {
+                return scene_rdl2::rdl2::Vec2f(p[0], p[1]);
+            });
+    }
+    const pxr::VtVec2fArray& v = value.Get<pxr::VtVec2fArray>();
+    return convertArray<scene_rdl2::rdl2::Vec2f>(
+        reinterpret_cast<const scene_rdl2::rdl2::Vec2f*>(v.cdata()), v.size(),
+        [](const scene_rdl2::rdl2::Vec2f& p) { return p; });
+}
+
+scene_rdl2::rdl2::Vec3fVector
+Geometry::toVec3fVector(const pxr::VtVec3fArray& v)
+{
+    return convertArray<scene_rdl2::rdl2::Vec3f>(
+        reinterpret_cast<const scene_rdl2::rdl2::Vec3f*>(v.cdata()), v.size(),
+        [](const scene_rdl2::rdl2::Vec3f& p) { return p; });
+}
+
 }
@@ -5,6 +5,7 @@
 
 #include <pxr/imaging/hd/rprim.h>
 #include <pxr/base/gf/matrix4f.h>
+#include <scene_rdl2/scene/rdl2/Types.h>
 
 // This macro is used for the instanceId argument to constructors which was removed in usd-21.2
 #if PXR_VERSION < 2102
@@ -84,6 +85,13 @@ public:
                                      pxr::VtValue& value,
                                      scene_rdl2::rdl2::Geometry* geometry);
 
+    // Convert primvar and topology arrays to rdl2 vectors. The data is copied once, directly into
+    // the returned vector which can be moved into the attribute. Large arrays are split over threads.
+    static scene_rdl2::rdl2::IntVector toIntVector(const pxr::VtIntArray&);
+    static scene_rdl2::rdl2::FloatVector toFloatVector(const pxr::VtFloatArray&, float scale = 1.0f);
+    static scene_rdl2::rdl2::Vec2fVector toVec2fVector(const pxr::VtValue&); // VtVec2fArray or VtVec3fArray
+    static scene_rdl2::rdl2::Vec3fVector toVec3fVector(const pxr::VtVec3fArray&);
+
 protected:
     // Subclass must fill these in if there are any parts. Currenlty only Mesh does this:
     std::vector<std::string> partList;
@@ -155,13 +155,8 @@ Mesh::Sync(pxr::HdSceneDelegate *sceneDelegate,
             pxr::HdMeshTopology topology(GetMeshTopology(sceneDelegate));
 
             if (pxr::HdChangeTracker::IsTopologyDirty(*dirtyBits, id)) { //
-                const pxr::VtIntArray& faceVertexCounts = topology.GetFaceVertexCounts();
-                geometry()->set("face_vertex_count",
-                                scene_rdl2::rdl2::IntVector(faceVertexCounts.begin(), faceVertexCounts.end()));
-
-                const pxr::VtIntArray& faceVertexIndices = topology.GetFaceVertexIndices();
-                geometry()->set("vertices_by_index",
-                                scene_rdl2::rdl2::IntVector(faceVertexIndices.begin(), faceVertexIndices.end()));
+                geometry()->set("face_vertex_count", toIntVector(topology.GetFaceVertexCounts()));
+                geometry()->set("vertices_by_index", toIntVector(topology.GetFaceVertexIndices()));
 
                 mFlip = topology.GetOrientation() != pxr::PxOsdOpenSubdivTokens->rightHanded;
                 if (topology.GetOrientation() != pxr::PxOsdOpenSubdivTokens->rightHanded)
@@ -328,25 +323,11 @@ Mesh::Sync(pxr::HdSceneDelegate *sceneDelegate,
 
             if (!updateCommonPrimvars(sceneDelegate, id, name, value, geometry())) {
                 if (name == pxr::HdTokens->normals || name == normalToken) {
-                    const pxr::VtVec3fArray& v = value.Get<pxr::VtVec3fArray>();
-                    const scene_rdl2::rdl2::Vec3f* p = reinterpret_cast<const scene_rdl2::rdl2::Vec3f*>(&v[0]);
-                    scene_rdl2::rdl2::Vec3fVector out(p, p + v.size());
-                    geometry()->set("normal_list", out);
+                    geometry()->set("normal_list", toVec3fVector(value.Get<pxr::VtVec3fArray>()));
                     value = pxr::VtValue(); // remove it from UserData primvars
 
                 } else if (name == stToken || name == uvToken) {
-                    scene_rdl2::rdl2::Vec2fVector out;
-                    if (value.IsHolding<pxr::VtVec3fArray>()) {
-                        const pxr::VtVec3fArray& v = value.UncheckedGet<pxr::VtVec3fArray>();
-                        out.reserve(v.size());
-                        for (const auto& v3 : v)
-                            out.emplace_back(*reinterpret_cast<const scene_rdl2::rdl2::Vec2f*>(&v3));
-                    } else {
-                        const pxr::VtVec2fArray& v = value.Get<pxr::VtVec2fArray>();
-                        const scene_rdl2::rdl2::Vec2f* p = reinterpret_cast<const scene_rdl2::rdl2::Vec2f*>(&v[0]);
-                        out.assign(p, p + v.size());
-                    }
-                    geometry()->set("uv_list", std::move(out));
+                    geometry()->set("uv_list", toVec2fVector(value));
                     value = pxr::VtValue(); // remove it from UserData primvars
 
                 }
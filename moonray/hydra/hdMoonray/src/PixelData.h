@@ -22,6 +22,9 @@ struct PixelData: public PixelSize {
     unsigned filmActivity = ~0; // renderer can use this to check if image has changed
     std::vector<float> vec; // renderer can use this to store the data (but it does not have to)
     scene_rdl2::fb_util::VariablePixelBuffer vpb; // renderer can use this to store the data also
+    // renderer can set this to the 8x8 pixel tiles (row-major from lower-left) that changed since
+    // the previous resolve so only those are post-processed. Empty means the whole image changed.
+    std::vector<unsigned> tiles;
 };
 
 }
@@ -79,11 +79,7 @@ Points::Sync(pxr::HdSceneDelegate *sceneDelegate,
 
             if (!updateCommonPrimvars(sceneDelegate, id, name, value, geometry())) {
                 if (name ==  pxr::HdTokens->widths) {
-                    const pxr::VtFloatArray& v = value.Get<pxr::VtFloatArray>();
-                    scene_rdl2::rdl2::FloatVector w;
-                    w.reserve(v.size());
-                    for (float width : v) w.emplace_back(width/2);
-                    geometry()->set("radius_list", w);
+                    geometry()->set("radius_list", toFloatVector(value.Get<pxr::VtFloatArray>(), 0.5f));
                     value = pxr::VtValue(); // remove it from UserData primvars
                 }
             }
@@ -10,6 +10,7 @@
 #include <scene_rdl2/scene/rdl2/RenderOutput.h>
 #include "pxr/base/work/loops.h"
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -43,6 +44,30 @@ operator<<(std::ostream& o, pxr::HdFormat format)
     return o;
 }
 
+// Calls func(begin, end) in parallel over the ranges of pixel indices changed by the last resolve
+template <typename Func>
+void
+parallelForChangedPixels(const hdMoonray::PixelData& pd, const Func& func)
+{
+    if (pd.tiles.empty()) {
+        pxr::WorkParallelForN(size_t(pd.mWidth) * pd.mHeight, func);
+        return;
+    }
+    const unsigned numTilesX = (pd.mWidth + 7) / 8;
+    pxr::WorkParallelForN(pd.tiles.size(), [&pd, &func, numTilesX](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                const unsigned x0 = (pd.tiles[t] % numTilesX) * 8;
+                const unsigned y0 = (pd.tiles[t] / numTilesX) * 8;
+                const unsigned x1 = std::min(x0 + 8, pd.mWidth);
+                const unsigned y1 = std::min(y0 + 8, pd.mHeight);
+                for (unsigned y = y0; y < y1; ++y) {
+                    const size_t row = size_t(y) * pd.mWidth;
+                    func(row + x0, row + x1);
+                }
+            }
+        });
+}
+
 // Lookup table from AOV name to RenderOutput settings
 typedef scene_rdl2::rdl2::RenderOutput RO;
 struct RODesc {
@@ -444,12 +469,12 @@ RenderBuffer::Resolve()
 #if PXR_VERSION >= 2008
         // these versions require alpha compositing over background color to be done by delegate
         if (clearValue[3] > 0.0f) {
-            const size_t count = pd.mWidth * pd.mHeight;
+            // the renderer may only have updated some tiles, the others are already composited
             typedef float v4sf __attribute__ ((vector_size (16)));
             v4sf* buffer = reinterpret_cast<v4sf*>(pd.mData);
             if (clearValue[0] || clearValue[1] || clearValue[2] || clearValue[3] < 1.0f) {
                 const v4sf& cv = reinterpret_cast<const v4sf&>(clearValue[0]);
-                pxr::WorkParallelForN(count, [buffer, cv](size_t begin, size_t end) {
+                parallelForChangedPixels(pd, [buffer, cv](size_t begin, size_t end) {
                     for (size_t i = begin; i < end; ++i) {
                         v4sf& pixel = *(buffer + i);
                         if (pixel[3] < 1.0f) {
@@ -464,7 +489,7 @@ RenderBuffer::Resolve()
                 });
             } else {
                 // composite is simpler when clearValue is opaque black
-                pxr::WorkParallelForN(count, [buffer](size_t begin, size_t end) {
+                parallelForChangedPixels(pd, [buffer](size_t begin, size_t end) {
                     for (size_t i = begin; i < end; ++i) {
                         v4sf& pixel = *(buffer + i);
                         pixel[3] = 1.0f;
@@ -79,11 +79,14 @@ RndrRenderer::allocate(scene_rdl2::rdl2::RenderOutput* ro, PixelData& pd, const
         // don't resize any existing buffer
         mResized = true;
     } else if (isBeauty(ro) && request.mChannels == 4) {
-        renderBuffer.init(request.mWidth, request.mHeight);
+        std::lock_guard<std::mutex> guard(mBeautyMutex);
+        beautyBuffer.init(request.mWidth, request.mHeight);
+        beautyTiledWeightBuffer.cleanUp(); // next resolve has to fill all of beautyBuffer
         pd.mChannels = 4;
         pd.mWidth = request.mWidth;
         pd.mHeight = request.mHeight;
-        pd.mData = renderBuffer.getData();
+        pd.mData = beautyBuffer.getData();
+        pd.tiles.clear();
     } else {
         pd.mChannels = request.mChannels;
         if (ro) {
@@ -164,14 +167,22 @@ RndrRenderer::resolve(scene_rdl2::rdl2::RenderOutput* ro, PixelData& pd)
     mResized = false;
 
     if (isBeauty(ro)) {
-        mRenderContext->snapshotRenderBuffer(&renderBuffer, true, true);
+        // Only the tiles which changed since the previous resolve are normalized and untiled
+        // into beautyBuffer, which hydra reads directly. RenderBuffer::Resolve() composites
+        // in place, so force a full update when it asks to recomposite (filmActivity == ~0).
+        std::lock_guard<std::mutex> guard(mBeautyMutex);
+        if (oldN == ~0u) beautyTiledWeightBuffer.cleanUp();
+        mRenderContext->snapshotDeltaUntiled(&beautyBuffer, &beautyTiledBuffer, &beautyTiledWeightBuffer,
+                                             pd.tiles, true);
         pd.mChannels = 4;
-        pd.mWidth = renderBuffer.getWidth();
-        pd.mHeight = renderBuffer.getHeight();
-        pd.mData = renderBuffer.getData();
-        return true;
+        pd.mWidth = beautyBuffer.getWidth();
+        pd.mHeight = beautyBuffer.getHeight();
+        pd.mData = beautyBuffer.getData();
+        return !pd.tiles.empty();
     }
 
+    // Other render outputs are still fully resolved on every call. snapshotRenderOutput() converts
+    // them from a variety of sources and formats, which have no per-tile change tracking.
     int index = renderOutputIndex(ro);
     if (index < 0) return false;
     const auto *rod = mRenderContext->getRenderOutputDriver();
@@ -202,6 +213,7 @@ RndrRenderer::resolve(scene_rdl2::rdl2::RenderOutput* ro, PixelData& pd)
     pd.mWidth = pd.vpb.getWidth();
     pd.mHeight = pd.vpb.getHeight();
     pd.mData = pd.vpb.getData();
+    pd.tiles.clear();
     return true;
 }
 
@@ -214,9 +226,13 @@ RndrRenderer::deallocate(scene_rdl2::rdl2::RenderOutput* ro, PixelData& pd)
 #   endif // end DEBUG_MSG
 
     if (isBeauty(ro)) {
-        renderBuffer.cleanUp();
+        std::lock_guard<std::mutex> guard(mBeautyMutex);
+        beautyBuffer.cleanUp();
+        beautyTiledBuffer.cleanUp();
+        beautyTiledWeightBuffer.cleanUp();
     } else {
         // free other buffers that may have been allocated:
+        renderBuffer.cleanUp();
         heatMapBuffer.cleanUp();
         weightBuffer.cleanUp();
         renderBufferOdd.cleanUp();
@@ -60,6 +60,10 @@ private:
     scene_rdl2::fb_util::HeatMapBuffer heatMapBuffer;
     scene_rdl2::fb_util::FloatBuffer weightBuffer;
     scene_rdl2::fb_util::RenderBuffer renderBufferOdd;
+    scene_rdl2::fb_util::RenderBuffer beautyBuffer; // updated incrementally, see resolve()
+    scene_rdl2::fb_util::RenderBuffer beautyTiledBuffer;
+    scene_rdl2::fb_util::FloatBuffer beautyTiledWeightBuffer;
+    std::mutex mBeautyMutex;
 
     void invalidateAllTextureResources();
     void stopFrame() const;
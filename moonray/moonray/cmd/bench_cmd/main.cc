@@ -0,0 +1,666 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+// moonray_bench renders a fixed set of procedurally generated scenes, each
+// stressing one part of the renderer, and reports the render throughput of
+// each one as json. The scenes are written as rdla into a work directory
+// (together with the volume and texture files they need) so they can also be
+// rendered and inspected with moonray directly.
+
+#include <scene_rdl2/render/util/AtomicFloat.h> // Needs to be included before any OpenImageIO file
+#include <moonray/common/mcrt_util/ProcessStats.h>
+#include <moonray/rendering/mcrt_common/ThreadLocalState.h>
+#include <moonray/rendering/pbr/core/Statistics.h>
+#include <moonray/rendering/rndr/RenderContext.h>
+#include <moonray/rendering/rndr/RenderDriver.h>
+#include <moonray/rendering/rndr/RenderOptions.h>
+#include <moonray/rendering/rndr/RenderStatistics.h>
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/render/logging/logging.h>
+
+#include <OpenImageIO/imagebuf.h>
+#include <OpenImageIO/imagebufalgo.h>
+#include <openvdb/openvdb.h>
+#include <openvdb/tools/LevelSetSphere.h>
+#include <openvdb/tools/LevelSetUtil.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using scene_rdl2::logging::Logger;
+
+namespace moonray {
+namespace {
+
+struct BenchScene
+{
+    const char* mName;
+    const char* mRdla;
+};
+
+// Shared by all scenes. The bench_* globals are set through the rdla globals
+// of the RenderOptions.
+const char* sPrelude = R"rdla(
+SceneVariables {
+    ["image width"] = bench_width,
+    ["image height"] = bench_height,
+    ["pixel samples"] = bench_pixel_samples,
+    ["light samples"] = 2,
+    ["bsdf samples"] = 2,
+    ["max depth"] = 5,
+}
+
+PerspectiveCamera("/camera") {
+    ["node xform"] = rotate(-15, 1, 0, 0) * translate(0, 4, 14),
+    ["focal"] = 30,
+}
+
+function sphereMesh(name, cx, cy, cz, radius, rings, segments)
+    local verts, uvs, indices, counts = {}, {}, {}, {}
+    for i = 0, rings do
+        local theta = math.pi * i / rings
+        for j = 0, segments do
+            local phi = 2 * math.pi * j / segments
+            table.insert(verts, Vec3(cx + radius * math.sin(theta) * math.cos(phi),
+                                     cy + radius * math.cos(theta),
+                                     cz + radius * math.sin(theta) * math.sin(phi)))
+            table.insert(uvs, Vec2(j / segments, 1 - i / rings))
+        end
+    end
+    for i = 0, rings - 1 do
+        for j = 0, segments - 1 do
+            local a = i * (segments + 1) + j
+            local b = a + segments + 1
+            table.insert(indices, a)
+            table.insert(indices, a + 1)
+            table.insert(indices, b + 1)
+            table.insert(indices, b)
+            table.insert(counts, 4)
+        end
+    end
+    return RdlMeshGeometry(name) {
+        ["vertex_list"] = verts,
+        ["uv_list"] = uvs,
+        ["vertices_by_index"] = indices,
+        ["face_vertex_count"] = counts,
+        ["is_subd"] = false,
+    }
+end
+
+ground = RdlMeshGeometry("/ground") {
+    ["vertex_list"] = { Vec3(-50, 0, -50), Vec3(50, 0, -50), Vec3(50, 0, 50), Vec3(-50, 0, 50) },
+    ["uv_list"] = { Vec2(0, 0), Vec2(1, 0), Vec2(1, 1), Vec2(0, 1) },
+    ["vertices_by_index"] = { 0, 3, 2, 1 },
+    ["face_vertex_count"] = { 4 },
+    ["is_subd"] = false,
+}
+
+groundMtl = BaseMaterial("/groundMtl") {
+    ["diffuse_color"] = Rgb(0.5, 0.5, 0.5),
+    ["specular_factor"] = 0.05,
+}
+
+keyLight = RectLight("/keyLight") {
+    ["node xform"] = rotate(-60, 1, 0, 0) * rotate(30, 0, 1, 0) * translate(6, 10, 8),
+    ["intensity"] = 4,
+    ["width"] = 6,
+    ["height"] = 6,
+}
+
+envLight = EnvLight("/envLight") {
+    ["intensity"] = 0.3,
+}
+)rdla";
+
+const BenchScene sScenes[] = {
+    {
+        // Many small instanced meshes, stresses instance traversal and bvh
+        // build over instances.
+        "instancing", R"rdla(
+proto = sphereMesh("/proto", 0, 0, 0, 1, 16, 32)
+protoMtl = BaseMaterial("/protoMtl") {
+    ["diffuse_color"] = Rgb(0.7, 0.3, 0.2),
+    ["specular_roughness"] = 0.2,
+}
+
+positions, scales = {}, {}
+for i = 0, 159 do
+    for j = 0, 159 do
+        local s = 0.05 + 0.05 * math.abs(math.sin(i * 12.9898 + j * 78.233))
+        table.insert(positions, Vec3(-16 + i * 0.2, s, -24 + j * 0.2))
+        table.insert(scales, Vec3(s, s, s))
+    end
+end
+
+instancer = RdlInstancerGeometry("/instancer") {
+    ["references"] = { proto },
+    ["positions"] = positions,
+    ["scales"] = scales,
+}
+
+lights = LightSet("/lights") { keyLight, envLight }
+
+GeometrySet("/geometry") { ground, proto, instancer }
+
+Layer("/layer") {
+    { ground, "", groundMtl, lights },
+    { proto, "", protoMtl, lights },
+    { instancer, "", protoMtl, lights },
+}
+)rdla"
+    },
+    {
+        // A dense patch of thin curves, stresses curve intersection.
+        "curves", R"rdla(
+counts, verts, radii = {}, {}, {}
+for i = 0, 299 do
+    for j = 0, 299 do
+        local x = -6 + i * 0.04 + 0.02 * math.sin(j * 3.7)
+        local z = -6 + j * 0.04 + 0.02 * math.cos(i * 5.3)
+        local bend = 0.3 * math.sin(i * 0.11 + j * 0.07)
+        table.insert(counts, 4)
+        for k = 0, 3 do
+            local t = k / 3
+            table.insert(verts, Vec3(x + bend * t * t, 1.5 * t, z + 0.5 * bend * t * t))
+            table.insert(radii, 0.006 * (1 - 0.8 * t))
+        end
+    end
+end
+
+hair = RdlCurveGeometry("/hair") {
+    ["curves_vertex_count"] = counts,
+    ["vertex_list_0"] = verts,
+    ["radius_list"] = radii,
+}
+
+hairMtl = BaseMaterial("/hairMtl") {
+    ["diffuse_color"] = Rgb(0.4, 0.25, 0.1),
+    ["specular_roughness"] = 0.35,
+}
+
+lights = LightSet("/lights") { keyLight, envLight }
+
+GeometrySet("/geometry") { ground, hair }
+
+Layer("/layer") {
+    { ground, "", groundMtl, lights },
+    { hair, "", hairMtl, lights },
+}
+)rdla"
+    },
+    {
+        // A few hundred small local lights, stresses light selection and
+        // light sampling.
+        "many_lights", R"rdla(
+ball = sphereMesh("/ball", 0, 2, 0, 2, 32, 64)
+ballMtl = BaseMaterial("/ballMtl") {
+    ["diffuse_color"] = Rgb(0.8, 0.8, 0.8),
+    ["specular_roughness"] = 0.25,
+}
+
+lights = {}
+for i = 0, 15 do
+    for j = 0, 15 do
+        local h = (i * 16 + j) * 0.618034
+        table.insert(lights, SphereLight("/light_" .. i .. "_" .. j) {
+            ["node xform"] = translate(-12 + i * 1.6, 0.4 + 0.3 * math.abs(math.sin(h * 7)), -16 + j * 1.6),
+            ["color"] = Rgb(0.5 + 0.5 * math.sin(h * 6.283),
+                            0.5 + 0.5 * math.sin(h * 6.283 + 2.094),
+                            0.5 + 0.5 * math.sin(h * 6.283 + 4.189)),
+            ["intensity"] = 2,
+            ["radius"] = 0.1,
+        })
+    end
+end
+lightSet = LightSet("/lights")(lights)
+
+GeometrySet("/geometry") { ground, ball }
+
+Layer("/layer") {
+    { ground, "", groundMtl, lightSet },
+    { ball, "", ballMtl, lightSet },
+}
+)rdla"
+    },
+    {
+        // A heterogeneous vdb fog volume, stresses volume integration.
+        "vdb_volume", R"rdla(
+cloud = VdbGeometry("/cloud") {
+    ["model"] = bench_dir .. "/bench_fog.vdb",
+    ["density_grid"] = "density",
+}
+
+cloudVol = BaseVolume("/cloudVol") {
+    ["diffuse_color"] = Rgb(0.9, 0.9, 0.9),
+    ["attenuation_color"] = Rgb(1, 1, 1),
+}
+
+lights = LightSet("/lights") { keyLight, envLight }
+
+GeometrySet("/geometry") { ground, cloud }
+
+Layer("/layer") {
+    { ground, "", groundMtl, lights },
+    { cloud, "", undef(), lights, undef(), cloudVol },
+}
+)rdla"
+    },
+    {
+        // Translucent spheres, stresses subsurface scattering.
+        "subsurface", R"rdla(
+sssMtl = BaseMaterial("/sssMtl") {
+    ["diffuse_color"] = Rgb(0.9, 0.7, 0.6),
+    ["translucency"] = true,
+    ["translucency_factor"] = 1,
+    ["translucency_color"] = Rgb(0.9, 0.4, 0.3),
+    ["translucency_radius"] = 0.5,
+    ["specular_roughness"] = 0.3,
+}
+
+lights = LightSet("/lights") { keyLight, envLight }
+
+geometry, assignments = { ground }, { { ground, "", groundMtl, lights } }
+for i = 0, 4 do
+    for j = 0, 2 do
+        local ball = sphereMesh("/ball_" .. i .. "_" .. j, -6 + i * 3, 1.2, -4 + j * 3, 1.2, 32, 64)
+        table.insert(geometry, ball)
+        table.insert(assignments, { ball, "", sssMtl, lights })
+    end
+end
+
+GeometrySet("/geometry")(geometry)
+Layer("/layer")(assignments)
+)rdla"
+    },
+    {
+        // Many distinct mip mapped textures, stresses texture filtering and
+        // the texture cache.
+        "textures", R"rdla(
+lights = LightSet("/lights") { keyLight, envLight }
+
+geometry, assignments = { ground }, { { ground, "", groundMtl, lights } }
+for i = 0, 7 do
+    for j = 0, 5 do
+        local index = i * 6 + j
+        local tex = ImageMap("/tex_" .. index) {
+            ["texture"] = bench_dir .. "/bench_tex_" .. (index % bench_num_textures) .. ".tx",
+        }
+        local mtl = BaseMaterial("/mtl_" .. index) {
+            ["diffuse_color"] = bind(tex),
+            ["specular_roughness"] = 0.4,
+        }
+        local ball = sphereMesh("/ball_" .. index, -10.5 + i * 3, 1, -12 + j * 3, 1, 24, 48)
+        table.insert(geometry, ball)
+        table.insert(assignments, { ball, "", mtl, lights })
+    end
+end
+
+GeometrySet("/geometry")(geometry)
+Layer("/layer")(assignments)
+)rdla"
+    },
+};
+
+constexpr int sNumTextures = 16;
+constexpr int sTextureRes = 1024;
+
+struct BenchResult
+{
+    std::string mName;
+    double mPrepTime;
+    double mMcrtTime;
+    uint64_t mPixelSamples;
+    uint64_t mTotalSamples;
+    uint64_t mRays;
+    int64 mPeakRss;
+};
+
+class BenchApplication
+{
+public:
+    BenchApplication();
+
+    int main(int argc, char* argv[]);
+
+private:
+    bool parseOptions(int argc, char* argv[]);
+    void printUsage(const char* argv0) const;
+
+    void writeVolume() const;
+    void writeTextures() const;
+    std::string writeScene(const BenchScene& scene) const;
+
+    BenchResult render(const BenchScene& scene);
+    void writeResults(std::ostream& out, const std::vector<BenchResult>& results) const;
+
+    std::vector<std::string> mSceneNames;
+    std::string mWorkDir;
+    std::string mOutFile;
+    std::string mDsoPath;
+    std::string mExecMode;
+    uint32_t mThreads;
+    unsigned mNumRenderThreads;
+    int mPixelSamples;
+    int mWidth;
+    int mHeight;
+
+    util::ProcessStats mProcessStats;
+};
+
+BenchApplication::BenchApplication() :
+    mWorkDir("/tmp/moonray_bench." + std::to_string(getpid())),
+    mThreads(0),
+    mNumRenderThreads(0),
+    mPixelSamples(16),
+    mWidth(640),
+    mHeight(360)
+{
+}
+
+void
+BenchApplication::printUsage(const char* argv0) const
+{
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+        "Renders procedurally generated benchmark scenes and reports their\n"
+        "throughput as json.\n"
+        "\n"
+        "    -scene name\n"
+        "        Only render this scene, may appear more than once. One of\n"
+        "        instancing, curves, many_lights, vdb_volume, subsurface, textures.\n"
+        "        All scenes by default.\n"
+        "\n"
+        "    -samples n\n"
+        "        Pixel samples per pixel (16 by default).\n"
+        "\n"
+        "    -size 640 360\n"
+        "        Image width and height.\n"
+        "\n"
+        "    -threads n\n"
+        "        Number of threads to use (all by default).\n"
+        "\n"
+        "    -exec_mode mode\n"
+        "        Execution mode: auto, scalar, vectorized or xpu.\n"
+        "\n"
+        "    -dso_path dso/path\n"
+        "        Prepend to search path for RDL DSOs.\n"
+        "\n"
+        "    -work_dir dir\n"
+        "        Where the generated scenes, volumes and textures are written.\n"
+        "\n"
+        "    -out results.json\n"
+        "        Write the results to a file instead of stdout.\n";
+}
+
+bool
+BenchApplication::parseOptions(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string flag = argv[i];
+        const int remaining = argc - i - 1;
+        if (flag == "-h" || flag == "-help") {
+            return false;
+        } else if (flag == "-scene" && remaining >= 1) {
+            mSceneNames.push_back(argv[++i]);
+        } else if (flag == "-samples" && remaining >= 1) {
+            mPixelSamples = std::max(1, std::atoi(argv[++i]));
+        } else if (flag == "-size" && remaining >= 2) {
+            mWidth = std::max(1, std::atoi(argv[++i]));
+            mHeight = std::max(1, std::atoi(argv[++i]));
+        } else if (flag == "-threads" && remaining >= 1) {
+            mThreads = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (flag == "-exec_mode" && remaining >= 1) {
+            mExecMode = argv[++i];
+        } else if (flag == "-dso_path" && remaining >= 1) {
+            mDsoPath = argv[++i];
+        } else if (flag == "-work_dir" && remaining >= 1) {
+            mWorkDir = argv[++i];
+        } else if (flag == "-out" && remaining >= 1) {
+            mOutFile = argv[++i];
+        } else {
+            std::cerr << "Unknown or incomplete option '" << flag << "'\n";
+            return false;
+        }
+    }
+
+    for (const std::string& name : mSceneNames) {
+        bool found = false;
+        for (const BenchScene& scene : sScenes) {
+            found |= (name == scene.mName);
+        }
+        if (!found) {
+            std::cerr << "Unknown scene '" << name << "'\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+BenchApplication::writeVolume() const
+{
+    // A fog sphere with some low frequency variation in density
+    openvdb::initialize();
+    openvdb::FloatGrid::Ptr grid =
+        openvdb::tools::createLevelSetSphere<openvdb::FloatGrid>(3.0f, openvdb::Vec3f(0.0f, 3.5f, 0.0f), 0.05f);
+    openvdb::tools::sdfToFogVolume(*grid);
+    for (openvdb::FloatGrid::ValueOnIter iter = grid->beginValueOn(); iter; ++iter) {
+        const openvdb::Vec3d p = grid->indexToWorld(iter.getCoord());
+        const double noise = std::sin(2.1 * p.x()) * std::sin(1.7 * p.y()) * std::sin(2.3 * p.z());
+        iter.setValue(iter.getValue() * static_cast<float>(0.6 + 0.4 * noise));
+    }
+    grid->setName("density");
+
+    openvdb::io::File file(mWorkDir + "/bench_fog.vdb");
+    file.write(openvdb::GridPtrVec(1, grid));
+    file.close();
+}
+
+void
+BenchApplication::writeTextures() const
+{
+    for (int t = 0; t < sNumTextures; ++t) {
+        OIIO::ImageBuf image(OIIO::ImageSpec(sTextureRes, sTextureRes, 3, OIIO::TypeDesc::HALF));
+        const float hue = 0.618034f * t;
+        const float tint[3] = { 0.5f + 0.5f * std::sin(6.283f * hue),
+                                0.5f + 0.5f * std::sin(6.283f * hue + 2.094f),
+                                0.5f + 0.5f * std::sin(6.283f * hue + 4.189f) };
+        for (OIIO::ImageBuf::Iterator<float> it(image); !it.done(); ++it) {
+            // a checker with a fine sine pattern on top, so every mip level differs
+            const int checker = ((it.x() / 64) + (it.y() / 64)) & 1;
+            const float detail = 0.75f + 0.25f * std::sin(0.37f * it.x()) * std::sin(0.29f * it.y());
+            for (int c = 0; c < 3; ++c) {
+                it[c] = (checker ? tint[c] : 1.0f - tint[c]) * detail;
+            }
+        }
+
+        OIIO::ImageSpec config;
+        config.tile_width = 64;
+        config.tile_height = 64;
+        const std::string path = mWorkDir + "/bench_tex_" + std::to_string(t) + ".tx";
+        if (!OIIO::ImageBufAlgo::make_texture(OIIO::ImageBufAlgo::MakeTxTexture, image, path, config)) {
+            Logger::error("Failed to write benchmark texture ", path, ": ", OIIO::geterror());
+        }
+    }
+}
+
+std::string
+BenchApplication::writeScene(const BenchScene& scene) const
+{
+    const std::string path = mWorkDir + "/" + scene.mName + ".rdla";
+    std::ofstream out(path);
+    out << sPrelude << scene.mRdla;
+    if (!out) {
+        throw scene_rdl2::except::IoError("Failed to write benchmark scene '" + path + "'");
+    }
+    return path;
+}
+
+BenchResult
+BenchApplication::render(const BenchScene& scene)
+{
+    rndr::RenderOptions options;
+    options.setSceneFiles({ writeScene(scene) });
+    options.setThreads(mThreads);
+    if (!mDsoPath.empty()) {
+        options.setDsoPath(mDsoPath);
+    }
+    if (!mExecMode.empty()) {
+        options.setDesiredExecutionMode(mExecMode);
+    }
+    options.setRdlaGlobals({
+        { "bench_width", std::to_string(mWidth) },
+        { "bench_height", std::to_string(mHeight) },
+        { "bench_pixel_samples", std::to_string(mPixelSamples) },
+        { "bench_num_textures", std::to_string(sNumTextures) },
+        { "bench_dir", "\"" + mWorkDir + "\"" },
+    });
+
+    // Each scene gets a fresh context so its prep time covers loading the
+    // whole scene, and a fresh peak resident set size.
+    mProcessStats.resetPeakProcessMemory();
+
+    std::stringstream initMessages;
+    rndr::RenderContext renderContext(options, &initMessages);
+    renderContext.initialize(initMessages);
+    renderContext.setRenderMode(rndr::RenderMode::BATCH);
+
+    renderContext.startFrame();
+    while (!renderContext.isFrameComplete()) {
+        usleep(10000);
+    }
+    renderContext.stopFrame();
+
+    const pbr::Statistics& pbrStats = renderContext.getPbrStatistics();
+
+    BenchResult result;
+    result.mName = scene.mName;
+    result.mPrepTime = renderContext.getSceneRenderStats().getTotalRenderPrepTime();
+    result.mMcrtTime = pbrStats.mMcrtTime;
+    result.mPixelSamples = pbrStats.getCounter(pbr::STATS_PIXEL_SAMPLES);
+    result.mTotalSamples = result.mPixelSamples +
+                           pbrStats.getCounter(pbr::STATS_LIGHT_SAMPLES) +
+                           pbrStats.getCounter(pbr::STATS_BSDF_SAMPLES) +
+                           pbrStats.getCounter(pbr::STATS_SSS_SAMPLES);
+    // same definition as the "Total rays" of the sampling statistics
+    result.mRays = pbrStats.getCounter(pbr::STATS_INTERSECTION_RAYS) +
+                   pbrStats.getCounter(pbr::STATS_OCCLUSION_RAYS);
+    result.mPeakRss = mProcessStats.getPeakProcessMemory();
+    return result;
+}
+
+void
+BenchApplication::writeResults(std::ostream& out, const std::vector<BenchResult>& results) const
+{
+    const auto perSecond = [](uint64_t count, double seconds) {
+        return (seconds > 0.0) ? static_cast<double>(count) / seconds : 0.0;
+    };
+
+    out << "{\n"
+        << "    \"threads\": " << mNumRenderThreads << ",\n"
+        << "    \"width\": " << mWidth << ",\n"
+        << "    \"height\": " << mHeight << ",\n"
+        << "    \"pixel_samples\": " << mPixelSamples << ",\n"
+        << "    \"scenes\": [\n";
+    out.precision(6);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "        {\n"
+            << "            \"name\": \"" << r.mName << "\",\n"
+            << "            \"prep_time\": " << r.mPrepTime << ",\n"
+            << "            \"mcrt_time\": " << r.mMcrtTime << ",\n"
+            << "            \"pixel_samples\": " << r.mPixelSamples << ",\n"
+            << "            \"total_samples\": " << r.mTotalSamples << ",\n"
+            << "            \"rays\": " << r.mRays << ",\n"
+            << "            \"samples_per_sec\": " << perSecond(r.mPixelSamples, r.mMcrtTime) << ",\n"
+            << "            \"total_samples_per_sec\": " << perSecond(r.mTotalSamples, r.mMcrtTime) << ",\n"
+            << "            \"rays_per_sec\": " << perSecond(r.mRays, r.mMcrtTime) << ",\n"
+            << "            \"peak_rss\": " << r.mPeakRss << "\n"
+            << "        }" << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+    out << "    ]\n"
+        << "}\n";
+}
+
+int
+BenchApplication::main(int argc, char* argv[])
+{
+    if (!parseOptions(argc, argv)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (mkdir(mWorkDir.c_str(), 0777) != 0 && errno != EEXIST) {
+        Logger::error("Unable to create benchmark work directory ", mWorkDir);
+        return EXIT_FAILURE;
+    }
+    const auto selected = [this](const char* name) {
+        return mSceneNames.empty() ||
+               std::find(mSceneNames.begin(), mSceneNames.end(), name) != mSceneNames.end();
+    };
+    if (selected("vdb_volume")) {
+        writeVolume();
+    }
+    if (selected("textures")) {
+        writeTextures();
+    }
+
+    // The global driver is shared by all scenes, like it is by the frames of
+    // an interactive session.
+    {
+        rndr::RenderOptions driverOptions;
+        driverOptions.setThreads(mThreads);
+        if (!mExecMode.empty()) {
+            driverOptions.setDesiredExecutionMode(mExecMode);
+        }
+        rndr::initGlobalDriver(driverOptions);
+    }
+    mNumRenderThreads = mcrt_common::getNumTBBThreads();
+
+    std::vector<BenchResult> results;
+    for (const BenchScene& scene : sScenes) {
+        if (!selected(scene.mName)) {
+            continue;
+        }
+        Logger::info("Rendering benchmark scene '", scene.mName, "'");
+        results.push_back(render(scene));
+    }
+
+    rndr::cleanUpGlobalDriver();
+
+    if (mOutFile.empty()) {
+        writeResults(std::cout, results);
+    } else {
+        std::ofstream out(mOutFile);
+        writeResults(out, results);
+        if (!out) {
+            Logger::error("Failed to write benchmark results to ", mOutFile);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+} // namespace moonray
+
+int main(int argc, char* argv[])
+{
+    moonray::BenchApplication app;
+    try {
+        return app.main(argc, argv);
+    } catch (const std::exception& e) {
+        Logger::error(e.what());
+        std::exit(EXIT_FAILURE);
+    }
+}
+
@@ -9,6 +9,7 @@ using namespace scene_rdl2;
 RDL2_DSO_ATTR_DECLARE
 
     rdl2::AttributeKey<rdl2::Bool>      attrSampleUpperHemisphereOnly;
+    rdl2::AttributeKey<rdl2::Bool>      attrCosineProductSampling;
 
 RDL2_DSO_ATTR_DEFINE(rdl2::Light)
 
@@ -23,5 +24,15 @@ RDL2_DSO_ATTR_DEFINE(rdl2::Light)
     
     sceneClass.setGroup("Map", attrSampleUpperHemisphereOnly);
 
+    attrCosineProductSampling =
+        sceneClass.declareAttribute<rdl2::Bool>("cosine_product_sampling", true, { "cosine product sampling" });
+    sceneClass.setMetadata(attrCosineProductSampling, "label", "cosine product sampling");
+    sceneClass.setMetadata(attrCosineProductSampling, rdl2::SceneClass::sComment,
+        "When a texture is used, sample the EnvLight according to the texture times the cosine to the "
+        "surface normal rather than according to the texture alone. This reduces noise when the brightest "
+        "parts of the texture are below the horizon of many surfaces, at the cost of some memory and of a "
+        "precomputation when the texture changes.");
+    sceneClass.setGroup("Map", attrCosineProductSampling);
+
 RDL2_DSO_ATTR_END
 
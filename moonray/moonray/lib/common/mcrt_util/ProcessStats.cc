@@ -5,6 +5,8 @@
 
 #include "ProcessStats.h"
 
+#include <sstream>
+
 #include <unistd.h>
 
 namespace moonray {
@@ -82,6 +84,32 @@ ProcessStats::getProcessMemory() const
     return currentMemoryUsage;
 }
 
+int64
+ProcessStats::getPeakProcessMemory() const
+{
+    std::ifstream statusFile("/proc/self/status");
+    std::string line;
+    while (std::getline(statusFile, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            // reported in kB
+            std::istringstream in(line.substr(6));
+            int64 peakKb = 0;
+            in >> peakKb;
+            return peakKb * 1024;
+        }
+    }
+    return 0;
+}
+
+bool
+ProcessStats::resetPeakProcessMemory() const
+{
+    // writing 5 to clear_refs resets VmHWM to the current resident set size
+    std::ofstream clearRefsFile("/proc/self/clear_refs");
+    clearRefsFile << "5";
+    clearRefsFile.flush();
+    return clearRefsFile.good();
+}
 
 ProcessUtilization
 ProcessStats::getProcessUtilization() const
@@ -37,6 +37,13 @@ public:
 
     int64 getProcessMemory() const;
 
+    // Peak resident set size (VmHWM) in bytes, 0 if unavailable
+    int64 getPeakProcessMemory() const;
+
+    // Restart peak resident set size tracking from the current resident set
+    // size. Returns false if the kernel does not support it.
+    bool resetPeakProcessMemory() const;
+
     ProcessUtilization getProcessUtilization() const;
 
 
@@ -0,0 +1,227 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file MajorantGrid.cc
+///
+
+#include "MajorantGrid.h"
+
+#include <openvdb/math/BBox.h>
+
+namespace moonray {
+namespace geom {
+namespace internal {
+
+using namespace scene_rdl2::math;
+
+namespace {
+
+// POINT lookups round to the nearest voxel, so the voxels in bbox answer
+// lookups anywhere in [min - 0.5, max + 0.5] in index space. The footprint is
+// padded a little to absorb floating point error in the lookup position.
+template <typename GridType>
+openvdb::BBoxd
+indexFootprint(const GridType& grid, const openvdb::CoordBBox& bbox)
+{
+    constexpr double sHalfVoxel = 0.5 + 1e-3;
+    return grid.transform().indexToWorld(openvdb::BBoxd(
+        bbox.min().asVec3d() - openvdb::Vec3d(sHalfVoxel),
+        bbox.max().asVec3d() + openvdb::Vec3d(sHalfVoxel)));
+}
+
+// world space region in which lookups into grid can return anything other
+// than the background value. Inactive voxels are included since POINT
+// lookups don't check the active state. Inactive tiles above the leaf level
+// are assumed to hold the background value.
+template <typename GridType>
+openvdb::BBoxd
+gridFootprint(const GridType& grid)
+{
+    openvdb::CoordBBox bbox = grid.evalActiveVoxelBoundingBox();
+    openvdb::CoordBBox leafBBox;
+    if (grid.tree().evalLeafBoundingBox(leafBBox)) {
+        bbox.expand(leafBBox);
+    }
+    return indexFootprint(grid, bbox);
+}
+
+Color
+minColor(const Color& a, const Color& b)
+{
+    return Color(min(a.r, b.r), min(a.g, b.g), min(a.b, b.b));
+}
+
+Color
+maxColor(const Color& a, const Color& b)
+{
+    return Color(max(a.r, b.r), max(a.g, b.g), max(a.b, b.b));
+}
+
+// bounds of the product of the intervals [loA, hiA] and [loB, hiB]
+void
+productRange(float loA, float hiA, float loB, float hiB, float& lo, float& hi)
+{
+    const float p0 = loA * loB;
+    const float p1 = loA * hiB;
+    const float p2 = hiA * loB;
+    const float p3 = hiA * hiB;
+    lo = min(min(p0, p1), min(p2, p3));
+    hi = max(max(p0, p1), max(p2, p3));
+}
+
+} // anonymous namespace
+
+// range of values point lookups can return in a cell
+struct MajorantGrid::Range
+{
+    Color mLo;
+    Color mHi;
+    Color mSum;
+    float mCount;
+};
+
+MajorantGrid::MajorantGrid(const openvdb::FloatGrid& densityGrid,
+                           const openvdb::Vec3SGrid* bakedDensityGrid,
+                           const Color& densityColor):
+    mCells(nullptr),
+    mMemory(0)
+{
+    const Color densityBackground(densityGrid.background());
+    const Color bakedBackground = bakedDensityGrid ?
+        Color(bakedDensityGrid->background().x(),
+              bakedDensityGrid->background().y(),
+              bakedDensityGrid->background().z()) :
+        densityColor;
+    mExterior.mControl = densityBackground * bakedBackground;
+    mExterior.mResidualMajorant = 0.0f;
+
+    openvdb::BBoxd aabb = gridFootprint(densityGrid);
+    if (bakedDensityGrid) {
+        aabb.expand(gridFootprint(*bakedDensityGrid));
+    }
+    mAABB = BBox3f(Vec3f(aabb.min().x(), aabb.min().y(), aabb.min().z()),
+                   Vec3f(aabb.max().x(), aabb.max().y(), aabb.max().z()));
+    const Vec3f dim = mAABB.size();
+    // same resolution heuristic as DDAIntersector, but never finer than
+    // the density voxels since the extra cells can't tighten the bounds
+    const openvdb::Vec3d voxelSize = densityGrid.voxelSize();
+    float unitWidth = max(dim.x, max(dim.y, dim.z)) / sMaxResolution;
+    unitWidth = max(unitWidth, static_cast<float>(voxelSize.x()));
+    unitWidth = max(unitWidth, static_cast<float>(voxelSize.y()));
+    unitWidth = max(unitWidth, static_cast<float>(voxelSize.z()));
+    for (int axis = 0; axis < 3; ++axis) {
+        mRes[axis] = static_cast<int>(round(dim[axis] / unitWidth));
+        mRes[axis] = clamp(mRes[axis], 1, sMaxResolution);
+        mUnitWidth[axis] = dim[axis] / mRes[axis];
+        mInvUnitWidth[axis] = (mUnitWidth[axis] == 0.0f) ?
+            0.0f : 1.0f / mUnitWidth[axis];
+    }
+    const int nTotal = mRes[0] * mRes[1] * mRes[2];
+
+    // gather the density and baked density ranges separately, lookups
+    // anywhere in a cell can also hit the background value
+    std::unique_ptr<Range[]> densityRanges(new Range[nTotal]);
+    std::unique_ptr<Range[]> bakedRanges(new Range[nTotal]);
+    for (int i = 0; i < nTotal; ++i) {
+        densityRanges[i] = Range{densityBackground, densityBackground, Color(0.0f), 0.0f};
+        bakedRanges[i] = Range{bakedBackground, bakedBackground, Color(0.0f), 0.0f};
+    }
+    accumulateGrid(densityRanges, densityGrid,
+        [](float v) { return Color(v); });
+    if (bakedDensityGrid) {
+        accumulateGrid(bakedRanges, *bakedDensityGrid,
+            [](const openvdb::Vec3f& v) { return Color(v.x(), v.y(), v.z()); });
+    }
+
+    // sigmaT = density * bakedDensity. Any control value keeps residual
+    // ratio tracking unbiased, the cell mean just keeps the residual small.
+    mCells.reset(new Cell[nTotal]);
+    mMemory = nTotal * sizeof(Cell);
+    for (int i = 0; i < nTotal; ++i) {
+        const Range& d = densityRanges[i];
+        const Range& b = bakedRanges[i];
+        const Color densityMean = d.mCount > 0.0f ? d.mSum / d.mCount : densityBackground;
+        const Color bakedMean = b.mCount > 0.0f ? b.mSum / b.mCount : bakedBackground;
+        const Color control = densityMean * bakedMean;
+
+        float lo[3], hi[3];
+        productRange(d.mLo.r, d.mHi.r, b.mLo.r, b.mHi.r, lo[0], hi[0]);
+        productRange(d.mLo.g, d.mHi.g, b.mLo.g, b.mHi.g, lo[1], hi[1]);
+        productRange(d.mLo.b, d.mHi.b, b.mLo.b, b.mHi.b, lo[2], hi[2]);
+        const float c[3] = { control.r, control.g, control.b };
+        float residualMajorant = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            residualMajorant = max(residualMajorant, max(hi[k] - c[k], c[k] - lo[k]));
+        }
+        mCells[i].mControl = control;
+        mCells[i].mResidualMajorant = residualMajorant;
+    }
+}
+
+void
+MajorantGrid::accumulate(std::unique_ptr<Range[]>& ranges,
+                         const openvdb::BBoxd& footprint,
+                         const Color& lo, const Color& hi, const Color& mean) const
+{
+    const Vec3f pMin(footprint.min().x(), footprint.min().y(), footprint.min().z());
+    const Vec3f pMax(footprint.max().x(), footprint.max().y(), footprint.max().z());
+    int lower[3], upper[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        lower[axis] = gridIndex(pMin, axis);
+        upper[axis] = gridIndex(pMax, axis);
+    }
+    for (int z = lower[2]; z <= upper[2]; ++z) {
+        for (int y = lower[1]; y <= upper[1]; ++y) {
+            for (int x = lower[0]; x <= upper[0]; ++x) {
+                Range& r = ranges[offset(x, y, z)];
+                r.mLo = minColor(r.mLo, lo);
+                r.mHi = maxColor(r.mHi, hi);
+                r.mSum += mean;
+                r.mCount += 1.0f;
+            }
+        }
+    }
+}
+
+template <typename GridType, typename ToColor>
+void
+MajorantGrid::accumulateGrid(std::unique_ptr<Range[]>& ranges,
+                             const GridType& grid,
+                             ToColor toColor) const
+{
+    // Accumulate whole leaf nodes rather than single voxels. The bounds get
+    // a little looser but this keeps the build cheap on large grids.
+    for (auto leaf = grid.tree().cbeginLeaf(); leaf; ++leaf) {
+        Color lo(static_cast<float>(inf));
+        Color hi(static_cast<float>(neg_inf));
+        Color sum(0.0f);
+        float count = 0.0f;
+        for (auto it = leaf->cbeginValueAll(); it; ++it) {
+            const Color value = toColor(*it);
+            lo = minColor(lo, value);
+            hi = maxColor(hi, value);
+            sum += value;
+            count += 1.0f;
+        }
+        accumulate(ranges, indexFootprint(grid, leaf->getNodeBoundingBox()),
+                   lo, hi, sum / count);
+    }
+
+    // active tiles above the leaf level
+    auto tile = grid.tree().cbeginValueOn();
+    tile.setMaxDepth(tile.getLeafDepth() - 1);
+    for (; tile; ++tile) {
+        openvdb::CoordBBox bbox;
+        tile.getBoundingBox(bbox);
+        const Color value = toColor(*tile);
+        accumulate(ranges, indexFootprint(grid, bbox), value, value, value);
+    }
+}
+
+constexpr int MajorantGrid::sMaxResolution;
+
+} // namespace internal
+} // namespace geom
+} // namespace moonray
+
@@ -0,0 +1,193 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file MajorantGrid.h
+///
+
+#pragma once
+
+#include <moonray/rendering/geom/Types.h>
+
+#include <scene_rdl2/common/math/BBox.h>
+#include <scene_rdl2/common/math/Color.h>
+#include <scene_rdl2/common/platform/Platform.h>
+
+#include <openvdb/openvdb.h>
+#include <openvdb/Grid.h>
+
+#include <memory>
+#include <utility>
+
+namespace moonray {
+namespace geom {
+namespace internal {
+
+// A coarse uniform grid over a VdbVolume's density field, used by residual
+// ratio tracking. Each cell stores a control extinction (the mean sigmaT in
+// the cell) and a residual majorant that bounds |sigmaT - control| for every
+// point lookup that can land in the cell. The control part of the optical
+// thickness is integrated in closed form, and only the (usually small) residual
+// needs to be tracked stochastically, so smooth or sparse regions cost very few
+// density lookups.
+//
+// The grid lives in the vdb grid's world space, the same space the
+// VolumeSampleInfo sample ray is in. Bounds are computed from the voxel
+// footprints of the density grid and the baked volume shader density grid,
+// which matches the POINT interpolation VdbVolume::evalDensity uses.
+// Velocity advected lookups are not bounded by this grid.
+class MajorantGrid
+{
+public:
+    struct Cell
+    {
+        scene_rdl2::math::Color mControl;
+        float mResidualMajorant;
+    };
+
+    // bakedDensityGrid may be null, in which case the density grid is
+    // scaled by the uniform densityColor
+    MajorantGrid(const openvdb::FloatGrid& densityGrid,
+                 const openvdb::Vec3SGrid* bakedDensityGrid,
+                 const scene_rdl2::math::Color& densityColor);
+
+    // Walk the segment org + t * dir, t in [t0, t1] and call
+    // func(ta, tb, cell) for each piece of the segment in front to back order.
+    // Pieces of the segment outside the grid bounds are reported with the
+    // exterior cell, which holds the (constant) background extinction.
+    // The traversal stops early if func returns false.
+    template <typename F>
+    void traverse(const Vec3f& org, const Vec3f& dir, float t0, float t1, F&& func) const
+    {
+        // clip the segment against the grid bounding box
+        float tStart = t0;
+        float tEnd = t1;
+        for (int axis = 0; axis < 3; ++axis) {
+            // see DDAIntersector::intersect for the reliance on IEEE inf here
+            const float invDir = 1.0f / dir[axis];
+            float tNear = (mAABB.lower[axis] - org[axis]) * invDir;
+            float tFar  = (mAABB.upper[axis] - org[axis]) * invDir;
+            if (tNear > tFar) {
+                std::swap(tNear, tFar);
+            }
+            tStart = tNear > tStart ? tNear : tStart;
+            tEnd = tFar < tEnd ? tFar : tEnd;
+        }
+        // the segment doesn't overlap the grid
+        if (!(tStart < tEnd)) {
+            func(t0, t1, mExterior);
+            return;
+        }
+        if (tStart > t0 && !func(t0, tStart, mExterior)) {
+            return;
+        }
+
+        // For detail reference see
+        // "A Fast Voxel Traversal Algorithm for Ray Tracing"
+        // John Amanatides and Andrew Woo
+        const Vec3f pStart = org + tStart * dir;
+        float nextT[3];
+        float deltaT[3];
+        int step[3];
+        int out[3];
+        int pos[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            pos[axis] = gridIndex(pStart, axis);
+            if (dir[axis] > 0.0f) {
+                nextT[axis] = tStart + (gridPosition(pos[axis] + 1, axis) - pStart[axis]) / dir[axis];
+                deltaT[axis] = mUnitWidth[axis] / dir[axis];
+                step[axis] = 1;
+                out[axis] = mRes[axis];
+            } else if (dir[axis] < 0.0f) {
+                nextT[axis] = tStart + (gridPosition(pos[axis], axis) - pStart[axis]) / dir[axis];
+                deltaT[axis] = -mUnitWidth[axis] / dir[axis];
+                step[axis] = -1;
+                out[axis] = -1;
+            } else {
+                nextT[axis] = scene_rdl2::math::inf;
+                deltaT[axis] = scene_rdl2::math::inf;
+                step[axis] = 0;
+                out[axis] = -1;
+            }
+        }
+        float tCurrent = tStart;
+        while (true) {
+            // the axis with the smallest nextT, see DDAIntersector::intersect
+            const int stepAxis =
+                ((nextT[1] < nextT[0]) | (nextT[2] < nextT[0])) <<
+                (nextT[2] < nextT[1]);
+            const float tNext = scene_rdl2::math::min(nextT[stepAxis], tEnd);
+            if (tNext > tCurrent &&
+                !func(tCurrent, tNext, mCells[offset(pos[0], pos[1], pos[2])])) {
+                return;
+            }
+            tCurrent = tNext;
+            if (tCurrent >= tEnd) {
+                break;
+            }
+            pos[stepAxis] += step[stepAxis];
+            if (pos[stepAxis] == out[stepAxis]) {
+                break;
+            }
+            nextT[stepAxis] += deltaT[stepAxis];
+        }
+
+        // tCurrent can fall slightly short of tEnd when floating point error
+        // steps the ray out of the grid early
+        if (tCurrent < t1) {
+            func(tCurrent, t1, mExterior);
+        }
+    }
+
+    size_t getMemory() const
+    {
+        return sizeof(MajorantGrid) + mMemory;
+    }
+
+private:
+    struct Range;
+
+    void accumulate(std::unique_ptr<Range[]>& ranges,
+                    const openvdb::BBoxd& footprint,
+                    const scene_rdl2::math::Color& lo,
+                    const scene_rdl2::math::Color& hi,
+                    const scene_rdl2::math::Color& mean) const;
+
+    template <typename GridType, typename ToColor>
+    void accumulateGrid(std::unique_ptr<Range[]>& ranges,
+                        const GridType& grid,
+                        ToColor toColor) const;
+
+    int gridIndex(const Vec3f& p, int axis) const
+    {
+        int index = static_cast<int>(scene_rdl2::math::floor(
+            (p[axis] - mAABB.lower[axis]) * mInvUnitWidth[axis]));
+        return scene_rdl2::math::clamp(index, 0, mRes[axis] - 1);
+    }
+
+    float gridPosition(int index, int axis) const
+    {
+        return mAABB.lower[axis] + index * mUnitWidth[axis];
+    }
+
+    finline int offset(int x, int y, int z) const
+    {
+        return (z * mRes[1]  + y) * mRes[0] + x;
+    }
+
+    BBox3f mAABB;
+    int mRes[3];
+    Vec3f mUnitWidth;
+    Vec3f mInvUnitWidth;
+    std::unique_ptr<Cell []> mCells;
+    Cell mExterior;
+    static constexpr int sMaxResolution = 64;
+
+    // Allocated memory for the mCells grid
+    size_t mMemory;
+};
+
+} // namespace internal
+} // namespace geom
+} // namespace moonray
+
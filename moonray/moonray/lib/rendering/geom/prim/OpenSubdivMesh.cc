@@ -9,6 +9,7 @@
 
 #include <moonray/rendering/geom/prim/GeomTLState.h>
 #include <moonray/rendering/geom/prim/MeshTessellationUtil.h>
+#include <moonray/rendering/geom/prim/TessellationCache.h>
 #include <moonray/rendering/geom/prim/Util.h>
 
 #include <moonray/rendering/bvh/shading/Attributes.h>
@@ -2083,6 +2084,22 @@ OpenSubdivMesh::tessellate(const TessellationParams& tessellationParams)
         computeSubdTessellationFactor(pRdlLayer, tessellationParams.mFrustums,
             tessellationParams.mEnableDisplacement, noTessellation);
 
+    // Without displacement the tessellated mesh is fully determined by the
+    // control mesh, its attributes and the tessellation factors, so it can
+    // come from the on-disk cache
+    TessellationCache* tessellationCache =
+        (tessellationParams.mEnableDisplacement && hasDisplacementAssignment(pRdlLayer)) ?
+        nullptr : tessellationParams.mTessellationCache;
+    std::string tessellationCacheKey;
+    if (tessellationCache) {
+        tessellationCacheKey = computeTessellationCacheKey(pRdlLayer,
+            tessellationFactors, noTessellation);
+        if (loadTessellation(*tessellationCache, tessellationCacheKey)) {
+            finishTessellation(tessellationParams);
+            return;
+        }
+    }
+
     // analyze control faces and generate quadTopologies, which are used
     // for generating tessellated vertices and indices later
 
@@ -2241,11 +2258,7 @@ OpenSubdivMesh::tessellate(const TessellationParams& tessellationParams)
         mSurfaceSt, mSurfaceDpds, mSurfaceDpdt, displacementFootprints,
         hasBadDerivatives, requireUniformFix, motionSampleCount);
     if (hasBadDerivatives) {
-        const scene_rdl2::rdl2::Geometry* pRdlGeometry = getRdlGeometry();
-        MNRY_ASSERT(pRdlGeometry != nullptr);
-        pRdlGeometry->debug("mesh ", getName(),
-            " contains bad derivatives that may cause incorrect"
-            " rendering result");
+        reportBadDerivatives();
     }
     // tessellate primitive attributes
     Attributes* primitiveAttributes = getAttributes();
@@ -2274,6 +2287,29 @@ OpenSubdivMesh::tessellate(const TessellationParams& tessellationParams)
             tessellationParams.mWorld2Render);
     }
 
+    if (tessellationCache) {
+        storeTessellation(*tessellationCache, tessellationCacheKey, hasBadDerivatives);
+    }
+
+    delete refiner;
+    delete patchTable;
+
+    finishTessellation(tessellationParams);
+}
+
+void
+OpenSubdivMesh::reportBadDerivatives() const
+{
+    const scene_rdl2::rdl2::Geometry* pRdlGeometry = getRdlGeometry();
+    MNRY_ASSERT(pRdlGeometry != nullptr);
+    pRdlGeometry->debug("mesh ", getName(),
+        " contains bad derivatives that may cause incorrect"
+        " rendering result");
+}
+
+void
+OpenSubdivMesh::finishTessellation(const TessellationParams& tessellationParams)
+{
     // For the baked volume shader grid, we want to set the transform
     // to world2render if the primitive is shared.
     if (getIsReference()) {
@@ -2285,12 +2321,221 @@ OpenSubdivMesh::tessellate(const TessellationParams& tessellationParams)
     if (!tessellationParams.mFastGeomUpdate && !tessellationParams.mIsBaking) {
         mControlMeshData.reset();
     }
-    delete refiner;
-    delete patchTable;
 
     mIsMeshFinalized = true;
 }
 
+std::string
+OpenSubdivMesh::computeTessellationCacheKey(const scene_rdl2::rdl2::Layer* pRdlLayer,
+        const std::vector<SubdTessellationFactor>& tessellationFactors,
+        bool noTessellation) const
+{
+    // everything read by tessellate() between here and the limit surface /
+    // attribute evaluation, after the attributes have been interleaved,
+    // transformed and reversed
+    TessellationCache::Hasher hasher;
+    const ControlMeshData& data = *mControlMeshData;
+    hasher.add(data.mScheme);
+    hasher.add(data.mBoundaryInterpolation);
+    hasher.add(data.mFVarLinearInterpolation);
+    hasher.add(data.mFaceVertexCount);
+    hasher.add(data.mIndices);
+    // only x, y, z : the w lane of Vec3fa is not meaningful
+    const size_t vertexTimeSteps = data.mVertices.get_time_steps();
+    hasher.add(static_cast<uint64_t>(data.mVertices.size()));
+    hasher.add(static_cast<uint64_t>(vertexTimeSteps));
+    for (size_t v = 0; v < data.mVertices.size(); ++v) {
+        for (size_t t = 0; t < vertexTimeSteps; ++t) {
+            const Vec3fa& p = data.mVertices(v, t);
+            hasher.add(p.x);
+            hasher.add(p.y);
+            hasher.add(p.z);
+        }
+    }
+    hasher.add(data.mTextureRate);
+    hasher.add(data.mTextureVertices);
+    hasher.add(data.mTextureIndices);
+    hasher.add(data.mCreaseSharpness);
+    hasher.add(data.mCreaseIndices);
+    hasher.add(data.mCornerSharpness);
+    hasher.add(data.mCornerIndices);
+    hasher.add(data.mHoleIndices);
+    hasher.add(noTessellation);
+    // edge factors, in the order computeSubdTessellationFactor() produces
+    // them : one factor per regular quad, using both half edges of every
+    // edge, and one per quadrangulated n-gon corner, using mEdge0Factor only
+    hasher.add(static_cast<uint64_t>(tessellationFactors.size()));
+    size_t factorIndex = 0;
+    for (size_t f = 0; f < data.mFaceVertexCount.size(); ++f) {
+        const int nFv = data.mFaceVertexCount[f];
+        const bool isQuad = nFv == sQuadVertexCount;
+        const int quadCount = isQuad ? 1 : nFv;
+        for (int q = 0; q < quadCount && factorIndex < tessellationFactors.size(); ++q) {
+            const SubdTessellationFactor& factor = tessellationFactors[factorIndex++];
+            for (size_t e = 0; e < sQuadVertexCount; ++e) {
+                hasher.add(factor.mEdge0Factor[e]);
+                if (isQuad) {
+                    hasher.add(factor.mEdge1Factor[e]);
+                }
+            }
+        }
+    }
+
+    // faces without a material or volume shader are not tessellated
+    for (size_t f = 0; f < data.mFaceVertexCount.size(); ++f) {
+        const int assignmentId = getControlFaceAssignmentId(f);
+        const bool hasAssignment = assignmentId != -1 &&
+            (pRdlLayer->lookupMaterial(assignmentId) != nullptr ||
+             pRdlLayer->lookupVolumeShader(assignmentId) != nullptr);
+        hasher.add(hasAssignment);
+    }
+
+    // varying and vertex rate attributes are tessellated float by float,
+    // so only their stride and values matter
+    Attributes* primitiveAttributes = getAttributes();
+    const size_t controlVertexCount = data.mVertices.size();
+    if (primitiveAttributes->hasVaryingAttributes()) {
+        const size_t stride = primitiveAttributes->getVaryingAttributesStride();
+        hasher.add(stride);
+        hasher.add(primitiveAttributes->getVaryingAttributesData(), controlVertexCount * stride);
+    }
+    if (primitiveAttributes->hasVertexAttributes()) {
+        const size_t stride = primitiveAttributes->getVertexAttributesStride();
+        hasher.add(stride);
+        hasher.add(primitiveAttributes->getVertexAttributesData(), controlVertexCount * stride);
+    }
+    for (const auto& key : mFaceVaryingAttributes->getAllKeys()) {
+        const auto& attributeBuffer = mFaceVaryingAttributes->getAttributeBuffer(key);
+        hasher.add(std::string(key.getName()));
+        hasher.add(attributeBuffer.mFloatPerVertex);
+        hasher.add(attributeBuffer.mChannel);
+        hasher.add(attributeBuffer.mData);
+        hasher.add(attributeBuffer.mIndices);
+    }
+    return hasher.getKey();
+}
+
+bool
+OpenSubdivMesh::loadTessellation(TessellationCache& cache, const std::string& key)
+{
+    std::unique_ptr<TessellationCache::Reader> reader = cache.load(key);
+    if (!reader) {
+        return false;
+    }
+
+    // read everything before touching the mesh, so a bad entry leaves
+    // it ready for regular tessellation
+    SubdivisionMesh::VertexBuffer vertices;
+    SubdivisionMesh::IndexBuffer indices;
+    VertexBuffer<Vec3f, InterleavedTraits> surfaceNormal;
+    VertexBuffer<Vec2f, InterleavedTraits> surfaceSt;
+    VertexBuffer<Vec3f, InterleavedTraits> surfaceDpds;
+    VertexBuffer<Vec3f, InterleavedTraits> surfaceDpdt;
+    std::vector<int> tessellatedToControlFace;
+    std::vector<float> varyingData;
+    std::vector<float> vertexData;
+    uint8_t hasBadDerivatives = 0;
+    bool valid = reader->read(&hasBadDerivatives, sizeof(hasBadDerivatives)) &&
+        reader->read(vertices) &&
+        reader->read(indices) &&
+        reader->read(surfaceNormal) &&
+        reader->read(surfaceSt) &&
+        reader->read(surfaceDpds) &&
+        reader->read(surfaceDpdt) &&
+        reader->read(tessellatedToControlFace) &&
+        reader->read(varyingData) &&
+        reader->read(vertexData);
+
+    const std::vector<AttributeKey> fvarKeys = mFaceVaryingAttributes->getAllKeys();
+    std::vector<std::vector<float>> fvarData(fvarKeys.size());
+    std::vector<SubdivisionMesh::IndexBuffer> fvarIndices(fvarKeys.size());
+    for (size_t i = 0; valid && i < fvarKeys.size(); ++i) {
+        valid = reader->read(fvarData[i]) && reader->read(fvarIndices[i]);
+    }
+
+    Attributes* primitiveAttributes = getAttributes();
+    const size_t vertexCount = vertices.size();
+    if (valid && primitiveAttributes->hasVaryingAttributes()) {
+        valid = varyingData.size() * sizeof(float) ==
+            vertexCount * primitiveAttributes->getVaryingAttributesStride();
+    }
+    if (valid && primitiveAttributes->hasVertexAttributes()) {
+        valid = vertexData.size() * sizeof(float) ==
+            vertexCount * primitiveAttributes->getVertexAttributesStride();
+    }
+    if (!valid) {
+        cache.rejected();
+        return false;
+    }
+
+    mTessellatedVertices = std::move(vertices);
+    mTessellatedIndices = std::move(indices);
+    mSurfaceNormal = std::move(surfaceNormal);
+    mSurfaceSt = std::move(surfaceSt);
+    mSurfaceDpds = std::move(surfaceDpds);
+    mSurfaceDpdt = std::move(surfaceDpdt);
+    mTessellatedToControlFace = std::move(tessellatedToControlFace);
+    if (primitiveAttributes->hasVaryingAttributes()) {
+        primitiveAttributes->resizeVaryingAttributes(vertexCount);
+        std::memcpy(primitiveAttributes->getVaryingAttributesData(), varyingData.data(),
+            varyingData.size() * sizeof(float));
+    }
+    if (primitiveAttributes->hasVertexAttributes()) {
+        primitiveAttributes->resizeVertexAttributes(vertexCount);
+        std::memcpy(primitiveAttributes->getVertexAttributesData(), vertexData.data(),
+            vertexData.size() * sizeof(float));
+    }
+    for (size_t i = 0; i < fvarKeys.size(); ++i) {
+        auto& attributeBuffer = mFaceVaryingAttributes->getAttributeBuffer(fvarKeys[i]);
+        attributeBuffer.mData.swap(fvarData[i]);
+        attributeBuffer.mIndices.swap(fvarIndices[i]);
+    }
+    // the warning of the original tessellation still applies
+    if (hasBadDerivatives) {
+        reportBadDerivatives();
+    }
+    return true;
+}
+
+void
+OpenSubdivMesh::storeTessellation(TessellationCache& cache, const std::string& key,
+        bool hasBadDerivatives) const
+{
+    // the blob order here has to match loadTessellation
+    cache.store(key, [&](TessellationCache::Writer& writer) {
+        const uint8_t badDerivatives = hasBadDerivatives ? 1 : 0;
+        writer.write(&badDerivatives, sizeof(badDerivatives));
+        writer.write(mTessellatedVertices);
+        writer.write(mTessellatedIndices);
+        writer.write(mSurfaceNormal);
+        writer.write(mSurfaceSt);
+        writer.write(mSurfaceDpds);
+        writer.write(mSurfaceDpdt);
+        writer.write(mTessellatedToControlFace);
+
+        Attributes* primitiveAttributes = getAttributes();
+        const size_t vertexCount = mTessellatedVertices.size();
+        if (primitiveAttributes->hasVaryingAttributes()) {
+            writer.write(primitiveAttributes->getVaryingAttributesData(),
+                vertexCount * primitiveAttributes->getVaryingAttributesStride());
+        } else {
+            writer.write(nullptr, 0);
+        }
+        if (primitiveAttributes->hasVertexAttributes()) {
+            writer.write(primitiveAttributes->getVertexAttributesData(),
+                vertexCount * primitiveAttributes->getVertexAttributesStride());
+        } else {
+            writer.write(nullptr, 0);
+        }
+
+        for (const auto& fvarKey : mFaceVaryingAttributes->getAllKeys()) {
+            const auto& attributeBuffer = mFaceVaryingAttributes->getAttributeBuffer(fvarKey);
+            writer.write(attributeBuffer.mData);
+            writer.write(attributeBuffer.mIndices);
+        }
+    });
+}
+
 void
 OpenSubdivMesh::getTessellatedMesh(TessellatedMesh& tessMesh) const
 {
@@ -31,6 +31,7 @@ class ControlMeshData;
 class SubdTessellatedVertexLookup;
 class SubdTopologyIdLookup;
 class FaceVaryingAttributes;
+class TessellationCache;
 
 class OpenSubdivMesh : public SubdMesh
 {
@@ -177,6 +178,23 @@ private:
             size_t vid1, size_t vid2, size_t vid3, float time,
             shading::Intersection& intersection) const;
 
+    // setup shared by regular and cached tessellation once the
+    // tessellated buffers are in place
+    void finishTessellation(const TessellationParams& tessellationParams);
+
+    std::string computeTessellationCacheKey(const scene_rdl2::rdl2::Layer* pRdlLayer,
+            const std::vector<SubdTessellationFactor>& tessellationFactors,
+            bool noTessellation) const;
+
+    // returns false (and leaves the mesh untouched) if there is no usable
+    // cache entry for key
+    bool loadTessellation(TessellationCache& cache, const std::string& key);
+
+    void storeTessellation(TessellationCache& cache, const std::string& key,
+            bool hasBadDerivatives) const;
+
+    void reportBadDerivatives() const;
+
     void displaceMesh(const scene_rdl2::rdl2::Layer *pRdlLayer,
             const std::vector<LimitSurfaceSample>& limitSurfaceSamples,
             const std::vector<DisplacementFootprint>& displacementFootprints,
@@ -53,6 +53,8 @@ struct MotionBlurParams;
 
 namespace internal {
 
+class MajorantGrid;
+class TessellationCache;
 class VolumeAssignmentTable;
 class VolumeSampleInfo;
 
@@ -64,13 +66,15 @@ struct TessellationParams {
         bool enableDisplacement,
         bool fastGeomUpdate,
         bool isBaking,
-        const VolumeAssignmentTable* volumeAssignmentTable) :
+        const VolumeAssignmentTable* volumeAssignmentTable,
+        TessellationCache* tessellationCache = nullptr) :
             mRdlLayer(rdlLayer), mFrustums(frustums),
             mWorld2Render(world2render),
             mEnableDisplacement(enableDisplacement),
             mFastGeomUpdate(fastGeomUpdate),
             mIsBaking(isBaking),
-            mVolumeAssignmentTable(volumeAssignmentTable) {}
+            mVolumeAssignmentTable(volumeAssignmentTable),
+            mTessellationCache(tessellationCache) {}
 
     const scene_rdl2::rdl2::Layer *mRdlLayer;
     const std::vector<mcrt_common::Frustum>& mFrustums;
@@ -79,6 +83,8 @@ struct TessellationParams {
     bool mFastGeomUpdate;
     bool mIsBaking;
     const VolumeAssignmentTable* mVolumeAssignmentTable;
+    // optional on-disk cache of tessellation results, see TessellationCache
+    TessellationCache* mTessellationCache;
 };
 
 /// @brief A Primitive is the actual geometry to be rendered.
@@ -354,6 +360,13 @@ public:
         return scene_rdl2::math::Color(1.0f);
     }
 
+    // Coarse bounds of the extinction returned by evalDensity, used for residual
+    // ratio tracking. Returns nullptr when the primitive doesn't provide them.
+    virtual const MajorantGrid* getMajorantGrid() const
+    {
+        return nullptr;
+    }
+
 protected:
     std::unique_ptr<BVHHandle> mBVHHandle;
     const scene_rdl2::rdl2::Geometry* mRdlGeometry;
@@ -0,0 +1,236 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TessellationCache.cc
+///
+
+#include "TessellationCache.h"
+
+#include <scene_rdl2/common/platform/Platform.h>
+#include <scene_rdl2/render/logging/logging.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace moonray {
+namespace geom {
+namespace internal {
+
+namespace {
+
+// File layout: sMagic, TessellationCache::sVersion, then blobs. Each blob is
+// a uint64_t byte size followed by the bytes, padded to 8 byte alignment so
+// the mapped blobs stay aligned for the copies back into the primitive.
+constexpr uint32_t sMagic = 0x4354524d; // "MRTC"
+constexpr size_t sHeaderSize = 2 * sizeof(uint32_t);
+
+size_t
+paddedSize(size_t size)
+{
+    return (size + 7) & ~size_t(7);
+}
+
+finline uint64_t
+rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+// splitmix64 finalizer
+finline uint64_t
+avalanche(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+}
+
+} // anonymous namespace
+
+constexpr uint32_t TessellationCache::sVersion;
+
+TessellationCache::Hasher::Hasher() :
+    mH0(0x6a09e667f3bcc908ull),
+    mH1(0xbb67ae8584caa73bull),
+    mLength(0)
+{
+    add(sVersion);
+}
+
+void
+TessellationCache::Hasher::add(const void* data, size_t size)
+{
+    // Two independently mixed 64 bit lanes, one 8 byte word at a time. The
+    // inputs are mostly large float buffers so this needs to be fast rather
+    // than cryptographically strong.
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t w;
+        std::memcpy(&w, bytes + i, sizeof(uint64_t));
+        mH0 = rotl(mH0 ^ (w * 0x87c37b91114253d5ull), 31) * 0x9e3779b97f4a7c15ull;
+        mH1 = rotl(mH1 ^ (w * 0x4cf5ad432745937full), 29) * 0xc2b2ae3d27d4eb4full;
+    }
+    if (i < size) {
+        uint64_t w = 0;
+        std::memcpy(&w, bytes + i, size - i);
+        mH0 = rotl(mH0 ^ (w * 0x87c37b91114253d5ull), 31) * 0x9e3779b97f4a7c15ull;
+        mH1 = rotl(mH1 ^ (w * 0x4cf5ad432745937full), 29) * 0xc2b2ae3d27d4eb4full;
+    }
+    mLength += size;
+}
+
+std::string
+TessellationCache::Hasher::getKey() const
+{
+    const uint64_t h0 = avalanche(mH0 ^ mLength);
+    const uint64_t h1 = avalanche(mH1 ^ rotl(mLength, 32) ^ h0);
+    std::ostringstream key;
+    key << std::hex << std::setfill('0') << std::setw(16) << h0 << std::setw(16) << h1;
+    return key.str();
+}
+
+TessellationCache::Writer::Writer(const std::string& path) :
+    mStream(path, std::ios::binary | std::ios::trunc)
+{
+    const uint32_t header[2] = { sMagic, sVersion };
+    mStream.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+void
+TessellationCache::Writer::write(const void* data, size_t size)
+{
+    static const char sPadding[8] = {};
+    const uint64_t blobSize = size;
+    mStream.write(reinterpret_cast<const char*>(&blobSize), sizeof(blobSize));
+    if (size > 0) {
+        mStream.write(static_cast<const char*>(data), size);
+    }
+    mStream.write(sPadding, paddedSize(size) - size);
+}
+
+TessellationCache::Reader::Reader(const uint8_t* data, size_t size) :
+    mData(data),
+    mSize(size),
+    mOffset(sHeaderSize)
+{
+}
+
+TessellationCache::Reader::~Reader()
+{
+    munmap(const_cast<uint8_t*>(mData), mSize);
+}
+
+size_t
+TessellationCache::Reader::peekSize() const
+{
+    if (mOffset + sizeof(uint64_t) > mSize) {
+        return 0;
+    }
+    uint64_t blobSize;
+    std::memcpy(&blobSize, mData + mOffset, sizeof(blobSize));
+    return blobSize;
+}
+
+bool
+TessellationCache::Reader::read(void* data, size_t size)
+{
+    if (mOffset + sizeof(uint64_t) > mSize || peekSize() != size) {
+        return false;
+    }
+    const size_t begin = mOffset + sizeof(uint64_t);
+    if (paddedSize(size) > mSize - begin) {
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(data, mData + begin, size);
+    }
+    mOffset = begin + paddedSize(size);
+    return true;
+}
+
+TessellationCache::TessellationCache(const std::string& directory) :
+    mDirectory(directory),
+    mHits(0),
+    mMisses(0),
+    mStores(0)
+{
+    if (mkdir(mDirectory.c_str(), 0777) != 0 && errno != EEXIST) {
+        scene_rdl2::logging::Logger::warn("Unable to create tessellation cache directory ",
+            mDirectory);
+    }
+}
+
+std::unique_ptr<TessellationCache::Reader>
+TessellationCache::load(const std::string& key)
+{
+    const std::string path = getPath(key);
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ++mMisses;
+        return nullptr;
+    }
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sHeaderSize) {
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+    if (data == MAP_FAILED) {
+        ++mMisses;
+        return nullptr;
+    }
+    std::unique_ptr<Reader> reader(new Reader(static_cast<const uint8_t*>(data), st.st_size));
+
+    uint32_t header[2];
+    std::memcpy(header, data, sizeof(header));
+    if (header[0] != sMagic || header[1] != sVersion) {
+        ++mMisses;
+        return nullptr;
+    }
+    ++mHits;
+    return reader;
+}
+
+std::string
+TessellationCache::getPath(const std::string& key) const
+{
+    return mDirectory + "/" + key + ".tess";
+}
+
+std::string
+TessellationCache::getTemporaryPath(const std::string& key) const
+{
+    std::ostringstream path;
+    path << getPath(key) << ".tmp." << getpid() << "." << std::this_thread::get_id();
+    return path.str();
+}
+
+void
+TessellationCache::commit(const std::string& tmpPath, const std::string& key)
+{
+    // rename is atomic, concurrent readers see either no entry or the whole one
+    if (std::rename(tmpPath.c_str(), getPath(key).c_str()) == 0) {
+        ++mStores;
+    } else {
+        std::remove(tmpPath.c_str());
+    }
+}
+
+} // namespace internal
+} // namespace geom
+} // namespace moonray
+
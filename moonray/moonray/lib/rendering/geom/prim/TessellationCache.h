@@ -0,0 +1,213 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TessellationCache.h
+///
+
+#pragma once
+
+#include <moonray/rendering/geom/VertexBuffer.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace moonray {
+namespace geom {
+namespace internal {
+
+// An opt-in on-disk cache of tessellation results. Primitives hash everything
+// that goes into their tessellation (control mesh, attributes, tessellation
+// factors, ...) into a key and store the tessellated buffers in a file named
+// after that key in the cache directory. Later renders of the unchanged
+// primitive map the file and copy the buffers back instead of tessellating.
+//
+// The cache does not know what a primitive stores, it only deals with a
+// sequence of sized blobs. Entries are never invalidated: a change of any
+// input changes the key. Entries are written to a temporary file and renamed
+// into place, so several renders can share a cache directory.
+class TessellationCache
+{
+public:
+    // Bumped whenever the layout of any primitive's cache entry, or the
+    // tessellation algorithm producing it, changes.
+    static constexpr uint32_t sVersion = 2;
+
+    class Hasher
+    {
+    public:
+        Hasher();
+
+        void add(const void* data, size_t size);
+
+        template <typename T>
+        void add(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                "only trivially copyable values can be hashed");
+            add(&value, sizeof(T));
+        }
+
+        template <typename T, typename A>
+        void add(const std::vector<T, A>& v)
+        {
+            add(static_cast<uint64_t>(v.size()));
+            add(v.data(), v.size() * sizeof(T));
+        }
+
+        void add(const std::string& s)
+        {
+            add(static_cast<uint64_t>(s.size()));
+            add(s.data(), s.size());
+        }
+
+        template <typename T, template <typename, typename> class Traits, typename A>
+        void add(const VertexBuffer<T, Traits, A>& v)
+        {
+            add(static_cast<uint64_t>(v.size()));
+            add(static_cast<uint64_t>(v.get_time_steps()));
+            add(v.data(), v.data_size() * sizeof(float));
+        }
+
+        // 128 bit key as a hex string
+        std::string getKey() const;
+
+    private:
+        uint64_t mH0;
+        uint64_t mH1;
+        uint64_t mLength;
+    };
+
+    // Writes the blobs of one cache entry, see TessellationCache::store()
+    class Writer
+    {
+    public:
+        void write(const void* data, size_t size);
+
+        template <typename T, typename A>
+        void write(const std::vector<T, A>& v)
+        {
+            write(v.data(), v.size() * sizeof(T));
+        }
+
+        template <typename T, template <typename, typename> class Traits, typename A>
+        void write(const VertexBuffer<T, Traits, A>& v)
+        {
+            const uint64_t shape[2] = { v.size(), v.get_time_steps() };
+            write(shape, sizeof(shape));
+            write(v.data(), v.data_size() * sizeof(float));
+        }
+
+    private:
+        friend class TessellationCache;
+        explicit Writer(const std::string& path);
+
+        std::ofstream mStream;
+    };
+
+    // Reads back the blobs of a cache entry in the order they were written.
+    // Every read checks the stored blob size, a mismatch (or a truncated
+    // file) fails the read and the caller should tessellate instead.
+    class Reader
+    {
+    public:
+        ~Reader();
+
+        // size of the next blob, 0 if there is none
+        size_t peekSize() const;
+
+        bool read(void* data, size_t size);
+
+        template <typename T, typename A>
+        bool read(std::vector<T, A>& v)
+        {
+            const size_t size = peekSize();
+            if (size % sizeof(T) != 0) {
+                return false;
+            }
+            v.resize(size / sizeof(T));
+            return read(v.data(), size);
+        }
+
+        template <typename T, template <typename, typename> class Traits, typename A>
+        bool read(VertexBuffer<T, Traits, A>& v)
+        {
+            uint64_t shape[2];
+            if (!read(shape, sizeof(shape)) || shape[1] == 0) {
+                return false;
+            }
+            using Buffer = VertexBuffer<T, Traits, A>;
+            Buffer result(static_cast<typename Buffer::size_type>(shape[0]),
+                          static_cast<typename Buffer::size_type>(shape[1]));
+            if (!read(result.data(), result.data_size() * sizeof(float))) {
+                return false;
+            }
+            v = std::move(result);
+            return true;
+        }
+
+    private:
+        friend class TessellationCache;
+        Reader(const uint8_t* data, size_t size);
+
+        const uint8_t* mData;
+        size_t mSize;
+        size_t mOffset;
+    };
+
+    explicit TessellationCache(const std::string& directory);
+
+    const std::string& getDirectory() const { return mDirectory; }
+
+    // Maps the entry for key, nullptr if there is none
+    std::unique_ptr<Reader> load(const std::string& key);
+
+    // func(Writer&) writes the blobs of the entry for key
+    template <typename F>
+    void store(const std::string& key, F&& func)
+    {
+        const std::string tmpPath = getTemporaryPath(key);
+        {
+            Writer writer(tmpPath);
+            if (!writer.mStream) {
+                return;
+            }
+            func(writer);
+            writer.mStream.flush();
+            if (!writer.mStream) {
+                std::remove(tmpPath.c_str());
+                return;
+            }
+        }
+        commit(tmpPath, key);
+    }
+
+    // A cached entry failed to load, count it as a miss
+    void rejected() { --mHits; ++mMisses; }
+
+    size_t getHitCount() const { return mHits; }
+    size_t getMissCount() const { return mMisses; }
+    size_t getStoreCount() const { return mStores; }
+
+private:
+    std::string getPath(const std::string& key) const;
+    std::string getTemporaryPath(const std::string& key) const;
+    void commit(const std::string& tmpPath, const std::string& key);
+
+    std::string mDirectory;
+    std::atomic<size_t> mHits;
+    std::atomic<size_t> mMisses;
+    std::atomic<size_t> mStores;
+};
+
+} // namespace internal
+} // namespace geom
+} // namespace moonray
+
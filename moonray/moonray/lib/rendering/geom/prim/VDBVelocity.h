@@ -52,6 +52,12 @@ public:
         mTShutterRange = tShutterRange;
     }
 
+    // whether getEvalPosition advects the sample position
+    bool isMotionBlurOn() const
+    {
+        return mIsMotionBlurOn;
+    }
+
     void getShutterOpenAndClose(float& shutterOpen, float& shutterClose)
     {
         shutterOpen = mTShutterOpen;
@@ -65,11 +65,10 @@ getGridLuminance(const VDBSampler<openvdb::VectorGrid>& emissionSampler,
 // 1. create a render space bounding box to enclose the VDB grid
 // 2. do 3D DDA traversal ourselves during ray tracing
 //
-// TODO currently we use coarser resolution grid to record whether
-// a particular grid entry contains any active voxel
-// This grid can be further used to store meta data like maximum/minimum sigmaT
-// in the grid entry, which will be helpful for other advanced volume rendering
-// techniques like residual/ratio tracking and decomposition tracking
+// We use a coarser resolution grid to record whether
+// a particular grid entry contains any active voxel.
+// The control/majorant sigmaT used by residual ratio tracking
+// lives in a separate grid, see MajorantGrid.
 class DDAIntersector
 {
 public:
@@ -416,6 +415,10 @@ VdbVolume::getMemory() const
 
     mem += mEmissionSampler.getMemory();
 
+    if (mMajorantGrid) {
+        mem += mMajorantGrid->getMemory();
+    }
+
     return mem;
 }
 
@@ -1337,6 +1340,7 @@ VdbVolume::bakeVolumeShaderDensityMap(const scene_rdl2::rdl2::VolumeShader* volu
         mDensityColor = volumeShader->extinct(tls, shading::State(&isect), 
                                               scene_rdl2::math::Color(1.f), 
                                               /*rayVolumeDepth*/ -1);
+        buildMajorantGrid();
         return;
     }
 
@@ -1370,6 +1374,7 @@ VdbVolume::bakeVolumeShaderDensityMap(const scene_rdl2::rdl2::VolumeShader* volu
     if (rez.x() <= 0.0 || rez.y() <= 0.0 || rez.z() <= 0.0) {
         // bad user input. Don't bake grid.
         mDensityColor = scene_rdl2::math::Color(1.0);
+        buildMajorantGrid();
         return;
     }
 
@@ -1410,6 +1415,23 @@ VdbVolume::bakeVolumeShaderDensityMap(const scene_rdl2::rdl2::VolumeShader* volu
     mBakedDensitySampler.initialize(mBakedDensityGrid,
                                     volumeIds,
                                     STATS_BAKED_DENSITY_GRID_SAMPLES);
+
+    buildMajorantGrid();
+}
+
+void
+VdbVolume::buildMajorantGrid()
+{
+    mMajorantGrid.reset();
+    // Velocity motion blur advects the lookup position by an unbounded
+    // amount, so the grid can't bound those lookups.
+    if (mIsEmpty || !mDensitySampler.mIsValid || mVdbVelocity->isMotionBlurOn()) {
+        return;
+    }
+    // This has to match sampleBakedDensity()
+    const openvdb::Vec3SGrid* bakedDensityGrid = mBakedDensitySampler.mIsValid ?
+        mBakedDensitySampler.mGrid.get() : nullptr;
+    mMajorantGrid.reset(new MajorantGrid(*mDensitySampler.mGrid, bakedDensityGrid, mDensityColor));
 }
 
 } // namespace internal
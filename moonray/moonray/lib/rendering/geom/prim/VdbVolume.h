@@ -11,6 +11,7 @@
 #include <moonray/rendering/geom/prim/BufferDesc.h>
 #include <moonray/rendering/geom/prim/GeomTLState.h>
 #include <moonray/rendering/geom/prim/GridSampler.h>
+#include <moonray/rendering/geom/prim/MajorantGrid.h>
 #include <moonray/rendering/geom/prim/NamedPrimitive.h>
 
 #include <moonray/rendering/bvh/shading/Intersection.h>
@@ -319,6 +320,11 @@ public:
                                         uint32_t volumeId,
                                         const Vec3f& pSample) const override;
 
+    virtual const MajorantGrid* getMajorantGrid() const override
+    {
+        return mMajorantGrid.get();
+    }
+
     // query all volume intersections of this VdbVolume alone the ray
     // note that tfar is stored in volumeState already
     bool queryIntersections(const Vec3f& rayOrg, const Vec3f& rayDir,
@@ -427,6 +433,10 @@ protected:
                                    uint32_t volumeId,
                                    const openvdb::Vec3d& p) const;
 
+    // (Re)build the majorant grid from the density grid and the baked
+    // volume shader density. Must be called after the volume shader is baked.
+    void buildMajorantGrid();
+
 protected:
     struct LinearGridTransform
     {
@@ -476,6 +486,9 @@ protected:
     bool mHasUniformVoxels;
 
     VDBSampler<openvdb::FloatGrid> mDensitySampler;
+    // control/majorant extinction grid for residual ratio tracking,
+    // null when the density lookups can't be bounded (e.g. velocity motion blur)
+    std::unique_ptr<MajorantGrid> mMajorantGrid;
 
     bool mHasEmissionField;
     openvdb::Vec3SGrid::Ptr mEmissionGrid;
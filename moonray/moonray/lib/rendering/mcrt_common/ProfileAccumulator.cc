@@ -8,13 +8,19 @@
 #include <scene_rdl2/render/logging/logging.h>
 
 #include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include <unistd.h>
+
 namespace moonray {
 namespace mcrt_common {
 
 bool gAccumulatorsActive = false;
+bool gTraceRecordingActive = false;
 MNRY_DURING_ASSERTS(alignas(CACHE_LINE_SIZE) std::atomic_int gNumAccumulatorsActive);
 
 namespace
@@ -37,6 +43,86 @@ struct Private
 
 Private gPrivate;
 
+// Bounds the memory used by a long recording to 6MB per thread (24 byte
+// events). Once a thread's list is full it wraps around, so the most recent
+// events are kept and the oldest ones are dropped.
+constexpr size_t sMaxTraceEventsPerThread = 1 << 18;
+
+struct TraceEvent
+{
+    const char *mName;
+    uint64_t    mStartTicks;
+    uint64_t    mEndTicks;
+};
+
+// Only appended to by its owning thread. Lists are never freed since threads
+// hold on to them, they are cleared lazily when a new recording starts.
+struct TraceEventList
+{
+    explicit TraceEventList(unsigned threadId) :
+        mThreadId(threadId),
+        mRecording(0),
+        mOldest(0),
+        mNumDropped(0) {}
+
+    unsigned                mThreadId;
+    unsigned                mRecording;
+    size_t                  mOldest;        // index of the oldest event once the list is full
+    size_t                  mNumDropped;    // events overwritten since the recording started
+    std::vector<TraceEvent> mEvents;
+};
+
+struct TraceRecorder
+{
+    TraceRecorder() :
+        mRecording(0),
+        mStartTicks(0) {}
+
+    std::mutex mMutex;
+    std::vector<std::unique_ptr<TraceEventList>> mLists;
+
+    // Incremented for each recording. Read by the recording threads without
+    // taking mMutex.
+    std::atomic<unsigned> mRecording;
+    uint64_t mStartTicks;
+};
+
+TraceRecorder gTraceRecorder;
+
+thread_local TraceEventList *tTraceEventList = nullptr;
+
+TraceEventList *
+getTraceEventList()
+{
+    if (!tTraceEventList) {
+        std::lock_guard<std::mutex> lock(gTraceRecorder.mMutex);
+        gTraceRecorder.mLists.emplace_back(new TraceEventList(unsigned(gTraceRecorder.mLists.size())));
+        tTraceEventList = gTraceRecorder.mLists.back().get();
+    }
+    TraceEventList *list = tTraceEventList;
+    const unsigned recording = gTraceRecorder.mRecording.load(std::memory_order_acquire);
+    if (list->mRecording != recording) {
+        list->mRecording = recording;
+        list->mOldest = 0;
+        list->mNumDropped = 0;
+        list->mEvents.clear();
+    }
+    return list;
+}
+
+void
+writeJsonString(std::ostream &out, const char *str)
+{
+    out << '"';
+    for (const char *c = str; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
 }   // End of anon namespace.
 
 //-----------------------------------------------------------------------------
@@ -243,6 +329,115 @@ snapshotSortedAccumulators(std::vector<AccumulatorResult> *dstResults,
 
 //-----------------------------------------------------------------------------
 
+void
+startTraceRecording()
+{
+    std::lock_guard<std::mutex> lock(gTraceRecorder.mMutex);
+    gTraceRecorder.mStartTicks = getProfileAccumulatorTicks();
+    gTraceRecorder.mRecording.fetch_add(1, std::memory_order_release);
+    MOONRAY_THREADSAFE_STATIC_WRITE(gTraceRecordingActive = true);
+}
+
+void
+stopTraceRecording()
+{
+    MOONRAY_THREADSAFE_STATIC_WRITE(gTraceRecordingActive = false);
+}
+
+bool
+isTraceRecording()
+{
+    return gTraceRecordingActive;
+}
+
+void
+recordTraceEvent(const char *name, uint64_t startTicks, uint64_t endTicks)
+{
+    TraceEventList *list = getTraceEventList();
+    if (list->mEvents.size() < sMaxTraceEventsPerThread) {
+        list->mEvents.push_back(TraceEvent{name, startTicks, endTicks});
+        return;
+    }
+    // Full, overwrite the oldest event.
+    list->mEvents[list->mOldest] = TraceEvent{name, startTicks, endTicks};
+    list->mOldest = (list->mOldest + 1) % sMaxTraceEventsPerThread;
+    ++list->mNumDropped;
+}
+
+bool
+writeTraceRecording(const std::string &filename, double rcpTickFrequency)
+{
+    MNRY_ASSERT(rcpTickFrequency > 0.0);
+
+    std::ofstream out(filename);
+    if (!out) {
+        return false;
+    }
+
+    // Chrome trace timestamps are in microseconds.
+    const double rcpTicksPerUs = rcpTickFrequency * 1e6;
+    const int pid = int(getpid());
+
+    std::lock_guard<std::mutex> lock(gTraceRecorder.mMutex);
+    const uint64_t startTicks = gTraceRecorder.mStartTicks;
+    const unsigned recording = gTraceRecorder.mRecording.load();
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out.precision(3);
+    out.setf(std::ios::fixed, std::ios::floatfield);
+
+    bool first = true;
+    size_t numDropped = 0;
+    for (const auto &list : gTraceRecorder.mLists) {
+        if (list->mRecording != recording || list->mEvents.empty()) {
+            continue;
+        }
+
+        out << (first ? "" : ",\n")
+            << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid
+            << ",\"tid\":" << list->mThreadId
+            << ",\"args\":{\"name\":\"thread " << list->mThreadId << "\"}}";
+        first = false;
+
+        const size_t numEvents = list->mEvents.size();
+        for (size_t i = 0; i < numEvents; ++i) {
+            const TraceEvent &event = list->mEvents[(list->mOldest + i) % numEvents];
+            // Events which started before the recording did are clamped.
+            const uint64_t start = std::max(event.mStartTicks, startTicks);
+            const uint64_t end = std::max(event.mEndTicks, start);
+            out << ",\n{\"ph\":\"X\",\"name\":";
+            writeJsonString(out, event.mName);
+            out << ",\"pid\":" << pid
+                << ",\"tid\":" << list->mThreadId
+                << ",\"ts\":" << double(start - startTicks) * rcpTicksPerUs
+                << ",\"dur\":" << double(end - start) * rcpTicksPerUs << "}";
+        }
+
+        // Mark where the thread's timeline was cut, so that a truncated
+        // trace isn't mistaken for a complete one.
+        if (list->mNumDropped) {
+            const TraceEvent &oldest = list->mEvents[list->mOldest];
+            const uint64_t ts = std::max(oldest.mStartTicks, startTicks);
+            out << ",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << list->mNumDropped
+                << " earlier events dropped\",\"pid\":" << pid
+                << ",\"tid\":" << list->mThreadId
+                << ",\"ts\":" << double(ts - startTicks) * rcpTicksPerUs << "}";
+            numDropped += list->mNumDropped;
+        }
+    }
+
+    out << "\n],\"otherData\":{\"droppedEvents\":" << numDropped << "}}\n";
+
+    if (numDropped) {
+        scene_rdl2::logging::Logger::warn("Trace recording dropped the ", numDropped,
+                                          " oldest events, the trace in ", filename,
+                                          " is incomplete");
+    }
+    return bool(out);
+}
+
+//-----------------------------------------------------------------------------
+
 Accumulator::Accumulator(const char *desc, unsigned index, unsigned numTLS, AccumulatorFlags flags) :
     mName(desc ? desc : "Unnamed"),
     mIndex(index),
@@ -250,6 +445,9 @@ Accumulator::Accumulator(const char *desc, unsigned index, unsigned numTLS, Accu
     mFlags(flags)
 {
     mThreadLocal = scene_rdl2::util::alignedMallocArrayCtor<ThreadLocalAccumulator>(numTLS, CACHE_LINE_SIZE);
+    for (unsigned i = 0; i < numTLS; ++i) {
+        mThreadLocal[i].mName = mName.c_str();
+    }
 }
 
 Accumulator::~Accumulator()
@@ -19,6 +19,7 @@
 
 #include <atomic>
 #include <cstring>
+#include <string>
 
 // UNIQUE_IDENTIFIER returns an unique identifer for each line of a source file.
 #define UNIQUE_INNER(prefix, x)     prefix##x
@@ -58,6 +59,7 @@ struct Accumulator;
 struct ThreadLocalAccumulator;
 
 extern bool gAccumulatorsActive;
+extern bool gTraceRecordingActive;
 MNRY_DURING_ASSERTS(extern alignas(CACHE_LINE_SIZE) std::atomic_int gNumAccumulatorsActive);
 
 struct AccumulatorResult
@@ -177,6 +179,82 @@ unsigned snapshotSortedAccumulators(std::vector<AccumulatorResult> *dstResults,
 
 //-----------------------------------------------------------------------------
 
+//
+// Timeline recording. While recording, every interval timed by an accumulator
+// and every TRACE_EVENT_SCOPE is appended to a list owned by the OS thread
+// which ran it, so stalls and load imbalance show up which the accumulated
+// totals hide. The recording is written as a Chrome trace json file, which can
+// be loaded into chrome://tracing or ui.perfetto.dev.
+//
+// When not recording, the only cost is a test of gTraceRecordingActive when an
+// accumulator stops. Event names aren't copied, they need to outlive the call
+// to writeTraceRecording.
+//
+// Each thread keeps at most a fixed number of events. In a long recording the
+// oldest events are dropped; the written trace then marks where each thread's
+// timeline starts and reports the number of dropped events in "otherData".
+//
+#define TRACE_EVENT_SCOPE(name)     moonray::mcrt_common::ScopedTraceEvent UNIQUE_IDENTIFIER(name)
+
+// Discards any previously recorded events.
+void startTraceRecording();
+void stopTraceRecording();
+bool isTraceRecording();
+
+// Appends an event covering [startTicks, endTicks) to the calling thread's
+// list. Only call this while recording.
+void recordTraceEvent(const char *name, uint64_t startTicks, uint64_t endTicks);
+
+// Writes all events recorded so far. Only valid when no other thread is
+// recording events, e.g. in between frames.
+bool writeTraceRecording(const std::string &filename, double rcpTickFrequency);
+
+class ScopedTraceEvent
+{
+public:
+    __forceinline explicit ScopedTraceEvent(const char *name) :
+        mName(gTraceRecordingActive ? name : nullptr),
+        mStartTicks(mName ? getProfileAccumulatorTicks() : 0)
+    {
+    }
+
+    __forceinline ~ScopedTraceEvent()
+    {
+        if (mName) {
+            recordTraceEvent(mName, mStartTicks, getProfileAccumulatorTicks());
+        }
+    }
+
+private:
+    const char *mName;
+    uint64_t    mStartTicks;
+};
+
+// For phases with separate start and end calls instead of a scope.
+class TraceEventTimer
+{
+public:
+    TraceEventTimer() : mStartTicks(0) {}
+
+    __forceinline void start()
+    {
+        mStartTicks = gTraceRecordingActive ? getProfileAccumulatorTicks() : 0;
+    }
+
+    __forceinline void stop(const char *name)
+    {
+        if (gTraceRecordingActive && mStartTicks) {
+            recordTraceEvent(name, mStartTicks, getProfileAccumulatorTicks());
+        }
+        mStartTicks = 0;
+    }
+
+private:
+    uint64_t    mStartTicks;
+};
+
+//-----------------------------------------------------------------------------
+
 // Private implementation:
 
 // Per thread data for a particular accumulator, doesn't support nesting.
@@ -193,7 +271,9 @@ struct CACHE_ALIGN ThreadLocalAccumulator
         MNRY_STATIC_ASSERT(alignof(ThreadLocalAccumulator) == CACHE_LINE_SIZE);
         MNRY_STATIC_ASSERT(sizeof(*this) == CACHE_LINE_SIZE);
         MNRY_ASSERT(gNumAccumulatorsActive == 0);
+        const char *name = mName;
         memset(this, 0, CACHE_LINE_SIZE);
+        mName = name;
     }
 
     __forceinline void start()
@@ -217,6 +297,10 @@ struct CACHE_ALIGN ThreadLocalAccumulator
         MNRY_ASSERT(endTime >= mLastStartTime);
         mTotalTime += endTime - mLastStartTime;
         MNRY_ASSERT(--gNumAccumulatorsActive >= 0);
+
+        if (gTraceRecordingActive) {
+            recordTraceEvent(mName, mLastStartTime, endTime);
+        }
     }
 
     __forceinline bool canStart() const
@@ -233,6 +317,9 @@ struct CACHE_ALIGN ThreadLocalAccumulator
     uint64_t    mTotalTime;
     unsigned    mTotalCallCount;
     bool        mTimerActive;
+
+    // Name of the owning Accumulator, for trace recording.
+    const char *mName;
 };
 
 // Ensure that the derived class also fits in a cache line!
@@ -78,6 +78,7 @@ conditionTimes(std::vector<double> &times)
                                             ACC(EXCL_ACCUM_RAY_HANDLER) +
                                             ACC(EXCL_ACCUM_OCCL_QUERY_HANDLER) +
                                             ACC(EXCL_ACCUM_PRESENCE_QUERY_HANDLER) +
+                                            ACC(EXCL_ACCUM_RAY_COHERENCE_SORT) +
                                             ACC(EXCL_ACCUM_RAY_SORT_KEY_GEN);
 
     ACC(INT_ACCUM_TOTAL_SHADING) = ACC(EXCL_ACCUM_SHADE_HANDLER) +
@@ -130,6 +131,7 @@ AccumulatorHandles::init(unsigned numThreads, unsigned numTLS)
     mExclusiveAccumulators[EXCL_ACCUM_PRESENCE_QUERY_HANDLER]   = allocAccumulator("Presence query handler (excl. embree)", ACCFLAG_DISPLAYABLE);
     mExclusiveAccumulators[EXCL_ACCUM_PRIMARY_RAY_GEN]          = allocAccumulator("Primary ray generation", ACCFLAG_DISPLAYABLE);
     mExclusiveAccumulators[EXCL_ACCUM_QUEUE_LOGIC]              = allocAccumulator("Queuing logic (incl. sorting)", ACCFLAG_DISPLAYABLE);
+    mExclusiveAccumulators[EXCL_ACCUM_RAY_COHERENCE_SORT]       = allocAccumulator("Ray coherence sort", ACCFLAG_DISPLAYABLE);
     mExclusiveAccumulators[EXCL_ACCUM_RAY_HANDLER]              = allocAccumulator("Ray handler (excl. embree)", ACCFLAG_DISPLAYABLE);
     mExclusiveAccumulators[EXCL_ACCUM_RAY_SORT_KEY_GEN]         = allocAccumulator("Ray sortkey gen", ACCFLAG_DISPLAYABLE);
     mExclusiveAccumulators[EXCL_ACCUM_RAYSTATE_ALLOCS]          = allocAccumulator("RayState allocs", ACCFLAG_DISPLAYABLE);
@@ -75,6 +75,9 @@ enum ExclAccType
     // All internal queuing overhead such as sorting and copying entries.
     EXCL_ACCUM_QUEUE_LOGIC,
 
+    // Time spent reordering queued rays for coherence before intersection.
+    EXCL_ACCUM_RAY_COHERENCE_SORT,
+
     // Time spent inside of the ray handler excluding time spent inside of embree.
     EXCL_ACCUM_RAY_HANDLER,
 
@@ -92,6 +92,10 @@ struct TLSInitParams
     // if not in bundled mode.
     unsigned        mHeatMapQueueSize;
 
+    // If true, the ray and occlusion queue handlers reorder incoming bundles
+    // by origin and direction before intersecting them.
+    bool            mCoherenceSortRays;
+
     // Callbacks for initializing TLState objects. Applications don't have to
     // fill these in manually.
     std::shared_ptr<geom::internal::TLState> (*initGeomTls) (ThreadLocalState *tls,
@@ -40,6 +40,7 @@ class GPUAccelerator;
 namespace pbr {
 
 class AovSchema;
+class DeepBuffer;
 class Light;
 class LightAovs;
 class MaterialAovs;
@@ -103,7 +104,7 @@ struct BundledOcclRayData
     static uint32_t hudValidation(bool verbose) { BUNDLED_OCCL_RAY_DATA_VALIDATION; }
 };
 
-MNRY_STATIC_ASSERT(sizeof(BundledOcclRayData) == 32);
+MNRY_STATIC_ASSERT(sizeof(BundledOcclRayData) == 56);
 
 struct CACHE_ALIGN BundledOcclRay
 {
@@ -243,6 +244,54 @@ struct DeepData
 
 MNRY_STATIC_ASSERT(sizeof(DeepData) == 64);
 
+// Volume state of a primary sample in vector mode, stored as the second item
+// of its DeepData list. Vector mode adds the radiance of the volumes in front
+// of the first hard surface to the path and attenuates the path by their
+// transmittance, but the deep buffer already holds those volumes as separate
+// segments. As in scalar mode, the hard surface sample must not include them.
+struct DeepVolumeData
+{
+    void init() {
+        mHitVolume = 0;                                 // did the primary ray go through a volume?
+        mRadianceRemoved = 0;                           // was mRadiance removed from a sample yet?
+        mTransmittance = scene_rdl2::math::sWhite;      // volume transmittance applied to the path throughput
+        mRadiance = scene_rdl2::math::sBlack;           // volume radiance added to the path radiance
+    }
+
+    // Removes the volumes from a radiance sample of the hard surface. The
+    // volume radiance is only in one of the samples of the path, and since the
+    // deep buffer sums them it is subtracted once, from whichever comes first.
+    void removeFromRadiance(float vals[3]) {
+        if (!mHitVolume) {
+            return;
+        }
+        if (mRadianceRemoved.fetch_and_store(1) == 0) {
+            vals[0] -= mRadiance.r;
+            vals[1] -= mRadiance.g;
+            vals[2] -= mRadiance.b;
+        }
+        vals[0] = removeTransmittance(vals[0], 0);
+        vals[1] = removeTransmittance(vals[1], 1);
+        vals[2] = removeTransmittance(vals[2], 2);
+    }
+
+    // Light aovs only pick up the transmittance.
+    float removeTransmittance(float val, unsigned channel) const {
+        if (!mHitVolume) {
+            return val;
+        }
+        const float tr = channel == 0 ? mTransmittance.r : (channel == 1 ? mTransmittance.g : mTransmittance.b);
+        return tr > 0.f ? val / tr : 0.f;
+    }
+
+    uint32_t mHitVolume;
+    tbb::atomic<uint32_t> mRadianceRemoved;
+    scene_rdl2::math::Color mTransmittance;
+    scene_rdl2::math::Color mRadiance;
+};
+
+MNRY_STATIC_ASSERT(sizeof(DeepVolumeData) <= sizeof(DeepData));
+
 
 struct CryptomatteData
 {
@@ -263,6 +312,30 @@ struct CryptomatteData
     }
 };
 
+// Refracted cryptomatte state of a primary sample in vector mode. It is stored
+// as the second item of the CryptomatteData list of the sample and shared by
+// all the rays of its path. The fragment itself is added to the cryptomatte
+// buffer when the refracted path hits a visible surface, its beauty once the
+// last radiance sample of the path has been accumulated.
+struct CryptomatteRefractData
+{
+    void init(uint32_t pixel) {
+        mHit = 0;                                   // did the refracted path end on a visible surface?
+        mPixel = pixel;                             // pixel of the sample
+        mId = 0.f;                                  // id of the hit
+        mPresenceDepth = 0;                         // presence depth of the hit
+        mBeauty = RenderColor(0.f, 0.f, 0.f, 0.f);  // radiance accumulated so far along the whole path
+    }
+
+    uint32_t mHit;
+    uint32_t mPixel;
+    float mId;
+    int32_t mPresenceDepth;
+    RenderColor mBeauty;
+};
+
+MNRY_STATIC_ASSERT(sizeof(CryptomatteRefractData) <= sizeof(CryptomatteData));
+
 finline void
 uint32ToPixelLocation(uint32_t val, unsigned *px, unsigned *py)
 {
@@ -69,7 +69,9 @@ enum OcclTestType
     HUD_MEMBER(HUD_NAMESPACE(scene_rdl2::math, Color), mLpeRadiance);   \
     HUD_MEMBER(int, mLpeStateId);                                       \
     HUD_MEMBER(float, mRayEpsilon);                                     \
-    HUD_PTR(const Light *, mLight)
+    HUD_PTR(const Light *, mLight);                                     \
+    HUD_MEMBER(HUD_NAMESPACE(scene_rdl2::math, Vec3f), mPathGuideP);    \
+    HUD_MEMBER(HUD_NAMESPACE(scene_rdl2::math, Vec3f), mPathGuideDir)
 
 #define BUNDLED_OCCL_RAY_DATA_VALIDATION                \
     HUD_BEGIN_VALIDATION(BundledOcclRayData);           \
@@ -78,6 +80,8 @@ enum OcclTestType
     HUD_VALIDATE(BundledOcclRayData, mLpeStateId);      \
     HUD_VALIDATE(BundledOcclRayData, mRayEpsilon);      \
     HUD_VALIDATE(BundledOcclRayData, mLight);           \
+    HUD_VALIDATE(BundledOcclRayData, mPathGuideP);      \
+    HUD_VALIDATE(BundledOcclRayData, mPathGuideDir);    \
     HUD_END_VALIDATION
 
 //
@@ -225,6 +229,8 @@ enum OcclTestType
 // mScene                           Scene we are rendering this frame.
 // mAovSchema                       Copy of Aov schema.
 // mMaterialAovs                    Material Aov manager.
+// mDeepBuffer                      Deep output buffer of the film, nullptr when no
+//                                  deep output is requested.
 // mRequiresHeatMap                 True if producing a heat map.
 // mShadingWorkloadChunkSize        The number of entries which should be processed
 //                                  in a single iteration. This should be tweaked
@@ -246,6 +252,7 @@ enum OcclTestType
     HUD_CPP_PTR(const AovSchema *, mAovSchema);                             \
     HUD_CPP_PTR(const MaterialAovs *, mMaterialAovs);                       \
     HUD_CPP_PTR(const LightAovs *, mLightAovs);                             \
+    HUD_CPP_PTR(DeepBuffer *, mDeepBuffer);                                 \
     HUD_MEMBER(bool, mRequiresHeatMap);                                     \
     HUD_MEMBER(bool,     mLockFrameNoise);                                  \
     HUD_MEMBER(uint32_t, mShadingWorkloadChunkSize);                        \
@@ -271,6 +278,7 @@ enum OcclTestType
     HUD_VALIDATE(FrameState, mAovSchema);                       \
     HUD_VALIDATE(FrameState, mMaterialAovs);                    \
     HUD_VALIDATE(FrameState, mLightAovs);                       \
+    HUD_VALIDATE(FrameState, mDeepBuffer);                      \
     HUD_VALIDATE(FrameState, mRequiresHeatMap);                 \
     HUD_VALIDATE(FrameState, mShadingWorkloadChunkSize);        \
     HUD_VALIDATE(FrameState, mLockFrameNoise);                  \
@@ -3,11 +3,15 @@
 
 #include "Cryptomatte.h"
 
+#include <algorithm>
 #include <cstring> // for size_t
+#include <numeric>
 
 namespace moonray {
 namespace pbr {
 
+const size_t CryptomatteBuffer::sStagingCapacity;
+
 CryptomatteBuffer::CryptomatteBuffer() :
     mWidth(0),
     mHeight(0),
@@ -23,7 +27,8 @@ CryptomatteBuffer::~CryptomatteBuffer()
     scene_rdl2::util::alignedFreeArrayDtor(mPixelMutexes, mMutexTileSize * mMutexTileSize);
 }
 
-void CryptomatteBuffer::init(unsigned width, unsigned height, unsigned numIdChannels, bool multiPresenceOn)
+void CryptomatteBuffer::init(unsigned width, unsigned height, unsigned numIdChannels, bool multiPresenceOn,
+                             unsigned numRenderThreads)
 {
     MNRY_ASSERT_REQUIRE(numIdChannels == 1);     // Production only wants simple 32-bit ids at present
 
@@ -37,6 +42,12 @@ void CryptomatteBuffer::init(unsigned width, unsigned height, unsigned numIdChan
     }
     mFinalized = false;
     mMultiPresenceOn = multiPresenceOn;
+
+    mSampleStagings.resize(numRenderThreads);
+    for (SampleStaging &staging : mSampleStagings) {
+        staging.mSamples.clear();
+        staging.mSamples.reserve(sStagingCapacity);
+    }
 }
 
 void CryptomatteBuffer::clear()
@@ -47,21 +58,23 @@ void CryptomatteBuffer::clear()
             pixelEntry.mFragments.clear();
         }
     }
+    // samples that haven't been merged yet belong to the image being cleared
+    for (SampleStaging &staging : mSampleStagings) {
+        staging.mSamples.clear();
+    }
     mFinalized = false;
 }
 
-void CryptomatteBuffer::addSampleScalar(unsigned x, unsigned y, float sampleId, float weight, 
-                                        const scene_rdl2::math::Vec3f& position, 
-                                        const scene_rdl2::math::Vec3f& normal,
-                                        const scene_rdl2::math::Color4& beauty,
-                                        const scene_rdl2::math::Vec3f refP,
-                                        const scene_rdl2::math::Vec3f refN,
-                                        const scene_rdl2::math::Vec2f uv,
-                                        unsigned presenceDepth,
-                                        int cryptoType)
+void CryptomatteBuffer::mergeSample(PixelEntry &pixelEntry, float sampleId, float weight,
+                                    const scene_rdl2::math::Vec3f& position,
+                                    const scene_rdl2::math::Vec3f& normal,
+                                    const scene_rdl2::math::Color4& beauty,
+                                    const scene_rdl2::math::Vec3f refP,
+                                    const scene_rdl2::math::Vec3f refN,
+                                    const scene_rdl2::math::Vec2f uv,
+                                    unsigned presenceDepth,
+                                    bool incrementSamples)
 {
-    PixelEntry &pixelEntry = mPixelEntries[cryptoType][y * mWidth + x];
-
     // Iterate over fragments stored at current pixel and see if we can merge the sample in to any of them
     for (Fragment &fragment : pixelEntry.mFragments) {
         // if multi presence is on, we treat each presence bounce as a separate cryptomatte fragment
@@ -75,17 +88,33 @@ void CryptomatteBuffer::addSampleScalar(unsigned x, unsigned y, float sampleId,
             fragment.mRefP += refP;
             fragment.mRefN += refN;
             fragment.mUV += uv;
-            fragment.mNumSamples++;
+            if (incrementSamples) fragment.mNumSamples++;
             return;
         }
     }
 
-    // No match, so add a new fragment.
+    // No match, so add a new fragment.  Staged samples can be merged in any order, so a beauty-only
+    // addendum may arrive before the sample it belongs to and must not count as a sample itself.
     pixelEntry.mFragments.push_back(Fragment(sampleId, weight, position, normal, beauty, 
-                                             refP, refN, uv, presenceDepth));
+                                             refP, refN, uv, presenceDepth, incrementSamples ? 1 : 0));
+}
+
+void CryptomatteBuffer::addSampleScalar(unsigned x, unsigned y, float sampleId, float weight, 
+                                        const scene_rdl2::math::Vec3f& position, 
+                                        const scene_rdl2::math::Vec3f& normal,
+                                        const scene_rdl2::math::Color4& beauty,
+                                        const scene_rdl2::math::Vec3f refP,
+                                        const scene_rdl2::math::Vec3f refN,
+                                        const scene_rdl2::math::Vec2f uv,
+                                        unsigned presenceDepth,
+                                        int cryptoType)
+{
+    mergeSample(mPixelEntries[cryptoType][y * mWidth + x], sampleId, weight, position, normal, beauty,
+                refP, refN, uv, presenceDepth, true);
 }
 
-void CryptomatteBuffer::addSampleVector(unsigned x, unsigned y, float sampleId, float weight, 
+void CryptomatteBuffer::addSampleVector(pbr::TLState *pbrTls,
+                                        unsigned x, unsigned y, float sampleId, float weight, 
                                         const scene_rdl2::math::Vec3f& position,
                                         const scene_rdl2::math::Vec3f& normal,
                                         const scene_rdl2::math::Color4& beauty,
@@ -93,39 +122,65 @@ void CryptomatteBuffer::addSampleVector(unsigned x, unsigned y, float sampleId,
                                         const scene_rdl2::math::Vec3f refN,
                                         const scene_rdl2::math::Vec2f uv,
                                         unsigned presenceDepth,
-                                        bool incrementSamples)
+                                        bool incrementSamples,
+                                        int cryptoType)
 {
-    // Lock in case multiple threads want to add samples to this pixel
-    tbb::mutex::scoped_lock lock(mPixelMutexes[getMutexIdx(x, y)]);
+    // Other threads may be adding samples to this pixel.  Rather than locking per sample, stage it
+    // and merge it later together with the rest of this thread's samples.
+    MNRY_ASSERT(pbrTls->mThreadIdx < mSampleStagings.size());
+    SampleStaging &staging = mSampleStagings[pbrTls->mThreadIdx];
+    staging.mSamples.push_back(StagedSample{x, y, getMutexIdx(x, y), sampleId, weight, position, normal, beauty,
+                                            refP, refN, uv, presenceDepth, incrementSamples,
+                                            cryptoType});
+    if (staging.mSamples.size() >= sStagingCapacity) {
+        flushStagedSamples(staging);
+    }
+}
 
-    PixelEntry &pixelEntry = mPixelEntries[CRYPTOMATTE_TYPE_REGULAR][y * mWidth + x];
+void CryptomatteBuffer::flushStagedSamples(SampleStaging &staging)
+{
+    const size_t numSamples = staging.mSamples.size();
+    if (numSamples == 0) {
+        return;
+    }
 
-    // Iterate over fragments stored at current pixel and see if we can merge the sample in to any of them
-    for (Fragment &fragment : pixelEntry.mFragments) {
-        // if multi presence is on, we treat each presence bounce as a separate cryptomatte fragment
-        bool fragMatches = mMultiPresenceOn ? fragment.mId == sampleId && fragment.mPresenceDepth == presenceDepth
-                                            : fragment.mId == sampleId;
-        if (fragMatches) {
-            fragment.mCoverage += weight;
-            fragment.mPosition += position;
-            fragment.mNormal += normal;
-            fragment.mBeauty += beauty;
-            fragment.mRefP += refP;
-            fragment.mRefN += refN;
-            fragment.mUV += uv;
-            if (incrementSamples) fragment.mNumSamples++;
-            return;
-        }
+    // Group the samples by pixel mutex so each mutex is locked once per flush rather than once
+    // per sample.  The sort is stable so samples reach each pixel in the order they were added.
+    staging.mOrder.resize(numSamples);
+    std::iota(staging.mOrder.begin(), staging.mOrder.end(), 0);
+    std::stable_sort(staging.mOrder.begin(), staging.mOrder.end(),
+        [&staging](uint32_t a, uint32_t b) {
+            return staging.mSamples[a].mMutexIdx < staging.mSamples[b].mMutexIdx;
+        });
+
+    size_t i = 0;
+    while (i < numSamples) {
+        const int mutexIdx = staging.mSamples[staging.mOrder[i]].mMutexIdx;
+        tbb::mutex::scoped_lock lock(mPixelMutexes[mutexIdx]);
+        do {
+            const StagedSample &s = staging.mSamples[staging.mOrder[i]];
+            mergeSample(mPixelEntries[s.mCryptoType][s.mY * mWidth + s.mX], s.mId, s.mWeight,
+                        s.mPosition, s.mNormal, s.mBeauty, s.mRefP, s.mRefN, s.mUV, s.mPresenceDepth,
+                        s.mIncrementSamples);
+            ++i;
+        } while (i < numSamples && staging.mSamples[staging.mOrder[i]].mMutexIdx == mutexIdx);
     }
 
-    // No match, so add a new fragment.
-    pixelEntry.mFragments.push_back(Fragment(sampleId, weight, position, normal, beauty, 
-                                             refP, refN, uv, presenceDepth));
+    staging.mSamples.clear();
+}
+
+void CryptomatteBuffer::flushStagedSamples()
+{
+    for (SampleStaging &staging : mSampleStagings) {
+        flushStagedSamples(staging);
+    }
 }
 
-void CryptomatteBuffer::addBeautySampleVector(unsigned x, unsigned y, 
+void CryptomatteBuffer::addBeautySampleVector(pbr::TLState *pbrTls,
+                                              unsigned x, unsigned y, 
                                               float id, const scene_rdl2::math::Color4& beauty, 
-                                              unsigned depth) 
+                                              unsigned depth,
+                                              int cryptoType)
 {
     // Only adds beauty, with all other data zeroed out
     // We only call this function when dealing with presence paths in vector mode. When a presence path is encountered, 
@@ -134,9 +189,10 @@ void CryptomatteBuffer::addBeautySampleVector(unsigned x, unsigned y,
     // number of samples (which we use to average position/normal data) because we already added this fragment in 
     // shadeBundleHandler, and this is basically an addendum, where we add no new position/normal data. We pass in false
     // to the incrementSamples parameter in order to suppress this incrementation 
-    addSampleVector(x, y, id, 0.f, scene_rdl2::math::Vec3f(0.f), scene_rdl2::math::Vec3f(0.f), beauty,
+    // The refracted fragments of vector mode get their beauty the same way, see TLState::releaseCryptomatteData().
+    addSampleVector(pbrTls, x, y, id, 0.f, scene_rdl2::math::Vec3f(0.f), scene_rdl2::math::Vec3f(0.f), beauty,
                     scene_rdl2::math::Vec3f(0.f), scene_rdl2::math::Vec3f(0.f), scene_rdl2::math::Vec2f(0.f),
-                    depth, false);
+                    depth, false, cryptoType);
 }
 
 void CryptomatteBuffer::finalize(const scene_rdl2::fb_util::PixelBuffer<unsigned>& samplesCount) 
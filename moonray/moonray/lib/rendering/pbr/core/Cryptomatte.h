@@ -112,7 +112,8 @@ public:
     CryptomatteBuffer();
     ~CryptomatteBuffer();
 
-    void init(unsigned width, unsigned height, unsigned numIdChannels, bool multiPresenceOn);
+    void init(unsigned width, unsigned height, unsigned numIdChannels, bool multiPresenceOn,
+              unsigned numRenderThreads);
 
     void clear();
 
@@ -138,7 +139,9 @@ public:
                          int cryptoType);
 
     // For details on why we have the incrementSamples parameter, see CryptomatteBuffer.cc::addBeautySampleVector
-    void addSampleVector(unsigned x, unsigned y, float id, float weight,
+    // The sample is staged per thread and merged into the pixel later, see flushStagedSamples().
+    void addSampleVector(pbr::TLState *pbrTls,
+                         unsigned x, unsigned y, float id, float weight,
                          const scene_rdl2::math::Vec3f& position,
                          const scene_rdl2::math::Vec3f& normal,
                          const scene_rdl2::math::Color4& beauty,
@@ -146,10 +149,17 @@ public:
                          const scene_rdl2::math::Vec3f refN,
                          const scene_rdl2::math::Vec2f uv,
                          unsigned presenceDepth,
-                         bool incrementSamples = true);
+                         bool incrementSamples = true,
+                         int cryptoType = CRYPTOMATTE_TYPE_REGULAR);
 
     // see CryptomatteBuffer.cc::addBeautySampleVector for info on why this function exists only in vector mode
-    void addBeautySampleVector(unsigned x, unsigned y, float id, const scene_rdl2::math::Color4& beauty, unsigned depth);
+    void addBeautySampleVector(pbr::TLState *pbrTls,
+                               unsigned x, unsigned y, float id, const scene_rdl2::math::Color4& beauty, unsigned depth,
+                               int cryptoType = CRYPTOMATTE_TYPE_REGULAR);
+
+    // Merges the samples staged by the vector mode functions above into the pixels.  Must only be
+    // called when no thread is adding samples, e.g. at the end of the render passes.
+    void flushStagedSamples();
 
     void finalize(const scene_rdl2::fb_util::PixelBuffer<unsigned>& samplesCount);
     void outputFragments(unsigned x, unsigned y, int numLayers, float *dest, const scene_rdl2::rdl2::RenderOutput& ro) const;
@@ -171,6 +181,47 @@ public:
     void printFragments(unsigned x, unsigned y, int cryptoType) const;
 
 private:
+    // Merges a sample into the pixel's fragment list.  No internal locking.
+    void mergeSample(PixelEntry &pixelEntry, float id, float weight,
+                     const scene_rdl2::math::Vec3f& position,
+                     const scene_rdl2::math::Vec3f& normal,
+                     const scene_rdl2::math::Color4& beauty,
+                     const scene_rdl2::math::Vec3f refP,
+                     const scene_rdl2::math::Vec3f refN,
+                     const scene_rdl2::math::Vec2f uv,
+                     unsigned presenceDepth,
+                     bool incrementSamples);
+
+    // A vector mode sample that hasn't been merged into its pixel yet
+    struct StagedSample
+    {
+        unsigned mX;
+        unsigned mY;
+        int mMutexIdx;
+        float mId;
+        float mWeight;
+        scene_rdl2::math::Vec3f mPosition;
+        scene_rdl2::math::Vec3f mNormal;
+        scene_rdl2::math::Color4 mBeauty;
+        scene_rdl2::math::Vec3f mRefP;
+        scene_rdl2::math::Vec3f mRefN;
+        scene_rdl2::math::Vec2f mUV;
+        unsigned mPresenceDepth;
+        bool mIncrementSamples;
+        int mCryptoType;
+    };
+
+    // One of these per thread, only touched by the owning thread so staging needs no locking.
+    struct CACHE_ALIGN SampleStaging
+    {
+        std::vector<StagedSample> mSamples;
+        std::vector<uint32_t> mOrder;       // scratch space for the flush
+    };
+    static const size_t sStagingCapacity = 1024;
+    std::vector<SampleStaging> mSampleStagings;
+
+    void flushStagedSamples(SampleStaging &staging);
+
     // Two sets of pixel entries: one for the regular cryptomatte data and one for the refracted
     //  cryptomatte data.
     std::vector<PixelEntry> mPixelEntries[NUM_CRYPTOMATTE_TYPES];
@@ -192,9 +243,8 @@ private:
  * have one mutex per pixel.  This would consume a lot of memory, so instead
  * there is an array of 225 mutexes for the entire image that are shared
  * between the pixels.  Some pixels will share the same mutex, which results
- * in some extra locking... however testing has shown the overhead is negligible
- * once there are >= 64 mutexes for ~20 rendering threads.  This may need to be
- * increased as the number of threads increases though.
+ * in some extra locking.  In vector mode samples are staged per thread and
+ * merged in batches grouped by mutex, so each flush takes every mutex at most once.
  * The mutexes form a 15x15 tile that repeats across the image, and the
  * getMutexIdx() logic maps a screen coordinate to a [0, 225] tile index.
  * Note that the tile size is not a multiple of the rendering 8x8 tile size.
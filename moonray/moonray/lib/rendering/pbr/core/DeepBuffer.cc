@@ -16,13 +16,16 @@
 #include <OpenEXR/ImfStringAttribute.h>
 #include <OpenEXR/ImfVecAttribute.h>
 
+#include <algorithm>
 #include <fstream>
+#include <numeric>
 
 
 namespace moonray {
 namespace pbr {
 
 const unsigned DeepBuffer::VolumePixelBuffer::mMaxPixelSamples;
+const size_t DeepBuffer::sStagingCapacity;
 
 DeepBuffer::DeepBuffer() :
     mWidth(0),
@@ -77,6 +80,11 @@ DeepBuffer::clear()
     for (unsigned i = 0; i < mNumRenderThreads; i++) {
         mVolumePixelBuffers[i].clear();
     }
+
+    // samples that haven't been merged yet belong to the image being cleared
+    for (SampleStaging &staging : mSampleStagings) {
+        staging.clear();
+    }
 }
 
 void
@@ -133,6 +141,12 @@ DeepBuffer::initDeep(unsigned width, unsigned height,
         mVolumePixelBuffers[i].mSampleList = nullptr;
         mVolumePixelBuffers[i].clear();
     }
+
+    mSampleStagings.resize(mNumRenderThreads);
+    for (unsigned i = 0; i < mNumRenderThreads; i++) {
+        mSampleStagings[i].clear();
+        mSampleStagings[i].mSamples.reserve(sStagingCapacity);
+    }
 }
 
 void
@@ -177,8 +191,6 @@ DeepBuffer::addSample(pbr::TLState *pbrTls,
                       const float *values,
                       float scale, float weight)
 {
-    // Duplicate the sample data if the subpixel resolution is < 8.
-
     unsigned subpixelX = (uint8_t)(sx * 8.f);
     unsigned subpixelY = (uint8_t)(sy * 8.f);
 
@@ -186,24 +198,42 @@ DeepBuffer::addSample(pbr::TLState *pbrTls,
     scene_rdl2::math::Vec3f nnormal = normal;
     nnormal.safeNormalize();
 
-    // Don't need to lock in scalar mode
-    auto addSample8x8Func = pbrTls->mFs->mExecutionMode == mcrt_common::ExecutionMode::SCALAR ?
-        &DeepBuffer::addSample8x8 :
-        &DeepBuffer::addSample8x8Safe;
+    if (pbrTls->mFs->mExecutionMode == mcrt_common::ExecutionMode::SCALAR) {
+        // Don't need to lock in scalar mode
+        addSampleSubpixels(x, y, subpixelX, subpixelY, layer, deepIDs, t, rayZ, nnormal,
+                           alpha, channels, numChannels, values, scale, weight);
+    } else {
+        // Other threads may be adding samples to this pixel.  Stage the sample
+        // rather than locking, it is merged later with this thread's other samples.
+        stageSample(pbrTls->mThreadIdx, x, y, subpixelX, subpixelY, layer, deepIDs, t, rayZ,
+                    nnormal, alpha, channels, numChannels, values, scale, weight);
+    }
+}
+
+void
+DeepBuffer::addSampleSubpixels(unsigned x, unsigned y, unsigned subpixelX, unsigned subpixelY,
+                               int layer,
+                               const float *deepIDs, float t, float rayZ,
+                               const scene_rdl2::math::Vec3f& nnormal, float alpha,
+                               const int *channels, int numChannels,
+                               const float *values,
+                               float scale, float weight)
+{
+    // Duplicate the sample data if the subpixel resolution is < 8.
 
     if (mFormat == DeepFormat::OpenEXR2_0) {
         // No sample duplication is needed.  Although we are still calling the 8x8
         // function, and an 8x8 mask is being constructed, we ignore it when we
         // output the deep file.
-        (this->*addSample8x8Func)(x, y, subpixelX, subpixelY, layer, deepIDs, t, rayZ, nnormal,
-                                  alpha, channels, numChannels, values, scale, weight);
+        addSample8x8(x, y, subpixelX, subpixelY, layer, deepIDs, t, rayZ, nnormal,
+                     alpha, channels, numChannels, values, scale, weight);
     } else {
         // If the subpixel res is less than 8, we need to duplicate samples to
         //  fill the subpixel mask.
         switch (mSubpixelRes) {
         case 8:  // 8x8, no sample duplication needed
-            (this->*addSample8x8Func)(x, y, subpixelX, subpixelY, layer, deepIDs, t, rayZ, nnormal,
-                                      alpha, channels, numChannels, values, scale, weight);
+            addSample8x8(x, y, subpixelX, subpixelY, layer, deepIDs, t, rayZ, nnormal,
+                         alpha, channels, numChannels, values, scale, weight);
         break;
         case 4:  // 4x4, duplicate samples
         {
@@ -211,8 +241,8 @@ DeepBuffer::addSample(pbr::TLState *pbrTls,
             unsigned startY = subpixelY & 0x06;
             for (int ssy = startY; ssy < startY + 2; ssy++) {
                 for (int ssx = startX; ssx < startX + 2; ssx++) {
-                    (this->*addSample8x8Func)(x, y, ssx, ssy, layer, deepIDs, t, rayZ, nnormal,
-                                     alpha, channels, numChannels, values, scale, weight);
+                    addSample8x8(x, y, ssx, ssy, layer, deepIDs, t, rayZ, nnormal,
+                                 alpha, channels, numChannels, values, scale, weight);
                 }
             }
         }
@@ -223,8 +253,8 @@ DeepBuffer::addSample(pbr::TLState *pbrTls,
             unsigned startY = subpixelY & 0x04;
             for (int ssy = startY; ssy < startY + 4; ssy++) {
                 for (int ssx = startX; ssx < startX + 4; ssx++) {
-                    (this->*addSample8x8Func)(x, y, ssx, ssy, layer, deepIDs, t, rayZ, nnormal,
-                                              alpha, channels, numChannels, values, scale, weight);
+                    addSample8x8(x, y, ssx, ssy, layer, deepIDs, t, rayZ, nnormal,
+                                 alpha, channels, numChannels, values, scale, weight);
                 }
             }
         }
@@ -232,8 +262,8 @@ DeepBuffer::addSample(pbr::TLState *pbrTls,
         case 1:  // 1x1, duplicate samples
             for (int ssy = 0; ssy < 8; ssy++) {
                 for (int ssx = 0; ssx < 8; ssx++) {
-                    (this->*addSample8x8Func)(x, y, ssx, ssy, layer, deepIDs, t, rayZ, nnormal,
-                                              alpha, channels, numChannels, values, scale, weight);
+                    addSample8x8(x, y, ssx, ssy, layer, deepIDs, t, rayZ, nnormal,
+                                 alpha, channels, numChannels, values, scale, weight);
                 }
             }
         break;
@@ -340,21 +370,90 @@ DeepBuffer::addSample8x8(unsigned x, unsigned y, unsigned subpixelX, unsigned su
     newSegment->mNext = nullptr;
 }
 
-// Does internal locking, suitable for vector mode execution.
 void
-DeepBuffer::addSample8x8Safe(unsigned x, unsigned y, unsigned subpixelX, unsigned subpixelY,
-                             int layer,
-                             const float *ids, float t, float rayZ,
-                             const scene_rdl2::math::Vec3f& normal, float alpha,
-                             const int *channels, int numChannels,
-                             const float *values,
-                             float scale, float weight)
+DeepBuffer::stageSample(unsigned threadIdx,
+                        unsigned x, unsigned y, unsigned subpixelX, unsigned subpixelY,
+                        int layer,
+                        const float *ids, float t, float rayZ,
+                        const scene_rdl2::math::Vec3f& normal, float alpha,
+                        const int *channels, int numChannels,
+                        const float *values,
+                        float scale, float weight)
 {
-    // Lock in case multiple threads want to add samples to this pixel
-    tbb::mutex::scoped_lock lock(mPixelMutex[getMutexIdx(x, y)]);
+    MNRY_ASSERT(threadIdx < mSampleStagings.size());
+    SampleStaging &staging = mSampleStagings[threadIdx];
+
+    StagedSample sample;
+    sample.mX = x;
+    sample.mY = y;
+    sample.mSubpixelX = subpixelX;
+    sample.mSubpixelY = subpixelY;
+    sample.mMutexIdx = getMutexIdx(x, y);
+    sample.mLayer = layer;
+    sample.mT = t;
+    sample.mRayZ = rayZ;
+    sample.mNormal = normal;
+    sample.mAlpha = alpha;
+    sample.mScale = scale;
+    sample.mWeight = weight;
+    sample.mNumChannels = numChannels;
+    sample.mChannelOffset = staging.mChannels.size();
+    staging.mSamples.push_back(sample);
+
+    staging.mIDs.insert(staging.mIDs.end(), ids, ids + mDeepIDChannels.size());
+    staging.mChannels.insert(staging.mChannels.end(), channels, channels + numChannels);
+    staging.mValues.insert(staging.mValues.end(), values, values + numChannels);
+
+    if (staging.mSamples.size() >= sStagingCapacity) {
+        flushStagedSamples(staging);
+    }
+}
+
+void
+DeepBuffer::flushStagedSamples(SampleStaging& staging)
+{
+    const size_t numSamples = staging.mSamples.size();
+    if (numSamples == 0) {
+        return;
+    }
 
-    addSample8x8(x, y, subpixelX, subpixelY, layer, ids, t, rayZ, normal, alpha,
-                 channels, numChannels, values, scale, weight);
+    // Group the samples by pixel mutex so each mutex is locked once per flush
+    // rather than once per sample.  The sort is stable so samples reach each
+    // pixel in the order they were added.
+    staging.mOrder.resize(numSamples);
+    std::iota(staging.mOrder.begin(), staging.mOrder.end(), 0);
+    std::stable_sort(staging.mOrder.begin(), staging.mOrder.end(),
+        [&staging](uint32_t a, uint32_t b) {
+            return staging.mSamples[a].mMutexIdx < staging.mSamples[b].mMutexIdx;
+        });
+
+    const size_t numIDs = mDeepIDChannels.size();
+    size_t i = 0;
+    while (i < numSamples) {
+        const int mutexIdx = staging.mSamples[staging.mOrder[i]].mMutexIdx;
+        tbb::mutex::scoped_lock lock(mPixelMutex[mutexIdx]);
+        do {
+            const uint32_t idx = staging.mOrder[i];
+            const StagedSample &s = staging.mSamples[idx];
+            addSampleSubpixels(s.mX, s.mY, s.mSubpixelX, s.mSubpixelY, s.mLayer,
+                               staging.mIDs.data() + idx * numIDs, s.mT, s.mRayZ, s.mNormal,
+                               s.mAlpha,
+                               staging.mChannels.data() + s.mChannelOffset, s.mNumChannels,
+                               staging.mValues.data() + s.mChannelOffset,
+                               s.mScale, s.mWeight);
+            ++i;
+        } while (i < numSamples && staging.mSamples[staging.mOrder[i]].mMutexIdx == mutexIdx);
+    }
+
+    staging.clear();
+}
+
+void
+DeepBuffer::flushStagedSamples()
+{
+    for (SampleStaging &staging : mSampleStagings) {
+        flushStagedSamples(staging);
+    }
 }
 
 void
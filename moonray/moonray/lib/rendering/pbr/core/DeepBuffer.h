@@ -62,7 +62,8 @@ public:
     void setSamplesPerPixel(unsigned samplesPerPixel) { mSamplesPerPixel = samplesPerPixel; }
 
     // Adds sample data to a deep pixel.  Can be called repeatedly to accumulate
-    // channel values.  Used in the Film's bundled handlers.  Thread safe.
+    // channel values.  Used in the Film's bundled handlers.  Thread safe.  In vector
+    // mode the sample is staged and only visible after flushStagedSamples().
     void addSample(pbr::TLState *pbrTls,
                    unsigned x,                // pixel x coordinate
                    unsigned y,                // pixel y coordinate
@@ -104,6 +105,12 @@ public:
 
     void finishPixel(unsigned threadIdx);
 
+    // In vector mode addSample() stages samples per thread and merges them into
+    // the deep pixels in batches.  This merges whatever is still staged.  Must
+    // only be called when no thread is adding samples, e.g. at the end of the
+    // render passes.
+    void flushStagedSamples();
+
     // Write the deep buffer to a deep file using OpenDCX
     void write(const std::string& filename,
                const std::vector<int>& aovs,       // aov channels
@@ -121,7 +128,7 @@ private:
     //  simulate a 1x1, 2x2, or 4x4 subpixel resolution.  This is the method that
     //  actually adds the (un)duplicated deep samples to the buffer.
 
-    // Lock free version, suitable for use in scalar mode.
+    // No internal locking.  Callers in vector mode must hold the pixel mutex.
     void addSample8x8(unsigned x, unsigned y, unsigned subpixelX, unsigned subpixelY,
                       int layer,
                       const float *ids, float t, float rayZ,
@@ -130,14 +137,69 @@ private:
                       const float *values,
                       float scale, float weight);
 
-    // Thread safe version suitable for use in vector mode.
-    void addSample8x8Safe(unsigned x, unsigned y, unsigned subpixelX, unsigned subpixelY,
-                          int layer,
-                          const float *ids, float t, float rayZ,
-                          const scene_rdl2::math::Vec3f& normal, float alpha,
-                          const int *channels, int numChannels,
-                          const float *values,
-                          float scale, float weight);
+    // Duplicates the sample over the subpixels according to mSubpixelRes and
+    // adds them with addSample8x8().  No internal locking.
+    void addSampleSubpixels(unsigned x, unsigned y, unsigned subpixelX, unsigned subpixelY,
+                            int layer,
+                            const float *ids, float t, float rayZ,
+                            const scene_rdl2::math::Vec3f& normal, float alpha,
+                            const int *channels, int numChannels,
+                            const float *values,
+                            float scale, float weight);
+
+    // Vector mode: a sample that was added by a render thread but not yet merged
+    // into the deep pixels.  The deep IDs, channel indices and channel values are
+    // variable length and stored in the owning SampleStaging.
+    struct StagedSample
+    {
+        unsigned mX;
+        unsigned mY;
+        unsigned mSubpixelX;
+        unsigned mSubpixelY;
+        int mMutexIdx;
+        int mLayer;
+        float mT;
+        float mRayZ;
+        scene_rdl2::math::Vec3f mNormal;
+        float mAlpha;
+        float mScale;
+        float mWeight;
+        int mNumChannels;
+        size_t mChannelOffset;      // offset into mChannels and mValues
+    };
+
+    // One of these per thread.  Only the owning thread touches it, so staging a
+    // sample needs no locking.  Once sStagingCapacity samples are staged they are
+    // merged into the deep pixels, taking each pixel mutex once per batch.
+    struct CACHE_ALIGN SampleStaging
+    {
+        std::vector<StagedSample> mSamples;
+        std::vector<float> mIDs;            // mDeepIDChannels.size() per sample
+        std::vector<int> mChannels;
+        std::vector<float> mValues;
+        std::vector<uint32_t> mOrder;       // scratch space for the flush
+
+        void clear()
+        {
+            mSamples.clear();
+            mIDs.clear();
+            mChannels.clear();
+            mValues.clear();
+        }
+    };
+    static const size_t sStagingCapacity = 1024;
+    std::vector<SampleStaging> mSampleStagings;  // one per thread
+
+    void stageSample(unsigned threadIdx,
+                     unsigned x, unsigned y, unsigned subpixelX, unsigned subpixelY,
+                     int layer,
+                     const float *ids, float t, float rayZ,
+                     const scene_rdl2::math::Vec3f& normal, float alpha,
+                     const int *channels, int numChannels,
+                     const float *values,
+                     float scale, float weight);
+
+    void flushStagedSamples(SampleStaging& staging);
 
     /* Each pixel has a linked list of HardSurfaceSegments.  Pixels may be empty and
      * have no HardSurfaceSegments assigned, in which case mHardSurfaceSegments will
@@ -410,9 +472,9 @@ private:
  * have one mutex per pixel.  This would consume a lot of memory, so instead
  * there is an array of 225 mutexes for the entire image that are shared
  * between the pixels.  Some pixels will share the same mutex, which results
- * in some extra locking... however testing has shown the overhead is negligible
- * once there are >= 64 mutexes for ~20 rendering threads.  This may need to be
- * increased as the number of threads increases though.
+ * in some extra locking.  Taking a mutex per sample contended badly at high
+ * thread counts, so samples are staged per thread (see SampleStaging) and
+ * each flush takes every mutex at most once.
  * The mutexes form a 15x15 tile that repeats across the image, and the
  * getMutexIdx() logic maps a screen coordinate to a [0, 225] tile index.
  * Note that the tile size is not a multiple of the rendering 8x8 tile size.
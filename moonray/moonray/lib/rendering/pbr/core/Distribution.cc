@@ -23,7 +23,10 @@
 #include <OpenImageIO/imagebufalgo.h>
 #include <tbb/parallel_for.h>
 
+#include <algorithm>
 #include <cstring>
+#include <numeric>
+#include <vector>
 
 // TODO: rethink the idea of recovering pdf values by diffing cdf values. Jeff Mahovsky points out that it has the
 // potential for highly imprecise pdf values due to catastrophic cancellation.
@@ -1415,8 +1418,253 @@ ImageDistribution::sample(const float ru, const float rv, float mipLevel, scene_
 }
 
 
+//----------------------------------------------------------------------------
+
+namespace {
+
+// Must match uv2local() in EnvLight.cc
+finline Vec3f
+latLongToLocal(const float u, const float v)
+{
+    const float phi = (1.0f - u) * sTwoPi;
+    const float theta = (1.0f - v) * sPi;
+
+    float sinTheta, cosTheta, sinPhi, cosPhi;
+    sincos(theta, &sinTheta, &cosTheta);
+    sincos(phi, &sinPhi, &cosPhi);
+
+    return Vec3f(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta);
+}
+
+// Inverse of the octahedral map used by CosineProductDistribution::getNormalBin()
+finline Vec3f
+octahedralToLocal(const float s, const float t)
+{
+    float x = 2.0f * s - 1.0f;
+    float y = 2.0f * t - 1.0f;
+    const float z = 1.0f - abs(x) - abs(y);
+    if (z < 0.0f) {
+        const float xFolded = (1.0f - abs(y)) * (x >= 0.0f  ?  1.0f  :  -1.0f);
+        y = (1.0f - abs(x)) * (y >= 0.0f  ?  1.0f  :  -1.0f);
+        x = xFolded;
+    }
+    return normalize(Vec3f(x, y, z));
+}
+
+// Bound the directions covered by the patch [s0, s1] x [t0, t1] of a mapping
+// of the sphere with a cone. The directions are only known at the vertices of
+// a grid over the patch, so the spread is padded by the largest angle between
+// neighboring vertices.
+template <typename ToLocal>
+void
+boundPatch(const ToLocal &toLocal, const float s0, const float t0, const float s1, const float t1,
+           Vec3f *axis, float *spread)
+{
+    constexpr int sGridSize = 16;
+    Vec3f dirs[sGridSize + 1][sGridSize + 1];
+    Vec3f sum(zero);
+    for (int j = 0; j <= sGridSize; ++j) {
+        for (int i = 0; i <= sGridSize; ++i) {
+            dirs[j][i] = toLocal(lerp(s0, s1, float(i) / sGridSize), lerp(t0, t1, float(j) / sGridSize));
+            sum += dirs[j][i];
+        }
+    }
+    if (lengthSqr(sum) < sEpsilon) {
+        *axis = Vec3f(0.0f, 0.0f, 1.0f);
+        *spread = sPi;
+        return;
+    }
+    *axis = normalize(sum);
+
+    float cosSpread = 1.0f;
+    float cosStep = 1.0f;
+    for (int j = 0; j <= sGridSize; ++j) {
+        for (int i = 0; i <= sGridSize; ++i) {
+            cosSpread = min(cosSpread, dot(*axis, dirs[j][i]));
+            if (i < sGridSize) cosStep = min(cosStep, dot(dirs[j][i], dirs[j][i + 1]));
+            if (j < sGridSize) cosStep = min(cosStep, dot(dirs[j][i], dirs[j + 1][i]));
+        }
+    }
+    *spread = min(scene_rdl2::math::acos(clamp(cosSpread, -1.0f, 1.0f)) +
+                  scene_rdl2::math::acos(clamp(cosStep, -1.0f, 1.0f)), sPi);
+}
+
+// Sample the index of an inclusive, non-normalized cdf. Returns the index and
+// optionally its probability and the fractional position of r within it.
+finline int
+sampleCdf(const float *cdf, const int size, const float r, float *const pdf, float *const rRemapped)
+{
+    const float total = cdf[size - 1];
+    const float rw = r * total;
+    int i = static_cast<int>(std::upper_bound(cdf, cdf + size, rw) - cdf);
+    if (i == size) {
+        // r * total may round up to the total
+        i = static_cast<int>(std::lower_bound(cdf, cdf + size, total) - cdf);
+    }
+    const float prevCdf = (i > 0)  ?  cdf[i - 1]  :  0.0f;
+    const float funcVal = cdf[i] - prevCdf;
+    MNRY_ASSERT(funcVal > 0.0f);
+    if (pdf) *pdf = funcVal / total;
+    if (rRemapped) *rRemapped = min((rw - prevCdf) / funcVal, sOneMinusEpsilon);
+    return i;
+}
+
+} // end anonymous namespace
+
+
+HUD_VALIDATOR(CosineProductDistribution);
+
+CosineProductDistribution::CosineProductDistribution(const ImageDistribution &image, const bool hemispherical) :
+    mRegionCdf(nullptr),
+    mTexelCdf(nullptr)
+{
+    MNRY_ASSERT(image.isValid());
+
+    const size_type width = image.getWidth();
+    const size_type height = image.getHeight();
+    mRegionSizeU = max(min(width, sMaxSizeU) / COSINE_PRODUCT_REGIONS_U, size_type(1));
+    mRegionSizeV = max(min(height, sMaxSizeV) / COSINE_PRODUCT_REGIONS_V, size_type(1));
+    mSizeU = mRegionSizeU * COSINE_PRODUCT_REGIONS_U;
+    mSizeV = mRegionSizeV * COSINE_PRODUCT_REGIONS_V;
+
+    const size_type regionTexelCount = mRegionSizeU * mRegionSizeV;
+    mTexelCdf = new float[sRegionCount * regionTexelCount];
+    mRegionCdf = new float[sNormalBinCount * sRegionCount];
+
+    // Average the image luminance over each texel, weighted by math::sin(pi * v)
+    // as with the Distribution2D::SPHERICAL mapping. Texels are stored region
+    // after region.
+    const size_type superU = (width + mSizeU - 1) / mSizeU;
+    const size_type superV = (height + mSizeV - 1) / mSizeV;
+    const float invSuperCount = 1.0f / static_cast<float>(superU * superV);
+    tbb::parallel_for(tbb::blocked_range<size_type>(0, mSizeV, max(mSizeV / sRangeDivider, size_type(1))),
+                      [&](const tbb::blocked_range<size_type> range) {
+        for (size_type y = range.begin(); y < range.end(); ++y) {
+            const float v = (static_cast<float>(y) + 0.5f) / mSizeV;
+            const float sinTheta = (hemispherical && v < 0.5f)  ?  0.0f  :  scene_rdl2::math::sin(v * sPi);
+            const size_type regionY = y / mRegionSizeV;
+            const size_type texelY = y % mRegionSizeV;
+            for (size_type x = 0; x < mSizeU; ++x) {
+                float lum = 0.0f;
+                if (sinTheta > 0.0f) {
+                    for (size_type j = 0; j < superV; ++j) {
+                        for (size_type i = 0; i < superU; ++i) {
+                            const float su = (x + (i + 0.5f) / superU) / mSizeU;
+                            const float sv = (y + (j + 0.5f) / superV) / mSizeV;
+                            lum += max(luminance(image.eval(su, sv, 0.0f, TEXTURE_FILTER_NEAREST)), 0.0f);
+                        }
+                    }
+                }
+                const size_type region = regionY * COSINE_PRODUCT_REGIONS_U + x / mRegionSizeU;
+                const size_type texel = texelY * mRegionSizeU + x % mRegionSizeU;
+                mTexelCdf[region * regionTexelCount + texel] = lum * invSuperCount * sinTheta;
+            }
+        }
+    });
+
+    // Tabulate the cdf of each region and bound its directions
+    std::vector<float> regionEnergy(sRegionCount);
+    std::vector<Vec3f> regionAxis(sRegionCount);
+    std::vector<float> regionSpread(sRegionCount);
+    for (size_type region = 0; region < sRegionCount; ++region) {
+        float *texelCdf = mTexelCdf + region * regionTexelCount;
+        std::partial_sum(texelCdf, texelCdf + regionTexelCount, texelCdf);
+        regionEnergy[region] = texelCdf[regionTexelCount - 1];
+
+        const float u0 = static_cast<float>(region % COSINE_PRODUCT_REGIONS_U) / COSINE_PRODUCT_REGIONS_U;
+        const float v0 = static_cast<float>(region / COSINE_PRODUCT_REGIONS_U) / COSINE_PRODUCT_REGIONS_V;
+        boundPatch(latLongToLocal, u0, v0, u0 + 1.0f / COSINE_PRODUCT_REGIONS_U, v0 + 1.0f / COSINE_PRODUCT_REGIONS_V,
+                   &regionAxis[region], &regionSpread[region]);
+    }
+
+    // Tabulate the cdf over the regions of each normal bin, where the energy of
+    // a region is scaled by the largest cosine between the two cones
+    for (size_type bin = 0; bin < sNormalBinCount; ++bin) {
+        const float s0 = static_cast<float>(bin % COSINE_PRODUCT_NORMAL_BINS) / COSINE_PRODUCT_NORMAL_BINS;
+        const float t0 = static_cast<float>(bin / COSINE_PRODUCT_NORMAL_BINS) / COSINE_PRODUCT_NORMAL_BINS;
+        Vec3f binAxis;
+        float binSpread;
+        boundPatch(octahedralToLocal, s0, t0, s0 + 1.0f / COSINE_PRODUCT_NORMAL_BINS,
+                   t0 + 1.0f / COSINE_PRODUCT_NORMAL_BINS, &binAxis, &binSpread);
+
+        float *regionCdf = mRegionCdf + bin * sRegionCount;
+        float sum = 0.0f;
+        for (size_type region = 0; region < sRegionCount; ++region) {
+            const float angle = scene_rdl2::math::acos(clamp(dot(binAxis, regionAxis[region]), -1.0f, 1.0f));
+            const float gap = angle - binSpread - regionSpread[region];
+            const float cosBound = (gap <= 0.0f)  ?  1.0f  :  max(scene_rdl2::math::cos(gap), 0.0f);
+            sum += regionEnergy[region] * cosBound;
+            regionCdf[region] = sum;
+        }
+    }
+}
+
+CosineProductDistribution::~CosineProductDistribution()
+{
+    delete [] mRegionCdf;
+    delete [] mTexelCdf;
+}
+
+int
+CosineProductDistribution::getNormalBin(const Vec3f &n)
+{
+    // Octahedral map of the normal to [0,1]^2
+    const float invL1 = 1.0f / (abs(n.x) + abs(n.y) + abs(n.z));
+    float x = n.x * invL1;
+    float y = n.y * invL1;
+    if (n.z < 0.0f) {
+        const float xFolded = (1.0f - abs(y)) * (x >= 0.0f  ?  1.0f  :  -1.0f);
+        y = (1.0f - abs(x)) * (y >= 0.0f  ?  1.0f  :  -1.0f);
+        x = xFolded;
+    }
+    const int i = min(static_cast<int>((x * 0.5f + 0.5f) * COSINE_PRODUCT_NORMAL_BINS), COSINE_PRODUCT_NORMAL_BINS - 1);
+    const int j = min(static_cast<int>((y * 0.5f + 0.5f) * COSINE_PRODUCT_NORMAL_BINS), COSINE_PRODUCT_NORMAL_BINS - 1);
+    return j * COSINE_PRODUCT_NORMAL_BINS + i;
+}
+
+float
+CosineProductDistribution::pdf(const int bin, const float u, const float v) const
+{
+    const size_type x = min(static_cast<size_type>(max(u, 0.0f) * mSizeU), mSizeU - 1);
+    const size_type y = min(static_cast<size_type>(max(v, 0.0f) * mSizeV), mSizeV - 1);
+    const size_type region = (y / mRegionSizeV) * COSINE_PRODUCT_REGIONS_U + x / mRegionSizeU;
+    const size_type texel = (y % mRegionSizeV) * mRegionSizeU + x % mRegionSizeU;
+
+    const float *regionCdf = getRegionCdf(bin);
+    const float regionTotal = regionCdf[sRegionCount - 1];
+    const float regionWeight = regionCdf[region] - ((region > 0)  ?  regionCdf[region - 1]  :  0.0f);
+    if (regionWeight <= 0.0f) {
+        return 0.0f;
+    }
+
+    const float *texelCdf = getTexelCdf(region);
+    const float texelTotal = texelCdf[mRegionSizeU * mRegionSizeV - 1];
+    const float texelWeight = texelCdf[texel] - ((texel > 0)  ?  texelCdf[texel - 1]  :  0.0f);
+
+    return (regionWeight / regionTotal) * (texelWeight / texelTotal) * mSizeU * mSizeV;
+}
+
+void
+CosineProductDistribution::sample(const int bin, const float ru, const float rv, Vec2f *const uv,
+                                  float *const pdf) const
+{
+    MNRY_ASSERT(uv != nullptr);
+    MNRY_ASSERT(canSample(bin));
+
+    float regionPdf, texelPdf, uRemapped, vRemapped;
+    const size_type region = sampleCdf(getRegionCdf(bin), sRegionCount, ru, &regionPdf, &uRemapped);
+    const size_type texel = sampleCdf(getTexelCdf(region), mRegionSizeU * mRegionSizeV, rv, &texelPdf, &vRemapped);
+
+    const size_type x = (region % COSINE_PRODUCT_REGIONS_U) * mRegionSizeU + texel % mRegionSizeU;
+    const size_type y = (region / COSINE_PRODUCT_REGIONS_U) * mRegionSizeV + texel / mRegionSizeU;
+    uv->x = (static_cast<float>(x) + uRemapped) / mSizeU;
+    uv->y = (static_cast<float>(y) + vRemapped) / mSizeV;
+
+    if (pdf) *pdf = regionPdf * texelPdf * mSizeU * mSizeV;
+}
+
+
 //----------------------------------------------------------------------------
 
 } // namespace pbr
 } // namespace moonray
-
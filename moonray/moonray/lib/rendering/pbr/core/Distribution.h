@@ -424,6 +424,88 @@ private:
     IMAGE_DISTRIBUTION_MEMBERS;
 };
 
+
+//----------------------------------------------------------------------------
+
+///
+/// @class CosineProductDistribution Distribution.h <pbr/core/Distribution.h>
+/// @brief A utility object that samples a lat-long ImageDistribution
+/// according to the image times a bound of the clamped cosine to a normal.
+///
+/// The image is divided into a grid of regions, each bounded by a cone of
+/// directions, and the normals into the bins of an octahedral map, each also
+/// bounded by a cone. For each normal bin, a distribution over the regions is
+/// precomputed from the energy of each region times the largest cosine it can
+/// make with a normal of the bin. Sampling picks a region from the bin of the
+/// normal, then a texel within the region according to the image alone.
+/// Directions are expressed in the z-up local space of the EnvLight.
+///
+class CosineProductDistribution
+{
+public:
+    typedef Distribution2D::size_type size_type;
+
+    /// Constructor / Destructor
+    /// The image is resampled to at most sMaxSizeU x sMaxSizeV texels. When
+    /// hemispherical, the lower hemisphere gets no weight.
+    CosineProductDistribution(const ImageDistribution &image, const bool hemispherical);
+    ~CosineProductDistribution();
+
+    /// HUD validation and type casting
+    static uint32_t hudValidation(const bool verbose)
+    {
+        COSINE_PRODUCT_DISTRIBUTION_VALIDATION;
+    }
+    HUD_AS_ISPC_METHODS(CosineProductDistribution);
+
+    size_type getSizeU() const { return mSizeU; }
+    size_type getSizeV() const { return mSizeV; }
+
+    /// Return the normal bin of the normalized local space normal n
+    static int getNormalBin(const scene_rdl2::math::Vec3f &n);
+
+    /// Can anything be sampled from the normal bin? If not, none of the
+    /// image faces the normals of the bin.
+    finline bool canSample(const int bin) const
+    {
+        return getRegionCdf(bin)[sRegionCount - 1] > 0.0f;
+    }
+
+    /// Return the pdf of sampling the given (u, v) value for a normal in the
+    /// given bin. As with the ImageDistribution, it's up to the caller to
+    /// transform the returned pdf wrt. the proper measure.
+    float pdf(const int bin, const float u, const float v) const;
+
+    /// Continuous sampling of (u, v) for a normal in the given bin, which must
+    /// satisfy canSample(). Optionally returns the pdf of the sample.
+    void sample(const int bin, const float ru, const float rv, scene_rdl2::math::Vec2f *const uv,
+                float *const pdf) const;
+
+    static constexpr size_type sMaxSizeU = 1024;
+    static constexpr size_type sMaxSizeV = 512;
+
+private:
+    /// Copy is disabled
+    CosineProductDistribution(const CosineProductDistribution &other);
+    const CosineProductDistribution &operator=(const CosineProductDistribution &other);
+
+    static constexpr size_type sRegionCount = COSINE_PRODUCT_REGIONS_U * COSINE_PRODUCT_REGIONS_V;
+    static constexpr size_type sNormalBinCount = COSINE_PRODUCT_NORMAL_BINS * COSINE_PRODUCT_NORMAL_BINS;
+
+    finline const float *getRegionCdf(const int bin) const
+    {
+        return mRegionCdf + bin * sRegionCount;
+    }
+
+    finline const float *getTexelCdf(const size_type region) const
+    {
+        return mTexelCdf + region * mRegionSizeU * mRegionSizeV;
+    }
+
+    // Members
+    COSINE_PRODUCT_DISTRIBUTION_MEMBERS;
+};
+
 //----------------------------------------------------------------------------
 
 } // namespace pbr
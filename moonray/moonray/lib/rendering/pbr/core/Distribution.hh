@@ -100,3 +100,30 @@
 
 //----------------------------------------------------------------------------
 
+// Number of regions along u and v of a CosineProductDistribution
+#define COSINE_PRODUCT_REGIONS_U 32
+#define COSINE_PRODUCT_REGIONS_V 16
+// Number of normal bins along each side of the octahedral map of a CosineProductDistribution
+#define COSINE_PRODUCT_NORMAL_BINS 8
+
+#define COSINE_PRODUCT_DISTRIBUTION_MEMBERS \
+    HUD_MEMBER(uint32_t, mSizeU);           \
+    HUD_MEMBER(uint32_t, mSizeV);           \
+    HUD_MEMBER(uint32_t, mRegionSizeU);     \
+    HUD_MEMBER(uint32_t, mRegionSizeV);     \
+    HUD_PTR(float *, mRegionCdf);           \
+    HUD_PTR(float *, mTexelCdf)
+
+#define COSINE_PRODUCT_DISTRIBUTION_VALIDATION                  \
+    HUD_BEGIN_VALIDATION(CosineProductDistribution);            \
+    HUD_VALIDATE(CosineProductDistribution, mSizeU);            \
+    HUD_VALIDATE(CosineProductDistribution, mSizeV);            \
+    HUD_VALIDATE(CosineProductDistribution, mRegionSizeU);      \
+    HUD_VALIDATE(CosineProductDistribution, mRegionSizeV);      \
+    HUD_VALIDATE(CosineProductDistribution, mRegionCdf);        \
+    HUD_VALIDATE(CosineProductDistribution, mTexelCdf);         \
+    HUD_END_VALIDATION
+
+
+//----------------------------------------------------------------------------
+
@@ -3,6 +3,7 @@
 
 //
 //
+#include "Cryptomatte.h"
 #include "DebugRay.h"
 #include "PbrTLState.h"
 #include "RayState.h"
@@ -257,7 +258,7 @@ TLState::TLState(mcrt_common::ThreadLocalState *tls,
             mRayEntries = scene_rdl2::alignedMallocArray<RayQueue::EntryType>
                                      (queueSize, CACHE_LINE_SIZE);
             mRayQueue.init(queueSize, mRayEntries);
-            uint32_t rayHandlerFlags = 0;
+            uint32_t rayHandlerFlags = initParams.mCoherenceSortRays ? RAY_HANDLER_COHERENCE_SORT : 0;
             mRayQueue.setHandler(rayBundleHandler, (void *)((uint64_t)rayHandlerFlags));
         }
 
@@ -267,7 +268,7 @@ TLState::TLState(mcrt_common::ThreadLocalState *tls,
             mOcclusionEntries = scene_rdl2::alignedMallocArray<OcclusionQueue::EntryType>
                                     (queueSize, CACHE_LINE_SIZE);
             mOcclusionQueue.init(queueSize, mOcclusionEntries);
-            uint32_t rayHandlerFlags = 0;
+            uint32_t rayHandlerFlags = initParams.mCoherenceSortRays ? RAY_HANDLER_COHERENCE_SORT : 0;
             mOcclusionQueue.setHandler(occlusionQueryBundleHandler, (void *)((uint64_t)rayHandlerFlags));
         }
 
@@ -504,6 +505,19 @@ TLState::releaseCryptomatteData(uint32_t cryptomatteDataHandle)
             static_cast<pbr::CryptomatteData*>(getListItem(cryptomatteDataHandle, 0));
         MNRY_ASSERT(cryptomatteData->mRefCount > 0);
         if (--(cryptomatteData->mRefCount) == 0) {
+            if (getNumListItems(cryptomatteDataHandle) > 1) {
+                // All the radiance of the path has been accumulated, add it to the refracted fragment
+                const pbr::CryptomatteRefractData *refractData =
+                    static_cast<pbr::CryptomatteRefractData*>(getListItem(cryptomatteDataHandle, 1));
+                if (refractData->mHit && cryptomatteData->mCryptomatteBuffer) {
+                    unsigned px, py;
+                    uint32ToPixelLocation(refractData->mPixel, &px, &py);
+                    const RenderColor &beauty = refractData->mBeauty;
+                    cryptomatteData->mCryptomatteBuffer->addBeautySampleVector(this, px, py, refractData->mId,
+                        scene_rdl2::math::Color4(beauty.x, beauty.y, beauty.z, beauty.w),
+                        refractData->mPresenceDepth, CRYPTOMATTE_TYPE_REFRACTED);
+                }
+            }
             freeList(cryptomatteDataHandle);
         }
     }
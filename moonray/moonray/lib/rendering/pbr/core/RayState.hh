@@ -92,7 +92,8 @@
     HVD_MEMBER(PathVertex, mPathVertex);                                    \
     HVD_MEMBER(uint32_t, mSequenceID);                                      \
     HVD_MEMBER(Subpixel, mSubpixel);                                        \
-    HVD_MEMBER(uint32_t, mPad0);                                            \
+    /* Non zero while the ray follows the refracted cryptomatte path. */    \
+    HVD_MEMBER(uint32_t, mCryptoRefractPath);                               \
     HVD_MEMBER(uint32_t, mTilePass);                                        \
     HVD_MEMBER(uint32_t, mRayStateIdx);                                     \
     HVD_ISPC_PAD(mPad1, 4);                                                 \
@@ -118,7 +119,7 @@
     HVD_VALIDATE(RayState, mPathVertex);                                    \
     HVD_VALIDATE(RayState, mSequenceID);                                    \
     HVD_VALIDATE(RayState, mSubpixel);                                      \
-    HVD_VALIDATE(RayState, mPad0);                                          \
+    HVD_VALIDATE(RayState, mCryptoRefractPath);                             \
     HVD_VALIDATE(RayState, mTilePass);                                      \
     HVD_VALIDATE(RayState, mRayStateIdx);                                   \
     HVD_VALIDATE(RayState, mAOSIsect);                                      \
@@ -25,6 +25,11 @@ enum StatCounters
     STATS_BUNDLED_GPU_OCCLUSION_RAYS,
     STATS_PRESENCE_SHADOW_RAYS,
 
+    // Bundled rays which went through the coherence sort before being traced,
+    // and how many of those hit something (intersection) or were occluded.
+    STATS_COHERENCE_SORTED_RAYS,
+    STATS_COHERENCE_SORTED_RAY_HITS,
+
     STATS_SHADER_EVALS,
     STATS_TEXTURE_SAMPLES,
 
@@ -136,6 +136,48 @@ getTransmittance(pbr::TLState* pbrTls, const BundledOcclRay& occlRay)
         occlRay.mSubpixelIndex, occlRay.mSequenceID, b->mLight);
 }
 
+PathGuideRecords::PathGuideRecords(pbr::TLState* pbrTls, unsigned maxEntries) :
+    mPathGuide(nullptr),
+    mP(nullptr),
+    mDir(nullptr),
+    mRadiance(nullptr),
+    mNumEntries(0),
+    mArena(pbrTls->mArena)
+{
+    const PathGuide& pathGuide = pbrTls->mFs->mIntegrator->getPathGuide();
+    if (pathGuide.isEnabled()) {
+        mPathGuide = &pathGuide;
+        mP = mArena->allocArray<scene_rdl2::math::Vec3f>(maxEntries);
+        mDir = mArena->allocArray<scene_rdl2::math::Vec3f>(maxEntries);
+        mRadiance = mArena->allocArray<scene_rdl2::math::Color>(maxEntries);
+    }
+}
+
+void
+PathGuideRecords::add(pbr::TLState* pbrTls, const BundledOcclRay& occlRay)
+{
+    // Only light samples taken at indirect hits train the guide, see
+    // PathIntegrator::computeRadianceRecurse(). Those are recorded at the
+    // point the parent ray was traced from, stored by prepareOcclusionTestRays().
+    if (!mPathGuide || occlRay.mDepth <= 1 || isBlack(occlRay.mRadiance)) {
+        return;
+    }
+    const BundledOcclRayData *b = static_cast<BundledOcclRayData *>(
+                pbrTls->getListItem(occlRay.mDataPtrHandle, 0));
+    mP[mNumEntries] = b->mPathGuideP;
+    mDir[mNumEntries] = b->mPathGuideDir;
+    mRadiance[mNumEntries] = occlRay.mRadiance;
+    ++mNumEntries;
+}
+
+void
+PathGuideRecords::record() const
+{
+    if (mNumEntries) {
+        mPathGuide->recordRadiance(mNumEntries, mP, mDir, mRadiance, mArena);
+    }
+}
+
 } // namespace pbr
 } // namespace moonray
 
@@ -34,6 +34,27 @@ void fillBundledRadiance(pbr::TLState* pbrTls, BundledRadiance* dst, const Bundl
 // occlusion ray test. We only need to know the transmittance if the ray is not occluded.
 scene_rdl2::math::Color getTransmittance(pbr::TLState* pbrTls, const BundledOcclRay& occlRay);
 
+// Gathers the radiance delivered by unoccluded occlusion rays of indirect
+// bounces and records it in the path guide in a single batch. Storage comes
+// from the thread local arena, the caller is responsible for scoping it.
+class PathGuideRecords
+{
+public:
+    PathGuideRecords(pbr::TLState* pbrTls, unsigned maxEntries);
+
+    // Call once the volume transmittance has been applied to the ray radiance.
+    void add(pbr::TLState* pbrTls, const BundledOcclRay& occlRay);
+    void record() const;
+
+private:
+    const PathGuide* mPathGuide;    // null when path guiding is disabled
+    scene_rdl2::math::Vec3f* mP;
+    scene_rdl2::math::Vec3f* mDir;
+    scene_rdl2::math::Color* mRadiance;
+    unsigned mNumEntries;
+    scene_rdl2::alloc::Arena* mArena;
+};
+
 } // namespace pbr
 } // namespace moonray
 
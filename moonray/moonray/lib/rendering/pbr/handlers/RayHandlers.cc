@@ -26,6 +26,8 @@
 #include <scene_rdl2/common/math/Vec3.h>
 #include <scene_rdl2/scene/rdl2/VisibilityFlags.h>
 
+#include <algorithm>
+
 #define RAY_HANDLER_STD_SORT_CUTOFF     200
 
 namespace moonray {
@@ -38,22 +40,115 @@ namespace pbr {
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+// Spreads the low 8 bits of v so there are 2 zero bits between each of them.
+finline uint32_t
+spreadBits3(uint32_t v)
+{
+    v &= 0xff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+// Quantizes each direction component into 4 buckets.
+finline uint32_t
+quantizeDirection(const scene_rdl2::math::Vec3f &dir)
+{
+    const auto bucket = [](float d) -> uint32_t {
+        return uint32_t(scene_rdl2::math::clamp((d + 1.f) * 2.f, 0.f, 3.f));
+    };
+    return (bucket(dir.x) << 4) | (bucket(dir.y) << 2) | bucket(dir.z);
+}
+
+// Reorders entries so that rays with similar directions and nearby origins
+// are adjacent. The sort key is the quantized direction in the top 6 bits,
+// followed by a 24 bit Morton code of the origin within the bounds of all
+// origins in this batch. getRay(entry, org, dir) returns the ray of an entry.
+template <typename EntryType, typename GetRayFn>
+void
+coherenceSort(pbr::TLState *pbrTls, unsigned numEntries, EntryType **entries,
+              const GetRayFn &getRay)
+{
+    if (numEntries < 2) {
+        return;
+    }
+
+    EXCL_ACCUMULATOR_PROFILE(pbrTls, EXCL_ACCUM_RAY_COHERENCE_SORT);
+
+    scene_rdl2::alloc::Arena *arena = pbrTls->mArena;
+    SCOPED_MEM(arena);
+
+    struct SortedEntry
+    {
+        uint32_t mSortKey;
+        EntryType *mEntry;
+    };
+    SortedEntry *sortedEntries = arena->allocArray<SortedEntry>(numEntries, CACHE_LINE_SIZE);
+    scene_rdl2::math::Vec3f *origins = arena->allocArray<scene_rdl2::math::Vec3f>(numEntries);
+    scene_rdl2::math::Vec3f *dirs = arena->allocArray<scene_rdl2::math::Vec3f>(numEntries);
+
+    scene_rdl2::math::Vec3f lower(scene_rdl2::math::sMaxValue);
+    scene_rdl2::math::Vec3f upper(-scene_rdl2::math::sMaxValue);
+    for (unsigned i = 0; i < numEntries; ++i) {
+        getRay(*entries[i], origins[i], dirs[i]);
+        lower = scene_rdl2::math::min(lower, origins[i]);
+        upper = scene_rdl2::math::max(upper, origins[i]);
+    }
+
+    const scene_rdl2::math::Vec3f extent = upper - lower;
+    const scene_rdl2::math::Vec3f scale(extent.x > 0.f ? 255.f / extent.x : 0.f,
+                                        extent.y > 0.f ? 255.f / extent.y : 0.f,
+                                        extent.z > 0.f ? 255.f / extent.z : 0.f);
+
+    uint32_t maxSortKey = 0;
+    for (unsigned i = 0; i < numEntries; ++i) {
+        const scene_rdl2::math::Vec3f cell = (origins[i] - lower) * scale;
+        const uint32_t morton = (spreadBits3(uint32_t(cell.x)) << 2) |
+                                (spreadBits3(uint32_t(cell.y)) << 1) |
+                                 spreadBits3(uint32_t(cell.z));
+        sortedEntries[i].mSortKey = (quantizeDirection(dirs[i]) << 24) | morton;
+        sortedEntries[i].mEntry = entries[i];
+        maxSortKey = std::max(maxSortKey, sortedEntries[i].mSortKey);
+    }
+
+    sortedEntries = scene_rdl2::util::smartSort32<SortedEntry, 0, RAY_HANDLER_STD_SORT_CUTOFF>(numEntries,
+                                                                                               sortedEntries,
+                                                                                               maxSortKey, arena);
+    for (unsigned i = 0; i < numEntries; ++i) {
+        entries[i] = sortedEntries[i].mEntry;
+    }
+}
+
+} // anonymous namespace
+
 // Returns the number of BundledRadiance entries filled in.
 unsigned
-areSingleRaysOccluded(pbr::TLState *pbrTls, unsigned numEntries, BundledOcclRay **entries,
-                      BundledRadiance *results, RayHandlerFlags flags)
+areRaysOccluded(pbr::TLState *pbrTls, unsigned numEntries, BundledOcclRay **entries,
+                BundledRadiance *results, RayHandlerFlags flags)
 {
     const FrameState &fs = *pbrTls->mFs;
     const rt::EmbreeAccelerator *accel = fs.mEmbreeAccel;
     const bool disableShadowing = !fs.mIntegrator->getEnableShadowing();
     unsigned numRadiancesFilled = 0;
 
+    scene_rdl2::alloc::Arena *arena = pbrTls->mArena;
+    SCOPED_MEM(arena);
+
+    mcrt_common::Ray *rtRays = arena->allocArray<mcrt_common::Ray>(numEntries, CACHE_LINE_SIZE);
+    mcrt_common::Ray **rtRayPtrs = arena->allocArray<mcrt_common::Ray *>(numEntries);
+    bool *isOccluded = arena->allocArray<bool>(numEntries);
+    PathGuideRecords pathGuideRecords(pbrTls, numEntries);
+
     for (unsigned i = 0; i < numEntries; ++i) {
-        BundledOcclRay &occlRay = *entries[i];
+        const BundledOcclRay &occlRay = *entries[i];
 
         MNRY_ASSERT(occlRay.isValid());
+        MNRY_ASSERT(occlRay.mOcclTestType == OcclTestType::STANDARD);
 
-        mcrt_common::Ray rtRay;
+        mcrt_common::Ray &rtRay = *new (&rtRays[i]) mcrt_common::Ray;
 
         rtRay.org[0]  = occlRay.mOrigin.x;
         rtRay.org[1]  = occlRay.mOrigin.y;
@@ -75,21 +170,31 @@ areSingleRaysOccluded(pbr::TLState *pbrTls, unsigned numEntries, BundledOcclRay
                                             // be sure of this because a scene with volumes will trigger a fallback
                                             // to scalar mode, so there won't be any vector-mode occlusion rays
                                             // generated by volumes.
+        rtRayPtrs[i] = &rtRay;
+    }
 
-        bool isOccluded;
-        {
-            MNRY_ASSERT(occlRay.mOcclTestType == OcclTestType::STANDARD);
-            EXCL_ACCUMULATOR_PROFILE(pbrTls, EXCL_ACCUM_EMBREE_OCCLUSION);
-            isOccluded = accel->occluded(rtRay);
-        }
+    {
+        EXCL_ACCUMULATOR_PROFILE(pbrTls, EXCL_ACCUM_EMBREE_OCCLUSION);
+        accel->occludedN(numEntries, rtRayPtrs, isOccluded);
+    }
+
+    if (flags & RAY_HANDLER_COHERENCE_SORT) {
+        pbrTls->mStatistics.addToCounter(STATS_COHERENCE_SORTED_RAYS, numEntries);
+        pbrTls->mStatistics.addToCounter(STATS_COHERENCE_SORTED_RAY_HITS,
+                                         std::count(isOccluded, isOccluded + numEntries, true));
+    }
+
+    for (unsigned i = 0; i < numEntries; ++i) {
+        BundledOcclRay &occlRay = *entries[i];
 
-        if (!isOccluded || disableShadowing) {
+        if (!isOccluded[i] || disableShadowing) {
             // At this point, we know that the ray is not occluded, but we still need to
             // apply volume transmittance to the final radiance value.
             scene_rdl2::math::Color tr = getTransmittance(pbrTls, occlRay);
             occlRay.mRadiance = occlRay.mRadiance * tr;
             BundledRadiance *result = &results[numRadiancesFilled++];
             fillBundledRadiance(pbrTls, result, occlRay);
+            pathGuideRecords.add(pbrTls, occlRay);
 
             // LPE
             if (occlRay.mDataPtrHandle != nullHandle) {
@@ -139,6 +244,8 @@ areSingleRaysOccluded(pbr::TLState *pbrTls, unsigned numEntries, BundledOcclRay
         pbrTls->releaseCryptomatteData(occlRay.mCryptomatteDataHandle);
     }
 
+    pathGuideRecords.record();
+
     return numRadiancesFilled;
 }
 
@@ -206,8 +313,16 @@ computeOcclusionQueriesBundled(pbr::TLState *pbrTls, unsigned numEntries,
     unsigned numNoOpEntries = numEntries - numStandardEntries;
     numEntries = numStandardEntries;
 
+    if (numEntries && (flags & RAY_HANDLER_COHERENCE_SORT)) {
+        coherenceSort(pbrTls, numEntries, entries,
+            [](const BundledOcclRay &occlRay, scene_rdl2::math::Vec3f &org, scene_rdl2::math::Vec3f &dir) {
+                org = occlRay.mOrigin;
+                dir = occlRay.mDir;
+            });
+    }
+
     if (numEntries) {
-        unsigned numRadiancesFilled = areSingleRaysOccluded(pbrTls, numEntries, entries, results, flags);
+        unsigned numRadiancesFilled = areRaysOccluded(pbrTls, numEntries, entries, results, flags);
         results += numRadiancesFilled;
         totalRadiancesFilled += numRadiancesFilled;
     }
@@ -317,20 +432,42 @@ rayBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
     int64_t ticks = 0;
     MCRT_COMMON_CLOCK_OPEN(fs.mRequiresHeatMap? &ticks : nullptr);
 
+    if (handlerFlags & RAY_HANDLER_COHERENCE_SORT) {
+        coherenceSort(pbrTls, numEntries, rayStates,
+            [](const RayState &rs, scene_rdl2::math::Vec3f &org, scene_rdl2::math::Vec3f &dir) {
+                org = rs.mRay.getOrigin();
+                dir = rs.mRay.getDirection();
+            });
+    }
+
     // Perform all intersection checks.
     if (numEntries) {
         pbrTls->mStatistics.addToCounter(STATS_INTERSECTION_RAYS, numEntries);
         pbrTls->mStatistics.addToCounter(STATS_BUNDLED_INTERSECTION_RAYS, numEntries);
         EXCL_ACCUMULATOR_PROFILE(pbrTls, EXCL_ACCUM_EMBREE_INTERSECTION);
 
-        const rt::EmbreeAccelerator *accel = fs.mEmbreeAccel;
+        mcrt_common::Ray **rays = arena->allocArray<mcrt_common::Ray *>(numEntries);
         for (unsigned i = 0; i < numEntries; ++i) {
             RayState *rs = rayStates[i];
             MNRY_ASSERT(isValid(rs));
-            accel->intersect(rs->mRay);
+            rays[i] = &rs->mRay;
+        }
+        fs.mEmbreeAccel->intersectN(numEntries, rays);
+
+        if (handlerFlags & RAY_HANDLER_COHERENCE_SORT) {
+            pbrTls->mStatistics.addToCounter(STATS_COHERENCE_SORTED_RAYS, numEntries);
+            pbrTls->mStatistics.addToCounter(STATS_COHERENCE_SORTED_RAY_HITS,
+                std::count_if(rays, rays + numEntries,
+                              [](const mcrt_common::Ray *ray) { return ray->geomID != -1; }));
         }
     }
 
+    // Deep volume segments are only gathered along primary rays, as in scalar mode.
+    float *deepVolumeAovs = nullptr;
+    if (fs.mDeepBuffer && !fs.mAovSchema->empty()) {
+        deepVolumeAovs = arena->allocArray<float>(fs.mAovSchema->numChannels());
+    }
+
     // Volumes - compute volume radiance and transmission for each ray
     for (unsigned i = 0; i < numEntries; ++i) {
         RayState &rs = *rayStates[i];
@@ -340,7 +477,23 @@ rayBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
         const int lobeType = pv.nonMirrorDepth == 0 ? 0 : pv.lobeType;
         const unsigned sequenceID = rs.mSequenceID;
         float *aovs = nullptr;
-        PathIntegrator::DeepParams *deepParams = nullptr; // TODO: MOONRAY-3133 support deep output of volumes
+
+        PathIntegrator::DeepParams deepParamsStorage;
+        PathIntegrator::DeepParams *deepParams = nullptr;
+        if (fs.mDeepBuffer && ray.getDepth() == 0 && rs.mDeepDataHandle != nullHandle) {
+            unsigned px, py;
+            uint32ToPixelLocation(sp.mPixel, &px, &py);
+            deepParamsStorage.mDeepBuffer = fs.mDeepBuffer;
+            deepParamsStorage.mPixelX = px;
+            deepParamsStorage.mPixelY = py;
+            deepParamsStorage.mSampleX = sp.mSubpixelX;
+            deepParamsStorage.mSampleY = sp.mSubpixelY;
+            deepParamsStorage.mPixelSamples = sp.mPixelSamples;
+            deepParamsStorage.mHitDeep = false;
+            deepParamsStorage.mVolumeAovs = deepVolumeAovs;
+            deepParams = &deepParamsStorage;
+        }
+
         rs.mVolRad = scene_rdl2::math::sBlack;
         VolumeTransmittance vt;
         vt.reset();
@@ -352,6 +505,16 @@ rayBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
         rs.mVolTalpha = vt.mTransmittanceAlpha;
         rs.mVolTm = vt.mTransmittanceMin;
         rs.mVolumeSurfaceT = volumeSurfaceT;
+
+        if (deepParams && rs.mVolHit) {
+            // The volume segments went to the deep buffer, Film removes them
+            // again from the hard surface sample behind them.
+            DeepVolumeData *deepVolumeData =
+                static_cast<DeepVolumeData*>(pbrTls->getListItem(rs.mDeepDataHandle, 1));
+            deepVolumeData->mHitVolume = 1;
+            deepVolumeData->mTransmittance *= rs.mVolTr * rs.mVolTh;
+            deepVolumeData->mRadiance += rs.mVolRad;
+        }
     }
 
     CHECK_CANCELLATION(pbrTls, return);
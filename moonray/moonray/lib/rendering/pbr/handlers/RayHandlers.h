@@ -22,7 +22,9 @@ class TLState;
 // the queue.
 enum RayHandlerFlags
 {
-    // Currently empty
+    // Reorder incoming rays by origin cell and quantized direction before
+    // tracing them so that neighboring rays walk the same parts of the BVH.
+    RAY_HANDLER_COHERENCE_SORT = 1 << 0,
 };
 
 //
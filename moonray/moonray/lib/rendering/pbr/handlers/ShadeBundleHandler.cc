@@ -13,6 +13,7 @@
 #include <moonray/rendering/mcrt_common/Clock.h>
 #include <moonray/rendering/mcrt_common/SOAUtil.h>
 #include <moonray/rendering/mcrt_common/ThreadLocalState.h>
+#include <moonray/rendering/pbr/camera/Camera.h>
 #include <moonray/rendering/pbr/core/PbrTLState.h>
 #include <moonray/rendering/pbr/core/RayState.h>
 #include <moonray/rendering/pbr/core/Scene.h>
@@ -489,6 +490,10 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
     const SortedEntry *endEntry = sortedEntries + numEntries;
 
     float *presences = arena->allocArray<float>(shadingWorkloadChunkSize);
+    MaterialPriorityListv *priorityLists =
+        arena->allocArray<MaterialPriorityListv>(numWorkloadChunkBlocks, CACHE_LINE_SIZE);
+    const scene_rdl2::rdl2::Camera *camera = scene->getCamera()->getRdlCamera();
+    const int materialPriority = material.priority();
     bool *continueDeepRays = arena->allocArray<bool>(shadingWorkloadChunkSize);
 
     // Split total work load into workloads which can be kept within the
@@ -548,8 +553,31 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
             }
         }
 
-        // TODO: overlapping dielectrics.  This is where most of it would be
-        // implemented, similar to the scalar version in PathIntegrator.cc.
+        // Nested dielectric handling, see the scalar version in PathIntegrator.cc.
+        // False intersections get a zero presence and are skipped by the presence
+        // continuation rays below. The updated priority lists are handed to the
+        // integrator for the rays spawned through transmission lobes.
+        for (unsigned i = 0; i < workLoadSize; ++i) {
+            RayState *rs = rayStates[i];
+            shading::Intersection *isect = static_cast<shading::Intersection*>(rs->mAOSIsect);
+            const scene_rdl2::rdl2::Material* newPriorityList[4];
+            int newPriorityListCount[4];
+            const float mediumIor = updateMaterialPriorities(rs->mRay, scene, camera, shadingTls, *isect,
+                                                             &material, &presences[i], materialPriority,
+                                                             newPriorityList, newPriorityListCount,
+                                                             rs->mPathVertex.presenceDepth);
+            isect->setMediumIor(mediumIor);
+            priorityLists[i / VLEN].set(i % VLEN, newPriorityList, newPriorityListCount);
+        }
+        // Smear the last valid entry across the remaining lanes, as the
+        // convertAOS*ToSOA utility functions do.
+        for (unsigned i = workLoadSize; i < numBlocks * VLEN; ++i) {
+            const scene_rdl2::rdl2::Material* lastPriorityList[4];
+            int lastPriorityListCount[4];
+            priorityLists[(workLoadSize - 1) / VLEN].get((workLoadSize - 1) % VLEN,
+                                                         lastPriorityList, lastPriorityListCount);
+            priorityLists[i / VLEN].set(i % VLEN, lastPriorityList, lastPriorityListCount);
+        }
 
         // Do conversion to from AOS to AOSOA.
         convertAOSIntersectionsToSOA(pbrTls, workLoadSize, isectMemory, isectsSOA,
@@ -577,6 +605,64 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
         // Need to allow presence continuation in this case, so flag
         bool cutout = bsdfv->mEarlyTerminationMask != 0;
 
+        // Refractive cryptomatte, see "refractive cryptomatte PART A" in the scalar code. The refracted
+        // path ends on the first surface which isn't invisible to refractive cryptomatte. Through the
+        // invisible ones the integrator picks the spawned ray which carries on with the path.
+        if (!material.invisibleRefractiveCryptomatte()) {
+            for (unsigned i = 0; i < workLoadSize; ++i) {
+                RayState *rs = rayStates[i];
+                if (!rs->mCryptoRefractPath) {
+                    continue;
+                }
+                rs->mCryptoRefractPath = 0;
+
+                // If we have terminated, don't output anything to the refract cryptomatte buffer
+                if (bsdfv[i / VLEN].mEarlyTerminationMask & (1 << (i % VLEN))) {
+                    continue;
+                }
+
+                const CryptomatteData *cryptomatteData =
+                    static_cast<CryptomatteData*>(pbrTls->getListItem(rs->mCryptomatteDataHandle, 0));
+                CryptomatteRefractData *refractData =
+                    static_cast<CryptomatteRefractData*>(pbrTls->getListItem(rs->mCryptomatteDataHandle, 1));
+                if (cryptomatteData->mCryptomatteBuffer == nullptr) {
+                    continue;
+                }
+
+                const shading::Intersection *isect = static_cast<shading::Intersection*>(rs->mAOSIsect);
+                float id = 0.f;
+                if (fs.mIntegrator->getDeepIDAttrIdxs().size() != 0) {
+                    shading::TypedAttributeKey<float> deepIDAttrKey(fs.mIntegrator->getDeepIDAttrIdxs()[0]);
+                    if (isect->isProvided(deepIDAttrKey)) {
+                        id = isect->getAttribute<float>(deepIDAttrKey);
+                    }
+                }
+                scene_rdl2::math::Vec2f uv = isect->getSt();
+                shading::TypedAttributeKey<scene_rdl2::rdl2::Vec2f> cryptoUVAttrKey(fs.mIntegrator->getCryptoUVAttrIdx());
+                if (isect->isProvided(cryptoUVAttrKey)) {
+                    uv = isect->getAttribute<scene_rdl2::rdl2::Vec2f>(cryptoUVAttrKey);
+                }
+                scene_rdl2::math::Vec3f refP, refN;
+                shading::State sstate(isect);
+                sstate.getRefP(refP);
+                sstate.getRefN(refN);
+
+                // The beauty is added once the whole path has been accumulated, see
+                // TLState::releaseCryptomatteData().
+                unsigned px, py;
+                uint32ToPixelLocation(refractData->mPixel, &px, &py);
+                const int presenceDepth = rs->mPathVertex.presenceDepth;
+                cryptomatteData->mCryptomatteBuffer->addSampleVector(pbrTls, px, py, id, 1.f,
+                                                                     isect->getP(), isect->getN(),
+                                                                     scene_rdl2::math::Color4(0.f, 0.f, 0.f, 0.f),
+                                                                     refP, refN, uv, presenceDepth,
+                                                                     true, CRYPTOMATTE_TYPE_REFRACTED);
+                refractData->mHit = 1;
+                refractData->mId = id;
+                refractData->mPresenceDepth = presenceDepth;
+            }
+        }
+
         // Evaluate any extra aovs on this material
         if (!cutout && aovs) {
             aovAccumExtraAovsBundled(pbrTls, fs, rayStates, presences, isectsSOA, &material, workLoadSize);
@@ -674,13 +760,19 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
                     deepLayerRay->mPathVertex.volumeDepth = 0;
                     deepLayerRay->mPathVertex.accumOpacity = 0.f;
 
+                    // Only the original ray follows the refracted cryptomatte path
+                    deepLayerRay->mCryptoRefractPath = 0;
+
                     // Need a new DeepData for this new ray
-                    deepLayerRay->mDeepDataHandle = pbrTls->allocList(sizeof(pbr::DeepData), 1);
+                    deepLayerRay->mDeepDataHandle = pbrTls->allocList(sizeof(pbr::DeepData), 2);
                     pbr::DeepData *deepData2 =
                         static_cast<pbr::DeepData*>(pbrTls->getListItem(deepLayerRay->mDeepDataHandle, 0));
                     deepData2->mHitDeep = false;
                     deepData2->mRefCount = 1;
                     deepData2->mLayer = deepData->mLayer + 1;
+                    pbr::DeepVolumeData *deepVolumeData2 =
+                        static_cast<pbr::DeepVolumeData*>(pbrTls->getListItem(deepLayerRay->mDeepDataHandle, 1));
+                    deepVolumeData2->init();
                 }
 
                 // Trace deep layer rays
@@ -727,6 +819,12 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
 
                         *presenceRay = *rs;
 
+                        // The presence ray continues with the priority list updated at this hit
+                        const scene_rdl2::rdl2::Material* newPriorityList[4];
+                        int newPriorityListCount[4];
+                        priorityLists[i / VLEN].get(i % VLEN, newPriorityList, newPriorityListCount);
+                        setPriorityList(presenceRay->mRay, newPriorityList, newPriorityListCount);
+
                         if (totalPresence >= fs.mPresenceThreshold ||
                             rs->mPathVertex.presenceDepth >= fs.mMaxPresenceDepth) {
                             // The cleanest way to terminate presence traversal is to make it impossible for the
@@ -760,6 +858,8 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
                         presenceRay->mRay.primID = -1;
                         presenceRay->mRay.instID = -1;
                         presenceRay->mDeepDataHandle = nullHandle;
+                        // The new cryptomatte data of the presence ray has no refracted cryptomatte state
+                        presenceRay->mCryptoRefractPath = 0;
 
                         rs->mPathVertex.pathPixelWeight *= presences[i];
                         rs->mPathVertex.aovPathPixelWeight *= presences[i];
@@ -785,7 +885,7 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
                             // radiance, which we will add to the cryptomatte in the radiance handler
                             if (cryptomatteData->mCryptomatteBuffer != nullptr && rs->mPathVertex.pathPixelWeight > 0.01f) {
                                 scene_rdl2::math::Color4 beauty(0.f, 0.f, 0.f, presences[i]);
-                                cryptomatteData->mCryptomatteBuffer->addSampleVector(px, py, cryptomatteData->mId, 
+                                cryptomatteData->mCryptomatteBuffer->addSampleVector(pbrTls, px, py, cryptomatteData->mId, 
                                                                                     rs->mPathVertex.pathPixelWeight,
                                                                                     cryptomatteData->mPosition,
                                                                                     cryptomatteData->mNormal, 
@@ -830,7 +930,7 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
                         // we will add beauty data in the radiance handler
                         if (cryptomatteData->mCryptomatteBuffer != nullptr && rs->mPathVertex.pathPixelWeight > 0.01f) {
                             scene_rdl2::math::Color4 beauty(0.f, 0.f, 0.f, presences[i]);
-                            cryptomatteData->mCryptomatteBuffer->addSampleVector(px, py, cryptomatteData->mId, 
+                            cryptomatteData->mCryptomatteBuffer->addSampleVector(pbrTls, px, py, cryptomatteData->mId, 
                                                                                 rs->mPathVertex.pathPixelWeight,
                                                                                 cryptomatteData->mPosition,
                                                                                 cryptomatteData->mNormal, 
@@ -863,7 +963,8 @@ void shadeBundleHandler(mcrt_common::ThreadLocalState *tls, unsigned numEntries,
 
         // Send results through to the integrator...
         fs.mIntegrator->integrateBundledv(pbrTls, shadingTls, workLoadSize, rayStatesSOA,
-                                          isectsSOA, bsdfv, lightList, lightFilterLists, lightAcc, presences);
+                                          isectsSOA, bsdfv, lightList, lightFilterLists, lightAcc, presences,
+                                          priorityLists);
 
         // For hybrid scalar/vectorized rendering, the scalar ray states may still
         // be accessed during integration, so don't free them until after the
@@ -109,6 +109,7 @@ computeXPUOcclusionQueriesOnGPU(mcrt_common::ThreadLocalState *tls,
     // Create the BundledRadiance objects as required based on the occlusion
     // test results.
     unsigned numRadiancesFilled = 0;
+    PathGuideRecords pathGuideRecords(pbrTls, numRays);
     for (unsigned i = 0; i < numRays; ++i) {
         BundledOcclRay &occlRay = rays[i];
 
@@ -132,6 +133,7 @@ computeXPUOcclusionQueriesOnGPU(mcrt_common::ThreadLocalState *tls,
             occlRay.mRadiance = occlRay.mRadiance * tr;
             BundledRadiance *result = &results[numRadiancesFilled++];
             fillBundledRadiance(pbrTls, result, occlRay);
+            pathGuideRecords.add(pbrTls, occlRay);
 
             // LPE
             if (occlRay.mDataPtrHandle != nullHandle) {
@@ -181,6 +183,8 @@ computeXPUOcclusionQueriesOnGPU(mcrt_common::ThreadLocalState *tls,
         pbrTls->releaseDeepData(occlRay.mDeepDataHandle);
     }
 
+    pathGuideRecords.record();
+
     return numRadiancesFilled;
 }
 
@@ -38,14 +38,21 @@ computeLightSampleCount(int maxLightSamples)
 //----------------------------------------------------------------------------
 
 LightSetSampler::LightSetSampler(scene_rdl2::alloc::Arena *arena, const LightSet &lightSet, const shading::Bsdf &bsdf,
-        const Vec3f &p, int maxSamplesPerLight) :
+        const Vec3f &p, int maxSamplesPerLight, const Vec3f *cullingNormal, bool sampleLightTree,
+        const LightSelectionCache *selectionCache) :
     mLightSet(lightSet),
     mMaxSamplesPerLight(maxSamplesPerLight),
     mSampleCount(0),
     mInvSampleCount(0),
     mLightSampleCount(0),
     mInvLightSampleCount(0),
-    mBsdf(&bsdf)
+    mBsdf(&bsdf),
+    mLightTree(nullptr),
+    mP(p),
+    mCullingNormal(cullingNormal  ?  *cullingNormal  :  Vec3f(0.0f)),
+    mHasCullingNormal(cullingNormal != nullptr),
+    mLightTreeSampleCounts(nullptr),
+    mLightTreeChoices(nullptr)
 {
     const int lightCount = mLightSet.getLightCount();
 
@@ -54,6 +61,22 @@ LightSetSampler::LightSetSampler(scene_rdl2::alloc::Arena *arena, const LightSet
 
     mSampleCount = lightCount * mLightSampleCount;
     mInvSampleCount = (mSampleCount > 0  ?  rcp(float(mSampleCount))  :  0);
+
+    // The light tree is only built in adaptive light sampling mode, and we
+    // need to map its lights back to the light set
+    const LightAccelerator *acc = mLightSet.getAccelerator();
+    if (sampleLightTree && lightCount > 0 && acc && !acc->getSamplingTree().isEmpty() &&
+        mLightSet.getLightAcceleratorIndex(0) >= 0) {
+        mLightTree = &acc->getSamplingTree();
+        mLightTreeSampleCounts = arena->allocArray<int>(lightCount);
+        mLightTreeChoices = arena->allocArray<int>(mLightTree->getBoundedLightCount());
+        for (int i = 0; i < lightCount; ++i) {
+            mLightTreeSampleCounts[i] = 0;
+        }
+        if (selectionCache && selectionCache->isEnabled()) {
+            mSelectionCell = LightSelectionCache::Cell(selectionCache, mLightTree, p, cullingNormal);
+        }
+    }
 }
 
 
@@ -62,6 +85,68 @@ LightSetSampler::~LightSetSampler()
 }
 
 
+//----------------------------------------------------------------------------
+
+float
+LightSetSampler::getExpectedLightSampleCount(int lightIndex) const
+{
+    if (!isLightTreeSampled(lightIndex)) {
+        return float(mLightSampleCount);
+    }
+
+    // Each sample of the budget picks this light with the probability of
+    // the tree choosing it at this shading point
+    const int accIndex = mLightSet.getLightAcceleratorIndex(lightIndex);
+    const float pmf = mLightTree->getPmf(mP, mHasCullingNormal  ?  &mCullingNormal  :  nullptr, accIndex,
+                                         mSelectionCell.isValid()  ?  &mSelectionCell  :  nullptr);
+    return float(mLightSampleCount) * pmf;
+}
+
+
+void
+LightSetSampler::drawLightTreeSamples(IntegratorSample1D &samples, int depth)
+{
+    if (!mLightTree) {
+        return;
+    }
+
+    const int lightCount = mLightSet.getLightCount();
+    for (int i = 0; i < lightCount; ++i) {
+        mLightTreeSampleCounts[i] = 0;
+    }
+
+    const Vec3f *n = mHasCullingNormal  ?  &mCullingNormal  :  nullptr;
+    const LightSelectionCache::Cell *cell = mSelectionCell.isValid()  ?  &mSelectionCell  :  nullptr;
+    for (int s = 0; s < mLightSampleCount; ++s) {
+        float u[1];
+        samples.getSample(u, depth);
+
+        // With adaptive tree splitting a sample may choose several lights,
+        // but never the same light twice
+        const int choiceCount = mLightTree->sample(mP, n, u[0], mLightTreeChoices, nullptr, cell);
+        for (int c = 0; c < choiceCount; ++c) {
+            // Lights culled from the light set can't illuminate the shading
+            // point, a sample spent on them contributes nothing
+            const int lightIndex = mLightSet.getAcceleratorLightSetIndex(mLightTreeChoices[c]);
+            if (lightIndex >= 0) {
+                ++mLightTreeSampleCounts[lightIndex];
+            }
+        }
+    }
+}
+
+
+void
+LightSetSampler::recordLightTreeContribution(int lightIndex, float unoccluded, float delivered) const
+{
+    if (!mSelectionCell.isValid() || !isLightTreeSampled(lightIndex)) {
+        return;
+    }
+    mLightTree->recordContribution(mSelectionCell, mLightSet.getLightAcceleratorIndex(lightIndex),
+                                   unoccluded, delivered);
+}
+
+
 //----------------------------------------------------------------------------
 
 void
@@ -10,6 +10,7 @@
 
 #include <moonray/rendering/pbr/core/PbrTLState.h>
 #include <moonray/rendering/pbr/light/Light.h>
+#include <moonray/rendering/pbr/light/LightSelectionCache.h>
 #include <moonray/rendering/pbr/light/LightSet.h>
 
 #include <moonray/rendering/shading/bsdf/Bsdf.h>
@@ -68,12 +69,23 @@ struct LightSample {
 /// - Generate / Iterate over light-set samples, retrieving light properties
 ///   for the current sample
 ///
+/// Light sets with many lights can instead be sampled with a fixed budget:
+/// when sampling through the light tree of the set's LightAccelerator, the
+/// bounded lights share maxSamplesPerLight samples, each of which is drawn
+/// from a light chosen according to the tree importance (or from several
+/// lights, when the tree splits nodes, see LightTree::shouldSplit()). Only the
+/// unbounded lights still get their own samples. Given a LightSelectionCache, the tree
+/// importance is scaled by how much of their contribution the lights around
+/// the shading point were found to deliver during the previous pass.
+///
 class LightSetSampler
 {
 public:
 
     LightSetSampler(scene_rdl2::alloc::Arena *arena, const LightSet &lightSet, const shading::Bsdf &bsdf,
-            const scene_rdl2::math::Vec3f &p, int maxSamplesPerLight);
+            const scene_rdl2::math::Vec3f &p, int maxSamplesPerLight,
+            const scene_rdl2::math::Vec3f *cullingNormal = nullptr, bool sampleLightTree = false,
+            const LightSelectionCache *selectionCache = nullptr);
     ~LightSetSampler();
 
     LightSetSampler(const LightSetSampler &) = delete;
@@ -112,12 +124,46 @@ public:
     finline int getLightSampleCount() const     {  return mLightSampleCount;  }
     finline float getInvLightSampleCount() const{  return mInvLightSampleCount;  }
 
+    // Returns true if the bounded lights share the light tree sample budget
+    finline bool isSamplingLightTree() const    {  return mLightTree != nullptr;  }
+
+    // Returns true if the samples of the light are drawn from the light tree
+    // sample budget
+    finline bool isLightTreeSampled(int lightIndex) const
+    {
+        return mLightTree && getLight(lightIndex)->isBounded();
+    }
+
+    // Returns number of samples for the given light. This is at most
+    // getLightSampleCount(), and may be zero for light tree sampled lights.
+    finline int getLightSampleCount(int lightIndex) const
+    {
+        return isLightTreeSampled(lightIndex)  ?  mLightTreeSampleCounts[lightIndex]  :  mLightSampleCount;
+    }
+
+    // Returns the expected number of samples drawn from the given light, the
+    // sample count to use when weighting its samples with multiple importance
+    // sampling
+    float getExpectedLightSampleCount(int lightIndex) const;
+
+    // Spends the light tree sample budget: chooses the lights for each of the
+    // getLightSampleCount() samples shared by the light tree sampled lights.
+    // Must be called before iterating over the light samples, when
+    // isSamplingLightTree().
+    void drawLightTreeSamples(IntegratorSample1D &samples, int depth);
+
+    // Records into the light selection cache, if any, the contribution of a
+    // sample of a light tree sampled light before (unoccluded) and after
+    // (delivered) tracing its shadow ray
+    void recordLightTreeContribution(int lightIndex, float unoccluded, float delivered) const;
+
     // Sample iteration should proceed as follows.  Given
     // an array of LightSample, lsmp...
     //
     // int s = 0;
+    // drawLightTreeSamples(samples, depth);
     // for (int lightIndex = 0; lightIndex < getLightCount(); ++lightIndex) {
-    //     for (int i = 0; i < getLightSampleCount(); ++i, ++s) {
+    //     for (int i = 0; i < getLightSampleCount(lightIndex); ++i, ++s) {
     //         sampleIntersectAndEval(lightIndex, P, N, time, r1, r2, lsmp[s]);
     //     }
     // }
@@ -148,6 +194,15 @@ private:
     float mInvLightSampleCount;
 
     const shading::Bsdf *mBsdf;
+
+    // Light tree sampling, mLightTree is null unless it is enabled
+    const LightTree *mLightTree;
+    scene_rdl2::math::Vec3f mP;
+    scene_rdl2::math::Vec3f mCullingNormal;
+    bool mHasCullingNormal;
+    int *mLightTreeSampleCounts;
+    int *mLightTreeChoices;         // lights chosen by one light tree sample
+    LightSelectionCache::Cell mSelectionCell;
 };
 
 
@@ -5,6 +5,7 @@
 
 #include "PathGuide.h"
 
+#include <scene_rdl2/render/util/Arena.h>
 #include <scene_rdl2/render/util/AtomicFloat.h>
 #include <scene_rdl2/render/logging/logging.h>
 #include <scene_rdl2/common/math/BBox.h>
@@ -13,6 +14,7 @@
 #include <scene_rdl2/common/math/Vec3.h>
 #include <scene_rdl2/scene/rdl2/SceneVariables.h>
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <stack>
@@ -47,6 +49,9 @@ public:
     void setNumSamplesBuild(uint64_t numSamples);
     uint64_t getNumSamplesBuild() const;
     void recordRadiance(const Vec3f &dir, const Color &radiance);
+    void recordRadiance(unsigned numEntries, const unsigned *entries,
+                        const Vec3f *dir, const Color *radiance,
+                        scene_rdl2::alloc::Arena *arena);
 
     void reset(int maxDepth, float threshold);
     void build();
@@ -65,6 +70,8 @@ private:
         void setNumSamples(uint64_t numSamples);
         uint64_t getNumSamples() const;
         void recordRadiance(const Vec2f &pos, const Color &radiance);
+        void recordRadiance(unsigned numEntries, const Vec2f *pos, const float *luminance,
+                            scene_rdl2::alloc::Arena *arena);
         
         struct Node
         {
@@ -246,6 +253,56 @@ DirTree::Tree::recordRadiance(const Vec2f &pos, const Color &radiance)
     } while (index != 0);
 }
 
+void
+DirTree::Tree::recordRadiance(unsigned numEntries, const Vec2f *pos, const float *luminance,
+                              scene_rdl2::alloc::Arena *arena)
+{
+    // Sum up the contributions of the batch per node quadrant first, so each
+    // quadrant touched by the batch receives a single atomic update instead
+    // of one per record.  Records from a bundle tend to land in the same few
+    // quadrants, which are otherwise heavily contended between threads.
+    // Each update is keyed by (node index * 4 + quadrant).
+    struct NodeUpdate
+    {
+        uint64_t mKey;
+        float mLuminance;
+    };
+    // a record visits at most one node per level of the tree
+    const size_t maxUpdates = size_t(numEntries) * (mMaxDepth + 1);
+    NodeUpdate *updates = arena->allocArray<NodeUpdate>(maxUpdates);
+    size_t numUpdates = 0;
+
+    float sum = 0.0f;
+    for (unsigned i = 0; i < numEntries; ++i) {
+        sum += luminance[i];
+
+        uint64_t index = 0;
+        Vec2f curPos = pos[i];
+        do {
+            const uint32_t childIndex = getChildIndexAndRemap(curPos);
+            MNRY_ASSERT(numUpdates < maxUpdates);
+            updates[numUpdates++] = NodeUpdate{index * 4 + childIndex, luminance[i]};
+            index = mNodes[index].mChildren[childIndex];
+        } while (index != 0);
+    }
+
+    mNumSamples.fetch_add(numEntries, std::memory_order_acq_rel);
+    mSum.fetch_add(sum, std::memory_order_acq_rel);
+
+    std::sort(updates, updates + numUpdates,
+              [](const NodeUpdate &a, const NodeUpdate &b) {
+                  return a.mKey < b.mKey;
+              });
+    for (size_t i = 0; i < numUpdates; ) {
+        const uint64_t key = updates[i].mKey;
+        float mean = 0.0f;
+        for (; i < numUpdates && updates[i].mKey == key; ++i) {
+            mean += updates[i].mLuminance;
+        }
+        mNodes[key / 4].mMean[key % 4].fetch_add(mean, std::memory_order_acq_rel);
+    }
+}
+
 
 DirTree::DirTree()
 {
@@ -274,6 +331,28 @@ DirTree::recordRadiance(const Vec3f &dir, const Color &radiance)
     mBuild.recordRadiance(pos, radiance);
 }
 
+void
+DirTree::recordRadiance(unsigned numEntries, const unsigned *entries,
+                        const Vec3f *dir, const Color *radiance,
+                        scene_rdl2::alloc::Arena *arena)
+{
+    // entries index into dir and radiance
+    Vec2f *pos = arena->allocArray<Vec2f>(numEntries);
+    float *luminance = arena->allocArray<float>(numEntries);
+    unsigned numValid = 0;
+    for (unsigned i = 0; i < numEntries; ++i) {
+        const unsigned e = entries[i];
+        MNRY_ASSERT(scene_rdl2::math::isFinite(radiance[e]));
+        if (!scene_rdl2::math::isFinite(radiance[e])) continue;
+        pos[numValid] = dirToPos(dir[e]);
+        luminance[numValid] = scene_rdl2::math::luminance(radiance[e]);
+        ++numValid;
+    }
+    if (numValid) {
+        mBuild.recordRadiance(numValid, pos, luminance, arena);
+    }
+}
+
 void
 DirTree::reset(int maxDepth, float threshold)
 {
@@ -682,8 +761,13 @@ public:
     void startFrame(const BBox3f &bbox, const scene_rdl2::rdl2::SceneVariables &vars);
     void passReset();
     void recordRadiance(const Vec3f &p, const Vec3f &dir, const Color &radiance) const;
+    void recordRadiance(unsigned numEntries, const Vec3f *p, const Vec3f *dir, const Color *radiance,
+                        scene_rdl2::alloc::Arena *arena) const;
     float getPdf(const Vec3f &p, const Vec3f &dir) const;
+    void getPdf(unsigned numEntries, const Vec3f *p, const Vec3f *dir, float *pdf) const;
     Vec3f sampleDirection(const Vec3f &p, float r1, float r2, float *pdf) const;
+    void sampleDirection(unsigned numEntries, const Vec3f *p, const float *r1, const float *r2,
+                         Vec3f *dir, float *pdf) const;
     bool isEnabled() const;
     bool canSample() const;
     float getPercentage() const;
@@ -769,6 +853,41 @@ PathGuide::Impl::recordRadiance(const Vec3f &p, const Vec3f &dir, const Color &r
     dirTree->recordRadiance(dir, radiance);
 }
 
+void
+PathGuide::Impl::recordRadiance(unsigned numEntries, const Vec3f *p, const Vec3f *dir,
+                                const Color *radiance, scene_rdl2::alloc::Arena *arena) const
+{
+    if (!mEnable || numEntries == 0) return;
+
+    SCOPED_MEM(arena);
+
+    // Group the records by directional tree, each group is then added to
+    // its tree in one go.
+    struct Record
+    {
+        DirTree *mDirTree;
+        unsigned mEntry;
+    };
+    Record *records = arena->allocArray<Record>(numEntries);
+    for (unsigned i = 0; i < numEntries; ++i) {
+        records[i] = Record{mSpatialTree->getDirTree(p[i]), i};
+    }
+    std::sort(records, records + numEntries, [](const Record &a, const Record &b) {
+        return a.mDirTree < b.mDirTree || (a.mDirTree == b.mDirTree && a.mEntry < b.mEntry);
+    });
+
+    unsigned *entries = arena->allocArray<unsigned>(numEntries);
+    for (unsigned i = 0; i < numEntries; ) {
+        DirTree *dirTree = records[i].mDirTree;
+        MNRY_ASSERT(dirTree != nullptr);
+        unsigned numTreeEntries = 0;
+        for (; i < numEntries && records[i].mDirTree == dirTree; ++i) {
+            entries[numTreeEntries++] = records[i].mEntry;
+        }
+        dirTree->recordRadiance(numTreeEntries, entries, dir, radiance, arena);
+    }
+}
+
 float
 PathGuide::Impl::getPdf(const Vec3f &p, const Vec3f &dir) const
 {
@@ -777,6 +896,15 @@ PathGuide::Impl::getPdf(const Vec3f &p, const Vec3f &dir) const
     return dirTree->getPdf(dir);
 }
 
+void
+PathGuide::Impl::getPdf(unsigned numEntries, const Vec3f *p, const Vec3f *dir, float *pdf) const
+{
+    MNRY_ASSERT(mEnable);
+    for (unsigned i = 0; i < numEntries; ++i) {
+        pdf[i] = mSpatialTree->getDirTree(p[i])->getPdf(dir[i]);
+    }
+}
+
 Vec3f
 PathGuide::Impl::sampleDirection(const Vec3f &p, float r1, float r2, float *pdf) const
 {
@@ -791,6 +919,19 @@ PathGuide::Impl::sampleDirection(const Vec3f &p, float r1, float r2, float *pdf)
     return dir;
 }
 
+void
+PathGuide::Impl::sampleDirection(unsigned numEntries, const Vec3f *p, const float *r1, const float *r2,
+                                 Vec3f *dir, float *pdf) const
+{
+    MNRY_ASSERT(mEnable);
+    for (unsigned i = 0; i < numEntries; ++i) {
+        const DirTree *dirTree = mSpatialTree->getDirTree(p[i]);
+        MNRY_ASSERT(dirTree != nullptr);
+        dir[i] = dirTree->sampleDirection(r1[i], r2[i]);
+        pdf[i] = dirTree->getPdf(dir[i]);
+    }
+}
+
 bool
 PathGuide::Impl::isEnabled() const
 {
@@ -842,18 +983,38 @@ PathGuide::recordRadiance(const Vec3f &p, const Vec3f &dir, const Color &radianc
     mImpl->recordRadiance(p, dir, radiance);
 }
 
+void
+PathGuide::recordRadiance(unsigned numEntries, const Vec3f *p, const Vec3f *dir, const Color *radiance,
+                          scene_rdl2::alloc::Arena *arena) const
+{
+    mImpl->recordRadiance(numEntries, p, dir, radiance, arena);
+}
+
 float
 PathGuide::getPdf(const Vec3f &p, const Vec3f &dir) const
 {
     return mImpl->getPdf(p, dir);
 }
 
+void
+PathGuide::getPdf(unsigned numEntries, const Vec3f *p, const Vec3f *dir, float *pdf) const
+{
+    mImpl->getPdf(numEntries, p, dir, pdf);
+}
+
 Vec3f
 PathGuide::sampleDirection(const Vec3f &p, float r1, float r2, float *pdf) const
 {
     return mImpl->sampleDirection(p, r1, r2, pdf);
 }
 
+void
+PathGuide::sampleDirection(unsigned numEntries, const Vec3f *p, const float *r1, const float *r2,
+                           Vec3f *dir, float *pdf) const
+{
+    mImpl->sampleDirection(numEntries, p, r1, r2, dir, pdf);
+}
+
 bool
 PathGuide::isEnabled() const
 {
@@ -11,6 +11,7 @@
 #include <memory>
 
 namespace scene_rdl2 {
+namespace alloc { class Arena; }
 namespace rdl2 { class SceneVariables; }
 }
 
@@ -52,6 +53,19 @@ public:
     // Return a guided sample direction and optional pdf.
     scene_rdl2::math::Vec3f sampleDirection(const scene_rdl2::math::Vec3f &p, float r1, float r2, float *pdf) const;
 
+    // Batched versions of the above, used by the vectorized integrator to
+    // process all the lanes of a bundle in a single call.  Records falling
+    // into the same directional tree are summed up per tree node before
+    // being added to the tree, so each node touched by a batch only sees a
+    // single atomic update.  Temporary storage comes from the thread local arena.
+    void recordRadiance(unsigned numEntries, const scene_rdl2::math::Vec3f *p,
+                        const scene_rdl2::math::Vec3f *dir, const scene_rdl2::math::Color *radiance,
+                        scene_rdl2::alloc::Arena *arena) const;
+    void getPdf(unsigned numEntries, const scene_rdl2::math::Vec3f *p,
+                const scene_rdl2::math::Vec3f *dir, float *pdf) const;
+    void sampleDirection(unsigned numEntries, const scene_rdl2::math::Vec3f *p, const float *r1, const float *r2,
+                         scene_rdl2::math::Vec3f *dir, float *pdf) const;
+
     // Is path guiding enabled?
     bool isEnabled() const;
 
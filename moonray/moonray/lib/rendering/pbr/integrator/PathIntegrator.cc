@@ -65,7 +65,8 @@ void PathIntegrator_integrateBundled(const moonray::pbr::PathIntegrator *integra
                                      const moonray::shading::Intersectionv *isects,
                                      const moonray::shading::Bsdfv *bsdfs,
                                      const moonray::pbr::LightSet *lightList,
-                                     const float *presences);
+                                     const float *presences,
+                                     const moonray::pbr::MaterialPriorityListv *priorityLists);
 }
 
 // using namespace scene_rdl2::math; // can't use this as it breaks openvdb in clang.
@@ -158,7 +159,9 @@ PathIntegrator::PathIntegrator() :
     mVolumePhaseAttenuationFactor(1.0f),
     mVolumeOverlapMode(VolumeOverlapMode::SUM),
     mEnableSSS(true),
-    mEnableShadowing(true)
+    mEnableShadowing(true),
+    mLightSamplingMode(static_cast<int>(LightSamplingMode::UNIFORM)),
+    mSampleLightTree(false)
 {
 }
 
@@ -211,6 +214,9 @@ PathIntegrator::update(const FrameState &fs, const PathIntegratorParams& params)
     mResolution           = vars.get(scene_rdl2::rdl2::SceneVariables::sResKey);
     mEnableSSS            = vars.get(scene_rdl2::rdl2::SceneVariables::sEnableSSS);
     mEnableShadowing      = vars.get(scene_rdl2::rdl2::SceneVariables::sEnableShadowing);
+    mLightSamplingMode    = vars.get(scene_rdl2::rdl2::SceneVariables::sLightSamplingMode);
+    mSampleLightTree      = getLightSamplingMode() == LightSamplingMode::ADAPTIVE &&
+                            fs.mExecutionMode == mcrt_common::ExecutionMode::SCALAR;
 
     mDeepMaxLayers = vars.get(scene_rdl2::rdl2::SceneVariables::sDeepMaxLayers);
     mDeepLayerBias = vars.get(scene_rdl2::rdl2::SceneVariables::sDeepLayerBias);
@@ -234,6 +240,10 @@ PathIntegrator::update(const FrameState &fs, const PathIntegratorParams& params)
 
     // initialize path guiding
     mPathGuide.startFrame(fs.mEmbreeAccel->getBounds(), vars);
+
+    // initialize light selection learning, the cache is only sampled along
+    // with the light tree, which is scalar only
+    mLightSelectionCache.startFrame(fs.mEmbreeAccel->getBounds(), getSampleLightTree());
 }
 
 void
@@ -242,6 +252,9 @@ PathIntegrator::passReset()
     if (getEnablePathGuide()) {
         mPathGuide.passReset();
     }
+    if (getEnableLightSelectionCache()) {
+        mLightSelectionCache.passReset();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -1525,7 +1538,8 @@ PathIntegrator::integrateBundledv(pbr::TLState *pbrTls,
                                   const LightPtrList *lightList,
                                   const LightFilterLists *lightFilterLists,
                                   const LightAccelerator *lightAcc,
-                                  const float *presences) const
+                                  const float *presences,
+                                  const MaterialPriorityListv *priorityLists) const
 {
     EXCL_ACCUMULATOR_PROFILE(pbrTls, EXCL_ACCUM_INTEGRATION);
 
@@ -1550,7 +1564,8 @@ PathIntegrator::integrateBundledv(pbr::TLState *pbrTls,
                                           isects,
                                           bsdfs,
                                           &lightSet,
-                                          presences);
+                                          presences,
+                                          priorityLists);
     pbrTls->stopIspcAccumulator();
 }
 
@@ -59,6 +59,7 @@ class CryptomatteBuffer;
 class DeepBuffer;
 struct FrameState;
 class Light;
+struct MaterialPriorityListv;
 class PathGuide;
 struct PathVertex;
 struct RayState;
@@ -243,14 +244,31 @@ public:
             const shading::Bsdfv *bsdfs, const LightPtrList *lightList,
             const LightFilterLists *lightFilterLists,
             const LightAccelerator *lightAcc,
-            const float *presences) const;
+            const float *presences,
+            const MaterialPriorityListv *priorityLists) const;
 
     bool getEnableShadowing() const { return mEnableShadowing; }
     bool getEnablePathGuide() const;
+    const PathGuide &getPathGuide() const { return mPathGuide; }
+
+    // The light selection cache learns light tree weights from pass to pass,
+    // it is only used when getSampleLightTree()
+    bool getEnableLightSelectionCache() const { return mLightSelectionCache.isEnabled(); }
 
     // mLightSamples is the user parameter "light_sample_count" squared
     int getLightSampleCount() const { return mLightSamples; }
 
+    LightSamplingMode getLightSamplingMode() const
+    {
+        return static_cast<LightSamplingMode>(mLightSamplingMode);
+    }
+
+    // In adaptive light sampling mode the light samples of the bounded lights
+    // are drawn from the light tree. This is scalar only : the vectorized and
+    // xpu integrators still give every light its own samples, so the same
+    // scene renders with a different noise level and cost in those modes.
+    bool getSampleLightTree() const { return mSampleLightTree; }
+
     const std::vector<int>& getDeepIDAttrIdxs() const { return mDeepIDAttrIdxs; }
     int getDeepMaxLayers() const { return mDeepMaxLayers; }
     float getDeepLayerBias() const { return mDeepLayerBias; }
@@ -40,11 +40,12 @@
     HUD_MEMBER(bool, mEnableShadowing);                    \
     HUD_MEMBER(int, mDeepMaxLayers);                       \
     HUD_MEMBER(float, mDeepLayerBias);                     \
-    HUD_MEMBER(int, mPad0);                                \
+    HUD_MEMBER(int, mLightSamplingMode);                   \
     HUD_CPP_MEMBER(std::vector<int>, mDeepIDAttrIdxs, 24); \
     HUD_MEMBER(int, mCryptoUVAttrIdx);                     \
-    HUD_MEMBER(int, mPad1);                                \
-    HUD_CPP_MEMBER(PathGuide, mPathGuide, 8)
+    HUD_MEMBER(bool, mSampleLightTree);                    \
+    HUD_CPP_MEMBER(PathGuide, mPathGuide, 8);              \
+    HUD_CPP_MEMBER(LightSelectionCache, mLightSelectionCache, 8)
                 
 
 #define PATH_INTEGRATOR_VALIDATION                                 \
@@ -81,10 +82,11 @@
     HUD_VALIDATE(PathIntegrator, mEnableShadowing);                \
     HUD_VALIDATE(PathIntegrator, mDeepMaxLayers);                  \
     HUD_VALIDATE(PathIntegrator, mDeepLayerBias);                  \
-    HUD_VALIDATE(PathIntegrator, mPad0);                           \
+    HUD_VALIDATE(PathIntegrator, mLightSamplingMode);              \
     HUD_VALIDATE(PathIntegrator, mDeepIDAttrIdxs);                 \
     HUD_VALIDATE(PathIntegrator, mCryptoUVAttrIdx);                \
-    HUD_VALIDATE(PathIntegrator, mPad1);                           \
+    HUD_VALIDATE(PathIntegrator, mSampleLightTree);                \
     HUD_VALIDATE(PathIntegrator, mPathGuide);                      \
+    HUD_VALIDATE(PathIntegrator, mLightSelectionCache);            \
     HUD_END_VALIDATION
 
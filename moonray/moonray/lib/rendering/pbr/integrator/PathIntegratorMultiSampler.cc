@@ -161,7 +161,6 @@ PathIntegrator::addDirectVisibleLightSampleContributions(pbr::TLState *pbrTls,
     MNRY_ASSERT(pbrTls->isIntegratorAccumulatorRunning());
     // Trace light sample shadow rays
     const int lightCount = lSampler.getLightCount();
-    const int lightSampleCount = lSampler.getLightSampleCount();
     const int sampleCount = lSampler.getSampleCount();
 
     const SequenceIDRR sid(sp.mPixel,
@@ -180,6 +179,12 @@ PathIntegrator::addDirectVisibleLightSampleContributions(pbr::TLState *pbrTls,
             continue;
         }
 
+        // Light tree sampled lights may not have been chosen for any sample
+        const int lightSampleCount = lSampler.getLightSampleCount(lightIndex);
+        if (lightSampleCount == 0) {
+            continue;
+        }
+
         // Draw light samples from the light and compute tentative contributions
         drawLightSetSamples(pbrTls, lSampler, bSampler, sp, pv, isect.getP(), cullingNormal, parentRay.getTime(), 
                             sequenceID, lsmp, mSampleClampingDepth, sp.mSampleClampingValue, 
@@ -187,7 +192,7 @@ PathIntegrator::addDirectVisibleLightSampleContributions(pbr::TLState *pbrTls,
 
         // Apply Russian Roulette to the light samples
         if (pv.nonMirrorDepth > 0 && mRussianRouletteThreshold > 0.0f) {
-            applyRussianRoulette(lSampler, lsmp, sp, pv, sequenceID, 
+            applyRussianRoulette(lSampler, lightIndex, lsmp, sp, pv, sequenceID, 
                                  mRussianRouletteThreshold, 
                                  mInvRussianRouletteThreshold, rrSamples);
         }
@@ -215,6 +220,9 @@ PathIntegrator::addDirectVisibleLightSampleContributions(pbr::TLState *pbrTls,
             const FrameState &fs = *pbrTls->mFs;
             const bool hasUnoccludedFlag = fs.mAovSchema->hasLpePrefixFlags(AovSchema::sLpePrefixUnoccluded);
             int32_t assignmentId = isect.getLayerAssignmentId();
+            // Luminance of the sample before and after shadowing, used to learn the light selection
+            const float unoccluded = luminance(lightT);
+            float delivered = 0.0f;
             if (isRayOccluded(pbrTls, light, shadowRay, rayEpsilon, shadowRayEpsilon, presence, assignmentId)) {
                 // Calculate clear radius falloff
                 // only do extra calculations if clear radius falloff enabled
@@ -278,6 +286,7 @@ PathIntegrator::addDirectVisibleLightSampleContributions(pbr::TLState *pbrTls,
                 mcrt_common::Ray trRay(P, lsmp[s].wi, scene_rdl2::math::max(rayEpsilon, shadowRayEpsilon), tfar, time, rayDepth);
                 tr = transmittance(pbrTls, trRay, sp.mPixel, sp.mSubpixelIndex, sequenceID, light);
                 radiance += tr * lightT;
+                delivered = luminance(tr * lightT);
 
                 // LPE
                 if (aovs) {
@@ -340,6 +349,7 @@ PathIntegrator::addDirectVisibleLightSampleContributions(pbr::TLState *pbrTls,
                     }
                 }
             }
+            lSampler.recordLightTreeContribution(lightIndex, unoccluded, delivered);
         }
     }
 
@@ -629,7 +639,22 @@ PathIntegrator::computeRadianceBsdfMultiSampler(pbr::TLState *pbrTls,
     // We use the same splitting strategy as for lobes above.
     const int maxSamplesPerLight = (pv.nonMirrorDepth == 0  ?  mLightSamples  :
             scene_rdl2::math::min(mLightSamples, 1));
-    LightSetSampler lSampler(arena, activeLightSet, bsdf, isect.getP(), maxSamplesPerLight);
+    // In adaptive light sampling mode the bounded lights share these samples
+    // instead, which get spread according to the light tree importance.
+    LightSetSampler lSampler(arena, activeLightSet, bsdf, isect.getP(), maxSamplesPerLight, cullingNormal,
+            getSampleLightTree(), &mLightSelectionCache);
+
+    // Choose the lights the light tree sample budget is spent on
+    if (lSampler.isSamplingLightTree()) {
+        const SequenceIDIntegrator lightTreeSid(pv.nonMirrorDepth,
+                                                sp.mPixel,
+                                                SequenceType::LightTree,
+                                                sp.mSubpixelIndex,
+                                                sequenceID);
+        IntegratorSample1D lightTreeSamples;
+        lightTreeSamples.restart(lightTreeSid, maxSamplesPerLight);
+        lSampler.drawLightTreeSamples(lightTreeSamples, pv.nonMirrorDepth);
+    }
 
     const int lightSampleCount = lSampler.getLightSampleCount();
     LightSample *lsmp = arena->allocArray<LightSample>(lightSampleCount);
@@ -155,8 +155,8 @@ integrateBsdfSample(const BsdfSampler &bSampler, int lobeIndex,
 
     // Compute direct tentative contribution (omit shadowing)
     const bool lobeIsMirror = bSampler.getLobe(lobeIndex)->matchesFlags(shading::BsdfLobe::ALL_MIRROR);
-    const int nl = (lCo.isInvalid  ?  0  :
-            lSampler.getLightSampleCount());
+    const float nl = (lCo.isInvalid  ?  0.0f  :
+            lSampler.getExpectedLightSampleCount(lCo.lightIndex));
     bsmp.tDirect = (lCo.isInvalid  ?  scene_rdl2::math::sBlack  :  (lobeIsMirror  ?
             // Bsdf importance sampling
             lCo.Li * pt  :
@@ -321,8 +321,8 @@ integrateLightSetSample(const LightSetSampler &lSampler,
     bool isInvalid = true;
     lsmp.t = scene_rdl2::math::sBlack;
 
-    const int ni = lSampler.getLightSampleCount();
-    const float invNi = lSampler.getInvLightSampleCount();
+    const float ni = lSampler.getExpectedLightSampleCount(lightIndex);
+    const float invNi = scene_rdl2::math::rcp(ni);
 
     const scene_rdl2::math::Color factor = pv.pathThroughput * invNi * lsmp.Li * scene_rdl2::math::rcp(lsmp.pdf);
 
@@ -443,18 +443,20 @@ drawLightSetSamples(pbr::TLState *pbrTls, const LightSetSampler &lSampler, const
     const Scene *scene = MNRY_VERIFY(pbrTls->mFs->mScene);
     bool lightFilterNeedsSamples = scene->lightFilterNeedsSamples();
 
-    const int spIndex = (pv.nonMirrorDepth == 0) ? 0 : sp.mSubpixelIndex;
-
     Statistics &stats = pbrTls->mStatistics;
 
     {
         const Light *light = lSampler.getLight(lightIndex);
         const LightFilterList *lightFilterList = lSampler.getLightFilterList(lightIndex);
 
-        const int lightSampleCount = lSampler.getLightSampleCount();
+        const int lightSampleCount = lSampler.getLightSampleCount(lightIndex);
 
         // Setup sampler sequence
-        // We want one shared sequence for depth 0.
+        // We want one shared sequence for depth 0. Light tree sampled lights
+        // get a different number of samples for each pixel sample, so they
+        // can't share it.
+        const bool shareSequence = pv.nonMirrorDepth == 0 && !lSampler.isLightTreeSampled(lightIndex);
+        const int spIndex = shareSequence ? 0 : sp.mSubpixelIndex;
         const SequenceIDIntegrator sid(  pv.nonMirrorDepth,
                                          sp.mPixel,
                                          light->getHash(),
@@ -462,7 +464,7 @@ drawLightSetSamples(pbr::TLState *pbrTls, const LightSetSampler &lSampler, const
                                          spIndex,
                                          sequenceID );
         int samplesSoFar = 0;
-        if (pv.nonMirrorDepth == 0) {
+        if (shareSequence) {
             samplesSoFar = sp.mSubpixelIndex * lightSampleCount;       // used here and below
             lightSamples.resume(sid, samplesSoFar);
         } else {
@@ -483,7 +485,7 @@ drawLightSetSamples(pbr::TLState *pbrTls, const LightSetSampler &lSampler, const
                                                      spIndex,
                                                      sequenceID );
 
-            if (pv.nonMirrorDepth == 0) {
+            if (shareSequence) {
                 lightFilterSamples.resume(sidFilter, samplesSoFar);
                 lightFilterSamples3D.resume(sidFilter3D, samplesSoFar);
 
@@ -576,11 +578,11 @@ applyRussianRoulette(const BsdfSampler &bSampler, BsdfSample *bsmp,
 }
 
 void
-applyRussianRoulette(const LightSetSampler &lSampler, LightSample *lsmp,
+applyRussianRoulette(const LightSetSampler &lSampler, int lightIndex, LightSample *lsmp,
         const Subpixel &sp, const PathVertex &pv, unsigned sequenceID,
         float threshold, float invThreshold, IntegratorSample1D& rrSamples)
 {
-    const int lightSampleCount = lSampler.getLightSampleCount();
+    const int lightSampleCount = lSampler.getLightSampleCount(lightIndex);
 
     // Cull shadow rays from the light samples
     for (int s = 0; s < lightSampleCount; ++s) {
@@ -1336,6 +1338,60 @@ CPP_applyVolumeTransmittance(const PathIntegrator *pathIntegrator,
     pbrTls->startIspcAccumulator();
 }
 
+bool
+CPP_isPathGuideEnabled(const PathIntegrator *pathIntegrator)
+{
+    return pathIntegrator->getPathGuide().isEnabled();
+}
+
+bool
+CPP_canSamplePathGuide(const PathIntegrator *pathIntegrator)
+{
+    return pathIntegrator->getPathGuide().canSample();
+}
+
+float
+CPP_getPathGuidePercentage(const PathIntegrator *pathIntegrator)
+{
+    return pathIntegrator->getPathGuide().getPercentage();
+}
+
+void
+CPP_getPathGuidePdfs(const PathIntegrator *pathIntegrator, PbrTLState *pbrTls,
+    unsigned numEntries, const scene_rdl2::math::Vec3f *p, const scene_rdl2::math::Vec3f *dir,
+    float *pdf)
+{
+    MNRY_ASSERT(pbrTls->isIspcAccumulatorRunning());
+
+    pbrTls->stopIspcAccumulator();
+    pathIntegrator->getPathGuide().getPdf(numEntries, p, dir, pdf);
+    pbrTls->startIspcAccumulator();
+}
+
+void
+CPP_samplePathGuideDirections(const PathIntegrator *pathIntegrator, PbrTLState *pbrTls,
+    unsigned numEntries, const scene_rdl2::math::Vec3f *p, const float *r1, const float *r2,
+    scene_rdl2::math::Vec3f *dir, float *pdf)
+{
+    MNRY_ASSERT(pbrTls->isIspcAccumulatorRunning());
+
+    pbrTls->stopIspcAccumulator();
+    pathIntegrator->getPathGuide().sampleDirection(numEntries, p, r1, r2, dir, pdf);
+    pbrTls->startIspcAccumulator();
+}
+
+void
+CPP_recordPathGuideRadiance(const PathIntegrator *pathIntegrator, PbrTLState *pbrTls,
+    unsigned numEntries, const scene_rdl2::math::Vec3f *p, const scene_rdl2::math::Vec3f *dir,
+    const scene_rdl2::math::Color *radiance)
+{
+    MNRY_ASSERT(pbrTls->isIspcAccumulatorRunning());
+
+    pbrTls->stopIspcAccumulator();
+    pathIntegrator->getPathGuide().recordRadiance(numEntries, p, dir, radiance, pbrTls->mArena);
+    pbrTls->startIspcAccumulator();
+}
+
 // -----------------------------------------------------------------
 
 } // namespace pbr
@@ -243,6 +243,34 @@ getHighestPriorityMaterial(const scene_rdl2::rdl2::Material* list[4], int &highe
     return hpMat;
 }
 
+// Material priority lists of VLEN rays, with the memory layout of the varying
+// MaterialPriorityList in PathIntegratorUtil.isph. In vector mode this carries
+// the priority list updated at each hit point (see updateMaterialPriorities())
+// over to the integrator, for the rays it spawns through transmission lobes.
+struct MaterialPriorityListv
+{
+    const scene_rdl2::rdl2::Material* mMaterial[4][VLEN];
+    int32_t mCount[4][VLEN];
+
+    void set(unsigned lane, const scene_rdl2::rdl2::Material* const list[4], const int listCount[4])
+    {
+        for (int i = 0; i < 4; i++) {
+            mMaterial[i][lane] = list[i];
+            mCount[i][lane] = listCount[i];
+        }
+    }
+
+    void get(unsigned lane, const scene_rdl2::rdl2::Material* list[4], int listCount[4]) const
+    {
+        for (int i = 0; i < 4; i++) {
+            list[i] = mMaterial[i][lane];
+            listCount[i] = mCount[i][lane];
+        }
+    }
+};
+
+MNRY_STATIC_ASSERT(sizeof(MaterialPriorityListv) == 4 * VLEN * (sizeof(intptr_t) + sizeof(int32_t)));
+
 // Updates the material priority list for the given ray and returns the mediumIor. See 
 // "Simple Nested Dielectrics in Ray Traced Images".
 float updateMaterialPriorities(mcrt_common::RayDifferential& ray, const Scene* scene, 
@@ -269,7 +297,7 @@ void applyRussianRoulette(const BsdfSampler &bSampler, BsdfSample *bsmp,
         const Subpixel &sp, const PathVertex &pv, unsigned sequenceID,
         float threshold, float invThreshold);
 
-void applyRussianRoulette(const LightSetSampler &lSampler, LightSample *lsmp,
+void applyRussianRoulette(const LightSetSampler &lSampler, int lightIndex, LightSample *lsmp,
         const Subpixel &sp, const PathVertex &pv, unsigned sequenceID,
         float threshold, float invThreshold, IntegratorSample1D& rrSamples);
 
@@ -365,6 +393,27 @@ void
 CPP_applyVolumeTransmittance(const PathIntegrator *pathIntegrator,
     PbrTLState *pbrTls, const uint32_t *rayStateIndices, int32_t lanemask);
 
+bool CPP_isPathGuideEnabled(const PathIntegrator *pathIntegrator);
+
+bool CPP_canSamplePathGuide(const PathIntegrator *pathIntegrator);
+
+float CPP_getPathGuidePercentage(const PathIntegrator *pathIntegrator);
+
+void
+CPP_getPathGuidePdfs(const PathIntegrator *pathIntegrator, PbrTLState *pbrTls,
+    unsigned numEntries, const scene_rdl2::math::Vec3f *p, const scene_rdl2::math::Vec3f *dir,
+    float *pdf);
+
+void
+CPP_samplePathGuideDirections(const PathIntegrator *pathIntegrator, PbrTLState *pbrTls,
+    unsigned numEntries, const scene_rdl2::math::Vec3f *p, const float *r1, const float *r2,
+    scene_rdl2::math::Vec3f *dir, float *pdf);
+
+void
+CPP_recordPathGuideRadiance(const PathIntegrator *pathIntegrator, PbrTLState *pbrTls,
+    unsigned numEntries, const scene_rdl2::math::Vec3f *p, const scene_rdl2::math::Vec3f *dir,
+    const scene_rdl2::math::Color *radiance);
+
 void CPP_addIncoherentRayQueueEntries(pbr::TLState *pbrTls, const RayStatev *rayStatesv,
                                       unsigned numRayStates, const unsigned *indices);
 
@@ -22,6 +22,7 @@
 #include <moonray/rendering/pbr/core/Util.h>
 #include <moonray/rendering/pbr/core/VolumePhase.h>
 #include <moonray/rendering/geom/prim/GeomTLState.h>
+#include <moonray/rendering/geom/prim/MajorantGrid.h>
 #include <moonray/rendering/geom/prim/Primitive.h>
 #include <moonray/rendering/geom/prim/VolumeRegions.h>
 #include <moonray/rendering/geom/prim/VolumeAssignmentTable.h>
@@ -789,6 +790,25 @@ evalVolumeShaders(pbr::TLState *pbrTls, int volumeRegionsCount, int* volumeIds,
     }
 }
 
+// Whether the volume attenuates light from the given light, according to
+// shadow linking. Always true when there is no light.
+static bool
+canCastShadow(mcrt_common::ThreadLocalState* tls, int volumeId, const Light* light)
+{
+    if (!light) {
+        return true;
+    }
+    const geom::internal::VolumeAssignmentTable* vTable = tls->mGeomTls->
+            mVolumeRayState.getVolumeAssignmentTable();
+    int originVolumeId = tls->mGeomTls->mVolumeRayState.getOriginVolumeId();
+    if (originVolumeId != geom::internal::VolumeRayState::ORIGIN_VOLUME_INIT &&
+        volumeId == originVolumeId) {
+        // shadow volume occlusion
+        return true;
+    }
+    return vTable->lookupShadowLinkingWithVolumeId(volumeId).canCastShadow(light->getRdlLight());
+}
+
 static scene_rdl2::math::Color
 evalSigmaT(pbr::TLState *pbrTls, int volumeRegionsCount, int* volumeIds,
         VolumeOverlapMode overlapMode, float rndVar,
@@ -812,32 +832,10 @@ evalSigmaT(pbr::TLState *pbrTls, int volumeRegionsCount, int* volumeIds,
     scene_rdl2::math::Color sigmaTSum(0.f);
 
     mcrt_common::ThreadLocalState* tls = pbrTls->mTopLevelTls;
-    const geom::internal::VolumeAssignmentTable* vTable = tls->mGeomTls->
-            mVolumeRayState.getVolumeAssignmentTable();
 
     for (int i = 0; i < volumeRegionsCount; ++i) {
-        if (light) {
-            bool eval = true;
-            auto& volumeRayState = tls->mGeomTls->mVolumeRayState;
-            int originVolumeId = volumeRayState.getOriginVolumeId();
-            if (originVolumeId == geom::internal::VolumeRayState::ORIGIN_VOLUME_INIT) {
-                // non shadow volume occlusion
-                if (!vTable->lookupShadowLinkingWithVolumeId(volumeIds[i]).
-                    canCastShadow(light->getRdlLight())) {
-                    eval = false;
-                }
-            } else {
-                // shadow volume occlusion
-                if (volumeIds[i] != originVolumeId) {
-                    if (!vTable->lookupShadowLinkingWithVolumeId(volumeIds[i]).
-                        canCastShadow(light->getRdlLight())) {
-                        eval = false;
-                    }
-                }
-            }
-            if (!eval) {
-                continue;
-            }
+        if (!canCastShadow(tls, volumeIds[i], light)) {
+            continue;
         }
         const geom::internal::VolumeSampleInfo& sampleInfo =
             volumeSampleInfo[volumeIds[i]];
@@ -2399,6 +2397,103 @@ PathIntegrator::transmittance(pbr::TLState *pbrTls, const mcrt_common::Ray& ray,
     return tr;
 }
 
+// Residual ratio tracking needs control/majorant bounds for the extinction.
+// These are only available when a single volume region with a majorant grid
+// (currently a VdbVolume without velocity blur) covers the interval.
+static const geom::internal::MajorantGrid*
+getTrackingMajorantGrid(mcrt_common::ThreadLocalState* tls, int volumeRegionsCount, const int* volumeIds,
+        const std::vector<geom::internal::VolumeSampleInfo>& volumeSampleInfo, const Light* light)
+{
+    if (volumeRegionsCount != 1) {
+        return nullptr;
+    }
+    const geom::internal::VolumeSampleInfo& sampleInfo = volumeSampleInfo[volumeIds[0]];
+    if (!(sampleInfo.getProperties() & scene_rdl2::rdl2::VolumeShader::IS_EXTINCTIVE) ||
+        !canCastShadow(tls, volumeIds[0], light)) {
+        return nullptr;
+    }
+    const geom::internal::Primitive* prim =
+        tls->mGeomTls->mVolumeRayState.getCurrentVolumeRegions().getPrimitive(volumeIds[0]);
+    return prim->getMajorantGrid();
+}
+
+// Residual ratio tracking
+// "Residual Ratio Tracking for Estimating Attenuation in Participating Media"
+// Novak et al. SIGGRAPH Asia 2014
+// The control extinction of each majorant grid cell is integrated analytically
+// and the residual sigmaT - control is ratio tracked against its cell bound,
+// which gives an unbiased transmittance estimate. Sparse and smooth regions
+// have a small residual bound and need very few density lookups.
+// Once the estimate drops below the transmittance threshold, tracking
+// continues with Russian roulette instead of stopping, which keeps the
+// optical thickness early out from biasing the estimate.
+static scene_rdl2::math::Color
+residualRatioTracking(pbr::TLState *pbrTls, const geom::internal::MajorantGrid& majorantGrid,
+        int* volumeIds, VolumeOverlapMode overlapMode,
+        const std::vector<geom::internal::VolumeSampleInfo>& volumeSampleInfo,
+        float t0, float t1, float time, const IntegratorSample1D& trSamples,
+        float tauThreshold, const Light* light, float scaleFactor)
+{
+    const geom::internal::VolumeSampleInfo& sampleInfo = volumeSampleInfo[volumeIds[0]];
+    // matches the optical thickness early out of the ray marching estimator
+    const float trThreshold = scene_rdl2::math::exp(-tauThreshold);
+    scene_rdl2::math::Color tr(1.0f);
+
+    // returns false if the path is terminated, in which case tr is zero
+    auto russianRoulette = [&]() {
+        const float lum = luminance(tr);
+        if (lum <= 0.0f) {
+            tr = scene_rdl2::math::Color(0.0f);
+            return false;
+        }
+        if (lum >= trThreshold) {
+            return true;
+        }
+        // survive with probability lum / trThreshold
+        const float survivalProb = lum / trThreshold;
+        float u;
+        trSamples.getSample(&u, 0);
+        if (u >= survivalProb) {
+            tr = scene_rdl2::math::Color(0.0f);
+            return false;
+        }
+        tr /= survivalProb;
+        return true;
+    };
+
+    majorantGrid.traverse(sampleInfo.getSampleRayOrg(), sampleInfo.getSampleRayDir(), t0, t1,
+        [&](float ta, float tb, const geom::internal::MajorantGrid::Cell& cell) {
+            tr *= scene_rdl2::math::exp(-cell.mControl * ((tb - ta) * scaleFactor));
+            if (!russianRoulette()) {
+                return false;
+            }
+            // scaleFactor scales both sigmaT and the control, so the tracking
+            // density is scaled but the ratio (sigmaT - control) / majorant is not
+            const float majorant = cell.mResidualMajorant * scaleFactor;
+            if (majorant > 0.0f) {
+                const float invResidualMajorant = 1.0f / cell.mResidualMajorant;
+                float t = ta;
+                while (true) {
+                    float u;
+                    trSamples.getSample(&u, 0);
+                    t -= scene_rdl2::math::log(1.0f - u) / majorant;
+                    if (t >= tb) {
+                        break;
+                    }
+                    scene_rdl2::math::Color sigmaT = evalSigmaT(pbrTls, 1, volumeIds, overlapMode,
+                                                                0.f, volumeSampleInfo, t, time, light, -1);
+                    tr *= scene_rdl2::math::Color(1.0f) - (sigmaT - cell.mControl) * invResidualMajorant;
+                    if (!russianRoulette()) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        });
+
+    return tr;
+}
+
 scene_rdl2::math::Color
 PathIntegrator::transmittanceSubinterval(pbr::TLState *pbrTls,
         float t0, float t1,
@@ -2443,10 +2538,13 @@ PathIntegrator::transmittanceSubinterval(pbr::TLState *pbrTls,
         scene_rdl2::math::Color sigmaT = evalSigmaT(pbrTls, volumeRegionsCount, volumeIds, mVolumeOverlapMode, rndVal,
             volumeSampleInfo, t0, time, light, rayVolumeDepth);
         tr = exp(-sigmaT * (t1 - t0) * scaleFactor);
+    } else if (const geom::internal::MajorantGrid* majorantGrid =
+               getTrackingMajorantGrid(tls, volumeRegionsCount, volumeIds, volumeSampleInfo, light)) {
+        tr = residualRatioTracking(pbrTls, *majorantGrid, volumeIds, mVolumeOverlapMode, volumeSampleInfo,
+                                   t0, t1, time, trSamples, tauThreshold, light, scaleFactor);
     } else {
-        // For now using traditional ray marching approach.
-        // Once we have the ability to query averge value on leaf node,
-        // we can potentially replace this with residual ratio tracking
+        // Traditional ray marching for overlapping volumes and volumes
+        // without a majorant grid
 
         // figure out the step size: when there are multiple volume regions
         // in this interval, use the smallest feature size for stepping
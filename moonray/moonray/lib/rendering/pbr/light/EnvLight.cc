@@ -18,6 +18,7 @@ using namespace scene_rdl2::math;
 
 bool                             EnvLight::sAttributeKeyInitialized;
 scene_rdl2::rdl2::AttributeKey<scene_rdl2::rdl2::Bool>   EnvLight::sSampleUpperHemisphereOnlyKey;
+scene_rdl2::rdl2::AttributeKey<scene_rdl2::rdl2::Bool>   EnvLight::sCosineProductSamplingKey;
 
 /// Special case for EnvLight where we want +Y to be the up direction in world/
 /// render space. We still want z to be up in local space.
@@ -124,7 +125,8 @@ EnvLight::globalToLocalXform(float time, bool needed) const
 
 EnvLight::EnvLight(const scene_rdl2::rdl2::Light* rdlLight) :
     Light(rdlLight),
-    mHemispherical(false)
+    mHemispherical(false),
+    mProductDistribution(nullptr)
 {
     mIsOpaqueInAlpha = false;
 
@@ -133,7 +135,10 @@ EnvLight::EnvLight(const scene_rdl2::rdl2::Light* rdlLight) :
     ispc::EnvLight_init(this->asIspc());
 }
 
-EnvLight::~EnvLight() { }
+EnvLight::~EnvLight()
+{
+    delete mProductDistribution;
+}
 
 bool
 EnvLight::update(const Mat4d& world2render)
@@ -200,8 +205,18 @@ EnvLight::update(const Mat4d& world2render)
     // Set here in case we early-out
     mLog2TexelAngle = scene_rdl2::math::neg_inf;
 
-    if (!updateImageMap(mHemispherical ? Distribution2D::HEMISPHERICAL :
-                                         Distribution2D::SPHERICAL)) {
+    bool imageMapRebuilt = false;
+    const bool imageMapValid = updateImageMap(mHemispherical ? Distribution2D::HEMISPHERICAL :
+                                                               Distribution2D::SPHERICAL, &imageMapRebuilt);
+
+    // The product distribution is derived from the image distribution
+    const bool cosineProductSampling = mRdlLight->get<scene_rdl2::rdl2::Bool>(sCosineProductSamplingKey);
+    if (imageMapRebuilt || !mDistribution || !cosineProductSampling) {
+        delete mProductDistribution;
+        mProductDistribution = nullptr;
+    }
+
+    if (!imageMapValid) {
         return false;
     }
 
@@ -213,6 +228,10 @@ EnvLight::update(const Mat4d& world2render)
         float texelAngleLatitude  = sPi    / (float)mDistribution->getHeight();
         float texelAngle = max(texelAngleLongitude, texelAngleLatitude);
         mLog2TexelAngle = scene_rdl2::math::log2(texelAngle);
+
+        if (cosineProductSampling && !mProductDistribution) {
+            mProductDistribution = new CosineProductDistribution(*mDistribution, mHemispherical);
+        }
     }
 
     return true;
@@ -252,6 +271,7 @@ EnvLight::intersect(const Vec3f &p, const Vec3f *n, const Vec3f &wi, float time,
     isect.N = -wi;
     isect.distance = sEnvLightDistance;
     isect.uv = mDistribution ? local2uv(globalToLocal(wi, time)) : zero;
+    setProductPdf(getProductBin(n, time), isect);
 
     return true;
 }
@@ -262,9 +282,21 @@ EnvLight::sample(const Vec3f &p, const Vec3f *n, float time, const Vec3f& r,
 {
     MNRY_ASSERT(mOn);
 
+    const int productBin = getProductBin(n, time);
     if (mDistribution) {
-        float mipLevel = getMipLevel(rayDirFootprint);
-        mDistribution->sample(r[0], r[1], mipLevel, &isect.uv, nullptr, mTextureFilter);
+        // Pick between the product and the image distribution with r[0]
+        float r0 = r[0];
+        if (productBin >= 0 && r0 < ENV_LIGHT_PRODUCT_SAMPLING_PROBABILITY) {
+            r0 = r0 / ENV_LIGHT_PRODUCT_SAMPLING_PROBABILITY;
+            mProductDistribution->sample(productBin, r0, r[1], &isect.uv, nullptr);
+        } else {
+            if (productBin >= 0) {
+                r0 = min((r0 - ENV_LIGHT_PRODUCT_SAMPLING_PROBABILITY) /
+                         (1.0f - ENV_LIGHT_PRODUCT_SAMPLING_PROBABILITY), sOneMinusEpsilon);
+            }
+            float mipLevel = getMipLevel(rayDirFootprint);
+            mDistribution->sample(r0, r[1], mipLevel, &isect.uv, nullptr, mTextureFilter);
+        }
 
         // Handle singularities at poles so that sample() and intersect()
         // will return identical values. if v == 0, then throw away u value
@@ -290,6 +322,7 @@ EnvLight::sample(const Vec3f &p, const Vec3f *n, float time, const Vec3f& r,
 
     isect.N = -wi;
     isect.distance = sEnvLightDistance;
+    setProductPdf(productBin, isect);
 
     return true;
 }
@@ -324,10 +357,12 @@ EnvLight::eval(mcrt_common::ThreadLocalState* tls, const Vec3f &wi, const Vec3f
         if (mDistribution) {
             // We must account for the mapping transformation so we express the
             // pdf density on the sphere in solid angles (see pbrt section 14.6.5)
+            // When the product distribution was also sampled, the pdf is
+            // that of the mixture of both distributions.
             float sinTheta = scene_rdl2::math::sin((isect.uv[1]) * sPi);
             sinTheta = max(sinTheta, sEpsilon);
-            *pdf = mDistribution->pdf(isect.uv[0], isect.uv[1], mipLevel, mTextureFilter)
-                 / (sTwoPiSqr * sinTheta);
+            const float imagePdf = mDistribution->pdf(isect.uv[0], isect.uv[1], mipLevel, mTextureFilter);
+            *pdf = lerp(imagePdf, isect.data[0], isect.data[1]) / (sTwoPiSqr * sinTheta);
             MNRY_ASSERT(finite(*pdf));
         } else {
             *pdf = mInvArea;
@@ -337,6 +372,28 @@ EnvLight::eval(mcrt_common::ThreadLocalState* tls, const Vec3f &wi, const Vec3f
     return radiance;
 }
 
+int
+EnvLight::getProductBin(const Vec3f *n, float time) const
+{
+    if (!mProductDistribution || !n) {
+        return -1;
+    }
+    const int bin = CosineProductDistribution::getNormalBin(globalToLocal(*n, time));
+    return mProductDistribution->canSample(bin)  ?  bin  :  -1;
+}
+
+void
+EnvLight::setProductPdf(int productBin, LightIntersection &isect) const
+{
+    if (productBin < 0) {
+        isect.data[0] = 0.0f;
+        isect.data[1] = 0.0f;
+        return;
+    }
+    isect.data[0] = mProductDistribution->pdf(productBin, isect.uv[0], isect.uv[1]);
+    isect.data[1] = ENV_LIGHT_PRODUCT_SAMPLING_PROBABILITY;
+}
+
 Vec3f
 EnvLight::getEquiAngularPivot(const Vec3f& r, float time) const
 {
@@ -357,6 +414,7 @@ EnvLight::initAttributeKeys(const scene_rdl2::rdl2::SceneClass &sc)
     sAttributeKeyInitialized = true;
 
     sSampleUpperHemisphereOnlyKey = sc.getAttributeKey<scene_rdl2::rdl2::Bool>("sample_upper_hemisphere_only");
+    sCosineProductSamplingKey = sc.getAttributeKey<scene_rdl2::rdl2::Bool>("cosine_product_sampling");
 
     MOONRAY_FINISH_NON_THREADSAFE_STATIC_WRITE
 }
@@ -80,6 +80,15 @@ private:
     scene_rdl2::math::Vec3f globalToLocal(const scene_rdl2::math::Vec3f &v, float time) const;
     scene_rdl2::math::Xform3f globalToLocalXform(float time, bool needed = true) const;
 
+    /// Return the bin of mProductDistribution to sample for the normal n, or
+    /// -1 if only mDistribution should be sampled.
+    int getProductBin(const scene_rdl2::math::Vec3f *n, float time) const;
+
+    /// eval() doesn't know the normal, so the pdf of sampling the direction
+    /// through mProductDistribution is passed along in the intersection:
+    /// data[0] is that pdf and data[1] the probability of using it.
+    void setProductPdf(int productBin, LightIntersection &isect) const;
+
     /// Copy is disabled
     EnvLight(const EnvLight &other);
     const EnvLight &operator=(const EnvLight &other);
@@ -100,6 +109,7 @@ private:
     // cppcheck-suppress duplInheritedMember
     static bool sAttributeKeyInitialized;
     static scene_rdl2::rdl2::AttributeKey<scene_rdl2::rdl2::Bool> sSampleUpperHemisphereOnlyKey;
+    static scene_rdl2::rdl2::AttributeKey<scene_rdl2::rdl2::Bool> sCosineProductSamplingKey;
 
     static const scene_rdl2::math::Mat4f sLocalOrientation;
 };
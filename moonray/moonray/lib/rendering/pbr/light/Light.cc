@@ -111,8 +111,10 @@ Light::updateVisibilityFlags()
 }
 
 bool
-Light::updateImageMap(Distribution2D::Mapping distributionMapping)
+Light::updateImageMap(Distribution2D::Mapping distributionMapping, bool *rebuilt)
 {
+    if (rebuilt) *rebuilt = false;
+
     // Re-creating the image distribution below is expensive, so let's make
     // sure we really need this
     if (!mRdlLight->hasChanged(scene_rdl2::rdl2::Light::sTextureKey)
@@ -134,6 +136,7 @@ Light::updateImageMap(Distribution2D::Mapping distributionMapping)
         return true;
     }
 
+    if (rebuilt) *rebuilt = true;
     mDistributionMapping = distributionMapping;
 
     delete mDistribution;
@@ -268,7 +268,8 @@ protected:
     /// the sampling CDF in the mDistribution.
     /// Returns false if there was an error loading the map and true otherwise.
     /// Also returns true if there is no map to load.
-    bool updateImageMap(Distribution2D::Mapping distributionMapping);
+    /// If rebuilt is non-null, it is set to whether mDistribution was re-created.
+    bool updateImageMap(Distribution2D::Mapping distributionMapping, bool *rebuilt = nullptr);
 
     void updatePresenceShadows();
     void updateRayTermination();
@@ -247,26 +247,37 @@ enum LightSidednessType
 
 //----------------------------------------------------------------------------
 
+// Probability of sampling an EnvLight through its CosineProductDistribution
+// rather than through its ImageDistribution, when the normal is known
+#define ENV_LIGHT_PRODUCT_SAMPLING_PROBABILITY 0.75f
+
 #define ENV_LIGHT_MEMBERS                                                \
     HUD_MEMBER(HUD_NAMESPACE(scene_rdl2::math, ReferenceFrame), mFrame); \
                                                                          \
     /* Are we upper-hemisphere-only ? */                                 \
     HUD_MEMBER(bool, mHemispherical);                                    \
-    HUD_MEMBER(float, mLog2TexelAngle)
+    HUD_MEMBER(float, mLog2TexelAngle);                                  \
+    HUD_PTR(CosineProductDistribution *, mProductDistribution)
 
 
-#define ENV_LIGHT_VALIDATION                \
-    HUD_BEGIN_VALIDATION(EnvLight);         \
-    HUD_VALIDATE(EnvLight, mFrame);         \
-    HUD_VALIDATE(EnvLight, mHemispherical); \
-    HUD_VALIDATE(EnvLight, mLog2TexelAngle);\
+#define ENV_LIGHT_VALIDATION                      \
+    HUD_BEGIN_VALIDATION(EnvLight);               \
+    HUD_VALIDATE(EnvLight, mFrame);               \
+    HUD_VALIDATE(EnvLight, mHemispherical);       \
+    HUD_VALIDATE(EnvLight, mLog2TexelAngle);      \
+    HUD_VALIDATE(EnvLight, mProductDistribution); \
     HUD_END_VALIDATION
 
 
 //----------------------------------------------------------------------------
 
+// Number of children of the nodes of the MeshLight sampling BVH
+#define MESH_LIGHT_BVH_WIDTH 4
+// Quantized thetaO of a MeshLight bounding cone that covers the whole sphere
+#define MESH_LIGHT_QTHETAO_SPHERE 255
+
 #define MESH_LIGHT_MEMBERS                           \
-    HUD_PTR(Node*, mBVHPtr);                         \
+    HUD_PTR(WideNode*, mBVHPtr);                     \
     HUD_MEMBER(uint32_t, mBVHSize);                  \
     HUD_MEMBER(uint32_t, mMbSteps);                  \
     HUD_MEMBER(uint32_t, mFaceCount);                \
@@ -276,9 +287,16 @@ enum LightSidednessType
     HUD_PTR(uint32_t*, mFaceOffsetPtr);              \
     HUD_PTR(uint32_t*, mFaceVertexCountPtr);         \
     HUD_PTR(int*, mPrimIDToNodeIDPtr);               \
+    /* Per face data, in BVH build order */          \
+    HUD_PTR(float*, mFaceInvAreaPtr);                \
+    HUD_PTR(HUD_NAMESPACE(scene_rdl2::math, Vec3f*), mFaceNormalPtr); \
+    HUD_PTR(int*, mFacePrimIDPtr);                   \
+    HUD_PTR(int*, mFaceGeomIDPtr);                   \
+    /* Index buffer of each mesh */                  \
+    HUD_PTR(const HUD_UNIFORM int * const HUD_UNIFORM *, mMeshIndicesPtr); \
     HUD_MEMBER(RTCScene, mRtcScene);                 \
     HUD_PTR(const int64 *, mMapShader);              \
-    HUD_ISPC_PAD(mPad, 388)
+    HUD_ISPC_PAD(mPad, 508)
 
 
 #define MESH_LIGHT_VALIDATION                     \
@@ -290,6 +308,11 @@ enum LightSidednessType
     HUD_VALIDATE(MeshLight, mVerticesPtr);        \
     HUD_VALIDATE(MeshLight, mFaceVertexCountPtr); \
     HUD_VALIDATE(MeshLight, mPrimIDToNodeIDPtr);  \
+    HUD_VALIDATE(MeshLight, mFaceInvAreaPtr);     \
+    HUD_VALIDATE(MeshLight, mFaceNormalPtr);      \
+    HUD_VALIDATE(MeshLight, mFacePrimIDPtr);      \
+    HUD_VALIDATE(MeshLight, mFaceGeomIDPtr);      \
+    HUD_VALIDATE(MeshLight, mMeshIndicesPtr);     \
     HUD_VALIDATE(MeshLight, mRtcScene);           \
     HUD_VALIDATE(MeshLight, mMapShader);          \
     HUD_END_VALIDATION
@@ -252,7 +252,7 @@ LightAccelerator::intersect(const Vec3f &P,  const Vec3f* N, const Vec3f &wi,
         visibilityMask, samples, depth, boundedIsect, numHits, lightIdMap);
 
     LightIntersection unboundedIsect;
-    int unboundedLightIdx = intersectUnbounded(P, wi, time, maxDistance, includeRayTerminationLights,
+    int unboundedLightIdx = intersectUnbounded(P, N, wi, time, maxDistance, includeRayTerminationLights,
         visibilityMask, samples, depth, unboundedIsect, numHits, lightIdMap);
 
     if (unboundedLightIdx >= 0) {
@@ -330,7 +330,7 @@ LightAccelerator::intersectBounded(const Vec3f &P,  const Vec3f* N, const Vec3f
 // Randomly intersect a ray against the LightAccelerator's list of unbounded lights.
 
 int
-LightAccelerator::intersectUnbounded(const Vec3f &P, const Vec3f &wi, float time,
+LightAccelerator::intersectUnbounded(const Vec3f &P, const Vec3f* N, const Vec3f &wi, float time,
         float maxDistance, bool includeRayTerminationLights, int visibilityMask, IntegratorSample1D &samples,
         int depth, LightIntersection &isect, int &numHits, const int* lightIdMap) const
 {
@@ -355,8 +355,8 @@ LightAccelerator::intersectUnbounded(const Vec3f &P, const Vec3f &wi, float time
             continue;
         }
 
-        if (light->intersect(P, nullptr /*unbounded lights do not depend on the shade point normal*/,
-                wi, time, maxDistance, currentIsect)) {
+        // The culling normal doesn't cull unbounded lights, but the EnvLight pdf depends on it
+        if (light->intersect(P, N, wi, time, maxDistance, currentIsect)) {
 
             numHits++;
 
@@ -41,6 +41,7 @@ public:
     finline int getLightCount() const { return mLightCount; }
     finline bool useAcceleration() const { return mBoundedLightCount >= SCALAR_THRESHOLD_COUNT; }
     void buildSamplingTree();
+    finline const LightTree& getSamplingTree() const { return mSamplingTree; }
 
 private:
     LIGHT_ACCELERATOR_MEMBERS;
@@ -48,7 +49,8 @@ private:
     int intersectBounded(const scene_rdl2::math::Vec3f &P, const scene_rdl2::math::Vec3f* N, const scene_rdl2::math::Vec3f &wi,
         float time, float maxDistance, bool includeRayTerminationLights, int visibilityMask,
         IntegratorSample1D &samples, int depth, LightIntersection &isect, int &numHits, const int* lightIdMap) const;
-    int intersectUnbounded(const scene_rdl2::math::Vec3f &P, const scene_rdl2::math::Vec3f &wi, float time,
+    int intersectUnbounded(const scene_rdl2::math::Vec3f &P, const scene_rdl2::math::Vec3f* N,
+        const scene_rdl2::math::Vec3f &wi, float time,
         float maxDistance, bool includeRayTerminationLights, int visibilityMask, IntegratorSample1D &samples,
         int depth, LightIntersection &isect, int &numHits, const int* lightIdMap) const;
 };
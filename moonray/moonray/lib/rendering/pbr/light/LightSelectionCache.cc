@@ -0,0 +1,265 @@
+// Copyright 2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file LightSelectionCache.cc
+
+#include "LightSelectionCache.h"
+
+#include <scene_rdl2/common/math/Math.h>
+
+#include <atomic>
+#include <utility>
+
+namespace moonray {
+namespace pbr {
+
+using namespace scene_rdl2::math;
+
+namespace {
+
+// These could become user settings via rdl scene variables.
+// So far, these defaults seem to work reasonably well.
+
+// Number of cells along the largest extent of the scene
+constexpr float sCellsPerAxis = 64.f;
+
+// Entries in each of the two tables, must be a power of two
+constexpr size_t sEntryCount = size_t(1) << 19;
+
+// Samples needed in an entry before its weight is trusted
+constexpr uint32_t sMinSampleCount = 8;
+
+// Lower bound of the weights, so that no light ever becomes impossible to sample
+constexpr float sMinWeight = 0.05f;
+
+finline uint64_t
+mix(uint64_t x)
+{
+    // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+finline uint32_t
+quantize(float x)
+{
+    return static_cast<uint32_t>(clamp(x, 0.f, sCellsPerAxis - 1.f));
+}
+
+} // end anonymous namespace
+
+// ---------------------------------------------- LightSelectionCache::Impl --------------------------------------------
+
+class LightSelectionCache::Impl
+{
+public:
+    Impl();
+    Impl(const Impl&) = delete;
+    Impl& operator=(const Impl&) = delete;
+    ~Impl() = default;
+
+    void startFrame(const BBox3f& bbox, bool enable);
+    void passReset();
+
+    uint64_t getCellKey(const LightTree* tree, const Vec3f& p, const Vec3f* n) const;
+    float getWeight(uint64_t key) const;
+    void record(uint64_t key, float unoccluded, float delivered) const;
+
+    bool isEnabled() const { return mEnable; }
+    bool canSample() const { return mEnable && mResetIterations > 0; }
+
+private:
+    struct Entry
+    {
+        std::atomic<uint64_t> mKey;         // 0 when the entry is free
+        std::atomic<uint32_t> mCount;       // number of samples recorded
+        std::atomic<float> mUnoccluded;     // sum of the sample luminances before shadowing
+        std::atomic<float> mDelivered;      // sum of the sample luminances after shadowing
+    };
+
+    static void clear(Entry* entries);
+
+    bool mEnable;
+    unsigned int mResetIterations;
+    Vec3f mOrigin;
+    float mInvCellSize;
+
+    // Entries are recorded into mRecordEntries and looked up in mLookupEntries, the two tables are swapped on
+    // every pass reset. Both are direct mapped, a record whose entry is taken by another key is dropped.
+    std::unique_ptr<Entry[]> mRecordEntries;
+    std::unique_ptr<Entry[]> mLookupEntries;
+};
+
+LightSelectionCache::Impl::Impl() :
+    mEnable(false),
+    mResetIterations(0),
+    mOrigin(0.f),
+    mInvCellSize(0.f)
+{
+}
+
+void
+LightSelectionCache::Impl::startFrame(const BBox3f& bbox, bool enable)
+{
+    mEnable = enable;
+    mResetIterations = 0;
+    if (!mEnable) {
+        mRecordEntries.reset();
+        mLookupEntries.reset();
+        return;
+    }
+
+    const Vec3f size = bbox.size();
+    const float maxExtent = max(size.x, max(size.y, size.z));
+    mOrigin = bbox.lower;
+    mInvCellSize = maxExtent > 0.f  ?  sCellsPerAxis / maxExtent  :  0.f;
+
+    if (!mRecordEntries) {
+        mRecordEntries.reset(new Entry[sEntryCount]);
+        mLookupEntries.reset(new Entry[sEntryCount]);
+    }
+    clear(mRecordEntries.get());
+    clear(mLookupEntries.get());
+}
+
+void
+LightSelectionCache::Impl::passReset()
+{
+    // As with the PathGuide, it is the responsibility of the render driver to
+    // ensure no render thread accesses the cache during this call.
+    MNRY_ASSERT(mEnable);
+    std::swap(mRecordEntries, mLookupEntries);
+    clear(mRecordEntries.get());
+    ++mResetIterations;
+}
+
+uint64_t
+LightSelectionCache::Impl::getCellKey(const LightTree* tree, const Vec3f& p, const Vec3f* n) const
+{
+    const Vec3f np = (p - mOrigin) * mInvCellSize;
+    uint64_t cell = (uint64_t(quantize(np.x)) << 16) | (uint64_t(quantize(np.y)) << 8) | quantize(np.z);
+
+    // Shading points facing away from each other don't see the same lights,
+    // split the cells by the dominant axis of the normal
+    uint64_t orientation = 6;
+    if (n) {
+        const Vec3f a(abs(n->x), abs(n->y), abs(n->z));
+        const int axis = a.x > a.y  ?  (a.x > a.z ? 0 : 2)  :  (a.y > a.z ? 1 : 2);
+        orientation = axis * 2 + ((*n)[axis] < 0.f  ?  1  :  0);
+    }
+    cell |= orientation << 24;
+
+    // Each light set has its own light tree
+    return mix(cell ^ mix(reinterpret_cast<uintptr_t>(tree)));
+}
+
+float
+LightSelectionCache::Impl::getWeight(uint64_t key) const
+{
+    key = key  ?  key  :  1;
+    const Entry& entry = mLookupEntries[key & (sEntryCount - 1)];
+    if (entry.mKey.load(std::memory_order_relaxed) != key ||
+        entry.mCount.load(std::memory_order_relaxed) < sMinSampleCount) {
+        return 1.f;
+    }
+
+    const float unoccluded = entry.mUnoccluded.load(std::memory_order_relaxed);
+    if (unoccluded <= 0.f) {
+        return 1.f;
+    }
+    const float visibility = saturate(entry.mDelivered.load(std::memory_order_relaxed) / unoccluded);
+    return sMinWeight + (1.f - sMinWeight) * visibility;
+}
+
+void
+LightSelectionCache::Impl::record(uint64_t key, float unoccluded, float delivered) const
+{
+    key = key  ?  key  :  1;
+    Entry& entry = mRecordEntries[key & (sEntryCount - 1)];
+    uint64_t entryKey = entry.mKey.load(std::memory_order_relaxed);
+    if (entryKey == 0 &&
+        entry.mKey.compare_exchange_strong(entryKey, key, std::memory_order_acq_rel)) {
+        entryKey = key;
+    }
+    if (entryKey != key) {
+        return;
+    }
+
+    entry.mCount.fetch_add(1, std::memory_order_relaxed);
+    entry.mUnoccluded.fetch_add(unoccluded, std::memory_order_relaxed);
+    entry.mDelivered.fetch_add(delivered, std::memory_order_relaxed);
+}
+
+void
+LightSelectionCache::Impl::clear(Entry* entries)
+{
+    for (size_t i = 0; i < sEntryCount; ++i) {
+        entries[i].mKey.store(0, std::memory_order_relaxed);
+        entries[i].mCount.store(0, std::memory_order_relaxed);
+        entries[i].mUnoccluded.store(0.f, std::memory_order_relaxed);
+        entries[i].mDelivered.store(0.f, std::memory_order_relaxed);
+    }
+}
+
+// --------------------------------------------------- Cell ------------------------------------------------------------
+
+LightSelectionCache::Cell::Cell(const LightSelectionCache* cache, const LightTree* tree,
+                                const Vec3f& p, const Vec3f* n) :
+    mImpl(cache->mImpl.get()),
+    mKey(cache->mImpl->getCellKey(tree, p, n))
+{
+}
+
+float
+LightSelectionCache::Cell::getNodeWeight(uint32_t nodeIndex) const
+{
+    if (!mImpl->canSample()) {
+        return 1.f;
+    }
+    return mImpl->getWeight(mix(mKey + nodeIndex));
+}
+
+void
+LightSelectionCache::Cell::recordNode(uint32_t nodeIndex, float unoccluded, float delivered) const
+{
+    mImpl->record(mix(mKey + nodeIndex), unoccluded, delivered);
+}
+
+// ---------------------------------------------- LightSelectionCache --------------------------------------------------
+
+LightSelectionCache::LightSelectionCache() :
+    mImpl(new Impl)
+{
+}
+
+LightSelectionCache::~LightSelectionCache()
+{
+}
+
+void
+LightSelectionCache::startFrame(const BBox3f& bbox, bool enable)
+{
+    mImpl->startFrame(bbox, enable);
+}
+
+void
+LightSelectionCache::passReset()
+{
+    mImpl->passReset();
+}
+
+bool
+LightSelectionCache::isEnabled() const
+{
+    return mImpl->isEnabled();
+}
+
+bool
+LightSelectionCache::canSample() const
+{
+    return mImpl->canSample();
+}
+
+} // end namespace pbr
+} // end namespace moonray
@@ -0,0 +1,83 @@
+// Copyright 2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file LightSelectionCache.h
+#pragma once
+
+#include <scene_rdl2/common/math/BBox.h>
+#include <scene_rdl2/common/math/Vec3.h>
+
+#include <memory>
+#include <stdint.h>
+
+namespace moonray {
+namespace pbr {
+
+class LightTree;
+
+// ------------------------------------------- LightSelectionCache -----------------------------------------------------
+/// The importance a LightTree gives to its nodes only accounts for their bounds and orientation cones, so lights
+/// which are occluded from a shading point keep receiving as many samples as unoccluded ones. The
+/// LightSelectionCache learns, for the shading points falling into a cell of a spatial hash (keyed by position and
+/// normal), which fraction of the unoccluded contribution of each light tree node was actually delivered once shadow
+/// rays were traced. The light tree then scales the importance of its nodes by that fraction.
+///
+/// Like the PathGuide, the cache expects the render to be broken into passes: contributions are recorded during
+/// every pass and the light tree is reweighted based on what was recorded in the previous pass, so the weights
+/// stay constant for the duration of a pass. Weights never reach zero, which keeps light tree sampling unbiased
+/// when the cache is wrong.
+
+class LightSelectionCache
+{
+    class Impl;
+
+public:
+    /// The cache entries of one light tree for the cell a shading point falls into. A default constructed cell
+    /// is not tied to any cache.
+    class Cell
+    {
+    public:
+        Cell() : mImpl(nullptr), mKey(0) {}
+        Cell(const LightSelectionCache* cache, const LightTree* tree,
+             const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n);
+
+        bool isValid() const { return mImpl != nullptr; }
+
+        /// Importance scale learned for the node during the previous pass
+        float getNodeWeight(uint32_t nodeIndex) const;
+
+        /// Record a light sample drawn through the node. This method is "const" because it is thread-safe.
+        void recordNode(uint32_t nodeIndex, float unoccluded, float delivered) const;
+
+    private:
+        const Impl* mImpl;
+        uint64_t mKey;
+    };
+
+    LightSelectionCache();
+    LightSelectionCache(const LightSelectionCache&) = delete;
+    LightSelectionCache& operator=(const LightSelectionCache&) = delete;
+    ~LightSelectionCache();
+
+    /// Initialize the cache for a new frame. Bbox is an aabb of the scene.
+    void startFrame(const scene_rdl2::math::BBox3f& bbox, bool enable);
+
+    /// Make what was recorded during the pass just rendered available for sampling, and start recording anew.
+    ///
+    /// This method is not thread safe.  It should be called only from a single thread when no other thread could
+    /// possibly access the cache.
+    void passReset();
+
+    /// Is the cache enabled?
+    bool isEnabled() const;
+
+    /// Is there anything to sample from yet? This includes a check for isEnabled()
+    bool canSample() const;
+
+private:
+    std::unique_ptr<Impl> mImpl;
+};
+
+} // end namespace pbr
+} // end namespace moonray
+
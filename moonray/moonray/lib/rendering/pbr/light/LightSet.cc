@@ -76,6 +76,7 @@ LightSet::intersectAndEval(mcrt_common::ThreadLocalState *tls, const Vec3f &P, c
     // Initialize contribution
     lCo.isInvalid = true;
     lCo.light = nullptr;
+    lCo.lightIndex = -1;
     lCo.distance = sMaxValue;
     lCo.Li = sBlack;
     lCo.pdf = 0.0f;
@@ -99,6 +100,7 @@ LightSet::intersectAndEval(mcrt_common::ThreadLocalState *tls, const Vec3f &P, c
     }
 
     lCo.light = light;
+    lCo.lightIndex = lightIdx;
     lCo.distance = isect.distance;
 
     // Evaluate the intersected light Li and pdf
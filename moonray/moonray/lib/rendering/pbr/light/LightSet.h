@@ -35,9 +35,11 @@ class LightAccelerator;
 // - Li is the emitted radiance of the intersected light
 //   in direction wi, and 0 if there is no light in that direction
 //   TODO: or if the intersected light is not in the subset
+// - lightIndex is the index of the intersected light in the LightSet
 struct LightContribution {
     bool isInvalid;
     const Light* light;
+    int lightIndex;
     float distance;
     float pdf;
     scene_rdl2::math::Color Li;
@@ -54,7 +56,7 @@ class LightSet
 {
 public:
     /// Constructor / Destructor
-    LightSet() : mLights(nullptr), mLightCount(0), mAccelerator(nullptr) {}
+    LightSet() : mLights(nullptr), mLightCount(0), mAccelerator(nullptr), mLightAcceleratorIndices(nullptr) {}
     ~LightSet() {}
 
 
@@ -72,6 +74,7 @@ public:
         mLightFilterLists = lightFilterLists;
         mAccelerator = nullptr;
         mAcceleratorLightIdMap = nullptr;
+        mLightAcceleratorIndices = nullptr;
     }
 
     finline int getLightCount() const              {  return mLightCount;  }
@@ -107,7 +110,7 @@ public:
             bool includeRayTerminationLights, IntegratorSample1D &samples, int depth,  int visibilityMask,
             LightContribution &lCo, float rayDirFootprint) const;
 
-    finline const LightAccelerator* getAccelerator() { return mAccelerator; }
+    finline const LightAccelerator* getAccelerator() const { return mAccelerator; }
 
     // Set the accelerator for this light set. The accelerator may contain more lights than the LightSet itself.
     // This is because the accelerator's light list is generated during render prep, and includes all of the original
@@ -121,6 +124,26 @@ public:
         mAcceleratorLightIdMap = lightIdMap;
     }
 
+    // Set the inverse of the lightIdMap: the index in the LightAccelerator of each light in the LightSet.
+    finline void setLightAcceleratorIndices(const int* lightAcceleratorIndices)
+    {
+        mLightAcceleratorIndices = lightAcceleratorIndices;
+    }
+
+    // Returns the index in the LightSet of the LightAccelerator light with the given index,
+    // or -1 if the light isn't part of the LightSet.
+    finline int getAcceleratorLightSetIndex(int accIndex) const
+    {
+        return mAcceleratorLightIdMap[accIndex];
+    }
+
+    // Returns the index in the LightAccelerator of the light with the given index,
+    // or -1 if the mapping wasn't set up.
+    finline int getLightAcceleratorIndex(int index) const
+    {
+        return mLightAcceleratorIndices ? mLightAcceleratorIndices[index] : -1;
+    }
+
 private:
     /// Copy is disabled
     LightSet(const LightSet &other);
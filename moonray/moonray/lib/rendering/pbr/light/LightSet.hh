@@ -16,16 +16,18 @@
     HUD_PTR(const HUD_UNIFORM LightFilterList * const HUD_UNIFORM *, mLightFilterLists);    \
     HUD_MEMBER(int32_t, mLightCount);                                                       \
     HUD_PTR(const LightAccelerator*, mAccelerator);                                         \
-    HUD_PTR(const HUD_UNIFORM int * HUD_UNIFORM, mAcceleratorLightIdMap)
-
-
-#define LIGHT_SET_VALIDATION                        \
-    HUD_BEGIN_VALIDATION(LightSet);                 \
-    HUD_VALIDATE(LightSet, mLights);                \
-    HUD_VALIDATE(LightSet, mLightFilterLists);      \
-    HUD_VALIDATE(LightSet, mLightCount);            \
-    HUD_VALIDATE(LightSet, mAccelerator);           \
-    HUD_VALIDATE(LightSet, mAcceleratorLightIdMap); \
+    HUD_PTR(const HUD_UNIFORM int * HUD_UNIFORM, mAcceleratorLightIdMap);                   \
+    HUD_PTR(const HUD_UNIFORM int * HUD_UNIFORM, mLightAcceleratorIndices)
+
+
+#define LIGHT_SET_VALIDATION                            \
+    HUD_BEGIN_VALIDATION(LightSet);                     \
+    HUD_VALIDATE(LightSet, mLights);                    \
+    HUD_VALIDATE(LightSet, mLightFilterLists);          \
+    HUD_VALIDATE(LightSet, mLightCount);                \
+    HUD_VALIDATE(LightSet, mAccelerator);               \
+    HUD_VALIDATE(LightSet, mAcceleratorLightIdMap);     \
+    HUD_VALIDATE(LightSet, mLightAcceleratorIndices);   \
     HUD_END_VALIDATION
 
 
@@ -28,6 +28,13 @@ void LightTree::build(const Light* const* boundedLights, uint boundedLightCount,
     mBoundedLightCount = boundedLightCount;
     mUnboundedLightCount = unboundedLightCount;
 
+    // discard any previous build
+    mNodes.clear();
+    mLightIndices.clear();
+    mLightPositions.clear();
+    mNodesPtr = nullptr;
+    mLightIndicesPtr = nullptr;
+
     // pre-allocate since we know the size of the array
     mLightIndices.reserve(boundedLightCount);
 
@@ -45,6 +52,12 @@ void LightTree::build(const Light* const* boundedLights, uint boundedLightCount,
         // build light tree recursively
         buildRecurse(/* root index */ 0);
 
+        // invert the final light order, so we can find the path to a given light
+        mLightPositions.resize(mBoundedLightCount);
+        for (uint i = 0; i < mBoundedLightCount; ++i) {
+            mLightPositions[mLightIndices[i]] = i;
+        }
+
         // update HUD data
         mNodesPtr = mNodes.data();
         mLightIndicesPtr = mLightIndices.data();
@@ -167,7 +180,153 @@ float LightTree::splitAxis(int axis, SplitCandidate& minSplit, const LightTreeNo
 
 // --------------------------------- SAMPLING METHODS --------------------------------------------------------------- //
 
-void LightTree::sample() const {}
+float LightTree::getNodeImportance(uint nodeIndex, const scene_rdl2::math::Vec3f& p,
+                                   const scene_rdl2::math::Vec3f* n, const LightSelectionCache::Cell* cell) const
+{
+    float importance = mNodes[nodeIndex].importance(p, n);
+    if (cell) {
+        importance *= cell->getNodeWeight(nodeIndex);
+    }
+    return importance;
+}
+
+bool LightTree::getLeftChildProbability(uint nodeIndex, const scene_rdl2::math::Vec3f& p,
+                                        const scene_rdl2::math::Vec3f* n, const LightSelectionCache::Cell* cell,
+                                        float& pLeft) const
+{
+    const float leftImportance  = getNodeImportance(nodeIndex + 1, p, n, cell);
+    const float rightImportance = getNodeImportance(mNodes[nodeIndex].getRightNodeIndex(), p, n, cell);
+    const float totalImportance = leftImportance + rightImportance;
+    if (totalImportance <= 0.f) {
+        return false;
+    }
+    pLeft = leftImportance / totalImportance;
+    return true;
+}
+
+bool LightTree::shouldSplit(uint nodeIndex, const scene_rdl2::math::Vec3f& p) const
+{
+    // The importance of a node stands for all of its lights, which works poorly when the node is large compared to
+    // its distance to p. Rather than the variance estimate of [1], we split when the sine of the half angle the
+    // node's bounding sphere subtends at p exceeds 1 - mSamplingThreshold. A threshold of 0 therefore never splits,
+    // and a threshold of 1 splits every node, choosing every light that can contribute.
+    const LightTreeNode& node = mNodes[nodeIndex];
+    if (node.isLeaf() || mSamplingThreshold <= 0.f) {
+        return false;
+    }
+    if (mSamplingThreshold >= 1.f) {
+        return true;
+    }
+    const scene_rdl2::math::BBox3f& bbox = node.getBBox();
+    const float radius = 0.5f * scene_rdl2::math::length(bbox.size());
+    const float distance = scene_rdl2::math::length(0.5f * (bbox.lower + bbox.upper) - p);
+    return distance <= radius || radius > (1.f - mSamplingThreshold) * distance;
+}
+
+void LightTree::sampleRecurse(uint nodeIndex, const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n,
+                              float u, float pmf, const LightSelectionCache::Cell* cell, int* lightIndices,
+                              float* pmfs, int& lightCount) const
+{
+    if (shouldSplit(nodeIndex, p)) {
+        // both children are visited, with the same random number
+        const uint leftIndex = nodeIndex + 1;
+        const uint rightIndex = mNodes[nodeIndex].getRightNodeIndex();
+        if (getNodeImportance(leftIndex, p, n, cell) > 0.f) {
+            sampleRecurse(leftIndex, p, n, u, pmf, cell, lightIndices, pmfs, lightCount);
+        }
+        if (getNodeImportance(rightIndex, p, n, cell) > 0.f) {
+            sampleRecurse(rightIndex, p, n, u, pmf, cell, lightIndices, pmfs, lightCount);
+        }
+        return;
+    }
+
+    while (!mNodes[nodeIndex].isLeaf()) {
+        float pLeft;
+        if (!getLeftChildProbability(nodeIndex, p, n, cell, pLeft)) {
+            return;
+        }
+        // choose a child and remap u to [0, 1) for the next level
+        if (u < pLeft) {
+            u = scene_rdl2::math::min(u / pLeft, scene_rdl2::math::sOneMinusEpsilon);
+            pmf *= pLeft;
+            nodeIndex = nodeIndex + 1;
+        } else {
+            u = scene_rdl2::math::min((u - pLeft) / (1.f - pLeft), scene_rdl2::math::sOneMinusEpsilon);
+            pmf *= 1.f - pLeft;
+            nodeIndex = mNodes[nodeIndex].getRightNodeIndex();
+        }
+    }
+
+    lightIndices[lightCount] = mNodes[nodeIndex].getLightIndex();
+    if (pmfs) {
+        pmfs[lightCount] = pmf;
+    }
+    ++lightCount;
+}
+
+int LightTree::sample(const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n, float u,
+                      int* lightIndices, float* pmfs, const LightSelectionCache::Cell* cell) const
+{
+    if (mNodes.empty() || mNodes[0].importance(p, n) <= 0.f) {
+        return 0;
+    }
+
+    int lightCount = 0;
+    sampleRecurse(/* root index */ 0, p, n, u, /* pmf */ 1.f, cell, lightIndices, pmfs, lightCount);
+    return lightCount;
+}
+
+float LightTree::getPmf(const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n, int lightIndex,
+                        const LightSelectionCache::Cell* cell) const
+{
+    if (mNodes.empty() || mNodes[0].importance(p, n) <= 0.f) {
+        return 0.f;
+    }
+
+    // follow the path sample() takes to reach the light
+    const uint position = mLightPositions[lightIndex];
+    float pmf = 1.f;
+    uint nodeIndex = 0;
+    bool splitting = true;
+    while (!mNodes[nodeIndex].isLeaf()) {
+        const LightTreeNode& leftNode = mNodes[nodeIndex + 1];
+        const bool left = position < leftNode.getStartIndex() + leftNode.getLightCount();
+        const uint childIndex = left  ?  nodeIndex + 1  :  mNodes[nodeIndex].getRightNodeIndex();
+
+        // split nodes choose lights on both sides, up to the first node sample() descends from
+        splitting = splitting && shouldSplit(nodeIndex, p);
+        if (splitting) {
+            if (getNodeImportance(childIndex, p, n, cell) <= 0.f) {
+                return 0.f;
+            }
+        } else {
+            float pLeft;
+            if (!getLeftChildProbability(nodeIndex, p, n, cell, pLeft)) {
+                return 0.f;
+            }
+            pmf *= left  ?  pLeft  :  1.f - pLeft;
+        }
+        nodeIndex = childIndex;
+    }
+    return pmf;
+}
+
+void LightTree::recordContribution(const LightSelectionCache::Cell& cell, int lightIndex,
+                                   float unoccluded, float delivered) const
+{
+    // the root is chosen with probability one, there is nothing to learn about it
+    const uint position = mLightPositions[lightIndex];
+    uint nodeIndex = 0;
+    while (!mNodes[nodeIndex].isLeaf()) {
+        const LightTreeNode& leftNode = mNodes[nodeIndex + 1];
+        if (position < leftNode.getStartIndex() + leftNode.getLightCount()) {
+            nodeIndex = nodeIndex + 1;
+        } else {
+            nodeIndex = mNodes[nodeIndex].getRightNodeIndex();
+        }
+        cell.recordNode(nodeIndex, unoccluded, delivered);
+    }
+}
 
 // --------------------------------- PRINT FUNCTIONS ---------------------------------------------------------------- //
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Light.h"
+#include "LightSelectionCache.h"
 #include "LightTreeUtil.h"
 #include "LightTree.hh"
 
@@ -42,9 +43,32 @@ public:
     void build(const Light* const* boundedLights, unsigned int boundedLightCount,
                const Light* const* unboundedLights, unsigned int unboundedLightCount);
 
-    /// Chooses light(s) using importance sampling and adaptive tree splitting 
-    /// @see [1] section 5.4
-    void sample() const;
+    /// Is there a tree to sample from?
+    bool isEmpty() const { return mNodes.empty(); }
+
+    /// Returns the number of bounded lights in the tree
+    unsigned int getBoundedLightCount() const { return mBoundedLightCount; }
+
+    /// Chooses bounded lights for the shading point p (with optional normal n). Starting at the root, nodes that
+    /// shouldSplit() are split and lights are chosen on both sides. From any other node a single light is chosen by
+    /// descending the tree, picking a child at each node in proportion to its importance. The indices of the chosen
+    /// lights in the bounded light array are written to lightIndices, and the probabilities of the choices to pmfs
+    /// unless it is null. Both arrays must hold getBoundedLightCount() entries. Returns the number of lights chosen, which is zero
+    /// if no light can contribute to p. When a cache cell is given, node importances are scaled by the weights
+    /// learned for it.
+    /// @see [1] sections 5.2 and 5.4
+    int sample(const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n, float u,
+               int* lightIndices, float* pmfs, const LightSelectionCache::Cell* cell = nullptr) const;
+
+    /// Returns the probability of sample() choosing the bounded light with the given index for the shading point p
+    float getPmf(const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n, int lightIndex,
+                 const LightSelectionCache::Cell* cell = nullptr) const;
+
+    /// Records the contribution of a sample of the bounded light with the given index into the cache cell, for
+    /// every node on the path from the root to the light. The unoccluded contribution is the one before shadow
+    /// rays were traced, the delivered contribution the one after.
+    void recordContribution(const LightSelectionCache::Cell& cell, int lightIndex,
+                            float unoccluded, float delivered) const;
 
     /// Sets the scene diameter (size of the scene bvh's bounding box)
     void setSceneDiameter(float sceneDiameter) { mSceneDiameter = sceneDiameter; }
@@ -166,11 +190,32 @@ private:
     ///
     float splitAxis(int axis, SplitCandidate& minSplit, const LightTreeNode& node) const;
 
+
+    /// Adaptive tree splitting: returns true if the lights of the given interior node should be sampled on both
+    /// sides of the node rather than through its importance. @see [1] section 5.4
+    bool shouldSplit(uint nodeIndex, const scene_rdl2::math::Vec3f& p) const;
+
+    /// Chooses lights below the given node, appending them to lightIndices and pmfs. pmf is the probability of
+    /// reaching the node.
+    void sampleRecurse(uint nodeIndex, const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n, float u,
+                       float pmf, const LightSelectionCache::Cell* cell, int* lightIndices, float* pmfs,
+                       int& lightCount) const;
+
+    /// Returns the importance of the given node for the shading point p, scaled by the cache cell weight if any
+    float getNodeImportance(uint nodeIndex, const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n,
+                            const LightSelectionCache::Cell* cell) const;
+
+    /// Computes the probability of descending into the left child of the given interior node. Returns false if
+    /// neither child can contribute to the shading point p.
+    bool getLeftChildProbability(uint nodeIndex, const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n,
+                                 const LightSelectionCache::Cell* cell, float& pLeft) const;
+
 // ------------------------------------ Member Variables ---------------------------------------------------------------
     LIGHT_TREE_MEMBERS;
     std::vector<LightTreeNode> mNodes;         // array of nodes 
     std::vector<uint> mLightIndices;           // array of light indices -- allows us to change the "order" of 
                                                // lights in the light tree without mutating the lightset itself
+    std::vector<uint> mLightPositions;         // position of each light in mLightIndices
 };
 
 } // end namespace pbr
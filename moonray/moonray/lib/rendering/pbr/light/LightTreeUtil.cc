@@ -220,5 +220,54 @@ void LightTreeNode::init(uint startIndex, float energy, const LightTreeCone& con
     calcEnergyVariance(lightCount, startIndex, lights, lightIndices);
 }
 
+float LightTreeNode::importance(const Vec3f& p, const Vec3f* n) const
+{
+    if (mEnergy <= 0.f) {
+        return 0.f;
+    }
+
+    // bound the cluster with the bounding sphere of its bbox
+    const Vec3f center = 0.5f * (mBBox.lower + mBBox.upper);
+    const float radius = 0.5f * length(mBBox.size());
+
+    const Vec3f pointToCenter = center - p;
+    const float distance = length(pointToCenter);
+
+    // the angle bounding the cluster as seen from p covers all directions
+    // when p is inside the bounding sphere
+    const bool inside = distance <= radius;
+    const float theta_u = inside ? sPi : scene_rdl2::math::asin(radius / distance);
+    const Vec3f wi = distance > 0.f ? pointToCenter / distance : mCone.mAxis;
+
+    // orientation term, the angle between the cone axis and the direction
+    // towards p, minus the spread of the normals and the bounding angle
+    float theta = scene_rdl2::math::dw_acos(clamp(dot(mCone.mAxis, -wi), -1.f, 1.f));
+    if (mCone.mTwoSided) {
+        theta = scene_rdl2::math::min(theta, sPi - theta);
+    }
+    const float theta_prime = scene_rdl2::math::max(0.f, theta - mCone.getThetaO() - theta_u);
+    if (theta_prime >= mCone.getThetaE()) {
+        return 0.f;
+    }
+
+    // material term, bounded by the hemisphere around the normal
+    float cosThetaIPrime = 1.f;
+    if (n) {
+        const float theta_i = scene_rdl2::math::dw_acos(clamp(dot(*n, wi), -1.f, 1.f));
+        const float theta_i_prime = scene_rdl2::math::max(0.f, theta_i - theta_u);
+        if (theta_i_prime >= sHalfPi) {
+            return 0.f;
+        }
+        cosThetaIPrime = scene_rdl2::math::cos(theta_i_prime);
+    }
+
+    // clamp the distance to the cluster size, so the importance of nearby
+    // clusters doesn't blow up
+    const float distanceSqr = scene_rdl2::math::max(distance * distance,
+                              scene_rdl2::math::max(radius * radius, sEpsilon));
+
+    return mEnergy * scene_rdl2::math::cos(theta_prime) * cosThetaIPrime / distanceSqr;
+}
+
 } // end namespace pbr
 } // end namespace moonray
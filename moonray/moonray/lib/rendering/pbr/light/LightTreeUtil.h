@@ -159,7 +159,7 @@ public:
 
 /// ------------------------------------- Inline Utils --------------------------------------------------
     /// Is this node a leaf?
-    inline bool isLeaf() { return mLightCount == 1; }
+    inline bool isLeaf() const { return mLightCount == 1; }
 
     /// Get the node's starting index in lightIndices
     inline uint getStartIndex() const { return mStartIndex; }
@@ -173,6 +173,8 @@ public:
     inline const scene_rdl2::math::BBox3f& getBBox() const { return mBBox; }
     /// Gets the emission-bounding cone
     inline const LightTreeCone& getCone() const { return mCone; }
+    /// Gets the combined energy of the lights
+    inline float getEnergy() const { return mEnergy; }
     /// Gets the energy variance
     inline float getEnergyVariance() const { return mEnergyVariance; }
     /// Gets the energy mean
@@ -200,6 +202,12 @@ public:
               const std::vector<uint>& lightIndices, 
               uint lightCount);
 
+    /// Importance of the node's cluster of lights for the shading point p. The optional normal n bounds the
+    /// hemisphere of directions which can receive light. The bounds are conservative: the importance is only zero
+    /// when none of the lights in the cluster can contribute to p.
+    /// @see [1] section 5.1, equation (3)
+    float importance(const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n) const;
+
 private:
 
     void calcEnergyVariance(uint lightCount, uint startIndex, const Light* const* lights, 
@@ -61,6 +61,8 @@ computeActiveLights(scene_rdl2::alloc::Arena *arena,
     // It is possible that we intersect a light in the light accelerator that does not exist
     // in the LightSet. We map those ids to -1.
     int* lightIdMap = nullptr;
+    // The inverse mapping, from the reduced light set index to the original light list index.
+    const int* lightAcceleratorIndices = nullptr;
 
     const bool hasBssrdf = (bsdf.getBssrdf() != nullptr);
     const bool hasVolumeSubsurface = (bsdf.getVolumeSubsurface() != nullptr);
@@ -103,11 +105,11 @@ computeActiveLights(scene_rdl2::alloc::Arena *arena,
                 activeLights[i] = (*lightList)[activeLightId[i]];
                 activeLightFilterLists[i] = (*lightFilterLists)[activeLightId[i]];
             }
+            lightAcceleratorIndices = activeLightId;
         } else {
             // Reset arena pointer if there are no active lights. If there are active lights, we
-            // must keep the arena pointer where is it because we need to keep activeLights and
-            // activeLightFilterLists in the arena. This means that even though we don't use activeLighId
-            // after this point, it is still hanging around in the arena. This is suboptimal.
+            // must keep the arena pointer where is it because we need to keep activeLightId,
+            // activeLights and activeLightFilterLists in the arena.
 
             // The pointer is reset to the beginning of activeLightId,
             // because lightIdMap is always filled and used, even when there are no active lights.
@@ -122,6 +124,7 @@ computeActiveLights(scene_rdl2::alloc::Arena *arena,
     // Augment light set with Embree-based acceleration structure
     const LightAccelerator *acc = scene->getLightAccelerator(lightSetIdx);
     lightSet.setAccelerator(acc, lightIdMap);
+    lightSet.setLightAcceleratorIndices(lightAcceleratorIndices);
 }
 
 bool chooseThisLight(const IntegratorSample1D &samples, int depth, unsigned int numHits)
@@ -18,6 +18,8 @@
 
 #include <scene_rdl2/scene/rdl2/VisibilityFlags.h>
 
+#include <cmath>
+
 #define SHADING_BRACKET_TIMING_ENABLED
 
 #ifdef SHADING_BRACKET_TIMING_ENABLED
@@ -313,6 +315,48 @@ struct Node
     }
 };
 
+// The sampling BVH is built as a binary tree of Nodes, which is then collapsed
+// into a tree of WideNodes. A WideNode stores up to MESH_LIGHT_BVH_WIDTH
+// children in structure of arrays form so that the importance of all of them
+// can be computed at once. The bounding boxes of the children are quantized
+// to 8 bits relative to the bounds of the node and their bounding cones to
+// 8 bits per axis component and 8 bits for thetaO, which keeps a node within
+// two cache lines.
+struct WideNode
+{
+    scene_rdl2::math::Vec3f mLower; // lower corner of the bounds of the node
+    scene_rdl2::math::Vec3f mScale; // extent of the bounds of the node / 255
+    uint8_t mQLower[3][MESH_LIGHT_BVH_WIDTH]; // quantized lower corners of the child bboxes
+    uint8_t mQUpper[3][MESH_LIGHT_BVH_WIDTH]; // quantized upper corners of the child bboxes
+    int8_t mQAxis[3][MESH_LIGHT_BVH_WIDTH]; // quantized child bounding cone axes
+    uint8_t mQThetaO[MESH_LIGHT_BVH_WIDTH]; // quantized child thetaO, MESH_LIGHT_QTHETAO_SPHERE for spheres
+    float mEnergy[MESH_LIGHT_BVH_WIDTH]; // energy of the children, 0 for unused slots
+    int32_t mChildren[MESH_LIGHT_BVH_WIDTH]; // >= 0 is a WideNode index, < 0 is ~(face index)
+    int32_t mParent; // parent WideNode index * MESH_LIGHT_BVH_WIDTH + slot, -1 for the root
+    int32_t mChildCount; // number of used slots
+};
+
+// Bounding cone axes are quantized to signed normalized 8 bit integers
+static constexpr float sQAxisScale = 127.0f;
+
+// cos and sin of the quantized values of thetaO, so that the importance
+// computation doesn't need any trigonometric function.
+struct QThetaOTable
+{
+    QThetaOTable()
+    {
+        for (int i = 0; i < 256; ++i) {
+            const float thetaO = float(i) * (scene_rdl2::math::sPi / 255.0f);
+            mCos[i] = scene_rdl2::math::cos(thetaO);
+            mSin[i] = scene_rdl2::math::sin(thetaO);
+        }
+    }
+    float mCos[256];
+    float mSin[256];
+};
+
+static const QThetaOTable sQThetaOTable;
+
 //----------------------------------------------------------------------------
 
 // We spatially bin the primitives of the bvh into buckets.
@@ -399,6 +443,11 @@ MeshLight::MeshLight(const scene_rdl2::rdl2::Light* rdlLight, bool uniformSampli
     mFaceOffsetPtr(nullptr),
     mFaceVertexCountPtr(nullptr),
     mPrimIDToNodeIDPtr(nullptr),
+    mFaceInvAreaPtr(nullptr),
+    mFaceNormalPtr(nullptr),
+    mFacePrimIDPtr(nullptr),
+    mFaceGeomIDPtr(nullptr),
+    mMeshIndicesPtr(nullptr),
     mRtcScene(nullptr),
     mMapShader(nullptr),
     mRdlGeometry(nullptr),
@@ -501,6 +550,16 @@ MeshLight::reset() {
     // clear faces
     mFaces.clear();
     mFaceCount = 0;
+    mFaceInvArea.clear();
+    mFaceInvAreaPtr = nullptr;
+    mFaceNormal.clear();
+    mFaceNormalPtr = nullptr;
+    mFacePrimID.clear();
+    mFacePrimIDPtr = nullptr;
+    mFaceGeomID.clear();
+    mFaceGeomIDPtr = nullptr;
+    mMeshIndices.clear();
+    mMeshIndicesPtr = nullptr;
 
     // clear BVH
     mBVH.clear();
@@ -542,10 +601,11 @@ MeshLight::canIlluminate(const scene_rdl2::math::Vec3f p, const scene_rdl2::math
     MNRY_ASSERT(mOn);
     // TODO: Consider a bounding solid angle
     if (lightFilterList) {
-        float lightRadius = math::length(mBVH[0].mBbox.upper - mBVH[0].mBbox.lower) / 2;
+        const scene_rdl2::math::Vec3f rootExtent = mBVH[0].mScale * 255.0f;
+        float lightRadius = math::length(rootExtent) / 2;
 
         return canIlluminateLightFilterList(lightFilterList,
-            { xformPointLocal2Render(mBVH[0].getCenter(), time),
+            { xformPointLocal2Render(mBVH[0].mLower + 0.5f * rootExtent, time),
               xformLocal2RenderScale(lightRadius, time),
               p, getXformRender2Local(time, lightFilterList->needsLightXform()),
               radius, time
@@ -647,6 +707,7 @@ MeshLight::setMesh(geom::internal::Primitive* prim)
     // index buffer
     const int* indices = (const int* )mesh.mIndexBufferDesc.mData;
     const size_t indexCount = faceCount * faceVertexCount;
+    mMeshIndices.push_back(indices);
 
     // get unique indices
     std::set<int> tmpOrderedIndices(indices, indices + indexCount);
@@ -905,14 +966,37 @@ MeshLight::finalize() {
         return;
     }
 
-    // build the mesh light bvh
+    // build the binary mesh light bvh, then collapse it into the wide bvh
+    // used for sampling
+    std::vector<Node> nodes;
+    buildBVHRecurse(nodes, mLocalSpaceBounds, mFaces, 0, mFaceCount, -1);
+    MNRY_ASSERT(verifyBuild(nodes, 0));
     mBVH.clear();
-    buildBVHRecurse(mLocalSpaceBounds, mFaces, 0, mFaceCount, 0);
-    MNRY_ASSERT(verifyBuild(0));
+    collapseBVHRecurse(nodes, 0, -1);
+
+    // The faces are only needed during the build, the sampling BVH refers to
+    // the faces in the order the build left them in.
+    mFaceInvArea.resize(mFaceCount);
+    mFaceNormal.resize(mFaceCount);
+    mFacePrimID.resize(mFaceCount);
+    mFaceGeomID.resize(mFaceCount);
+    for (size_t f = 0; f < mFaceCount; ++f) {
+        mFaceInvArea[f] = mFaces[f].mInvArea;
+        mFaceNormal[f] = mFaces[f].mNormal;
+        mFacePrimID[f] = mFaces[f].mPrimID;
+        mFaceGeomID[f] = mFaces[f].mGeomID;
+    }
+    mFaces.clear();
+    mFaces.shrink_to_fit();
 
     // Fill in relevant HUD data
     mBVHPtr = mBVH.data();
     mBVHSize = mBVH.size();
+    mFaceInvAreaPtr = mFaceInvArea.data();
+    mFaceNormalPtr = mFaceNormal.data();
+    mFacePrimIDPtr = mFacePrimID.data();
+    mFaceGeomIDPtr = mFaceGeomID.data();
+    mMeshIndicesPtr = mMeshIndices.data();
     mVerticesPtr = mVertices.data();
     mVertexOffsetPtr = mVertexOffset.data();
     mFaceOffsetPtr = mFaceOffset.data();
@@ -992,10 +1076,30 @@ MeshLight::getFaceVertexCount(const Face& face) const
     return mFaceVertexCount[face.mGeomID];
 }
 
+unsigned int
+MeshLight::getFaceVertexCount(int faceIndex) const
+{
+    return mFaceVertexCount[mFaceGeomID[faceIndex]];
+}
+
 const scene_rdl2::math::Vec3f
 MeshLight::getFaceVertex(const Face& face, size_t index, float time) const
 {
-    size_t vertexOffset = mVertexOffset[face.mGeomID] + face.mIndices[index] * mMbSteps;
+    return getVertex(face.mGeomID, face.mIndices[index], time);
+}
+
+const scene_rdl2::math::Vec3f
+MeshLight::getFaceVertex(int faceIndex, size_t index, float time) const
+{
+    const int geomID = mFaceGeomID[faceIndex];
+    const int* indices = mMeshIndices[geomID] + mFacePrimID[faceIndex] * mFaceVertexCount[geomID];
+    return getVertex(geomID, indices[index], time);
+}
+
+const scene_rdl2::math::Vec3f
+MeshLight::getVertex(int geomID, int vertexIndex, float time) const
+{
+    size_t vertexOffset = mVertexOffset[geomID] + vertexIndex * mMbSteps;
 
     if (!mDeformationMb) {
         return mVertices[vertexOffset];
@@ -1066,8 +1170,8 @@ MeshLight::naiveSplit(std::vector<Face>& faces,
 }
 
 int
-MeshLight::buildBVHRecurse(const scene_rdl2::math::BBox3f& bbox, std::vector<Face>& faces,
-    int start, int end, int parentIndex)
+MeshLight::buildBVHRecurse(std::vector<Node>& nodes, const scene_rdl2::math::BBox3f& bbox,
+    std::vector<Face>& faces, int start, int end, int parentIndex)
 {
     if ((end - start) < sBucketsCount) {
 
@@ -1076,9 +1180,9 @@ MeshLight::buildBVHRecurse(const scene_rdl2::math::BBox3f& bbox, std::vector<Fac
         // partition
         //
 
-        int nodeIndex = mBVH.size();
+        int nodeIndex = nodes.size();
         Node node;
-        mBVH.push_back(node);
+        nodes.push_back(node);
         if ((end - start) > 1) {
             // compute energy of node
             float energy = 0.0f;
@@ -1094,11 +1198,11 @@ MeshLight::buildBVHRecurse(const scene_rdl2::math::BBox3f& bbox, std::vector<Fac
             }
 
             // fill in node parameters
-            mBVH[nodeIndex].mParentIndex = parentIndex;
-            mBVH[nodeIndex].mBbox = bbox;
-            mBVH[nodeIndex].mBcone = cone;
-            mBVH[nodeIndex].mEnergy = energy;
-            mBVH[nodeIndex].mFace = nullptr;
+            nodes[nodeIndex].mParentIndex = parentIndex;
+            nodes[nodeIndex].mBbox = bbox;
+            nodes[nodeIndex].mBcone = cone;
+            nodes[nodeIndex].mEnergy = energy;
+            nodes[nodeIndex].mFace = nullptr;
 
             // the longest length of the bounding box
             int splitAxis = maxDim(bbox.size());
@@ -1109,24 +1213,21 @@ MeshLight::buildBVHRecurse(const scene_rdl2::math::BBox3f& bbox, std::vector<Fac
             int mid = naiveSplit(faces, start, end, splitAxis, leftBound, rightBound);
 
             // recursively build left branch
-            buildBVHRecurse(leftBound, faces, start, mid, nodeIndex);
+            buildBVHRecurse(nodes, leftBound, faces, start, mid, nodeIndex);
             // recursively build right branch
 
-            int rightChildIndex = buildBVHRecurse(rightBound, faces, mid, end, nodeIndex);
-            mBVH[nodeIndex].mRightChildIndex = rightChildIndex;
+            int rightChildIndex = buildBVHRecurse(nodes, rightBound, faces, mid, end, nodeIndex);
+            nodes[nodeIndex].mRightChildIndex = rightChildIndex;
 
         } else {
             // leaf node
-            mBVH[nodeIndex].mParentIndex = parentIndex;
-            mBVH[nodeIndex].mEnergy = faces[start].mEnergy;
-            mBVH[nodeIndex].mFace = &faces[start];
-            mBVH[nodeIndex].mBbox = bbox;
-            mBVH[nodeIndex].mBcone = {faces[start].mNormal, faces[start].mThetaO};
+            nodes[nodeIndex].mParentIndex = parentIndex;
+            nodes[nodeIndex].mEnergy = faces[start].mEnergy;
+            nodes[nodeIndex].mFace = &faces[start];
+            nodes[nodeIndex].mBbox = bbox;
+            nodes[nodeIndex].mBcone = {faces[start].mNormal, faces[start].mThetaO};
             // right child nodeIndex is a dummy value that is never used for leaf nodes
-            mBVH[nodeIndex].mRightChildIndex = -1;
-            // Map the leaf node ids to the bvh node index
-            unsigned faceOffset = mFaceOffset[faces[start].mGeomID] + faces[start].mPrimID;
-            mPrimIDToNodeID[faceOffset] = nodeIndex;
+            nodes[nodeIndex].mRightChildIndex = -1;
         }
 
         return nodeIndex;
@@ -1350,29 +1451,29 @@ MeshLight::buildBVHRecurse(const scene_rdl2::math::BBox3f& bbox, std::vector<Fac
         node.mEnergy += faces[i].mEnergy;
     }
 
-    int32_t nodeIndex = mBVH.size();
-    mBVH.push_back(node);
+    int32_t nodeIndex = nodes.size();
+    nodes.push_back(node);
 
     // recursively build left branch
-    buildBVHRecurse(leftBound, faces, start, mid, nodeIndex);
+    buildBVHRecurse(nodes, leftBound, faces, start, mid, nodeIndex);
     // recursively build right branch
-    int rightChildIndex = buildBVHRecurse(rightBound, faces, mid, end, nodeIndex);
-    mBVH[nodeIndex].mRightChildIndex = rightChildIndex;
+    int rightChildIndex = buildBVHRecurse(nodes, rightBound, faces, mid, end, nodeIndex);
+    nodes[nodeIndex].mRightChildIndex = rightChildIndex;
 
     return nodeIndex;
 }
 
 bool
-MeshLight::verifyBuild(int index) const
+MeshLight::verifyBuild(const std::vector<Node>& nodes, int index) const
 {
     // TODO: Is there anything else that should be verified?
-    const Node& node = mBVH[index];
+    const Node& node = nodes[index];
     if (node.isLeaf()) {
         return true;
     } else {
         const scene_rdl2::math::BBox3f& bbox = node.mBbox;
-        const scene_rdl2::math::BBox3f& leftBbox = mBVH[index + 1].mBbox;
-        const scene_rdl2::math::BBox3f& rightBbox = mBVH[node.mRightChildIndex].mBbox;
+        const scene_rdl2::math::BBox3f& leftBbox = nodes[index + 1].mBbox;
+        const scene_rdl2::math::BBox3f& rightBbox = nodes[node.mRightChildIndex].mBbox;
         bool leftIsInside = (bbox.lower.x <= leftBbox.lower.x &&
                              bbox.lower.y <= leftBbox.lower.y &&
                              bbox.lower.z <= leftBbox.lower.z &&
@@ -1387,115 +1488,271 @@ MeshLight::verifyBuild(int index) const
                               bbox.upper.z >= rightBbox.upper.z);
 
         // the energy of each node should be the sum of its children's energies
-        bool correctEnergy = (scene_rdl2::math::isEqual(node.mEnergy, mBVH[index + 1].mEnergy +
-            mBVH[node.mRightChildIndex].mEnergy, node.mEnergy * 1e-5f));
+        bool correctEnergy = (scene_rdl2::math::isEqual(node.mEnergy, nodes[index + 1].mEnergy +
+            nodes[node.mRightChildIndex].mEnergy, node.mEnergy * 1e-5f));
 
         return leftIsInside && rightIsInside && correctEnergy &&
-            verifyBuild(index + 1) && verifyBuild(node.mRightChildIndex);
+            verifyBuild(nodes, index + 1) && verifyBuild(nodes, node.mRightChildIndex);
     }
 }
 
-float
-MeshLight::importance(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f* shadingNormal, const Node& node) const
+int
+MeshLight::collapseBVHRecurse(const std::vector<Node>& nodes, int nodeIndex, int parent)
 {
-    // Early out if this node has no energy. This would happen if the MapShader
-    // is black for all the faces contained in this node.
-    if (node.mEnergy == 0.0f) {
-        return 0.0f;
-    }
-
-    scene_rdl2::math::Vec3f center = node.getCenter();
-    // the vector from the shadingPoint to the center of the node
-    scene_rdl2::math::Vec3f point2center = center - shadingPoint;
-    float distance2 = lengthSqr(point2center);
-
-    // orientation metric
-    // For more deatils see Kulla (2017) p. 8 Fig. 7 and Eq. 3.
-    float orientation = 1.0f;
-    if (!scene_rdl2::math::isEqual(node.mBcone.mThetaO, scene_rdl2::math::sPi) && distance2 != 0) {
-        float distance = scene_rdl2::math::sqrt(distance2);
-        point2center /= distance;
-        // thetaU is the uncertainty angle from the center of the box to its edge
-        float thetaU = 0.0f;
-        // radius of the sphere that circumscribes the bounding box
-        float radius = length(node.mBbox.upper - center);
-
-        if (distance >= radius) {
-            // the shading point is outside the bounding sphere
-            thetaU = scene_rdl2::math::asin(radius / distance);
-        } else {
-            // shading point is inside the bounding sphere
-            thetaU = scene_rdl2::math::sPi;
+    const auto boxArea = [](const scene_rdl2::math::BBox3f& bbox) {
+        const scene_rdl2::math::Vec3f dim = bbox.size();
+        return dim[0] * dim[1] + dim[1] * dim[2] + dim[2] * dim[0];
+    };
+
+    // Gather the children of the wide node by repeatedly replacing the
+    // internal child with the largest surface area by its own two children.
+    int children[MESH_LIGHT_BVH_WIDTH];
+    int childCount = 0;
+    const Node& node = nodes[nodeIndex];
+    if (node.isLeaf()) {
+        // mesh light with a single face
+        children[childCount++] = nodeIndex;
+    } else {
+        children[childCount++] = nodeIndex + 1;
+        children[childCount++] = node.mRightChildIndex;
+    }
+    while (childCount < MESH_LIGHT_BVH_WIDTH) {
+        int openSlot = -1;
+        float maxArea = -1.0f;
+        for (int i = 0; i < childCount; ++i) {
+            const Node& child = nodes[children[i]];
+            if (!child.isLeaf() && boxArea(child.mBbox) > maxArea) {
+                maxArea = boxArea(child.mBbox);
+                openSlot = i;
+            }
         }
-        // thetaI is the angle between the axis and the shading normal
-        float thetaI = 0.0f;
-        float shadingNormalContribution = 1.0f;
-        if (shadingNormal) {
-            const scene_rdl2::math::Vec3f& normal = *shadingNormal;
-            thetaI = scene_rdl2::math::acos(scene_rdl2::math::clamp(dot(point2center, normal), -1.0f, 1.0f));
-            shadingNormalContribution = scene_rdl2::math::abs(scene_rdl2::math::cos(scene_rdl2::math::max(thetaI - thetaU, 0.0f)));
+        if (openSlot < 0) {
+            break;
+        }
+        const int openIndex = children[openSlot];
+        children[openSlot] = openIndex + 1;
+        children[childCount++] = nodes[openIndex].mRightChildIndex;
+    }
+
+    scene_rdl2::math::BBox3f bounds(scene_rdl2::util::empty);
+    for (int i = 0; i < childCount; ++i) {
+        bounds.extend(nodes[children[i]].mBbox);
+    }
+    const scene_rdl2::math::Vec3f extent = bounds.size();
+    scene_rdl2::math::Vec3f invScale;
+    for (int axis = 0; axis < 3; ++axis) {
+        invScale[axis] = extent[axis] > 0.0f ? 255.0f / extent[axis] : 0.0f;
+    }
+
+    const int wideIndex = mBVH.size();
+    WideNode wideNode;
+    wideNode.mLower = bounds.lower;
+    wideNode.mScale = extent / 255.0f;
+    wideNode.mParent = parent;
+    wideNode.mChildCount = childCount;
+    for (int slot = 0; slot < MESH_LIGHT_BVH_WIDTH; ++slot) {
+        if (slot >= childCount) {
+            // Unused slots have no energy, so they are never selected
+            for (int axis = 0; axis < 3; ++axis) {
+                wideNode.mQLower[axis][slot] = 0;
+                wideNode.mQUpper[axis][slot] = 0;
+                wideNode.mQAxis[axis][slot] = 0;
+            }
+            wideNode.mQThetaO[slot] = MESH_LIGHT_QTHETAO_SPHERE;
+            wideNode.mEnergy[slot] = 0.0f;
+            wideNode.mChildren[slot] = 0;
+            continue;
         }
-        // theta is the angle between the bounding cone axis and the center to shading point axis
-        float theta = scene_rdl2::math::acos(-dot(node.mBcone.mAxis, point2center));
-        float thetaPrime = scene_rdl2::math::max(theta - node.mBcone.mThetaO - thetaU, 0.0f);
-        // For the mesh light, thetaE is always the same. For the many lights
-        // solution we would need to compare against node.mBcone.mThetaE
-        bool useThetaPrime = thetaPrime < sThetaE;
-        orientation = shadingNormalContribution * (useThetaPrime ? scene_rdl2::math::cos(thetaPrime) : 0.0f);
-    }
 
-    return node.mEnergy * orientation / distance2;
-}
+        const Node& child = nodes[children[slot]];
 
-int
-MeshLight::drawSampleRecurse(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f* shadingNormal,
-    int currentNodeIndex, float u, float& pdf) const
-{
-    const Node& node = mBVH[currentNodeIndex];
-    if (node.isLeaf()) {
-        // The face is selected. Multiply by the inverse area of the face to get
-        // the final pdf = pdf(face) * pdf(point | face)
-        pdf *= node.mFace->mInvArea;
-        return currentNodeIndex;
+        // Round the bounding box outwards
+        for (int axis = 0; axis < 3; ++axis) {
+            const float lower = (child.mBbox.lower[axis] - bounds.lower[axis]) * invScale[axis];
+            const float upper = (child.mBbox.upper[axis] - bounds.lower[axis]) * invScale[axis];
+            wideNode.mQLower[axis][slot] = uint8_t(scene_rdl2::math::clamp(
+                scene_rdl2::math::floor(lower), 0.0f, 255.0f));
+            wideNode.mQUpper[axis][slot] = uint8_t(scene_rdl2::math::clamp(
+                scene_rdl2::math::ceil(upper), 0.0f, 255.0f));
+        }
+
+        // Widen the bounding cone by the angle between the axis and its
+        // quantized counterpart, so that it still bounds the normals
+        const Cone& cone = child.mBcone;
+        scene_rdl2::math::Vec3f qAxis;
+        for (int axis = 0; axis < 3; ++axis) {
+            qAxis[axis] = scene_rdl2::math::clamp(std::round(cone.mAxis[axis] * sQAxisScale),
+                -sQAxisScale, sQAxisScale);
+            wideNode.mQAxis[axis][slot] = int8_t(qAxis[axis]);
+        }
+        float thetaO = scene_rdl2::math::sPi;
+        if (!scene_rdl2::math::isEqual(cone.mThetaO, scene_rdl2::math::sPi) && cone.mThetaO < scene_rdl2::math::sPi &&
+            !scene_rdl2::math::isZero(length(qAxis))) {
+            const float cosError = dot(normalize(qAxis), cone.mAxis);
+            thetaO = cone.mThetaO + scene_rdl2::math::acos(scene_rdl2::math::clamp(cosError, -1.0f, 1.0f));
+        }
+        wideNode.mQThetaO[slot] = thetaO < scene_rdl2::math::sPi ?
+            uint8_t(scene_rdl2::math::min(scene_rdl2::math::ceil(thetaO * (255.0f / scene_rdl2::math::sPi)),
+                                          float(MESH_LIGHT_QTHETAO_SPHERE - 1))) :
+            MESH_LIGHT_QTHETAO_SPHERE;
+
+        wideNode.mEnergy[slot] = child.mEnergy;
+
+        if (child.isLeaf()) {
+            const int faceIndex = child.mFace - mFaces.data();
+            wideNode.mChildren[slot] = ~faceIndex;
+            // Map the face to its slot in the bvh
+            unsigned faceOffset = mFaceOffset[child.mFace->mGeomID] + child.mFace->mPrimID;
+            mPrimIDToNodeID[faceOffset] = wideIndex * MESH_LIGHT_BVH_WIDTH + slot;
+        }
     }
 
-    int32_t leftIndex = currentNodeIndex + 1;
-    const Node& leftChild = mBVH[leftIndex];
-    int32_t rightIndex = node.mRightChildIndex;
-    const Node& rightChild = mBVH[rightIndex];
+    mBVH.push_back(wideNode);
 
-    float leftImportance = importance(shadingPoint, shadingNormal, leftChild);
-    float rightImportance = importance(shadingPoint, shadingNormal, rightChild);
+    // recursively collapse the internal children
+    for (int slot = 0; slot < childCount; ++slot) {
+        if (!nodes[children[slot]].isLeaf()) {
+            const int childIndex = collapseBVHRecurse(nodes, children[slot],
+                wideIndex * MESH_LIGHT_BVH_WIDTH + slot);
+            mBVH[wideIndex].mChildren[slot] = childIndex;
+        }
+    }
 
-    MNRY_ASSERT(leftImportance >= 0.0f);
-    MNRY_ASSERT(rightImportance >= 0.0f);
+    return wideIndex;
+}
 
-    float pdfL;
-    if (leftImportance == 0 && rightImportance == 0) {
-        // edge case
-        pdfL = 0.5;
-    } else {
-        pdfL = leftImportance / (leftImportance + rightImportance);
+void
+MeshLight::importance(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f* shadingNormal,
+    const WideNode& node, float importances[MESH_LIGHT_BVH_WIDTH]) const
+{
+    // This is the importance of Kulla (2017) p. 8 Fig. 7 and Eq. 3, with the
+    // angle differences computed from their sines and cosines so that no
+    // trigonometric function is needed and the loop over the children can be
+    // vectorized.
+    const bool hasNormal = shadingNormal != nullptr;
+    const scene_rdl2::math::Vec3f normal = hasNormal ? *shadingNormal : scene_rdl2::math::Vec3f(0.0f);
+
+    for (int i = 0; i < MESH_LIGHT_BVH_WIDTH; ++i) {
+        // dequantize the bounding box
+        const float lowerX = node.mLower.x + float(node.mQLower[0][i]) * node.mScale.x;
+        const float lowerY = node.mLower.y + float(node.mQLower[1][i]) * node.mScale.y;
+        const float lowerZ = node.mLower.z + float(node.mQLower[2][i]) * node.mScale.z;
+        const float upperX = node.mLower.x + float(node.mQUpper[0][i]) * node.mScale.x;
+        const float upperY = node.mLower.y + float(node.mQUpper[1][i]) * node.mScale.y;
+        const float upperZ = node.mLower.z + float(node.mQUpper[2][i]) * node.mScale.z;
+
+        // the vector from the shadingPoint to the center of the child
+        const float toCenterX = 0.5f * (lowerX + upperX) - shadingPoint.x;
+        const float toCenterY = 0.5f * (lowerY + upperY) - shadingPoint.y;
+        const float toCenterZ = 0.5f * (lowerZ + upperZ) - shadingPoint.z;
+        const float distance2 = toCenterX * toCenterX + toCenterY * toCenterY + toCenterZ * toCenterZ;
+        const float invDistance = distance2 > 0.0f ? 1.0f / scene_rdl2::math::sqrt(distance2) : 0.0f;
+        const float dirX = toCenterX * invDistance;
+        const float dirY = toCenterY * invDistance;
+        const float dirZ = toCenterZ * invDistance;
+
+        // thetaU is the uncertainty angle from the center of the box to its
+        // edge, it is pi when the shading point is inside the sphere that
+        // circumscribes the bounding box
+        const float radius2 = 0.25f * ((upperX - lowerX) * (upperX - lowerX) +
+                                       (upperY - lowerY) * (upperY - lowerY) +
+                                       (upperZ - lowerZ) * (upperZ - lowerZ));
+        const bool inside = distance2 < radius2;
+        const float sinU2 = inside ? 0.0f : radius2 / distance2;
+        const float sinU = scene_rdl2::math::sqrt(sinU2);
+        const float cosU = inside ? -1.0f : scene_rdl2::math::sqrt(1.0f - sinU2);
+
+        // thetaI is the angle between the shading normal and the direction
+        // to the center: cos(max(thetaI - thetaU, 0))
+        const float cosI = scene_rdl2::math::clamp(dirX * normal.x + dirY * normal.y + dirZ * normal.z,
+                                                   -1.0f, 1.0f);
+        const float sinI = scene_rdl2::math::sqrt(1.0f - cosI * cosI);
+        const float normalTerm = (!hasNormal || cosI >= cosU) ? 1.0f :
+            scene_rdl2::math::abs(cosI * cosU + sinI * sinU);
+
+        // theta is the angle between the bounding cone axis and the direction
+        // from the center to the shading point: cos(max(theta - thetaO - thetaU, 0))
+        const float axisX = float(node.mQAxis[0][i]);
+        const float axisY = float(node.mQAxis[1][i]);
+        const float axisZ = float(node.mQAxis[2][i]);
+        const float axisLength2 = axisX * axisX + axisY * axisY + axisZ * axisZ;
+        const float invAxisLength = axisLength2 > 0.0f ? 1.0f / scene_rdl2::math::sqrt(axisLength2) : 0.0f;
+        const float cosT = scene_rdl2::math::clamp(-(axisX * dirX + axisY * dirY + axisZ * dirZ) * invAxisLength,
+                                                   -1.0f, 1.0f);
+        const float sinT = scene_rdl2::math::sqrt(1.0f - cosT * cosT);
+        const float cosO = sQThetaOTable.mCos[node.mQThetaO[i]];
+        const float sinO = sQThetaOTable.mSin[node.mQThetaO[i]];
+        const float cosTO = cosT * cosO + sinT * sinO;
+        const float sinTO = sinT * cosO - cosT * sinO;
+        // For the mesh light, thetaE is always pi / 2, so the cosine of
+        // thetaPrime must be positive
+        const float coneTerm = (cosT >= cosO || cosTO >= cosU) ? 1.0f :
+            scene_rdl2::math::max(cosTO * cosU + sinTO * sinU, 0.0f);
+
+        const float orientation = (node.mQThetaO[i] == MESH_LIGHT_QTHETAO_SPHERE || distance2 == 0.0f) ? 1.0f :
+            normalTerm * coneTerm;
+
+        // Children without energy have no importance. This would happen if the
+        // MapShader is black for all the faces contained in the child.
+        importances[i] = node.mEnergy[i] > 0.0f ? node.mEnergy[i] * orientation / distance2 : 0.0f;
     }
+}
 
-    float pdfR = 1.0f - pdfL;
+int
+MeshLight::drawSample(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f* shadingNormal,
+    float u, float& pdf) const
+{
+    int nodeIndex = 0;
+    while (true) {
+        const WideNode& node = mBVH[nodeIndex];
+
+        float importances[MESH_LIGHT_BVH_WIDTH];
+        importance(shadingPoint, shadingNormal, node, importances);
+        float totalImportance = 0.0f;
+        for (int i = 0; i < MESH_LIGHT_BVH_WIDTH; ++i) {
+            MNRY_ASSERT(importances[i] >= 0.0f);
+            totalImportance += importances[i];
+        }
 
-    // During the traversal of the BVH, we my encounter situations where
-    // u, pdfL, or pdfR equals exactly 1 or exactly 0.
-    // If u == 1 and pdfL == 1, we want to traverse the left branch.
-    // But if u == 0 and pdfL == 0, we want to traverse the right branch.
-    if (u <= pdfL && pdfL != 0) {
-        // traverse left branch
-        float uRemapped = u / pdfL;
-        pdf *= pdfL;
-        return drawSampleRecurse(shadingPoint, shadingNormal, leftIndex,
-            uRemapped, pdf);
-    } else {
-        // traverse right branch
-        float uRemapped = (u - pdfL) / pdfR;
-        pdf *= pdfR;
-        return drawSampleRecurse(shadingPoint, shadingNormal, rightIndex,
-            uRemapped, pdf);
+        int slot = 0;
+        float slotPdf;
+        if (totalImportance == 0.0f) {
+            // edge case
+            slot = scene_rdl2::math::min(int(u * node.mChildCount), node.mChildCount - 1);
+            slotPdf = 1.0f / node.mChildCount;
+            u = u * node.mChildCount - slot;
+        } else {
+            // During the traversal of the BVH, u or the probability of a child
+            // may equal exactly 0 or 1. Children with a probability of 0 are
+            // never selected, and u == 1 selects the last child that can be.
+            float cdf = 0.0f;
+            float slotCdf = 0.0f;
+            slotPdf = 0.0f;
+            for (int i = 0; i < node.mChildCount; ++i) {
+                if (importances[i] == 0.0f) {
+                    continue;
+                }
+                slot = i;
+                slotPdf = importances[i] / totalImportance;
+                slotCdf = cdf;
+                cdf += slotPdf;
+                if (u <= cdf) {
+                    break;
+                }
+            }
+            u = scene_rdl2::math::clamp((u - slotCdf) / slotPdf, 0.0f, 1.0f);
+        }
+        pdf *= slotPdf;
+
+        const int child = node.mChildren[slot];
+        if (child < 0) {
+            // The face is selected. Multiply by the inverse area of the face to get
+            // the final pdf = pdf(face) * pdf(point | face)
+            const int faceIndex = ~child;
+            pdf *= mFaceInvArea[faceIndex];
+            return faceIndex;
+        }
+        nodeIndex = child;
     }
 }
 
@@ -1503,38 +1760,29 @@ float
 MeshLight::getPdfOfFace(size_t nodeID, const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n) const
 {
     // compute pdf by traversing backwards through the bvh and computing
-    // the importance of each traversed node and its sibling.
-    MNRY_ASSERT(mBVH[nodeID].isLeaf());
+    // the importance of all the children of each traversed node.
     float pdf = 1.0f;
-    unsigned currNodeIndex = nodeID;
-    while (currNodeIndex > 0) {
-        Node currNode = mBVH[currNodeIndex];
-        MNRY_ASSERT(currNode.mParentIndex < (int)mBVH.size() ||
-            (currNode.mParentIndex == -1 && currNodeIndex == 0));
-        Node siblingNode;
-        const Node& parentNode = mBVH[currNode.mParentIndex];
-        if (parentNode.mRightChildIndex == currNodeIndex) {
-            // currNode is the right child, sibling is the left child
-            siblingNode = mBVH[currNode.mParentIndex + 1];
-        } else {
-            // currNode is the left child, sibling is the right child
-            MNRY_ASSERT(currNodeIndex == currNode.mParentIndex + 1);
-            siblingNode =  mBVH[parentNode.mRightChildIndex];
+    int leafID = nodeID;
+    while (leafID >= 0) {
+        const WideNode& node = mBVH[leafID / MESH_LIGHT_BVH_WIDTH];
+        const int slot = leafID % MESH_LIGHT_BVH_WIDTH;
+        MNRY_ASSERT(slot < node.mChildCount);
+
+        float importances[MESH_LIGHT_BVH_WIDTH];
+        importance(p, n, node, importances);
+        float totalImportance = 0.0f;
+        for (int i = 0; i < MESH_LIGHT_BVH_WIDTH; ++i) {
+            MNRY_ASSERT(importances[i] >= 0.0f);
+            totalImportance += importances[i];
         }
 
-        float currImportance = importance(p, n, currNode);
-        float siblingImportance = importance(p, n, siblingNode);
-
-        MNRY_ASSERT(currImportance >= 0.0f);
-        MNRY_ASSERT(siblingImportance >= 0.0f);
-
-        if (currImportance == 0.0f && siblingImportance == 0.0f) {
-            pdf *= 0.5;
+        if (totalImportance == 0.0f) {
+            pdf /= node.mChildCount;
         } else {
-            pdf *= currImportance / (currImportance + siblingImportance);
+            pdf *= importances[slot] / totalImportance;
         }
 
-        currNodeIndex = currNode.mParentIndex;
+        leafID = node.mParent;
     }
 
     return pdf;
@@ -1583,18 +1831,20 @@ MeshLight::intersect(const scene_rdl2::math::Vec3f &p, const scene_rdl2::math::V
     // pdf = pdf (point | face) * pdf(face)
     int faceOffset = mFaceOffset[rayHit.hit.geomID] + rayHit.hit.primID;
     int nodeIndex = mPrimIDToNodeID[faceOffset];
+    const WideNode& leafNode = mBVH[nodeIndex / MESH_LIGHT_BVH_WIDTH];
+    const int faceIndex = ~leafNode.mChildren[nodeIndex % MESH_LIGHT_BVH_WIDTH];
     float pdf = 1.0f;
     if (n) {
         // transform shading point's normal from render space to the light's
         // local space.
         const scene_rdl2::math::Vec3f transformedN = xformNormalRender2LocalRot(*n, time);
-        pdf = mBVH[nodeIndex].mFace->mInvArea * getPdfOfFace(nodeIndex, transformedP, &transformedN);
+        pdf = mFaceInvArea[faceIndex] * getPdfOfFace(nodeIndex, transformedP, &transformedN);
     } else {
-        pdf = mBVH[nodeIndex].mFace->mInvArea * getPdfOfFace(nodeIndex, transformedP, nullptr);
+        pdf = mFaceInvArea[faceIndex] * getPdfOfFace(nodeIndex, transformedP, nullptr);
     }
 
     // Fill in isect members
-    isect.N = xformNormalLocal2RenderRot(mBVH[nodeIndex].mFace->mNormal, time);
+    isect.N = xformNormalLocal2RenderRot(mFaceNormal[faceIndex], time);
     isect.uv = scene_rdl2::math::Vec2f(rayHit.hit.u, rayHit.hit.v);
     isect.distance = xformLocal2RenderScale(rayHit.ray.tfar, time);
     isect.pdf = pdf;
@@ -1621,24 +1871,23 @@ MeshLight::sample(const scene_rdl2::math::Vec3f &p, const scene_rdl2::math::Vec3
     const scene_rdl2::math::Vec3f transformedP = xformPointRender2Local(p, time);
     if (n) {
         const scene_rdl2::math::Vec3f transformedN = xformNormalRender2LocalRot(*n, time);
-        faceIndex = drawSampleRecurse(transformedP, &transformedN, 0, r3, pdf);
+        faceIndex = drawSample(transformedP, &transformedN, r3, pdf);
     } else {
-        faceIndex = drawSampleRecurse(transformedP, nullptr, 0, r3, pdf);
+        faceIndex = drawSample(transformedP, nullptr, r3, pdf);
     }
 
     MNRY_ASSERT(scene_rdl2::math::isfinite(pdf) && pdf >= 0.0f);
-    MNRY_ASSERT(mBVH[faceIndex].isLeaf());
-    const Face& face = *mBVH[faceIndex].mFace;
+    MNRY_ASSERT(faceIndex >= 0 && faceIndex < (int)mFaceCount);
 
     scene_rdl2::math::Vec2f uv;
     scene_rdl2::math::Vec3f hit;
     scene_rdl2::math::Vec3f normal;
 
-    if (getFaceVertexCount(face) == 3 || getFaceVertex(face, 2, time) == getFaceVertex(face, 3, time)) {
+    if (getFaceVertexCount(faceIndex) == 3 || getFaceVertex(faceIndex, 2, time) == getFaceVertex(faceIndex, 3, time)) {
         // triangle or degenerate quad case
-        scene_rdl2::math::Vec3f p1 = getFaceVertex(face, 0, time);
-        scene_rdl2::math::Vec3f p2 = getFaceVertex(face, 1, time);
-        scene_rdl2::math::Vec3f p3 = getFaceVertex(face, 2, time);
+        scene_rdl2::math::Vec3f p1 = getFaceVertex(faceIndex, 0, time);
+        scene_rdl2::math::Vec3f p2 = getFaceVertex(faceIndex, 1, time);
+        scene_rdl2::math::Vec3f p3 = getFaceVertex(faceIndex, 2, time);
 
         // the random numbers r1 and r2 can be used as uv coordinates
         float u = r1;
@@ -1653,11 +1902,11 @@ MeshLight::sample(const scene_rdl2::math::Vec3f &p, const scene_rdl2::math::Vec3
         hit = w*p1 + u*p2 + v*p3;
 
         if (mDeformationMb) {
-            // We cannot directly use face.mNormal here because it is the normal at
+            // We cannot directly use mFaceNormal here because it is the normal at
             // time = centroidTime. Therefore we compute it here.
             normal = normalize(cross(p2 - p1, p3 - p1));
         } else {
-            normal = face.mNormal;
+            normal = mFaceNormal[faceIndex];
         }
 
         if (mMapShader) {
@@ -1667,12 +1916,12 @@ MeshLight::sample(const scene_rdl2::math::Vec3f &p, const scene_rdl2::math::Vec3
         }
     } else {
         // quad case
-        MNRY_ASSERT(getFaceVertexCount(face) == 4);
+        MNRY_ASSERT(getFaceVertexCount(faceIndex) == 4);
 
-        scene_rdl2::math::Vec3f v0 = getFaceVertex(face, 0, time);
-        scene_rdl2::math::Vec3f v1 = getFaceVertex(face, 1, time);
-        scene_rdl2::math::Vec3f v2 = getFaceVertex(face, 2, time);
-        scene_rdl2::math::Vec3f v3 = getFaceVertex(face, 3, time);
+        scene_rdl2::math::Vec3f v0 = getFaceVertex(faceIndex, 0, time);
+        scene_rdl2::math::Vec3f v1 = getFaceVertex(faceIndex, 1, time);
+        scene_rdl2::math::Vec3f v2 = getFaceVertex(faceIndex, 2, time);
+        scene_rdl2::math::Vec3f v3 = getFaceVertex(faceIndex, 3, time);
 
         scene_rdl2::math::Vec3f normal013 = cross(v1 - v0, v3 - v0);
         scene_rdl2::math::Vec3f normal231 = cross(v3 - v2, v1 - v2);
@@ -1747,8 +1996,8 @@ MeshLight::sample(const scene_rdl2::math::Vec3f &p, const scene_rdl2::math::Vec3
 
     isect.N = xformNormalLocal2RenderRot(normal, time);
     isect.pdf = pdf;
-    isect.primID = face.mPrimID;
-    isect.geomID = face.mGeomID;
+    isect.primID = mFacePrimID[faceIndex];
+    isect.geomID = mFaceGeomID[faceIndex];
     isect.uv = uv;
 
     return true;
@@ -1798,7 +2047,7 @@ MeshLight::eval(mcrt_common::ThreadLocalState* tls, const scene_rdl2::math::Vec3
 scene_rdl2::math::Vec3f
 MeshLight::getEquiAngularPivot(const scene_rdl2::math::Vec3f& r, float time) const
 {
-    return mBVH[0].getCenter();
+    return mBVH[0].mLower + 0.5f * 255.0f * mBVH[0].mScale;
 }
 
 void
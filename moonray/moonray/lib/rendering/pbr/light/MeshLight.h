@@ -40,10 +40,12 @@ namespace pbr {
 
 // A Face is a polygon in the mesh. It behaves as a flat polygonal light.
 struct Face;
-// A Node is a node in the SAOH Sampling BVH. It contains the necessary
-// information to traverse the BVH for the purpose of importance sampling
-// the mesh light.
+// A Node is a node in the binary SAOH BVH built over the faces.
 struct Node;
+// A WideNode is a node in the Sampling BVH, which the binary BVH is collapsed
+// into. It contains the necessary information to traverse the BVH for the
+// purpose of importance sampling the mesh light.
+struct WideNode;
 
 //----------------------------------------------------------------------------
 
@@ -249,21 +251,35 @@ private:
     // How many vertices per face in each mesh. Should be either 3 or 4.
     std::vector<unsigned> mFaceVertexCount;
 
+    // Index buffer of each mesh
+    std::vector<const int*> mMeshIndices;
+
     // The mesh light is made up of faces. Each face acts as an area light.
+    // Faces are only kept until the BVH is built.
     std::vector<Face> mFaces;
 
-    // The MeshLight BVH is structured as a vector of nodes. For a node at index
-    // n, its left child is at index n+1 and its right child is at node.mRightIndex.
-    std::vector<Node> mBVH;
+    // Data of the faces needed for sampling, indexed by face index, which is
+    // the order the faces are left in by the BVH build.
+    std::vector<float> mFaceInvArea;
+    std::vector<scene_rdl2::math::Vec3f> mFaceNormal;
+    std::vector<int> mFacePrimID;
+    std::vector<int> mFaceGeomID;
+
+    // The MeshLight BVH is structured as a vector of wide nodes, the root is at
+    // index 0. A child of a node is either another node or a face.
+    std::vector<WideNode> mBVH;
 
-    // Given the geometry ID and primitive id of a face, map is back to the node
-    // index in the BVH.
+    // Given the geometry ID and primitive id of a face, map is back to its leaf
+    // in the BVH: node index * MESH_LIGHT_BVH_WIDTH + child slot.
     std::vector<int> mPrimIDToNodeID;
 
     //--------------- Accessors ------------------//
 
     unsigned int getFaceVertexCount(const Face& face) const;
+    unsigned int getFaceVertexCount(int faceIndex) const;
     const scene_rdl2::math::Vec3f getFaceVertex(const Face& face, size_t index, float time) const;
+    const scene_rdl2::math::Vec3f getFaceVertex(int faceIndex, size_t index, float time) const;
+    const scene_rdl2::math::Vec3f getVertex(int geomID, int vertexIndex, float time) const;
 
     //------------- Building BVH ----------------//
 
@@ -277,36 +293,40 @@ private:
 
     // Recursively builds the bvh by splitting primitives into left and right nodes
     // Returns the index of the node in the bvh.
-    int buildBVHRecurse(const scene_rdl2::math::BBox3f& bbox, std::vector<Face>& faces, int start,
-        int end, int parentIndex);
+    int buildBVHRecurse(std::vector<Node>& nodes, const scene_rdl2::math::BBox3f& bbox,
+        std::vector<Face>& faces, int start, int end, int parentIndex);
 
     // Verify that the bvh is built properly
-    bool verifyBuild(int index) const;
+    bool verifyBuild(const std::vector<Node>& nodes, int index) const;
+
+    // Recursively collapses the binary bvh into mBVH. The children of a wide
+    // node are found by opening the internal node with the largest surface
+    // area until there are MESH_LIGHT_BVH_WIDTH of them.
+    // Returns the index of the node in mBVH.
+    int collapseBVHRecurse(const std::vector<Node>& nodes, int nodeIndex, int parent);
 
     //------------- Traversing BVH ----------------//
 
     // Given a shading point and shading normal, what is the importance value of
-    // this node in the bvh?
-    float importance(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f* shadingNormal, const Node& node) const;
+    // each child of this node in the bvh?
+    void importance(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f* shadingNormal,
+        const WideNode& node, float importances[MESH_LIGHT_BVH_WIDTH]) const;
 
     // Called during sample operation. This traverses the bvh using the random
     // number u. It uses the shadingPoint and shadingNormal to determine the
-    // probability of picking the left or right node (PL and PR). If u < PL,
-    // we traverse down the left side of the tree, otherwise we traverse down
-    // the right side. We terminate at a leaf node, which contains the index of
-    // a mesh face.
+    // probability of picking each child of a node, and picks the child whose
+    // interval of the cdf contains u. u is then remapped to that interval and
+    // the traversal continues until a face is picked.
     // During the traversal we compute the pdf by multiplying the probabilities of
-    // traversing each node. For example, the root node of the BVH has probability
-    // P = 1. If we traverse the left node, that is P *= PL. If we traverse the
-    // right node P *= PR. Once we have reached the leaf node, we have the pdf
-    // for that face.
-    // Returns index of the leaf node in the BVH.
-    int drawSampleRecurse(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f *shadingNormal,
-        int currentNodeIndex, float u, float& pdf) const;
+    // the children traversed. Once we have reached a face, we have the pdf for
+    // that face.
+    // Returns index of the face.
+    int drawSample(const scene_rdl2::math::Vec3f& shadingPoint, const scene_rdl2::math::Vec3f *shadingNormal,
+        float u, float& pdf) const;
 
     // If we know the face that we intersected, what is the pdf of selecting that
     // face?
-    // nodeID is the node index in the BVH. It should be the index of a leaf node.
+    // nodeID is the leaf of the face in the BVH, as found in mPrimIDToNodeID.
     // p is the shading point and n is the shading normal. These are needed to
     // compute the importance at each node.
     float getPdfOfFace(size_t nodeID, const scene_rdl2::math::Vec3f& p, const scene_rdl2::math::Vec3f* n) const;
@@ -19,6 +19,7 @@ AdaptiveRenderTileInfo::show(const std::string &hd) const
     ostr << hd << "AdaptiveRenderTileInfo {\n";
     ostr << hd << "  mStage:" << conditionStr[(int)mStage] << '\n';
     ostr << hd << "  mCompletedSamples:" << mCompletedSamples << '\n';
+    ostr << hd << "  mActivePixels:" << getActivePixels() << '\n';
     ostr << hd << "}";
     return ostr.str();
 }
@@ -8,6 +8,7 @@
 #include <scene_rdl2/common/fb_util/FbTypes.h> // fb_util::Tile
 #include <scene_rdl2/common/math/Viewport.h> // math::Viewport
 #include <scene_rdl2/common/platform/Platform.h> // finline
+#include <atomic>
 #include <cstdint> // uint64_t
 
 namespace moonray {
@@ -24,7 +25,8 @@ public:
 
     AdaptiveRenderTileInfo() :
         mStage(Stage::UNIFORM_STAGE),
-        mCompletedSamples(0)
+        mCompletedSamples(0),
+        mActivePixels(64)
     {}
 
     finline void reset();
@@ -39,11 +41,17 @@ public:
 
     finline bool isCompleted() const { return (mStage == Stage::COMPLETED); }
 
+    // Number of pixels the adaptive stage still wanted to sample the last time this tile was rendered.
+    // Written by render threads and read while the TileWorkQueue deals the next pass.
+    unsigned getActivePixels() const { return mActivePixels.load(std::memory_order_relaxed); }
+    void setActivePixels(const unsigned activePixels) { mActivePixels.store(activePixels, std::memory_order_relaxed); }
+
     std::string show(const std::string &hd) const;
 
 private:
     Stage mStage;
     unsigned mCompletedSamples; // total completed samples for this tile (= sum of all completed pix samples).
+    std::atomic<unsigned> mActivePixels; // pixels above the adaptive target error at the last adaptive stage render.
 };
 
 finline void
@@ -51,6 +59,7 @@ AdaptiveRenderTileInfo::reset()
 {
     mStage = Stage::UNIFORM_STAGE;
     mCompletedSamples = 0;
+    setActivePixels(64);
 }
 
 finline unsigned
@@ -58,6 +67,7 @@ AdaptiveRenderTileInfo::complete(const unsigned maxSamplesPerPixel)
 // return delta completed samples of this tile from previous call.
 {
     mStage = Stage::COMPLETED;
+    setActivePixels(0);
 
     unsigned oldCompletedSamples = mCompletedSamples;
     mCompletedSamples = maxSamplesPerPixel * 64;
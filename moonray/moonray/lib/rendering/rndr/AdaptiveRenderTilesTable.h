@@ -77,8 +77,13 @@ public:
     finline void setTileAdaptive(const unsigned tileIdx, const unsigned addedSamples);
     finline void setTileUpdate(const unsigned tileIdx, const unsigned addedSamples);
     finline void setTileCompleteAdaptiveStage(const unsigned tileIdx);
+    finline void setTileActivePixels(const unsigned tileIdx, const unsigned activePixels);
     finline bool getMinimumDone() const noexcept;
 
+    // Scheduling priority of a tile : the number of its pixels which still need samples.
+    // Used by the work stealing TileWorkQueue to hand out the noisiest tiles first.
+    finline unsigned getTilePriority(const unsigned tileIdx) const;
+
     AdaptiveRenderTileInfo &getTile(const unsigned tileIdx) { return mTiles[tileIdx]; }
 
     finline float getCompletedFraction(bool activeRendering,
@@ -196,6 +201,19 @@ AdaptiveRenderTilesTable::setTileCompleteAdaptiveStage(const unsigned tileIdx)
     mCompletedSamples += mTiles[tileIdx].complete(mMaxSamplesPerPixel);
 }
 
+finline void
+AdaptiveRenderTilesTable::setTileActivePixels(const unsigned tileIdx, const unsigned activePixels)
+{
+    mTiles[tileIdx].setActivePixels(activePixels);
+}
+
+finline unsigned
+AdaptiveRenderTilesTable::getTilePriority(const unsigned tileIdx) const
+{
+    // completed tiles have no active pixels left
+    return mTiles[tileIdx].getActivePixels();
+}
+
 finline bool
 AdaptiveRenderTilesTable::getMinimumDone() const noexcept
 {
@@ -381,9 +381,12 @@ Film::init(unsigned w, unsigned h,
     // know which buffer corresponds to which aov index.
     mAovIdxToBufIdx.clear();
     mAovIdxToBufIdx.resize(mAovBufNumFloats);
+    mAovIdxToChannel.clear();
+    mAovIdxToChannel.resize(mAovBufNumFloats);
     unsigned int idx = 0;
     for (unsigned int i = 0; i < aovSchema.size(); ++i) {
         for (unsigned int j = 0; j < aovSchema[i].numChannels(); ++j) {
+            mAovIdxToChannel[idx] = j;
             mAovIdxToBufIdx[idx++] = i;
         }
     }
@@ -448,7 +451,7 @@ Film::init(unsigned w, unsigned h,
         if (!mCryptomatteBuf) {
             mCryptomatteBuf = new pbr::CryptomatteBuffer;
         }
-        mCryptomatteBuf->init(w, h, deepIDChannelNames.size(), multiPresenceOn);
+        mCryptomatteBuf->init(w, h, deepIDChannelNames.size(), multiPresenceOn, numRenderThreads);
     } else {
         delete mCryptomatteBuf;
         mCryptomatteBuf = nullptr;
@@ -980,7 +983,10 @@ Film::addSampleBundleHandlerHelper(mcrt_common::ThreadLocalState *tls,
                 pbr::DeepData *deepData = static_cast<pbr::DeepData*>(pbrTls->getListItem(br->mDeepDataHandle, 0));
                 if (deepData->mHitDeep) {
                     constexpr int channels[3] = { 0, 1, 2 };
-                    const float vals[3] = { br->mRadiance[0], br->mRadiance[1], br->mRadiance[2] };
+                    float vals[3] = { br->mRadiance[0], br->mRadiance[1], br->mRadiance[2] };
+                    pbr::DeepVolumeData *deepVolumeData =
+                        static_cast<pbr::DeepVolumeData*>(pbrTls->getListItem(br->mDeepDataHandle, 1));
+                    deepVolumeData->removeFromRadiance(vals);
                     film.mDeepBuf->addSample(pbrTls, px, py,
                                              deepData->mSubpixelX, deepData->mSubpixelY, deepData->mLayer,
                                              deepData->mDeepIDs, deepData->mDeepT, deepData->mRayZ,
@@ -1018,20 +1024,27 @@ Film::addSampleBundleHandlerHelper(mcrt_common::ThreadLocalState *tls,
                             // we only want to increment coverage, position, normal, and the normalization factor
                             // numFragSamples if we're dealing with the first sample for this path. We don't want 
                             // any data from the subsequent bounces except for the beauty (for GI)
-                            film.mCryptomatteBuf->addSampleVector(px, py, id, 1.f, position, normal, beauty,
+                            film.mCryptomatteBuf->addSampleVector(pbrTls, px, py, id, 1.f, position, normal, beauty,
                                                                   refP, refN, uv, depth);                    
                             cryptomatteData->mIsFirstSample = 0;
                         } else {
-                            film.mCryptomatteBuf->addBeautySampleVector(px, py, id, beauty, depth);
+                            film.mCryptomatteBuf->addBeautySampleVector(pbrTls, px, py, id, beauty, depth);
                         }
                     } else if (cryptomatteData->mPresenceDepth >= 0 && cryptomatteData->mPathPixelWeight > 0.01f) {
                         // We divide by pathPixelWeight to compute Cryptomatte beauty.  This can cause fireflies if
                         // the value is small, so we clamp at 0.01.
                         beauty.a = 0.f;
                         // presence path: only add beauty -- the rest of the data is populated in the shadeBundleHandler 
-                        film.mCryptomatteBuf->addBeautySampleVector(px, py, id, beauty, depth);
+                        film.mCryptomatteBuf->addBeautySampleVector(pbrTls, px, py, id, beauty, depth);
                     }
                 }
+                if (pbrTls->getNumListItems(br->mCryptomatteDataHandle) > 1) {
+                    // The refracted fragment gets the radiance of the whole path, it is added to the
+                    // cryptomatte buffer once the path is done.
+                    pbr::CryptomatteRefractData *refractData =
+                        static_cast<pbr::CryptomatteRefractData*>(pbrTls->getListItem(br->mCryptomatteDataHandle, 1));
+                    refractData->mBeauty += br->mRadiance;
+                }
                 pbrTls->releaseCryptomatteData(br->mCryptomatteDataHandle);
             }
 
@@ -1143,8 +1156,13 @@ Film::addAovSampleBundleHandler(mcrt_common::ThreadLocalState *tls,
                     if (ba->mDeepDataHandle != pbr::nullHandle) {
                         pbr::DeepData *deepData = static_cast<pbr::DeepData*>(pbrTls->getListItem(ba->mDeepDataHandle, 0));
                         if (deepData->mHitDeep) {
+                            const pbr::DeepVolumeData *deepVolumeData =
+                                static_cast<pbr::DeepVolumeData*>(pbrTls->getListItem(ba->mDeepDataHandle, 1));
                             int channels[1] = { (int)aovIdx + 3 };
                             float vals[1] = { ba->mAovs[aov] };
+                            if (film->mAovEntries[film->mAovIdxToBufIdx[aovIdx]].type() == pbr::AOV_TYPE_LIGHT_AOV) {
+                                vals[0] = deepVolumeData->removeTransmittance(vals[0], film->mAovIdxToChannel[aovIdx]);
+                            }
                             film->mDeepBuf->addSample(pbrTls, px, py,
                                                       deepData->mSubpixelX, deepData->mSubpixelY, deepData->mLayer,
                                                       deepData->mDeepIDs, deepData->mDeepT, deepData->mRayZ,
@@ -1324,8 +1342,13 @@ Film::addFilteredAovSampleBundleHandler(mcrt_common::ThreadLocalState *tls,
                     if (ba->mDeepDataHandle != pbr::nullHandle) {
                         pbr::DeepData *deepData = static_cast<pbr::DeepData*>(pbrTls->getListItem(ba->mDeepDataHandle, 0));
                         if (deepData->mHitDeep) {
+                            const pbr::DeepVolumeData *deepVolumeData =
+                                static_cast<pbr::DeepVolumeData*>(pbrTls->getListItem(ba->mDeepDataHandle, 1));
                             int channels[1] = { (int)aovIdx + 3 };
                             float vals[1] = { ba->mAovs[aov] };
+                            if (film->mAovEntries[film->mAovIdxToBufIdx[aovIdx]].type() == pbr::AOV_TYPE_LIGHT_AOV) {
+                                vals[0] = deepVolumeData->removeTransmittance(vals[0], film->mAovIdxToChannel[aovIdx]);
+                            }
                             film->mDeepBuf->addSample(pbrTls, px, py,
                                                       deepData->mSubpixelX, deepData->mSubpixelY, deepData->mLayer,
                                                       deepData->mDeepIDs, deepData->mDeepT, deepData->mRayZ,
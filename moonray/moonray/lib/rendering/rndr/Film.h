@@ -376,6 +376,8 @@ protected:
     // this is used in addAovSampleBundleHandler
     // to efficiently find the buffer associated with an aov index
     std::vector<unsigned>            mAovIdxToBufIdx;
+    // and the channel of that buffer
+    std::vector<unsigned>            mAovIdxToChannel;
     std::vector<unsigned>            mAovBeautyBufIdx;
     std::vector<unsigned>            mAovAlphaBufIdx;
 
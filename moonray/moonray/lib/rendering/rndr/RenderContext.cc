@@ -33,6 +33,7 @@
 #include <moonray/rendering/bvh/shading/AttributeKey.h>
 #include <moonray/rendering/bvh/shading/Intersection.h>
 #include <moonray/rendering/bvh/shading/ThreadLocalObjectState.h>
+#include <moonray/rendering/mcrt_common/ProfileAccumulator.h>
 #include <moonray/rendering/mcrt_common/ThreadLocalState.h>
 #include <moonray/rendering/pbr/camera/Camera.h>
 #include <moonray/rendering/pbr/core/Aov.h>
@@ -455,6 +456,7 @@ RenderContext::initialize(std::stringstream &initMessages, LoggingConfiguration
     // configure GeometryManager options
     mGeometryManagerOptions->accelOptions.maxThreads = getNumTBBThreads();
     mGeometryManagerOptions->accelOptions.verbose = false;
+    mGeometryManagerOptions->tessellationCacheDir = mOptions.getTessellationCacheDir();
 
     mGeometryManagerOptions->stats.logString =
         [stats = mRenderStats.get()](const std::string& str)
@@ -714,6 +716,12 @@ RenderContext::startFrame()
     mResumeHistoryMetaData->setFrameStartTime(); // record frame start timing for resume history 
     mRenderPrepExecTracker.init();
 
+    // The recording spans all frames, each stopFrame rewrites the trace file
+    // with everything recorded so far.
+    if (!mOptions.getProfileTraceFile().empty() && !mcrt_common::isTraceRecording()) {
+        mcrt_common::startTraceRecording();
+    }
+
     {
         texture::TextureSampler* sampler = texture::getTextureSampler();
 
@@ -729,6 +737,7 @@ RenderContext::startFrame()
         if (static_cast<int>(sampler->getMemoryUsage()) != textureCacheSizeMb) {
             sampler->setMemoryUsage(static_cast<float>(textureCacheSizeMb));
         }
+        sampler->setTilePrefetchThreads(mOptions.getTexturePrefetchThreads());
     }
 
     MNRY_ASSERT_REQUIRE(!mRendering, "Must stop rendering before starting it again.");
@@ -1054,6 +1063,7 @@ RenderContext::stopFrame()
     // Accumulate pbr stats data.
     mPbrStatistics->mMcrtTime = mDriver->getLastFrameMcrtDuration();
     mPbrStatistics->mMcrtUtilization = mDriver->getLastFrameMcrtUtilization();
+    mRenderStats->mPassTailIdleTime = mDriver->getLastFramePassTailIdleTime();
     pbr::forEachTLS([this](pbr::TLState const *tls){ (*mPbrStatistics) += tls->mStatistics; });
 
     // Accumulate geom stats data.
@@ -1109,6 +1119,13 @@ RenderContext::stopFrame()
 
     mRenderStats->flush();
 
+    if (!mOptions.getProfileTraceFile().empty() && mcrt_common::isTraceRecording()) {
+        const std::string& traceFile = mOptions.getProfileTraceFile();
+        if (!mcrt_common::writeTraceRecording(traceFile, 1.0 / mcrt_common::computeTicksPerSecond())) {
+            Logger::error("Failed to write profile trace \"", traceFile, "\"");
+        }
+    }
+
     // Do debug ray database processing if we've just been recording rays.
     if (mDriver->getDebugRayState() == RenderDriver::RECORDING_COMPLETE) {
 
@@ -1253,6 +1270,22 @@ RenderContext::snapshotDelta(scene_rdl2::fb_util::RenderBuffer *renderBuffer,
     mDriver->snapshotDelta(renderBuffer, weightBuffer, activePixels, parallel);
 }
 
+void
+RenderContext::snapshotDeltaUntiled(scene_rdl2::fb_util::RenderBuffer *outputBuffer,
+                                    scene_rdl2::fb_util::RenderBuffer *renderBuffer,
+                                    scene_rdl2::fb_util::FloatBuffer *weightBuffer,
+                                    std::vector<unsigned> &updatedTiles,
+                                    bool parallel) const
+//
+// Incrementally updates a normalized and untiled snapshot of the renderBuffer (outputBuffer)
+// for interactive clients. Only the tiles which changed since the previous call are updated
+// and returned by updatedTiles. renderBuffer/weightBuffer are tiled and keep the previous
+// snapshot between calls.
+//
+{
+    mDriver->snapshotDeltaUntiled(outputBuffer, renderBuffer, weightBuffer, updatedTiles, parallel);
+}
+
 void
 RenderContext::snapshotDeltaRenderBufferOdd(scene_rdl2::fb_util::RenderBuffer *renderBufferOdd,
                                             scene_rdl2::fb_util::FloatBuffer *weightRenderBufferOdd,
@@ -1886,6 +1919,7 @@ RenderContext::renderPrep(ExecutionMode executionMode, bool allowUnsupportedXPUF
                 mRenderStats->getLogCsv()  ||
                 mRenderStats->getLogAthena()) {
                 reportGeometryTessellationTime();
+                reportGeometryBVHBuildTime();
                 reportGeometryMemory();
             }
         }
@@ -2451,6 +2485,8 @@ RenderContext::loadGeometries(const rt::ChangeFlag flag)
         mGeometryManager->getStatistics().mTessellationTime;
     mRenderStats->mPerPrimitiveTessellationTime =
         mGeometryManager->getStatistics().mPerPrimitiveTessellationTime;
+    mRenderStats->mPerGeometryBVHBuildTime =
+        mGeometryManager->getStatistics().mPerGeometryBVHBuildTime;
     mRenderStats->mBuildAcceleratorTime =
         mGeometryManager->getStatistics().mBuildAcceleratorTime;
     mRenderStats->mBuildProceduralTime =
@@ -2564,6 +2600,17 @@ RenderContext::reportGeometryTessellationTime()
     }
 }
 
+void
+RenderContext::reportGeometryBVHBuildTime()
+{
+    if (mRenderStats->getLogInfo() || mRenderStats->getLogCsv()) {
+        mRenderStats->logTopBVHBuildStats();
+    }
+    if (mRenderStats->getLogAthena()) {
+        mRenderStats->logAllBVHBuildStats();
+    }
+}
+
 void
 RenderContext::reportGeometryMemory()
 {
@@ -2743,6 +2790,7 @@ RenderContext::buildFrameState(FrameState *fs, double frameStartTime, ExecutionM
     fs->mAovSchema = &mRenderOutputDriver->getAovSchema();
     fs->mMaterialAovs = &mRenderOutputDriver->getMaterialAovs();
     fs->mLightAovs = &mRenderOutputDriver->getLightAovs();
+    fs->mDeepBuffer = nullptr; // hooked up by the RenderDriver once the film is allocated
     fs->mRequiresHeatMap = mRenderOutputDriver->requiresHeatMap();
     fs->mShadingWorkloadChunkSize = mOptions.getShadingWorkloadChunkSize();
     fs->mRequiresCryptomatteBuffer = mRenderOutputDriver->requiresCryptomatteBuffer();
@@ -2791,6 +2839,15 @@ RenderContext::buildFrameState(FrameState *fs, double frameStartTime, ExecutionM
         MNRY_ASSERT(0);
     }
 
+    // Work stealing only balances tiles within this process, distributed renders keep
+    // their tile order so the render nodes stay in step.
+    if (mOptions.getTileWorkStealing() && fs->mNumRenderNodes == 1 &&
+        (getRenderMode() == RenderMode::BATCH ||
+         getRenderMode() == RenderMode::PROGRESSIVE ||
+         getRenderMode() == RenderMode::PROGRESSIVE_FAST)) {
+        fs->mTileSchedulerType = TileScheduler::WORK_STEALING;
+    }
+
     if (getRenderMode() == RenderMode::BATCH) {
         if (mSceneContext->getCheckpointActive() || mSceneContext->getResumeRender()) {
             // We can use checkpoint mode for regular BATCH rendering.
@@ -3149,80 +3206,9 @@ RenderContext::handlePickLocation(const int x, const int y, scene_rdl2::math::Ve
 bool
 RenderContext::canRunVectorized(std::string &reason) const
 {
-    // Naturally, the goal is to have this method simply be:
-    //   return true;
-    bool result = true;
+    // All features are supported in vectorized mode now.
     reason.clear();
-
-    std::function<void(std::string)> fail = [&](const std::string &feature) {
-        if (!reason.empty()) reason += ", ";
-        reason += feature;
-        result = false;
-    };
-
-    MNRY_ASSERT(mLayer);
-
-    // These are conservative checks.  This function is run before
-    // render prep so it isn't possible to know if a particular object
-    // in the scene actually participates in rendering.  In some cases,
-    // the mere existence of an unsupported object or setting returns false.
-
-    // The order of checks is alphabetical based on the fail string.  This
-    // makes reading the debug message easier when multiple features are
-    // missing.
-
-    // Since we have multiple issues with render output objects, we'll loop
-    // over all the render outputs once, checking for all the problem types.
-    // The issues will still be reported in alphabetical order.
-    bool hasDeepOutput = false;
-    bool hasRefractCrypto = false;
-    const scene_rdl2::rdl2::SceneContext::RenderOutputVector &ros = mSceneContext->getAllRenderOutputs();
-    for (auto roItr = ros.cbegin(); roItr != ros.cend(); ++roItr) {
-        const scene_rdl2::rdl2::RenderOutput *ro = *roItr;
-        if (ro->getActive()) {
-            if (ro->getOutputType() == "deep") {
-                hasDeepOutput = true;
-            }
-            if (ro->getResult() == scene_rdl2::rdl2::RenderOutput::RESULT_CRYPTOMATTE &&
-                ro->getCryptomatteEnableRefract()) {
-                hasRefractCrypto = true;
-            }
-        }
-    }
-    const scene_rdl2::rdl2::SceneVariables &vars = mSceneContext->getSceneVariables();
-
-    // Overlapping Dielectrics: MOONRAY-3083
-    scene_rdl2::rdl2::Layer::MaterialSet materials;
-    mLayer->getAllMaterials(materials);
-    for (const scene_rdl2::rdl2::Material *mat : materials) {
-        if (mat->priority() > 0) {
-            fail("overlapping dielectrics");
-            break; // no need to keep looping
-        }
-    }
-
-    // Path Guiding: MOONRAY-3018
-    if (vars.get(scene_rdl2::rdl2::SceneVariables::sPathGuideEnable)) {
-        fail("path guiding");
-    }
-
-    // Volume Rendering + Deep Output: MOONRAY-3133
-    if (hasDeepOutput) {
-        const auto &volumeShaders = mLayer->get<scene_rdl2::rdl2::SceneObjectVector>("volume shaders");
-        for (size_t i = 0; i < volumeShaders.size(); ++i) {
-            if (volumeShaders[i] != nullptr) {
-                fail("volume rendering with deep output");
-                break; // no reason to keep looping
-            }
-        }
-    }
-
-    // Refractive crypto: MOONRAY-5074
-    if (hasRefractCrypto) {
-        fail("refractive cryptomattes");
-    }
-
-    return result;
+    return true;
 }
 
 void
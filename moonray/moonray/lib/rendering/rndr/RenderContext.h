@@ -234,6 +234,22 @@ public:
                        scene_rdl2::fb_util::ActivePixels &activePixels,
                        bool parallel) const;
 
+    /**
+     * Incrementally updates a normalized and untiled snapshot of the renderBuffer (outputBuffer)
+     * for interactive clients which resolve the same image over and over again.
+     * renderBuffer/weightBuffer are tiled, not normalized and hold the previous snapshot between
+     * calls the same way as snapshotDelta(). All the pixels of the tiles which have active pixels are
+     * normalized and untiled into outputBuffer, other tiles are left untouched. updatedTiles returns the ids
+     * of the updated 8x8 tiles (tileY * numTilesX + tileX). While the coarse passes still require
+     * extrapolation, this falls back to a full snapshotRenderBuffer() and all tiles are returned.
+     * Call weightBuffer->cleanUp() in order to force a full update by the next call.
+     */
+    void snapshotDeltaUntiled(scene_rdl2::fb_util::RenderBuffer *outputBuffer,
+                              scene_rdl2::fb_util::RenderBuffer *renderBuffer,
+                              scene_rdl2::fb_util::FloatBuffer *weightBuffer,
+                              std::vector<unsigned> &updatedTiles,
+                              bool parallel) const;
+
     /**
      * Snapshots the contents of the renderBufferOdd/weightRenderBufferOdd w/ ActivePixelsRenderBufferOdd information
      * for ProgressiveFrame message related logic. So renderBufferOdd is not normalized by weight yet.
@@ -605,6 +621,9 @@ private:
     // Report tessellation time for geometry primitives
     void reportGeometryTessellationTime();
 
+    // Report BVH build quality and time per geometry
+    void reportGeometryBVHBuildTime();
+
     // Report memory for geometry primitives
     void reportGeometryMemory();
 
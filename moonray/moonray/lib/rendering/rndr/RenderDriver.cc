@@ -529,6 +529,7 @@ RenderDriver::RenderDriver(const TLSInitParams &initParams) :
     mMcrtStartTime(-1.0),
     mMcrtDuration(-1.0),
     mMcrtUtilization(-1.0),
+    mPassTailIdleTime(0.0),
     mFrameEndTime(-1.0),
     mStopAtFrameReadyForDisplay(false),
     mRenderThreadState(),
@@ -731,6 +732,8 @@ RenderDriver::startFrame(const FrameState &fs)
         updated = true;
     }
 
+    mFs.mDeepBuffer = mFilm->getDeepBuffer();
+
     new(&mProgressEstimation) RenderProgressEstimation; // for interactive session, we need reset
 
     // We need to update mProgressEstimation and initialize adaptiveRegions data when
@@ -869,6 +872,12 @@ RenderDriver::startFrame(const FrameState &fs)
                             &passes.front());
     }
 
+    // The work stealing queue orders tiles by their adaptive priority when the
+    // frame is adaptively sampled, otherwise it keeps the tile scheduler order.
+    mTileWorkQueue.setWorkStealing(mFs.mTileSchedulerType == TileScheduler::WORK_STEALING,
+                                   (mFs.mSamplingMode == SamplingMode::ADAPTIVE) ?
+                                   mFilm->getAdaptiveRenderTilesTable() : nullptr);
+
     // Reset realtime stats.
     RealtimeFrameStats &rfs = getCurrentRealtimeFrameStats();
 
@@ -259,6 +259,20 @@ public:
                        scene_rdl2::fb_util::ActivePixels &activePixels,
                        bool parallel) const;
 
+    //
+    // Incrementally updates a normalized and untiled renderBuffer snapshot for interactive
+    // clients which resolve the same image over and over again (i.e. hdMoonray).
+    // renderBuffer/weightBuffer are tiled and keep the previous snapshot between calls like
+    // snapshotDelta(). Only the tiles which have active pixels are normalized and untiled into
+    // outputBuffer, always as whole tiles, and their ids are returned by updatedTiles. Falls back to the full
+    // snapshotRenderBuffer() while extrapolation is required.
+    //
+    void snapshotDeltaUntiled(scene_rdl2::fb_util::RenderBuffer *outputBuffer,
+                              scene_rdl2::fb_util::RenderBuffer *renderBuffer,
+                              scene_rdl2::fb_util::FloatBuffer *weightBuffer,
+                              std::vector<unsigned> &updatedTiles,
+                              bool parallel) const;
+
     //
     // Creates snapshot renderBufferOdd/weightRenderBufferOdd data w/ activePixelsRenderBufferOdd information
     // for ProgressiveFrame message related logic.
@@ -407,6 +421,7 @@ public:
     double getLastFrameMcrtStartTime() const          { return mMcrtStartTime; }
     double getLastFrameMcrtDuration() const           { return mMcrtDuration; }
     double getLastFrameMcrtUtilization() const        { return mMcrtUtilization; }
+    double getLastFramePassTailIdleTime() const       { return mPassTailIdleTime; }
 
     RealtimeFrameStats &getCurrentRealtimeFrameStats();
     void                commitCurrentRealtimeStats();
@@ -444,6 +459,19 @@ public:
                                                     int maxSPP,
                                                     int numCheckpointFiles,
                                                     std::string &logMessage);
+    // Tile update logic of snapshotDeltaUntiled() for the given tiled srcRenderBuffer/srcWeightBuffer.
+    // Also called from unitTest
+    static void snapshotDeltaUntiledTiles(const scene_rdl2::fb_util::Tiler &tiler,
+                                          unsigned unalignedW,
+                                          unsigned unalignedH,
+                                          const scene_rdl2::fb_util::RenderBuffer &srcRenderBuffer,
+                                          const scene_rdl2::fb_util::FloatBuffer &srcWeightBuffer,
+                                          scene_rdl2::fb_util::RenderBuffer *outputBuffer,
+                                          scene_rdl2::fb_util::RenderBuffer *renderBuffer,
+                                          scene_rdl2::fb_util::FloatBuffer *weightBuffer,
+                                          std::vector<unsigned> &updatedTiles,
+                                          bool parallel);
+
     // called from unitTest
     static bool verifyKJSequenceTable(const unsigned maxSampleId, std::string *tblStr = nullptr);
     static bool verifyTotalCheckpointToQualitySteps(SamplingMode mode,
@@ -752,6 +780,10 @@ private:
     double              mMcrtDuration;
     double              mMcrtUtilization;
 
+    // Sum over all render threads of the time spent idle at the end of each
+    // renderPasses() call, waiting for the other threads' last tile groups.
+    double              mPassTailIdleTime;
+
     // Estimated time of frame end, used to stop rendering for realtime mode.
     std::atomic<double> mFrameEndTime;
 
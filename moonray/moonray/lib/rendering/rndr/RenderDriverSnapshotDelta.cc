@@ -8,6 +8,9 @@
 #include <scene_rdl2/common/fb_util/ActivePixels.h>
 #include <scene_rdl2/common/fb_util/SnapshotUtil.h>
 
+#include <algorithm>
+#include <numeric>
+
 //#define SNAPSHOT_DELTA_TIMING_TEST
 //#define SNAPSHOT_DELTA_PIXINFO_TIMING_TEST
 //#define SNAPSHOT_DELTA_HEATMAP_TIMING_TEST
@@ -194,6 +197,120 @@ RenderDriver::snapshotDelta(scene_rdl2::fb_util::RenderBuffer *dstRenderBuffer,
 #endif // end SNAPSHOT_DELTA_TIMING_TEST
 }
 
+void
+RenderDriver::snapshotDeltaUntiled(scene_rdl2::fb_util::RenderBuffer *outputBuffer,
+                                   scene_rdl2::fb_util::RenderBuffer *renderBuffer,
+                                   scene_rdl2::fb_util::FloatBuffer *weightBuffer,
+                                   std::vector<unsigned> &updatedTiles,
+                                   bool parallel) const
+//
+// Incrementally updates a normalized and untiled renderBuffer snapshot (outputBuffer) for
+// interactive clients which resolve the same image over and over again (i.e. hdMoonray).
+// renderBuffer/weightBuffer are tiled, not normalized and keep the previous snapshot between
+// calls exactly like snapshotDelta(). All the pixels of the tiles which have active pixels are
+// normalized and untiled into outputBuffer, all the other tiles of outputBuffer are left untouched.
+// updatedTiles returns the ids of the updated 8x8 tiles in outputBuffer (tileY * numTilesX + tileX).
+// While coarse passes are not complete, the result requires extrapolation. In this case we
+// fall back to the full snapshotRenderBuffer() and reset the delta state so that the next call
+// updates all the tiles again.
+// Call weightBuffer->cleanUp() in order to force a full update by the next call.
+//
+{
+    const scene_rdl2::fb_util::Tiler &tiler = mFilm->getTiler();
+
+    if (!mCoarsePassesComplete) {
+        snapshotRenderBufferSub(outputBuffer, true, parallel, false);
+        weightBuffer->cleanUp();
+        updatedTiles.resize(tiler.mNumTiles);
+        std::iota(updatedTiles.begin(), updatedTiles.end(), 0u);
+        return;
+    }
+
+    snapshotDeltaUntiledTiles(tiler, mUnalignedW, mUnalignedH,
+                              mFilm->getRenderBuffer(), mFilm->getWeightBuffer(),
+                              outputBuffer, renderBuffer, weightBuffer, updatedTiles, parallel);
+}
+
+// static function
+void
+RenderDriver::snapshotDeltaUntiledTiles(const scene_rdl2::fb_util::Tiler &tiler,
+                                        unsigned unalignedW,
+                                        unsigned unalignedH,
+                                        const scene_rdl2::fb_util::RenderBuffer &srcRenderBuffer,
+                                        const scene_rdl2::fb_util::FloatBuffer &srcWeightBuffer,
+                                        scene_rdl2::fb_util::RenderBuffer *outputBuffer,
+                                        scene_rdl2::fb_util::RenderBuffer *renderBuffer,
+                                        scene_rdl2::fb_util::FloatBuffer *weightBuffer,
+                                        std::vector<unsigned> &updatedTiles,
+                                        bool parallel)
+//
+// Tile update of snapshotDeltaUntiled() without the extrapolation fallback. srcRenderBuffer/
+// srcWeightBuffer are the tiled film buffers. outputBuffer and renderBuffer/weightBuffer are
+// (re)initialized and fully updated when their resolution doesn't match.
+//
+{
+    const unsigned numTiles = tiler.mNumTiles;
+    const unsigned numTilesX = tiler.mAlignedW >> 3;
+
+    updatedTiles.clear();
+
+    bool updateAll = false;
+    if (outputBuffer->getWidth() != unalignedW || outputBuffer->getHeight() != unalignedH) {
+        outputBuffer->init(unalignedW, unalignedH);
+        updateAll = true;
+    }
+    if (weightBuffer->getWidth() != tiler.mAlignedW || weightBuffer->getHeight() != tiler.mAlignedH) {
+        renderBuffer->init(tiler.mAlignedW, tiler.mAlignedH);
+        weightBuffer->init(tiler.mAlignedW, tiler.mAlignedH);
+        renderBuffer->clear();
+        weightBuffer->clear();
+        updateAll = true;
+    }
+
+    std::vector<uint8_t> tileUpdated(numTiles, 0);
+
+    simpleLoop(parallel, 0u, numTiles, [&](unsigned tileIdx) {
+            const unsigned startX = (tileIdx % numTilesX) << 3;
+            const unsigned startY = (tileIdx / numTilesX) << 3;
+            const unsigned pixId = tiler.linearCoordsToTiledOffset(startX, startY); // tile is 8x8 = 64pixels
+
+            scene_rdl2::fb_util::RenderColor *dst = renderBuffer->getData() + pixId;
+            float *dstWeight = weightBuffer->getData() + pixId;
+            const scene_rdl2::fb_util::RenderColor *srcColor = srcRenderBuffer.getData() + pixId;
+            const float *srcWeight = srcWeightBuffer.getData() + pixId;
+
+            uint64_t activePixelMask =
+                scene_rdl2::fb_util::SnapshotUtil::snapshotTileColorWeight((uint32_t *)dst,
+                                                               (uint32_t *)dstWeight,
+                                                               (const uint32_t *)srcColor,
+                                                               (const uint32_t *)srcWeight);
+            if (!activePixelMask && !updateAll) return; // nothing changed inside this tile
+
+            // Normalize and untile all the pixels of this tile, not only the active ones : the caller
+            // post-processes (e.g. alpha composites) whole updated tiles of the output buffer, and the
+            // pixels it didn't get from us would be processed twice.
+            const unsigned endX = std::min(startX + 8, unalignedW);
+            const unsigned endY = std::min(startY + 8, unalignedH);
+            for (unsigned y = startY; y < endY; ++y) {
+                scene_rdl2::fb_util::RenderColor *dstRow = outputBuffer->getRow(y);
+                for (unsigned x = startX; x < endX; ++x) {
+                    const unsigned offset = tiler.linearCoordsToTiledOffset(x, y) - pixId;
+                    const float weight = dstWeight[offset];
+                    if (weight > 0.f) {
+                        dstRow[x] = dst[offset] * (1.f / weight);
+                    } else {
+                        dstRow[x] = scene_rdl2::fb_util::RenderColor(scene_rdl2::math::zero);
+                    }
+                }
+            }
+            tileUpdated[tileIdx] = 1;
+        });
+
+    for (unsigned tileIdx = 0; tileIdx < numTiles; ++tileIdx) {
+        if (tileUpdated[tileIdx]) updatedTiles.push_back(tileIdx);
+    }
+}
+
 void
 RenderDriver::snapshotDeltaRenderBufferOdd(scene_rdl2::fb_util::RenderBuffer *dstRenderBufferOdd,
                                            scene_rdl2::fb_util::FloatBuffer *dstWeightRenderBufferOdd,
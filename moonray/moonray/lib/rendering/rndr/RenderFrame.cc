@@ -93,6 +93,7 @@ RenderDriver::renderFrame(RenderDriver *driver, const FrameState &fs)
 
     // Start recording end to end frame time for realtime and progressive modes.
     driver->mMcrtStartTime = scene_rdl2::util::getSeconds();
+    driver->mPassTailIdleTime = 0.0;
 
     moonray::util::ProcessUtilization frameStartUtilization = moonray::util::ProcessStats().getProcessUtilization();
 
@@ -216,10 +217,12 @@ RenderDriver::renderFrame(RenderDriver *driver, const FrameState &fs)
 
     case RenderMode::PROGRESS_CHECKPOINT: {
         const bool pgEnabled = fs.mIntegrator->getEnablePathGuide(); // is path guiding enabled?
+        // is light selection learned? (adaptive light sampling, scalar mode only)
+        const bool lscEnabled = fs.mIntegrator->getEnableLightSelectionCache();
         std::unique_ptr<TileSampleSpecialEvent> tileSampleSpecialEvent;
-        if (pgEnabled) {
+        if (pgEnabled || lscEnabled) {
             //
-            // When PathGuiding case, we set up TileSampleSpecialEvent information to the
+            // When PathGuiding or light selection learning case, we set up TileSampleSpecialEvent information to the
             // checkpoint rendering main logic.
             //
             auto genSpecialEventTileSampleIdTable = [&](const unsigned maxPixSamples) -> UIntTable {
@@ -449,18 +452,23 @@ RenderDriver::progressiveRenderFrame(RenderDriver *driver, const FrameState &fs)
     if (workQueue->getNumPasses() > 0) {
 
         if (!getPrimaryTLS()->mPbrTls->isCanceled()) {
-            bool enablePathGuide = fs.mIntegrator->getEnablePathGuide();
+            // The path guide and the light selection cache both learn from
+            // one pass to the next. The light selection cache is only enabled
+            // for scalar renders, vectorized renders don't pay for the
+            // clamped passes unless they use path guiding
+            bool enablePassReset = fs.mIntegrator->getEnablePathGuide() ||
+                                   fs.mIntegrator->getEnableLightSelectionCache();
             // Clamp coarse passes for display filters. Some pixels do not
             // yet have data during coarse passes so display filters
             // must be run at the end of the pass.
             bool hasDisplayFilters = driver->getDisplayFilterDriver().hasDisplayFilters()
                 && !driver->areCoarsePassesComplete();
-            bool clampPasses = enablePathGuide || hasDisplayFilters;
+            bool clampPasses = enablePassReset || hasDisplayFilters;
             if (clampPasses) {
                 for (clampPass = 1; clampPass < workQueue->getNumPasses(); ++clampPass) {
                     // we need to reset the path guide after each pass
                     // we are responsible for ensuring thread-safety
-                    if (enablePathGuide) {
+                    if (enablePassReset) {
                         const_cast<pbr::PathIntegrator *>(fs.mIntegrator)->passReset();
                     }
                     workQueue->clampToPass(clampPass);
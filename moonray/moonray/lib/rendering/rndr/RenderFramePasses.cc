@@ -30,6 +30,9 @@
 #include <scene_rdl2/common/math/Color.h>
 #include <scene_rdl2/render/util/ThreadPoolExecutor.h>
 
+#include <algorithm>
+#include <vector>
+
 #ifdef RUNTIME_VERIFY_PIX_SAMPLE_COUNT // See RuntimeVerify.h
 #define RUNTIME_VERIFY0
 #endif // end RUNTIME_VERIFY_PIX_SAMPLE_COUNT
@@ -150,6 +153,10 @@ RenderDriver::renderPasses(RenderDriver *driver, const FrameState &fs,
     // Hand out one TLS per TBB thread from this list.
     mcrt_common::ThreadLocalState *topLevelTlsList = MNRY_VERIFY(mcrt_common::getTLSList());
 
+    // Time each thread ran out of work, used to measure how long threads sit idle
+    // at the tail of the passes waiting for the last tile groups to finish.
+    std::vector<double> threadWorkEndTimes(fs.mNumRenderThreads, 0.0);
+
     std::mutex checkpointEstimationTimeMutex;
     std::atomic<size_t> finishedTilesCount;
     finishedTilesCount = 0;
@@ -346,6 +353,7 @@ RenderDriver::renderPasses(RenderDriver *driver, const FrameState &fs,
             }
 
             double timeQueueDraining = scene_rdl2::util::getSeconds(); // get current time
+            threadWorkEndTimes[tls->mThreadIdx] = timeQueueDraining;
 
             if (tls->isCanceled()) {
                 canceled = true;
@@ -376,6 +384,28 @@ RenderDriver::renderPasses(RenderDriver *driver, const FrameState &fs,
 
     taskGroup.wait();
 
+    // Accumulate the thread time lost between each thread running out of work and
+    // the last thread finishing. Threads which exited on cancel before starting are skipped.
+    {
+        const double lastWorkEndTime = *std::max_element(threadWorkEndTimes.begin(), threadWorkEndTimes.end());
+        double tailIdleTime = 0.0;
+        for (double workEndTime : threadWorkEndTimes) {
+            if (workEndTime > 0.0) {
+                tailIdleTime += lastWorkEndTime - workEndTime;
+            }
+        }
+        driver->mPassTailIdleTime += tailIdleTime;
+    }
+
+    // All render threads are idle now, merge the deep and cryptomatte samples
+    // which were staged per thread in vector mode.
+    if (pbr::DeepBuffer *deepBuffer = driver->mFilm->getDeepBuffer()) {
+        deepBuffer->flushStagedSamples();
+    }
+    if (pbr::CryptomatteBuffer *cryptomatteBuffer = driver->mFilm->getCryptomatteBuffer()) {
+        cryptomatteBuffer->flushStagedSamples();
+    }
+
     timingRec.finalizeRenderPasses(); // End record timing : compute average thread timing and other info
     driver->mProgressEstimation.updatePassInfo(timingRec); // update pass info
 
@@ -517,7 +547,8 @@ RenderDriver::renderTiles(RenderDriver *driver,
     // Loop over current batch of tiles, we execute tile batches in parallel.
     unsigned processedSampleTotal = 0;
     for (unsigned itile = group.mStartTileIdx; itile != group.mEndTileIdx; ++itile) {
-        params.mTileIdx = itile;
+        params.mTileIdx = group.getTileIdx(itile);
+        TRACE_EVENT_SCOPE("Tile");
         if (!renderTile(driver, tls, group, params, deepBuffer, cryptomatteBuffer, processedSampleTotal)) {
             return 0; // cancel return
         }
@@ -619,6 +650,7 @@ RenderDriver::renderTileAdaptiveStage(RenderDriver* driver,
             break;
 
     }
+    film->getAdaptiveRenderTilesTable()->setTileActivePixels(params.mTileIdx, adaptiveRegion.count());
     if (!renderTileUniformSamples<true>(driver,
                                         tls,
                                         group,
@@ -1246,18 +1278,28 @@ RenderDriver::renderPixelVectorSamples(pbr::TLState *pbrTls,
         rs->mTilePass = pbr::makeTilePass(params->mTileIdx, group.mPassIdx);
 
         if (deepBuffer != nullptr) {
-            rs->mDeepDataHandle = pbrTls->allocList(sizeof(pbr::DeepData), 1);
+            // The second item holds the volume state of the sample.
+            rs->mDeepDataHandle = pbrTls->allocList(sizeof(pbr::DeepData), 2);
             pbr::DeepData *deepData = static_cast<pbr::DeepData*>(pbrTls->getListItem(rs->mDeepDataHandle, 0));
             deepData->mRefCount = 1;
             deepData->mHitDeep = 0;
             deepData->mLayer = 0;
+            pbr::DeepVolumeData *deepVolumeData =
+                        static_cast<pbr::DeepVolumeData*>(pbrTls->getListItem(rs->mDeepDataHandle, 1));
+            deepVolumeData->init();
         }
 
+        rs->mCryptoRefractPath = 0;
         if (cryptomatteBuffer != nullptr) {
-            rs->mCryptomatteDataHandle = pbrTls->allocList(sizeof(pbr::CryptomatteData), 1);
+            // The second item holds the refracted cryptomatte state of the sample.
+            rs->mCryptomatteDataHandle = pbrTls->allocList(sizeof(pbr::CryptomatteData), 2);
             pbr::CryptomatteData *cryptomatteData =
                         static_cast<pbr::CryptomatteData*>(pbrTls->getListItem(rs->mCryptomatteDataHandle, 0));
             cryptomatteData->init(cryptomatteBuffer);
+            pbr::CryptomatteRefractData *refractData =
+                        static_cast<pbr::CryptomatteRefractData*>(pbrTls->getListItem(rs->mCryptomatteDataHandle, 1));
+            refractData->init(pixel);
+            rs->mCryptoRefractPath = 1;
 
             rs->mCryptoRefP = scene_rdl2::math::Vec3f(0.f);
             rs->mCryptoRefN = scene_rdl2::math::Vec3f(0.f);
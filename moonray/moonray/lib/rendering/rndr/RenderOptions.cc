@@ -122,6 +122,10 @@ RenderOptions::RenderOptions() :
     mSceneFiles(),
     mDsoPath(""),
     mTextureCacheSizeMb(0),
+    mTexturePrefetchThreads(0),
+    mTessellationCacheDir(""),
+    mTileWorkStealing(false),
+    mProfileTraceFile(""),
     mAttributeOverrides(),
     mRdlaGlobals(),
     mCommandLine(""),
@@ -142,6 +146,7 @@ RenderOptions::RenderOptions() :
     mShadeQueueSize(0),
     mRadianceQueueSize(0),
     mShadingWorkloadChunkSize(32),
+    mCoherenceSortRays(false),
     mFps(0.0f)                  // 0.0 means not defined.
 {
     parserConfigure();
@@ -206,6 +211,26 @@ RenderOptions::parseFromCommandLine(int argc, char* argv[])
         setDsoPath(values[0]);
     }
 
+    validFlags.push_back("-texture_prefetch_threads");
+    if (args.getFlagValues("-texture_prefetch_threads", 1, values) >= 0) {
+        setTexturePrefetchThreads(stringToUnsignedLong(values[0]));
+    }
+
+    validFlags.push_back("-tessellation_cache_dir");
+    if (args.getFlagValues("-tessellation_cache_dir", 1, values) >= 0) {
+        setTessellationCacheDir(values[0]);
+    }
+
+    validFlags.push_back("-tile_work_stealing");
+    if (args.getFlagValues("-tile_work_stealing", 0, values) >= 0) {
+        setTileWorkStealing(true);
+    }
+
+    validFlags.push_back("-profile_trace");
+    if (args.getFlagValues("-profile_trace", 1, values) >= 0) {
+        setProfileTraceFile(values[0]);
+    }
+
     validFlags.push_back("-exec_mode");
     if (args.getFlagValues("-exec_mode", 1, values) >= 0) {
         setDesiredExecutionMode(values[0]);
@@ -480,6 +505,15 @@ RenderOptions::parseFromCommandLine(int argc, char* argv[])
         mPresenceShadowsQueueSize  = unsigned(presenceShadowsQueueSize  * 1024.f);
     }
 
+    //
+    // For developer profiling only, not documented or exposed to user.
+    // Reorders bundled rays by origin and direction before they are traced.
+    //
+    validFlags.push_back("-ray_coherence_sort");
+    if (args.getFlagValues("-ray_coherence_sort", 0, values) >= 0) {
+        mCoherenceSortRays = true;
+    }
+
     if ( ! args.allFlagsValid( validFlags ) ) {
         fprintf(stderr, "Invalid Input Flag Found!  Exiting %s...\n", argv[0]);
         exit(-1);
@@ -559,6 +593,24 @@ RenderOptions::getUsageMessage(const std::string& programName, bool guiMode)
 "    -fast_geometry_update\n"
 "        Turn on supporting fast geometry update for animation.\n"
 "\n"
+"    -texture_prefetch_threads 0\n"
+"        Number of threads loading the texture tiles of each shade bundle\n"
+"        ahead of its lookups. Also reports tile hits, misses and stall time\n"
+"        per texture. 0 (default) disables it.\n"
+"\n"
+"    -tessellation_cache_dir cache/dir\n"
+"        Cache tessellated subdivision meshes in this directory and reuse\n"
+"        them in later renders of the same meshes.\n"
+"\n"
+"    -tile_work_stealing\n"
+"        Balance tiles across render threads by work stealing and render the\n"
+"        noisiest tiles of each pass first. Overrides the tile order.\n"
+"\n"
+"    -profile_trace trace.json\n"
+"        Record a timeline of render prep, tiles, queue flushes and shade\n"
+"        handlers per thread and write it as a Chrome trace, viewable in\n"
+"        chrome://tracing or ui.perfetto.dev.\n"
+"\n"
 "    -record_rays .raydb/.mm\n"
 "        Save ray database or mm for later debugging.\n"
 "\n"
@@ -768,6 +820,7 @@ RenderOptions::setupTLSInitParams(mcrt_common::TLSInitParams *params, bool realt
         params->mShadeQueueSize            = mShadeQueueSize;
         params->mRadianceQueueSize         = mRadianceQueueSize;
     }
+    params->mCoherenceSortRays = mCoherenceSortRays;
 
     scene_rdl2::logging::Logger::info("Setting mPerThreadRayStatePoolSize to ", params->mPerThreadRayStatePoolSize);
     scene_rdl2::logging::Logger::info("Setting mRayQueueSize to ", params->mRayQueueSize);
@@ -776,6 +829,7 @@ RenderOptions::setupTLSInitParams(mcrt_common::TLSInitParams *params, bool realt
     scene_rdl2::logging::Logger::info("Setting mRadianceQueueSize to ", params->mRadianceQueueSize);
     scene_rdl2::logging::Logger::info("Setting mShadingWorkloadChunkSize to ", mShadingWorkloadChunkSize);
     scene_rdl2::logging::Logger::info("Setting mPresenceShadowsQueueSize to ", params->mPresenceShadowsQueueSize);
+    scene_rdl2::logging::Logger::info("Setting mCoherenceSortRays to ", params->mCoherenceSortRays);
 
     // always assign these three
     params->mDesiredNumTBBThreads = getThreads();
@@ -900,6 +954,10 @@ RenderOptions::show() const
          << scene_rdl2::str_util::addIndent(showVectorString("mDeltasFiles", mDeltasFiles)) << '\n'
          << "  mDsoPath:" << mDsoPath << '\n'
          << "  mTextureCacheSizeMb:" << mTextureCacheSizeMb << '\n'
+         << "  mTexturePrefetchThreads:" << mTexturePrefetchThreads << '\n'
+         << "  mTessellationCacheDir:" << mTessellationCacheDir << '\n'
+         << "  mTileWorkStealing:" << ((mTileWorkStealing) ? "true" : "false") << '\n'
+         << "  mProfileTraceFile:" << mProfileTraceFile << '\n'
          << scene_rdl2::str_util::addIndent(showAttributeOverrides(mAttributeOverrides)) << '\n'
          << scene_rdl2::str_util::addIndent(showRdlaGlobals(mRdlaGlobals)) << '\n'
          << "  mCommandLine:" << mCommandLine << '\n'
@@ -920,6 +978,7 @@ RenderOptions::show() const
          << "  mShadeQueueSize:" << mShadeQueueSize << '\n'
          << "  mRadianceQueueSize:" << mRadianceQueueSize << '\n'
          << "  mShadingWorkloadChunkSize:" << mShadingWorkloadChunkSize << '\n'
+         << "  mCoherenceSortRays:" << ((mCoherenceSortRays) ? "true" : "false") << '\n'
          << "  mFps:" << mFps << '\n'
          << "}";
     return ostr.str();
@@ -170,6 +170,26 @@ public:
     void setTextureCacheSizeMb(int sizeMb) { mTextureCacheSizeMb = sizeMb; }
     int getTextureCacheSizeMb() const { return mTextureCacheSizeMb; }
 
+    /// Number of threads prefetching the texture tiles of each shade bundle
+    /// ahead of its lookups, 0 disables the texture tile cache.
+    void setTexturePrefetchThreads(unsigned threads) { mTexturePrefetchThreads = threads; }
+    unsigned getTexturePrefetchThreads() const { return mTexturePrefetchThreads; }
+
+    /// Hand out tiles through per thread work stealing deques, ordered by their
+    /// adaptive priority, instead of the tile order scene variables (batch and
+    /// progressive modes on a single render node).
+    void setTileWorkStealing(bool workStealing) { mTileWorkStealing = workStealing; }
+    bool getTileWorkStealing() const { return mTileWorkStealing; }
+
+    /// Record a timeline of render prep stages, tiles and profiled sections of
+    /// the render threads and write it as a Chrome trace json file.
+    void setProfileTraceFile(const std::string& filename) { mProfileTraceFile = filename; }
+    const std::string& getProfileTraceFile() const { return mProfileTraceFile; }
+
+    /// Directory of the on-disk tessellation cache, empty to disable it.
+    void setTessellationCacheDir(const std::string& dir) { mTessellationCacheDir = dir; }
+    const std::string& getTessellationCacheDir() const { return mTessellationCacheDir; }
+
     /// Retrieves the attribute overrides for SceneObjects in the scene.
     std::vector<AttributeOverride> getAttributeOverrides() const;
 
@@ -264,6 +284,10 @@ private:
     std::vector<std::string> mDeltasFiles;
     std::string mDsoPath;
     int mTextureCacheSizeMb;
+    unsigned mTexturePrefetchThreads;
+    std::string mTessellationCacheDir;
+    bool mTileWorkStealing;
+    std::string mProfileTraceFile;
     std::vector<AttributeOverride> mAttributeOverrides;
     std::vector<RdlaGlobal> mRdlaGlobals;
     std::string mCommandLine;
@@ -287,6 +311,7 @@ private:
     unsigned mShadeQueueSize;
     unsigned mRadianceQueueSize;
     unsigned mShadingWorkloadChunkSize;
+    bool mCoherenceSortRays;
 
     float mFps;                 // only used for realtime rednerMode
 
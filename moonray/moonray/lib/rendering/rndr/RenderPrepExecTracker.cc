@@ -5,6 +5,7 @@
 //
 #include "RenderPrepExecTracker.h"
 
+#include <moonray/rendering/mcrt_common/ProfileAccumulator.h>
 #include <scene_rdl2/common/grid_util/Arg.h>
 #include <scene_rdl2/common/grid_util/Parser.h>
 #include <scene_rdl2/common/grid_util/RenderPrepStats.h>
@@ -127,6 +128,14 @@ private:
     Condition mRunFinalizeChange0;
     Condition mRunFinalizeChange1;
 
+    // timeline of the stages for trace recording
+    mcrt_common::TraceEventTimer mTraceRenderPrep;
+    mcrt_common::TraceEventTimer mTraceApplyUpdate;
+    mcrt_common::TraceEventTimer mTraceLoadGeom0;
+    mcrt_common::TraceEventTimer mTraceLoadGeom1;
+    mcrt_common::TraceEventTimer mTraceFinalizeChange0;
+    mcrt_common::TraceEventTimer mTraceFinalizeChange1;
+
     //------------------------------
 
     Parser mParser;
@@ -165,6 +174,7 @@ RenderPrepExecTracker::Impl::init()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::startRenderPrep()
 {
+    mTraceRenderPrep.start();
     return updateRunStatus(CancelCodePos::RENDER_PREP_START,
                            mRunRenderPrep,
                            Condition::START,
@@ -174,6 +184,7 @@ RenderPrepExecTracker::Impl::startRenderPrep()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::startApplyUpdate()
 {
+    mTraceApplyUpdate.start();
     return updateRunStatus(CancelCodePos::APPLY_UPDATE_START,
                            mRunApplyUpdate,
                            Condition::START,
@@ -183,6 +194,7 @@ RenderPrepExecTracker::Impl::startApplyUpdate()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::endApplyUpdate()
 {
+    mTraceApplyUpdate.stop("Apply update");
     return updateRunStatus(CancelCodePos::APPLY_UPDATE_END,
                            mRunApplyUpdate,
                            Condition::END,
@@ -192,6 +204,7 @@ RenderPrepExecTracker::Impl::endApplyUpdate()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::startLoadGeom0()
 {
+    mTraceLoadGeom0.start();
     return updateRunStatus(CancelCodePos::LOAD_GEOM0_START,
                            mRunLoadGeom0,
                            Condition::START,
@@ -201,6 +214,7 @@ RenderPrepExecTracker::Impl::startLoadGeom0()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::endLoadGeom0()
 {
+    mTraceLoadGeom0.stop("Load geometry");
     return updateRunStatus(CancelCodePos::LOAD_GEOM0_END,
                            mRunLoadGeom0,
                            Condition::END,
@@ -210,6 +224,7 @@ RenderPrepExecTracker::Impl::endLoadGeom0()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::startLoadGeom1()
 {
+    mTraceLoadGeom1.start();
     return updateRunStatus(CancelCodePos::LOAD_GEOM1_START,
                            mRunLoadGeom1,
                            Condition::START,
@@ -219,6 +234,7 @@ RenderPrepExecTracker::Impl::startLoadGeom1()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::endLoadGeom1()
 {
+    mTraceLoadGeom1.stop("Load mesh light geometry");
     return updateRunStatus(CancelCodePos::LOAD_GEOM1_END,
                            mRunLoadGeom1,
                            Condition::END,
@@ -228,6 +244,7 @@ RenderPrepExecTracker::Impl::endLoadGeom1()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::startFinalizeChange0()
 {
+    mTraceFinalizeChange0.start();
     return updateRunStatus(CancelCodePos::FINALIZE_CHANGE0_START,
                            mRunFinalizeChange0,
                            Condition::START,
@@ -237,6 +254,7 @@ RenderPrepExecTracker::Impl::startFinalizeChange0()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::endFinalizeChange0()
 {
+    mTraceFinalizeChange0.stop("Finalize change");
     return updateRunStatus(CancelCodePos::FINALIZE_CHANGE0_END,
                            mRunFinalizeChange0,
                            Condition::END,
@@ -246,6 +264,7 @@ RenderPrepExecTracker::Impl::endFinalizeChange0()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::startFinalizeChange1()
 {
+    mTraceFinalizeChange1.start();
     return updateRunStatus(CancelCodePos::FINALIZE_CHANGE1_START,
                            mRunFinalizeChange1,
                            Condition::START,
@@ -255,6 +274,7 @@ RenderPrepExecTracker::Impl::startFinalizeChange1()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::endFinalizeChange1()
 {
+    mTraceFinalizeChange1.stop("Finalize mesh light change");
     return updateRunStatus(CancelCodePos::FINALIZE_CHANGE1_END,
                            mRunFinalizeChange1,
                            Condition::END,
@@ -264,6 +284,7 @@ RenderPrepExecTracker::Impl::endFinalizeChange1()
 RenderPrepExecTracker::Impl::RESULT
 RenderPrepExecTracker::Impl::endRenderPrep()
 {
+    mTraceRenderPrep.stop("Render prep");
     return updateRunStatus(CancelCodePos::RENDER_PREP_END,
                            mRunRenderPrep,
                            Condition::END,
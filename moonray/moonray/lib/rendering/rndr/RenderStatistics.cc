@@ -125,6 +125,7 @@ getExecutablePath()
 RenderStats::RenderStats():
     mBuildProceduralTime(0.0),
     mRtcCommitTime(0.0),
+    mPassTailIdleTime(0.0),
     mHostName(""),
     mCurPath(""),
     mInvTicksPerSecond(-1.0),
@@ -174,6 +175,7 @@ RenderStats::reset()
 
     mBuildProceduralTime = 0.0;
     mRtcCommitTime = 0.0;
+    mPassTailIdleTime = 0.0;
 
     mShaderCallStats.clear();
 
@@ -1043,6 +1045,39 @@ RenderStats::logAllTessellationStats()
     writeCSVTable(mAthenaStream, table, true, tsFormat);
 }
 
+void
+RenderStats::logTopBVHBuildStats()
+{
+    const std::size_t maxEntry = 10;
+    const auto bvhTableInfo = buildBVHBuildStatistics(maxEntry);
+
+    if (getLogInfo()) {
+        auto bvhFormat = getHumanColumnFlags(mInfoStream, bvhTableInfo);
+        bvhFormat.set(0).left();
+        bvhFormat.set(1).left();
+        bvhFormat.set(3).precision(3);
+        bvhFormat.set(3).right();
+        writeInfoTable(mInfoStream, getPrependString(), bvhTableInfo, bvhFormat);
+    }
+    if (getLogCsv()) {
+        auto bvhFormat = getCSVFlags(mCSVStream, bvhTableInfo);
+        bvhFormat.set().setf(std::ios::fixed, std:: ios::floatfield);
+        bvhFormat.set().precision(5);
+        writeCSVTable(mCSVStream, bvhTableInfo, false /* not athena */, bvhFormat);
+    }
+}
+
+void
+RenderStats::logAllBVHBuildStats()
+{
+    const auto bvhTableInfo = buildBVHBuildStatistics(mPerGeometryBVHBuildTime.size());
+
+    auto bvhFormat = getCSVFlags(mAthenaStream, bvhTableInfo);
+    bvhFormat.set().setf(std::ios::fixed, std:: ios::floatfield);
+    bvhFormat.set().precision(5);
+    writeCSVTable(mAthenaStream, bvhTableInfo, true, bvhFormat);
+}
+
 void
 RenderStats::updateAndLogRenderPrepStats(std::ostream& outs, OutputFormat format)
 {
@@ -1154,6 +1189,9 @@ RenderStats::logSamplingStats(const pbr::Statistics& pbrStats, const geom::inter
     const size_t bundledOcclRays = pbrStats.getCounter(pbr::STATS_BUNDLED_OCCLUSION_RAYS);
     const size_t bundledGPUOcclRays = pbrStats.getCounter(pbr::STATS_BUNDLED_GPU_OCCLUSION_RAYS);
 
+    const size_t coherenceSortedRays = pbrStats.getCounter(pbr::STATS_COHERENCE_SORTED_RAYS);
+    const size_t coherenceSortedRayHits = pbrStats.getCounter(pbr::STATS_COHERENCE_SORTED_RAY_HITS);
+
     const size_t totalRays = isectRays + occlRays;
 
     const size_t shaderEvals = pbrStats.getCounter(pbr::STATS_SHADER_EVALS);
@@ -1185,6 +1223,13 @@ RenderStats::logSamplingStats(const pbr::Statistics& pbrStats, const geom::inter
         static_cast<double>(bundledGPUOcclRays) / static_cast<double>(bundledOcclRays) : 0.0;
     table.emplace_back("GPU bundled occlusion ray utilization", percentage(gpuOcclusionUtilization));
 
+    if (coherenceSortedRays > 0) {
+        table.emplace_back("Coherence sorted rays", coherenceSortedRays);
+        const double coherenceSortedHitRate =
+            static_cast<double>(coherenceSortedRayHits) / static_cast<double>(coherenceSortedRays);
+        table.emplace_back("Coherence sorted ray hit rate", percentage(coherenceSortedHitRate));
+    }
+
     table.emplace_back("Total rays", totalRays);
 
     table.emplace_back("Shader evals", shaderEvals);
@@ -1356,6 +1401,29 @@ RenderStats::buildTessellationStatistics(std::size_t maxEntry, std::size_t callD
     return table;
 }
 
+moonray_stats::StatsTable<4>
+RenderStats::buildBVHBuildStatistics(std::size_t maxEntry)
+{
+    using BVHStat = rt::BVHBuildStat;
+    auto first = mPerGeometryBVHBuildTime.begin();
+    auto last = mPerGeometryBVHBuildTime.end();
+    std::tie(first, last) = getRelevantStats(first, last,
+            [](const BVHStat& bs) { return bs.mBuildTime > 0; },
+            [](const BVHStat& s1, const BVHStat& s2)
+            {
+                return s1.mBuildTime > s2.mBuildTime;
+            },
+            maxEntry);
+
+    moonray_stats::StatsTable<4> table("BVH build time", "Rdl Geometry", "quality", "primitives", "time");
+
+    for (auto it = first; it != last; ++it) {
+        table.emplace_back(it->mName, it->mBuildQuality, it->mPrimitiveCount, moonray_stats::time(it->mBuildTime));
+    }
+
+    return table;
+}
+
 // This function WILL modify the ShaderStat vector.
 RenderStats::ShaderStatsTable RenderStats::buildShaderStatistics(std::vector<ShaderStat>::iterator first,
                                                                  std::vector<ShaderStat>::iterator last,
@@ -1557,6 +1625,12 @@ RenderStats::logRenderingStats(const pbr::Statistics& pbrStats,
     renderingStatsTable.emplace_back("Prep efficiency", percentage((mPrepSysTime + mPrepUserTime)/(mTotalRenderPrepTime * numThreads)));
     renderingStatsTable.emplace_back("Mcrt efficiency", percentage(pbrStats.mMcrtUtilization/(100 * numThreads)));
     renderingStatsTable.emplace_back("Total efficiency", percentage((sysTimeSecs + userTimeSecs) / (processTime * numThreads)));
+    // thread time lost waiting for the last tile groups at the end of each renderPasses() call,
+    // averaged per thread. Threads don't synchronize between the passes of a single call.
+    const double mcrtThreadTime = pbrStats.mMcrtTime * numThreads;
+    renderingStatsTable.emplace_back("Render passes tail idle time", moonray_stats::time(mPassTailIdleTime / numThreads));
+    renderingStatsTable.emplace_back("Render passes tail idle % of Mcrt time",
+                                     percentage(mcrtThreadTime > 0.0 ? mPassTailIdleTime / mcrtThreadTime : 0.0));
     if (film.isAdaptive()) {
         renderingStatsTable.emplace_back("Pixels at max adaptive samples", percentage(proportionOfPixelsAtAdaptiveMax));
     }
@@ -11,6 +11,7 @@
 #include <moonray/rendering/rndr/statistics/AthenaCSVStream.h>
 #include <moonray/common/mcrt_util/Average.h>
 #include <moonray/common/mcrt_util/ProcessStats.h>
+#include <moonray/rendering/rt/rt.h>
 #include <moonray/statistics/StatsTable.h>
 
 #include <scene_rdl2/common/rec_time/RecTime.h>
@@ -99,6 +100,9 @@ public:
     // Called when render prep start
     void startRenderPrep();
 
+    // Wall clock time of the last render prep, in seconds
+    double getTotalRenderPrepTime() const { return mTotalRenderPrepTime; }
+
     //  report the first line in the log
     void logInfoPrependStringHeader() const;
 
@@ -143,6 +147,11 @@ public:
     // report all tessellation times per geometry primitive
     void logAllTessellationStats();
 
+    // report top BVH build times per geometry
+    void logTopBVHBuildStats();
+    // report all BVH build times per geometry
+    void logAllBVHBuildStats();
+
     //  report out the total plus per stage times for
     //  render prep time
     void updateAndLogRenderPrepStats();
@@ -290,9 +299,15 @@ public:
     double mBuildProceduralTime;
     double mRtcCommitTime;
 
+    // render thread time spent idle at the end of each renderPasses() call (summed over threads)
+    double mPassTailIdleTime;
+
     // tessellation time stats
     std::vector<std::pair<geom::internal::NamedPrimitive*, double> > mPerPrimitiveTessellationTime;
 
+    // BVH build time stats
+    std::vector<rt::BVHBuildStat> mPerGeometryBVHBuildTime;
+
     // shader call stats
     std::unordered_map<scene_rdl2::rdl2::SceneObject *, moonray::util::InclusiveExclusiveAverage<int64> > mShaderCallStats;
 
@@ -316,6 +331,8 @@ private:
 
     moonray_stats::StatsTable<3> buildTessellationStatistics(std::size_t maxEntry, std::size_t callDivisor);
 
+    moonray_stats::StatsTable<4> buildBVHBuildStatistics(std::size_t maxEntry);
+
     // This function WILL modify the ShaderStat vector.
     ShaderStatsTable buildShaderStatistics(std::vector<ShaderStat>::iterator first,
                                            std::vector<ShaderStat>::iterator last,
@@ -148,6 +148,7 @@ TileScheduler::create(TileScheduler::Type type)
     case SPIRAL_SQUARE:    tileScheduler.reset(new SpiralSquareTileScheduler);    break;
     case SPIRAL_RECT:      tileScheduler.reset(new SpiralRectTileScheduler);      break;
     case MORTON_SHIFTFLIP: tileScheduler.reset(new MortonShiftFlipTileScheduler); break;
+    case WORK_STEALING:    tileScheduler.reset(new WorkStealingTileScheduler);    break;
     default:
         MNRY_ASSERT(0);
     }
@@ -307,6 +308,14 @@ MortonShiftFlipTileScheduler::generateTileIndices(scene_rdl2::alloc::Arena *aren
     mortonTileOrderGen(arena, numTilesX, numTilesY, tileIndices, mShiftX, mShiftY, mFlipX, mFlipY);
 }
 
+void
+WorkStealingTileScheduler::generateTileIndices(scene_rdl2::alloc::Arena *arena,
+                                               unsigned numTilesX, unsigned numTilesY,
+                                               uint32_t *tileIndices, uint32_t seed) const
+{
+    mortonTileOrderGen(arena, numTilesX, numTilesY, tileIndices, 0, 0, false, false);
+}
+
 void
 RandomTileScheduler::generateTileIndices(scene_rdl2::alloc::Arena *arena,
                                          unsigned numTilesX, unsigned numTilesY,
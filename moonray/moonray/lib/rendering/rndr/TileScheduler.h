@@ -34,6 +34,7 @@ public:
         SPIRAL_SQUARE,      // 6
         SPIRAL_RECT,        // 7
         MORTON_SHIFTFLIP,   // 8
+        WORK_STEALING,      // 9 : MORTON order, handed out by the work stealing TileWorkQueue
         NUM_TILE_SCHEDULER_TYPES,
     };
 
@@ -211,6 +212,20 @@ private:
     bool mFlipY {false};
 };
 
+// Tiles are generated in MORTON order. The order only seeds the work stealing
+// TileWorkQueue, which reorders tiles by their adaptive priority at the start
+// of each pass and balances them across render threads at run time.
+class WorkStealingTileScheduler : public TileScheduler
+{
+public:
+    WorkStealingTileScheduler() : TileScheduler(TileScheduler::WORK_STEALING) {}
+    virtual void generateTileIndices(scene_rdl2::alloc::Arena *arena,
+                                     unsigned numTilesX,
+                                     unsigned numTilesY,
+                                     uint32_t *tileIndices,
+                                     uint32_t seed) const override;
+};
+
 //-----------------------------------------------------------------------------
 
 } // namespace rndr
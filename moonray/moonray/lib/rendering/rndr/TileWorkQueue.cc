@@ -4,6 +4,7 @@
 //
 //
 #include "TileWorkQueue.h"
+#include "AdaptiveRenderTilesTable.h"
 #include "TileWorkQueueRuntimeVerify.h"
 
 #include <moonray/rendering/pbr/Types.h>
@@ -11,6 +12,9 @@
 #include <scene_rdl2/common/math/MathUtil.h>
 #include <scene_rdl2/render/util/StrUtil.h>
 
+#include <algorithm>
+#include <numeric>
+
 #ifdef RUNTIME_VERIFY_TILE_WORK_QUEUE // See RuntimeVerify.h
 #define RUNTIME_VERIFY
 #endif // end RUNTIME_VERIFY_TILE_WORK_QUEUE
@@ -24,6 +28,29 @@ constexpr unsigned roundUpDivision(unsigned dividend, unsigned divisor) noexcept
 {
     return (dividend + (divisor - 1u)) / divisor;
 }
+
+// Work stealing deque ranges are packed as pass(16bit) | front(24bit) | back(24bit)
+// so that the owner and the thieves claim slots with a single CAS.
+constexpr unsigned sSlotBits = 24;
+constexpr std::uint64_t sSlotMask = (std::uint64_t(1) << sSlotBits) - 1;
+constexpr unsigned sInvalidPassIdx = ~0u;
+
+// Groups are shrunk under work stealing until every thread owns at least this
+// many of them per pass, small groups at the end of a pass are what keeps the
+// tail balanced.
+constexpr unsigned sMinStealingGroupsPerThread = 4;
+
+constexpr std::uint64_t packRange(unsigned passIdx, unsigned front, unsigned back) noexcept
+{
+    return (std::uint64_t(passIdx) << (2 * sSlotBits)) | (std::uint64_t(front) << sSlotBits) | std::uint64_t(back);
+}
+
+void unpackRange(std::uint64_t range, unsigned &passIdx, unsigned &front, unsigned &back) noexcept
+{
+    passIdx = unsigned(range >> (2 * sSlotBits));
+    front = unsigned((range >> sSlotBits) & sSlotMask);
+    back = unsigned(range & sSlotMask);
+}
 }   // End of anon namespace.
 
 //-----------------------------------------------------------------------------
@@ -34,6 +61,9 @@ TileWorkQueue::TileWorkQueue()
 , mGroupClampIdx(0)
 , mOffset(OffsetData{0, 0})
 , mGlobalGroupIdx(0)
+, mStealingPassIdx(0)
+, mDealtPassIdx(sInvalidPassIdx)
+, mNumStolenGroups(0)
 , mRuntimeDebug(false)
 {
     // CPPCHECK -- Using memset() on struct which contains a floating point number.
@@ -143,6 +173,12 @@ TileWorkQueue::init(RenderMode mode,
         groupIdx = passInfo->mEndGroupIdx;
     }
 
+    if (mNumDeques != numRenderThreads) {
+        mNumDeques = numRenderThreads;
+        mDeques.reset(new StealingDeque[mNumDeques]);
+    }
+    mStealingPasses.resize(mNumPasses);
+
     reset();
 
     if (mRuntimeDebug) {
@@ -159,6 +195,13 @@ TileWorkQueue::reset()
 
     mGlobalGroupIdx.store(0);
     mOffset.store(OffsetData{0, 0});
+
+    for (unsigned i = 0; i < mNumDeques; ++i) {
+        mDeques[i].mRange.store(packRange(0, 0, 0));
+    }
+    mStealingPassIdx.store(0);
+    mDealtPassIdx.store(sInvalidPassIdx);
+    mNumStolenGroups.store(0);
 }
 
 // Executes the up until and including this pass and then stops.
@@ -168,6 +211,7 @@ TileWorkQueue::clampToPass(unsigned passIdx)
     MNRY_ASSERT(mNumPasses);
     passIdx = std::min(passIdx, mNumPasses - 1u);
     mGroupClampIdx = mPassInfos[passIdx].mEndGroupIdx;
+    mPassClampIdx = passIdx;
 }
 
 void
@@ -175,6 +219,14 @@ TileWorkQueue::unclampPasses()
 {
     MNRY_ASSERT(mNumPasses);
     mGroupClampIdx = mPassInfos[mNumPasses - 1].mEndGroupIdx;
+    mPassClampIdx = mNumPasses - 1;
+}
+
+void
+TileWorkQueue::setWorkStealing(bool workStealing, const AdaptiveRenderTilesTable *adaptiveTilesTable)
+{
+    mWorkStealing = workStealing;
+    mAdaptiveTilesTable = workStealing ? adaptiveTilesTable : nullptr;
 }
 
 TileGroup
@@ -218,6 +270,7 @@ TileWorkQueue::reserveNextTileGroup()
             group.mPassIdx      = currentOffset.mPass;
             group.mStartTileIdx = currentOffset.mTile;
             group.mEndTileIdx   = (nextOffset.mTile == 0) ? mNumTiles : (nextOffset.mTile);
+            group.mTileOrder    = nullptr;
 
             MNRY_ASSERT(group.mEndTileIdx > group.mStartTileIdx);
             MNRY_ASSERT(group.mStartTileIdx < mNumTiles);
@@ -232,14 +285,20 @@ TileWorkQueue::getNextTileGroup(unsigned threadIdx, TileGroup *group, unsigned l
 {
     MNRY_ASSERT(mNumPasses);
 
-    // mGroupClampIdx is set by the main thread.
-    auto groupIdx = mGlobalGroupIdx.load();
-    do {
-        if (groupIdx >= mGroupClampIdx) {
+    if (mWorkStealing) {
+        if (!getNextStealingTileGroup(threadIdx, group)) {
             return false;
         }
-    } while (!mGlobalGroupIdx.compare_exchange_weak(groupIdx, groupIdx + 1u));
-    *group = reserveNextTileGroup();
+    } else {
+        // mGroupClampIdx is set by the main thread.
+        auto groupIdx = mGlobalGroupIdx.load();
+        do {
+            if (groupIdx >= mGroupClampIdx) {
+                return false;
+            }
+        } while (!mGlobalGroupIdx.compare_exchange_weak(groupIdx, groupIdx + 1u));
+        *group = reserveNextTileGroup();
+    }
 
 #ifdef RUNTIME_VERIFY
     TileGroupRuntimeVerify::get()->push(*group);
@@ -259,6 +318,130 @@ TileWorkQueue::getNextTileGroup(unsigned threadIdx, TileGroup *group, unsigned l
     return true;
 }
 
+bool
+TileWorkQueue::getNextStealingTileGroup(unsigned threadIdx, TileGroup *group)
+{
+    MNRY_ASSERT(mNumDeques);
+    const unsigned ownDequeIdx = threadIdx % mNumDeques;
+
+    while (true) {
+        // mPassClampIdx is set by the main thread.
+        const unsigned passIdx = mStealingPassIdx.load(std::memory_order_acquire);
+        if (passIdx >= mNumPasses || passIdx > mPassClampIdx) {
+            return false;
+        }
+        if (mDealtPassIdx.load(std::memory_order_acquire) != passIdx) {
+            dealPass(passIdx);
+            continue;
+        }
+
+        unsigned dequeIdx = ownDequeIdx;
+        unsigned slot = 0;
+        bool found = popFront(dequeIdx, passIdx, slot);
+        for (unsigned i = 1; !found && i < mNumDeques; ++i) {
+            dequeIdx = (ownDequeIdx + i) % mNumDeques;
+            found = popBack(dequeIdx, passIdx, slot);
+            if (found) {
+                ++mNumStolenGroups;
+            }
+        }
+
+        if (found) {
+            const StealingPass &stealingPass = mStealingPasses[passIdx];
+            const unsigned groupIdx = slot * mNumDeques + dequeIdx;
+            MNRY_ASSERT(groupIdx < stealingPass.mNumGroups);
+
+            group->mPassIdx      = passIdx;
+            group->mStartTileIdx = groupIdx * stealingPass.mTilesPerGroup;
+            group->mEndTileIdx   = std::min(group->mStartTileIdx + stealingPass.mTilesPerGroup, mNumTiles);
+            group->mTileOrder    = stealingPass.mTileOrder.data();
+            return true;
+        }
+
+        // Every deque of this pass was empty at some point and deques are never
+        // refilled within a pass, so the whole pass has been handed out.
+        unsigned expected = passIdx;
+        mStealingPassIdx.compare_exchange_strong(expected, passIdx + 1u);
+    }
+}
+
+void
+TileWorkQueue::dealPass(unsigned passIdx)
+{
+    std::lock_guard<std::mutex> lock(mDealMutex);
+
+    // Another thread may have dealt this pass, or moved past it, while we waited.
+    if (mStealingPassIdx.load() != passIdx || mDealtPassIdx.load() == passIdx) {
+        return;
+    }
+
+    // Priorities are sampled now, at the start of the pass, so they reflect the
+    // adaptive state left behind by the previous passes.
+    StealingPass &stealingPass = mStealingPasses[passIdx];
+    std::vector<unsigned> &tileOrder = stealingPass.mTileOrder;
+    tileOrder.resize(mNumTiles);
+    std::iota(tileOrder.begin(), tileOrder.end(), 0u);
+    if (mAdaptiveTilesTable) {
+        std::vector<unsigned> priorities(mNumTiles);
+        for (unsigned i = 0; i < mNumTiles; ++i) {
+            priorities[i] = mAdaptiveTilesTable->getTilePriority(i);
+        }
+        // stable, equal priorities keep the spatially coherent tile scheduler order
+        std::stable_sort(tileOrder.begin(), tileOrder.end(), [&](unsigned a, unsigned b) {
+            return priorities[a] > priorities[b];
+        });
+    }
+
+    const unsigned maxTilesPerGroup = std::max(1u, mNumTiles / (mNumDeques * sMinStealingGroupsPerThread));
+    stealingPass.mTilesPerGroup = std::min(mPassInfos[passIdx].mTilesPerGroup, maxTilesPerGroup);
+    stealingPass.mNumGroups = roundUpDivision(mNumTiles, stealingPass.mTilesPerGroup);
+    MNRY_ASSERT(stealingPass.mNumGroups <= sSlotMask);
+
+    for (unsigned i = 0; i < mNumDeques; ++i) {
+        const unsigned numSlots = (stealingPass.mNumGroups > i) ?
+            roundUpDivision(stealingPass.mNumGroups - i, mNumDeques) : 0u;
+        mDeques[i].mRange.store(packRange(passIdx, 0, numSlots), std::memory_order_relaxed);
+    }
+
+    mDealtPassIdx.store(passIdx, std::memory_order_release);
+}
+
+bool
+TileWorkQueue::popFront(unsigned dequeIdx, unsigned passIdx, unsigned &slot)
+{
+    std::atomic<std::uint64_t> &range = mDeques[dequeIdx].mRange;
+    std::uint64_t current = range.load(std::memory_order_acquire);
+    while (true) {
+        unsigned rangePassIdx, front, back;
+        unpackRange(current, rangePassIdx, front, back);
+        if (rangePassIdx != passIdx || front >= back) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, packRange(passIdx, front + 1u, back))) {
+            slot = front;
+            return true;
+        }
+    }
+}
+
+bool
+TileWorkQueue::popBack(unsigned dequeIdx, unsigned passIdx, unsigned &slot)
+{
+    std::atomic<std::uint64_t> &range = mDeques[dequeIdx].mRange;
+    std::uint64_t current = range.load(std::memory_order_acquire);
+    while (true) {
+        unsigned rangePassIdx, front, back;
+        unpackRange(current, rangePassIdx, front, back);
+        if (rangePassIdx != passIdx || front >= back) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, packRange(passIdx, front, back - 1u))) {
+            slot = back - 1u;
+            return true;
+        }
+    }
+}
+
 unsigned
 TileWorkQueue::getTotalTileSamples() const
 {
@@ -295,7 +478,11 @@ TileWorkQueue::show() const
     std::ostringstream ostr;
     ostr << "TileWorkQueue {\n";
     ostr << "  mNumTiles:" << mNumTiles << '\n'
-         << "  mGroupClampIdx:" << mGroupClampIdx << '\n';
+         << "  mGroupClampIdx:" << mGroupClampIdx << '\n'
+         << "  mPassClampIdx:" << mPassClampIdx << '\n'
+         << "  mWorkStealing:" << scene_rdl2::str_util::boolStr(mWorkStealing) << '\n'
+         << "  mNumDeques:" << mNumDeques << '\n'
+         << "  mNumStolenGroups:" << mNumStolenGroups << '\n';
     ostr << "  mNumPasses:" << mNumPasses << " {\n";
     for (unsigned i = 0; i < mNumPasses; ++i) {
         ostr << "    i:" << i << '\n'
@@ -9,12 +9,18 @@
 #include <moonray/rendering/mcrt_common/Types.h> // for MAX_RENDER_PASSES
 #include <scene_rdl2/common/grid_util/Arg.h>
 #include <scene_rdl2/common/grid_util/Parser.h>
+#include <scene_rdl2/common/platform/Platform.h> // CACHE_LINE_SIZE
 
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace moonray {
 namespace rndr {
 
+class AdaptiveRenderTilesTable;
+
 // This is the granularity which work is handled. A single TileGroup represents
 // a single unit of work for a single thread.
 struct TileGroup
@@ -23,6 +29,12 @@ struct TileGroup
     unsigned    mStartTileIdx;
     unsigned    mEndTileIdx;        // One past the end.
     bool        mFirstFinePass;     // If this is the first tile group of the fine pass this will be set to true.
+
+    // Under work stealing mStartTileIdx~mEndTileIdx index into this per pass tile order,
+    // otherwise (nullptr) they are the tile indices themselves.
+    const unsigned *mTileOrder;
+
+    unsigned    getTileIdx(unsigned i) const { return mTileOrder ? mTileOrder[i] : i; }
 };
 
 //
@@ -59,6 +71,20 @@ public:
     // Keep rendering until there is no more work to do.
     void        unclampPasses();
 
+    //
+    // Work stealing mode : instead of handing out tile groups from a single shared
+    // sequence, each render thread owns a deque of tile groups for the current pass.
+    // A thread pops from the front of its own deque and steals from the back of the
+    // other threads' deques once its own is empty, so the tail of a pass does not
+    // leave threads idle. When a pass starts its tiles are sorted by their adaptive
+    // priority (see AdaptiveRenderTilesTable::getTilePriority(), nullptr keeps the
+    // tile scheduler order) and the noisiest tiles are dealt to the fronts of the deques.
+    // Must not be called while rendering.
+    //
+    void        setWorkStealing(bool workStealing, const AdaptiveRenderTilesTable *adaptiveTilesTable);
+    bool        isWorkStealing() const { return mWorkStealing; }
+    unsigned    getNumStolenGroups() const { return mNumStolenGroups; }
+
     //
     // For each thread to query the next chunk of work. Thread-safe.
     //
@@ -79,6 +105,11 @@ public:
 private:
     TileGroup reserveNextTileGroup();
 
+    bool getNextStealingTileGroup(unsigned threadIdx, TileGroup *group);
+    void dealPass(unsigned passIdx);
+    bool popFront(unsigned dequeIdx, unsigned passIdx, unsigned &slot);
+    bool popBack(unsigned dequeIdx, unsigned passIdx, unsigned &slot);
+
     void parserConfigure();
 
     static constexpr std::size_t OffsetDataAlignment = alignof(std::atomic<std::uint64_t>);
@@ -113,6 +144,31 @@ private:
     std::atomic<OffsetData>        mOffset{OffsetData{0, 0}};
     std::atomic<std::uint32_t>     mGlobalGroupIdx{0};
 
+    // Work stealing. Slot j of deque t holds tile group (j * mNumDeques + t) of the
+    // current pass, so every deque gets an even share of the high priority groups.
+    struct alignas(CACHE_LINE_SIZE) StealingDeque
+    {
+        std::atomic<std::uint64_t> mRange;  // pass, front and back slots packed together
+    };
+
+    struct StealingPass
+    {
+        std::vector<unsigned> mTileOrder;   // tile indices by descending priority
+        unsigned    mTilesPerGroup;
+        unsigned    mNumGroups;
+    };
+
+    bool                           mWorkStealing{false};
+    const AdaptiveRenderTilesTable *mAdaptiveTilesTable{nullptr};
+    unsigned                       mPassClampIdx{0};
+    unsigned                       mNumDeques{0};
+    std::unique_ptr<StealingDeque[]> mDeques;
+    std::vector<StealingPass>      mStealingPasses;
+    std::atomic<unsigned>          mStealingPassIdx{0};   // pass currently handed out
+    std::atomic<unsigned>          mDealtPassIdx{0};      // pass the deques were last dealt for
+    std::atomic<unsigned>          mNumStolenGroups{0};
+    std::mutex                     mDealMutex;
+
     Parser mParser;
     bool mRuntimeDebug;
 };
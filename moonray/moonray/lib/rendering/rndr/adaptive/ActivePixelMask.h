@@ -86,6 +86,12 @@ public:
         return !empty();
     }
 
+    // Number of active pixels
+    size_type count() const noexcept
+    {
+        return static_cast<size_type>(__builtin_popcountll(mActiveMask));
+    }
+
     // Fill in any gaps in the axis-aligned bounding-box of the selection set.
     // +----------+
     // |..........|
@@ -0,0 +1,75 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <moonray/rendering/rt/rt.h>
+
+#include <embree4/rtcore.h>
+
+#include <cstddef>
+
+namespace moonray {
+namespace rt {
+
+/**
+ * BVHBuildPlanner picks the embree build quality of each bottom level BVH
+ * (the shared scene of an instanced primitive) instead of applying a single
+ * quality to the whole scene.
+ *
+ * A HIGH quality (spatial split) build costs several times more than a
+ * MEDIUM one and only pays off when enough rays end up traversing the
+ * result. The expected ray load of a shared scene is approximated by the
+ * number of instances referencing it: heavily instanced scenes always get
+ * the best BVH, while very large scenes referenced only a few times are
+ * built with MEDIUM quality to keep render prep time in check.
+ */
+class BVHBuildPlanner
+{
+public:
+    // Shared scenes with more primitives than this are considered expensive
+    // to build with spatial splits.
+    static constexpr size_t sLargePrimitiveCount = 1 << 20;
+    // Number of referencing instances from which a shared scene is expected
+    // to be traversed by enough rays to justify a HIGH quality build.
+    static constexpr size_t sHighRayLoadReferenceCount = 4;
+
+    explicit BVHBuildPlanner(OptimizationTarget accelMode):
+        mAccelMode(accelMode) {}
+
+    RTCBuildQuality planSceneBuildQuality(size_t primitiveCount,
+            size_t referenceCount, bool isStatic) const
+    {
+        // dynamic geometry gets refit every frame, a fast build is all
+        // that matters
+        if (!isStatic) {
+            return RTC_BUILD_QUALITY_LOW;
+        }
+        if (referenceCount >= sHighRayLoadReferenceCount) {
+            return RTC_BUILD_QUALITY_HIGH;
+        }
+        if (mAccelMode == OptimizationTarget::FAST_BVH_BUILD ||
+            primitiveCount > sLargePrimitiveCount) {
+            return RTC_BUILD_QUALITY_MEDIUM;
+        }
+        return RTC_BUILD_QUALITY_HIGH;
+    }
+
+    static const char* getBuildQualityName(RTCBuildQuality quality)
+    {
+        switch (quality) {
+        case RTC_BUILD_QUALITY_LOW: return "low";
+        case RTC_BUILD_QUALITY_MEDIUM: return "medium";
+        case RTC_BUILD_QUALITY_HIGH: return "high";
+        case RTC_BUILD_QUALITY_REFIT: return "refit";
+        default: return "unknown";
+        }
+    }
+
+private:
+    OptimizationTarget mAccelMode;
+};
+
+} // namespace rt
+} // namespace moonray
+
@@ -6,6 +6,7 @@
 #include "EmbreeAccelerator.h"
 
 #include "AcceleratorUtils.h"
+#include "BVHBuildPlanner.h"
 #include "IntersectionFilters.h"
 
 #include <moonray/rendering/geom/PolygonMesh.h>
@@ -30,6 +31,11 @@
 #include <embree4/rtcore.h>
 
 #include <tbb/concurrent_unordered_map.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 namespace scene_rdl2 {
 using namespace math;
@@ -43,6 +49,117 @@ namespace rt {
 typedef tbb::concurrent_unordered_map<std::shared_ptr<geom::SharedPrimitive>,
         tbb::atomic<bool>, geom::SharedPtrHash> SharedSceneMap;
 
+// Shared scenes are not committed while the geometry is being traversed.
+// They are collected here and committed once the traversal is done, so that
+// the build planner knows how many instances reference each of them and
+// independent shared scenes can be committed concurrently.
+class SharedSceneCommitList
+{
+public:
+    void add(const geom::SharedPrimitive* ref, RTCScene scene,
+            const scene_rdl2::rdl2::Geometry* geometry,
+            size_t primitiveCount, unsigned height)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIndices[ref] = mCommits.size();
+        mCommits.push_back({scene, geometry, primitiveCount, 0, height});
+    }
+
+    void addReference(const geom::SharedPrimitive* ref)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mIndices.find(ref);
+        if (it != mIndices.end()) {
+            ++mCommits[it->second].mReferenceCount;
+        }
+    }
+
+    unsigned getHeight(const geom::SharedPrimitive* ref) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mIndices.find(ref);
+        return it != mIndices.end() ? mCommits[it->second].mHeight : 0;
+    }
+
+    // Commit all shared scenes, one nesting level at a time: a scene can only
+    // be committed after all the scenes it instances, while scenes of the same
+    // level are independent and get committed in parallel.
+    void commit(const BVHBuildPlanner& planner, std::vector<BVHBuildStat>& stats)
+    {
+        unsigned maxHeight = 0;
+        for (const auto& c : mCommits) {
+            maxHeight = std::max(maxHeight, c.mHeight);
+        }
+        size_t statsOffset = stats.size();
+        stats.resize(statsOffset + mCommits.size());
+        std::vector<size_t> level;
+        for (unsigned height = 0; height <= maxHeight && !mCommits.empty(); ++height) {
+            level.clear();
+            for (size_t i = 0; i < mCommits.size(); ++i) {
+                if (mCommits[i].mHeight == height) {
+                    level.push_back(i);
+                }
+            }
+            tbb::parallel_for(size_t(0), level.size(), [&](size_t l) {
+                const size_t i = level[l];
+                const Commit& c = mCommits[i];
+                RTCBuildQuality quality = planner.planSceneBuildQuality(
+                    c.mPrimitiveCount, c.mReferenceCount, c.mGeometry->isStatic());
+                rtcSetSceneBuildQuality(c.mScene, quality);
+                scene_rdl2::rec_time::RecTime recTime;
+                recTime.start();
+                rtcCommitScene(c.mScene);
+                stats[statsOffset + i] = {c.mGeometry->getName(),
+                    BVHBuildPlanner::getBuildQualityName(quality),
+                    c.mPrimitiveCount, c.mReferenceCount, recTime.end()};
+            });
+        }
+        mCommits.clear();
+        mIndices.clear();
+    }
+
+private:
+    struct Commit
+    {
+        RTCScene mScene;
+        const scene_rdl2::rdl2::Geometry* mGeometry;
+        size_t mPrimitiveCount;
+        size_t mReferenceCount;
+        // length of the longest chain of nested instances below this scene
+        unsigned mHeight;
+    };
+
+    mutable std::mutex mMutex;
+    std::vector<Commit> mCommits;
+    std::unordered_map<const geom::SharedPrimitive*, size_t> mIndices;
+};
+
+// Define the packet types which depend on the vector width
+#if (VLEN == 16u)
+    const auto& rtcIntersectv = rtcIntersect16;
+    const auto& rtcOccludedv = rtcOccluded16;
+    typedef RTCRayHit16 RTCRayHitv;
+    typedef RTCRay16 RTCRayv;
+    static constexpr RTCDeviceProperty sNativePacketProperty =
+        RTC_DEVICE_PROPERTY_NATIVE_RAY16_SUPPORTED;
+#elif (VLEN == 8u)
+    const auto& rtcIntersectv = rtcIntersect8;
+    const auto& rtcOccludedv = rtcOccluded8;
+    typedef RTCRayHit8 RTCRayHitv;
+    typedef RTCRay8 RTCRayv;
+    static constexpr RTCDeviceProperty sNativePacketProperty =
+        RTC_DEVICE_PROPERTY_NATIVE_RAY8_SUPPORTED;
+#else
+    const auto& rtcIntersectv = rtcIntersect4;
+    const auto& rtcOccludedv = rtcOccluded4;
+    typedef RTCRayHit4 RTCRayHitv;
+    typedef RTCRay4 RTCRayv;
+    static constexpr RTCDeviceProperty sNativePacketProperty =
+        RTC_DEVICE_PROPERTY_NATIVE_RAY4_SUPPORTED;
+#endif
+
+static constexpr unsigned sPacketSize = sizeof(RTCRayv::tfar) / sizeof(float);
+
 
 class BVHBuilder : public geom::PrimitiveVisitor
 {
@@ -51,14 +168,17 @@ public:
 
     BVHBuilder(const scene_rdl2::rdl2::Layer* layer, const scene_rdl2::rdl2::Geometry* geometry,
             RTCDevice& device, RTCScene& parentScene,
-            SharedSceneMap& sharedSceneMap, BVHUserDataList& userData,
-            bool getAssignments):
+            SharedSceneMap& sharedSceneMap, SharedSceneCommitList& commitList,
+            BVHUserDataList& userData, bool getAssignments):
         mLayer(layer), mGeometry(geometry),
         mDevice(device), mParentScene(parentScene),
-        mSharedSceneMap(sharedSceneMap), mBVHUserData(userData),
+        mSharedSceneMap(sharedSceneMap), mCommitList(commitList),
+        mBVHUserData(userData),
         mGetAssignments(getAssignments),
         mHasVolumeAssignment(false),
-        mHasSurfaceAssignment(false) {}
+        mHasSurfaceAssignment(false),
+        mPrimitiveCount(0),
+        mInstanceHeight(0) {}
 
     virtual void visitCurves(geom::Curves& c) override {
         geom::internal::Primitive* pImpl =
@@ -183,14 +303,15 @@ public:
         // visit the referenced Primitive if it's not visited yet
         if (mSharedSceneMap.insert(std::make_pair(ref, false)).second) {
             RTCScene sharedScene = rtcNewScene(mDevice);
-            rtcSetSceneBuildQuality(sharedScene, mGeometry->isStatic() ?
-                RTC_BUILD_QUALITY_HIGH : RTC_BUILD_QUALITY_LOW);
             geom::internal::PrimitivePrivateAccess::setBVHScene(*ref,
                 static_cast<void*>(sharedScene));
             BVHBuilder builder(mLayer, mGeometry, mDevice, sharedScene,
-                mSharedSceneMap, mBVHUserData, mGetAssignments);
+                mSharedSceneMap, mCommitList, mBVHUserData, mGetAssignments);
             ref->getPrimitive()->accept(builder);
-            rtcCommitScene(sharedScene);
+            // build quality is planned and the scene committed once all
+            // the instances referencing it are known
+            mCommitList.add(ref.get(), sharedScene, mGeometry,
+                builder.getPrimitiveCount(), builder.getInstanceHeight());
             // store if the reference contains volumes or surfaces
             if (mGetAssignments) {
                 ref->setHasSurfaceAssignment(builder.getHasSurfaceAssignment());
@@ -206,6 +327,9 @@ public:
         while (it == mSharedSceneMap.end() || !it->second) {
             it = mSharedSceneMap.find(ref);
         }
+        mCommitList.addReference(ref.get());
+        mInstanceHeight = std::max(mInstanceHeight,
+            mCommitList.getHeight(ref.get()) + 1);
         auto pImpl = geom::internal::PrimitivePrivateAccess::getPrimitiveImpl(&i);
         MNRY_ASSERT_REQUIRE(pImpl != nullptr);
         MNRY_ASSERT_REQUIRE(pImpl->getType() == geom::internal::Primitive::INSTANCE);
@@ -250,6 +374,16 @@ public:
         return mHasVolumeAssignment;
     }
 
+    size_t getPrimitiveCount() const
+    {
+        return mPrimitiveCount;
+    }
+
+    unsigned getInstanceHeight() const
+    {
+        return mInstanceHeight;
+    }
+
 private:
 
     std::unique_ptr<geom::internal::BVHHandle> createPolyMeshInBVH(
@@ -287,6 +421,7 @@ private:
                                    mesh.mIndexBufferDesc.mOffset,
                                    mesh.mIndexBufferDesc.mStride,
                                    mesh.mFaceCount);
+        mPrimitiveCount += mesh.mFaceCount;
         // Set up the polygon mesh vertex buffers, one for each motion step
         for (size_t i = 0; i < mbSteps; i++) {
             rtcSetSharedGeometryBuffer(rtcGeom, RTC_BUFFER_TYPE_VERTEX, i,
@@ -336,6 +471,7 @@ private:
         rtcSetGeometryBuildQuality(rtcGeom, flag);
         rtcSetGeometryUserPrimitiveCount(rtcGeom,
             quadric.getSubPrimitiveCount());
+        mPrimitiveCount += quadric.getSubPrimitiveCount();
 
         // Set up bounds/intersection/occlusion kernel functions
         rtcSetGeometryBoundsFunction(rtcGeom,
@@ -415,6 +551,7 @@ private:
             spans.mIndexBufferDesc.mOffset,
             spans.mIndexBufferDesc.mStride,
             spans.mSpanCount);
+        mPrimitiveCount += spans.mSpanCount;
 
         // Set up the control vertex data buffers, one for each motion step
         for (size_t i = 0; i < mbSteps; i++) {
@@ -468,6 +605,7 @@ private:
 
         RTCGeometry rtcGeom = rtcNewGeometry(mDevice, RTC_GEOMETRY_TYPE_USER);
         rtcSetGeometryUserPrimitiveCount(rtcGeom, 1);
+        mPrimitiveCount += 1;
         rtcSetGeometryBuildQuality(rtcGeom, flag);
         // instancing kernel handle motion blur through matrix decomposition
         // so we don't need to feed in multiple buffers for motion blur case
@@ -536,6 +674,7 @@ private:
             indexBufferDesc.mOffset,
             indexBufferDesc.mStride,
             faceCount);
+        mPrimitiveCount += faceCount;
         // Set up the quad mesh vertex buffer, one for each motion step
         for (size_t i = 0; i < mbSteps; i++) {
             rtcSetSharedGeometryBuffer(
@@ -608,6 +747,7 @@ private:
     RTCScene mParentScene;
 
     SharedSceneMap& mSharedSceneMap;
+    SharedSceneCommitList& mCommitList;
     // Reference to container owned by EmbreeAccelerator
     // This container allow for safe allocation and
     // deletion of additional data needed for intersection filters
@@ -619,6 +759,11 @@ private:
     bool mGetAssignments;
     bool mHasVolumeAssignment;
     bool mHasSurfaceAssignment;
+
+    // Primitives added to mParentScene and the longest chain of nested
+    // instances below it, used to plan and order the shared scene commits
+    size_t mPrimitiveCount;
+    unsigned mInstanceHeight;
 };
 
 static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool post)
@@ -630,7 +775,9 @@ static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool post)
 EmbreeAccelerator::EmbreeAccelerator(const AcceleratorOptions& options):
     mBvhBuildProceduralTime(0.0),
     mRtcCommitTime(0.0),
-    mRootScene(nullptr), mDevice(nullptr), mBVHMemory(0)
+    mRootScene(nullptr), mRootBuildQuality(RTC_BUILD_QUALITY_MEDIUM),
+    mDevice(nullptr), mBVHMemory(0),
+    mNativePacketSupport(false)
 {
     std::string cfg = "threads=" + std::to_string(options.maxThreads);
     if (options.verbose) {
@@ -640,6 +787,9 @@ EmbreeAccelerator::EmbreeAccelerator(const AcceleratorOptions& options):
     mDevice = rtcNewDevice(cfg.c_str());
     // monitor memory usage
     rtcSetDeviceMemoryMonitorFunction(mDevice, memoryMonitor, this);
+    // embree emulates packets on builds without native support for our
+    // vector width, in which case single ray traversal is just as fast
+    mNativePacketSupport = rtcGetDeviceProperty(mDevice, sNativePacketProperty) != 0;
 
     mRootScene = rtcNewScene(mDevice);
 }
@@ -657,9 +807,9 @@ EmbreeAccelerator::~EmbreeAccelerator()
 void
 buildBVHBottomUp(const scene_rdl2::rdl2::Layer* layer, scene_rdl2::rdl2::Geometry* geometry,
         RTCDevice& rtcDevice, RTCScene& rootScene,
-        SharedSceneMap& visitedBVHScene,
+        SharedSceneMap& visitedBVHScene, SharedSceneCommitList& commitList,
         std::unordered_set<scene_rdl2::rdl2::Geometry*>& visitedGeometry,
-        BVHUserDataList& bvhUserData)
+        BVHUserDataList& bvhUserData, size_t& rootPrimitiveCount)
 {
     geom::Procedural* procedural = geometry->getProcedural();
     // All parts in a procedural are unassigned in the layer
@@ -679,7 +829,8 @@ buildBVHBottomUp(const scene_rdl2::rdl2::Layer* layer, scene_rdl2::rdl2::Geometr
         }
         scene_rdl2::rdl2::Geometry* referencedGeometry = ref->asA<scene_rdl2::rdl2::Geometry>();
         buildBVHBottomUp(layer, referencedGeometry, rtcDevice, rootScene,
-            visitedBVHScene, visitedGeometry, bvhUserData);
+            visitedBVHScene, commitList, visitedGeometry, bvhUserData,
+            rootPrimitiveCount);
     }
     // We disable the parallel here to solve the non-deterministic
     // issue for some hair/fur related scenes.
@@ -691,14 +842,14 @@ buildBVHBottomUp(const scene_rdl2::rdl2::Layer* layer, scene_rdl2::rdl2::Geometr
             procedural->getReference();
         if (visitedBVHScene.insert(std::make_pair(ref, false)).second) {
             RTCScene sharedScene = rtcNewScene(rtcDevice);
-            rtcSetSceneBuildQuality(sharedScene, geometry->isStatic()?
-                RTC_BUILD_QUALITY_HIGH : RTC_BUILD_QUALITY_LOW);
             geom::internal::PrimitivePrivateAccess::setBVHScene(*ref,
                 static_cast<void*>(sharedScene));
             BVHBuilder builder(layer, geometry, rtcDevice, sharedScene,
-                visitedBVHScene, bvhUserData, /* get assignments = */ true);
+                visitedBVHScene, commitList, bvhUserData,
+                /* get assignments = */ true);
             ref->getPrimitive()->accept(builder);
-            rtcCommitScene(sharedScene);
+            commitList.add(ref.get(), sharedScene, geometry,
+                builder.getPrimitiveCount(), builder.getInstanceHeight());
             // mark the BVH representation of referenced primitive (group)
             // has been correctly constructed so that all the instances
             // reference it can start accessing it
@@ -706,8 +857,10 @@ buildBVHBottomUp(const scene_rdl2::rdl2::Layer* layer, scene_rdl2::rdl2::Geometr
         }
     } else {
         BVHBuilder bvhBuilder(layer, geometry, rtcDevice, rootScene,
-            visitedBVHScene, bvhUserData, /* get assignments = */ false);
+            visitedBVHScene, commitList, bvhUserData,
+            /* get assignments = */ false);
         procedural->forEachPrimitive(bvhBuilder, doParallel);
+        rootPrimitiveCount += bvhBuilder.getPrimitiveCount();
     }
     visitedGeometry.insert(geometry);
 }
@@ -720,18 +873,21 @@ EmbreeAccelerator::build(OptimizationTarget accelMode, ChangeFlag changeFlag,
 {
     if (changeFlag == ChangeFlag::ALL) {
         if (accelMode == OptimizationTarget::HIGH_QUALITY_BVH_BUILD) {
-            rtcSetSceneBuildQuality(mRootScene, RTC_BUILD_QUALITY_HIGH);
+            mRootBuildQuality = RTC_BUILD_QUALITY_HIGH;
             rtcSetSceneFlags(mRootScene, RTC_SCENE_FLAG_NONE);
         } else {
-            rtcSetSceneBuildQuality(mRootScene, RTC_BUILD_QUALITY_LOW);
+            mRootBuildQuality = RTC_BUILD_QUALITY_LOW;
             rtcSetSceneFlags(mRootScene, RTC_SCENE_FLAG_DYNAMIC);
         }
+        rtcSetSceneBuildQuality(mRootScene, mRootBuildQuality);
     }
     scene_rdl2::rec_time::RecTime recTime;
 
     recTime.start();
     SharedSceneMap visitedBVHScene;
+    SharedSceneCommitList commitList;
     std::unordered_set<scene_rdl2::rdl2::Geometry*> visitedGeometry;
+    size_t rootPrimitiveCount = 0;
     for (const auto& geometrySet : geometrySets) {
         const scene_rdl2::rdl2::SceneObjectIndexable& geometries = geometrySet->getGeometries();
         for (auto& sceneObject : geometries) {
@@ -740,14 +896,23 @@ EmbreeAccelerator::build(OptimizationTarget accelMode, ChangeFlag changeFlag,
                 continue;
             }
             buildBVHBottomUp(layer, geometry, mDevice, mRootScene,
-                visitedBVHScene, visitedGeometry, mBVHUserData);
+                visitedBVHScene, commitList, visitedGeometry, mBVHUserData,
+                rootPrimitiveCount);
         }
     }
     mBvhBuildProceduralTime = recTime.end();
 
-    // now build the root scene
+    // commit the shared scenes, then build the root scene on top of them
     recTime.start();
+    mBVHBuildStats.clear();
+    commitList.commit(BVHBuildPlanner(accelMode), mBVHBuildStats);
+
+    scene_rdl2::rec_time::RecTime rootRecTime;
+    rootRecTime.start();
     rtcCommitScene(mRootScene);
+    mBVHBuildStats.push_back({"(root scene)",
+        BVHBuildPlanner::getBuildQualityName(mRootBuildQuality),
+        rootPrimitiveCount, 1, rootRecTime.end()});
     mRtcCommitTime = recTime.end();
 }
 
@@ -820,6 +985,180 @@ EmbreeAccelerator::occluded(mcrt_common::Ray& ray) const
     return ray.tfar < 0.0f;
 }
 
+// Rays which carry a geometry TLState (volume interval collection, subsurface
+// projection) depend on intersection filters that only handle single rays.
+finline bool
+isPacketCompatible(const mcrt_common::Ray& ray)
+{
+    return ray.ext.geomTls == nullptr && ray.ext.materialID < 0;
+}
+
+finline void
+loadPacketLane(RTCRayv& rays, unsigned lane, const mcrt_common::Ray& ray)
+{
+    MNRY_ASSERT(isValidRay(ray));
+    rays.org_x[lane] = ray.org.x;
+    rays.org_y[lane] = ray.org.y;
+    rays.org_z[lane] = ray.org.z;
+    rays.tnear[lane] = ray.tnear;
+    rays.dir_x[lane] = ray.dir.x;
+    rays.dir_y[lane] = ray.dir.y;
+    rays.dir_z[lane] = ray.dir.z;
+    rays.time[lane] = ray.time;
+    rays.tfar[lane] = ray.tfar;
+    rays.mask[lane] = ray.mask;
+    // the ray id indexes into IntersectContext::mRayExtension
+    rays.id[lane] = lane;
+    rays.flags[lane] = 0;
+}
+
+static void
+intersectPacket(RTCScene scene, unsigned numLanes, mcrt_common::Ray** lanes)
+{
+    MNRY_ASSERT(numLanes <= sPacketSize);
+
+    alignas(sizeof(RTCRayv::tfar)) int valid[sPacketSize];
+    RTCRayHitv rayHit;
+    mcrt_common::RayExtension rayExtensions[sPacketSize];
+    for (unsigned lane = 0; lane < sPacketSize; ++lane) {
+        if (lane >= numLanes) {
+            valid[lane] = 0;
+            continue;
+        }
+        const mcrt_common::Ray& ray = *lanes[lane];
+        valid[lane] = -1;
+        loadPacketLane(rayHit.ray, lane, ray);
+        rayHit.hit.geomID[lane] = ray.geomID;
+        rayHit.hit.instID[0][lane] = ray.instID;
+        rayExtensions[lane] = ray.ext;
+    }
+
+    // See intersect() for why the context carries the ray extensions. Each
+    // lane finds its extension through its ray id.
+    mcrt_common::IntersectContext context;
+    context.mRayExtension = rayExtensions;
+
+    RTCIntersectArguments args;
+    rtcInitIntersectArguments(&args);
+    args.context = &context.mRtcContext;
+
+    rtcIntersectv(valid, scene, &rayHit, &args);
+
+    for (unsigned lane = 0; lane < numLanes; ++lane) {
+        mcrt_common::Ray& ray = *lanes[lane];
+        ray.id = 0;
+        ray.tfar = rayHit.ray.tfar[lane];
+        ray.Ng = scene_rdl2::math::Vec3f(rayHit.hit.Ng_x[lane],
+                                         rayHit.hit.Ng_y[lane],
+                                         rayHit.hit.Ng_z[lane]);
+        ray.u = rayHit.hit.u[lane];
+        ray.v = rayHit.hit.v[lane];
+        ray.primID = rayHit.hit.primID[lane];
+        ray.geomID = rayHit.hit.geomID[lane];
+        ray.instID = rayHit.hit.instID[0][lane];
+        ray.ext = rayExtensions[lane];
+
+        if (ray.geomID != RTC_INVALID_GEOMETRY_ID &&
+            ray.instID == RTC_INVALID_GEOMETRY_ID) {
+            ray.ext.userData = rtcGetGeometryUserData(
+                rtcGetGeometry(scene, ray.geomID));
+        }
+    }
+}
+
+static void
+occludedPacket(RTCScene scene, unsigned numLanes, mcrt_common::Ray** lanes,
+        bool** isOccluded)
+{
+    MNRY_ASSERT(numLanes <= sPacketSize);
+
+    alignas(sizeof(RTCRayv::tfar)) int valid[sPacketSize];
+    RTCRayv rays;
+    mcrt_common::RayExtension rayExtensions[sPacketSize];
+    for (unsigned lane = 0; lane < sPacketSize; ++lane) {
+        if (lane >= numLanes) {
+            valid[lane] = 0;
+            continue;
+        }
+        valid[lane] = -1;
+        loadPacketLane(rays, lane, *lanes[lane]);
+        rayExtensions[lane] = lanes[lane]->ext;
+    }
+
+    mcrt_common::IntersectContext context;
+    context.mRayExtension = rayExtensions;
+
+    RTCOccludedArguments args;
+    rtcInitOccludedArguments(&args);
+    args.context = &context.mRtcContext;
+
+    rtcOccludedv(valid, scene, &rays, &args);
+
+    for (unsigned lane = 0; lane < numLanes; ++lane) {
+        mcrt_common::Ray& ray = *lanes[lane];
+        ray.id = 0;
+        ray.tfar = rays.tfar[lane];
+        ray.ext = rayExtensions[lane];
+        *isOccluded[lane] = ray.tfar < 0.0f;
+    }
+}
+
+void
+EmbreeAccelerator::intersectN(unsigned numRays, mcrt_common::Ray** rays) const
+{
+    mcrt_common::Ray* lanes[sPacketSize];
+    unsigned numLanes = 0;
+
+    for (unsigned i = 0; i < numRays; ++i) {
+        mcrt_common::Ray& ray = *rays[i];
+        if (!mNativePacketSupport || !isPacketCompatible(ray)) {
+            intersect(ray);
+            continue;
+        }
+        lanes[numLanes++] = &ray;
+        if (numLanes == sPacketSize) {
+            intersectPacket(mRootScene, numLanes, lanes);
+            numLanes = 0;
+        }
+    }
+
+    // a packet with a single active lane is slower than rtcIntersect1
+    if (numLanes == 1) {
+        intersect(*lanes[0]);
+    } else if (numLanes > 1) {
+        intersectPacket(mRootScene, numLanes, lanes);
+    }
+}
+
+void
+EmbreeAccelerator::occludedN(unsigned numRays, mcrt_common::Ray** rays,
+        bool* isOccluded) const
+{
+    mcrt_common::Ray* lanes[sPacketSize];
+    bool* laneResults[sPacketSize];
+    unsigned numLanes = 0;
+
+    for (unsigned i = 0; i < numRays; ++i) {
+        mcrt_common::Ray& ray = *rays[i];
+        if (!mNativePacketSupport || !isPacketCompatible(ray)) {
+            isOccluded[i] = occluded(ray);
+            continue;
+        }
+        lanes[numLanes] = &ray;
+        laneResults[numLanes] = &isOccluded[i];
+        if (++numLanes == sPacketSize) {
+            occludedPacket(mRootScene, numLanes, lanes, laneResults);
+            numLanes = 0;
+        }
+    }
+
+    if (numLanes == 1) {
+        *laneResults[0] = occluded(*lanes[0]);
+    } else if (numLanes > 1) {
+        occludedPacket(mRootScene, numLanes, lanes, laneResults);
+    }
+}
+
 scene_rdl2::math::BBox3f
 EmbreeAccelerator::getBounds() const
 {
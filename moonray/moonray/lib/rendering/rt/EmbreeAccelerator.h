@@ -38,6 +38,15 @@ public:
 
     bool occluded(mcrt_common::Ray& ray) const;
 
+    /// Batched versions of intersect() / occluded() for the bundled ray
+    /// handlers. Rays are traced as VLEN wide packets when the embree device
+    /// has native packet support, the remaining rays fall back to the single
+    /// ray entry points. Results are written back into each ray exactly as
+    /// the single ray versions would, occlusion results go into isOccluded.
+    void intersectN(unsigned numRays, mcrt_common::Ray** rays) const;
+
+    void occludedN(unsigned numRays, mcrt_common::Ray** rays, bool* isOccluded) const;
+
     scene_rdl2::math::BBox3f getBounds() const;
 
     size_t getMemory() const {
@@ -53,18 +62,30 @@ public:
         mBVHMemory += bytes;
     }
 
+    /// Build quality and commit time of every BVH committed by the last
+    /// build() call, shared scenes first and the root scene last.
+    const std::vector<BVHBuildStat>& getBVHBuildStats() const
+    {
+        return mBVHBuildStats;
+    }
+
     //------------------------------
 
     double mBvhBuildProceduralTime;
+    // time spent committing the shared scenes and the root scene
     double mRtcCommitTime;
 
 private:
     /// An Embree scene that contains all geometry and instances
     RTCScene mRootScene;
+    RTCBuildQuality mRootBuildQuality;
     RTCDevice mDevice;
     // container for userdata so that they can be safely deleted.
     BVHUserDataList mBVHUserData;
     std::atomic<ssize_t> mBVHMemory;
+    // Whether the embree device natively supports VLEN wide ray packets
+    bool mNativePacketSupport;
+    std::vector<BVHBuildStat> mBVHBuildStats;
 };
 
 } // namespace rt
@@ -510,6 +510,11 @@ GeometryManager::GeometryManager(scene_rdl2::rdl2::SceneContext* sceneContext,
 {
     mEmbreeAccelerator.reset(new EmbreeAccelerator(mOptions.accelOptions));
 
+    if (!mOptions.tessellationCacheDir.empty()) {
+        mTessellationCache.reset(
+            new geom::internal::TessellationCache(mOptions.tessellationCacheDir));
+    }
+
     mDeformedGeometrySets.clear();
 
     // We *don't* create the GPUAccelerator here because we need a completely
@@ -952,7 +957,8 @@ GeometryManager::bakeGeometry(scene_rdl2::rdl2::Layer* layer,
                                                                 enableDisplacement,
                                                                 fastGeomUpdate,
                                                                 /* isBaking = */ true,
-                                                                mVolumeAssignmentTable.get());
+                                                                mVolumeAssignmentTable.get(),
+                                                                mTessellationCache.get());
                 prim->tessellate(params);
 
                 // Bake the density map of a volume shader bound to this primitive. This is more
@@ -1461,7 +1467,8 @@ GeometryManager::tessellate(scene_rdl2::rdl2::Layer* layer,
                                                                     enableDisplacement,
                                                                     fastGeomUpdate,
                                                                     /* isBaking = */ false,
-                                                                    mVolumeAssignmentTable.get());
+                                                                    mVolumeAssignmentTable.get(),
+                                                                    mTessellationCache.get());
                 prim->tessellate(tessParams);
 
                 // Bake the density map of a volume shader bound to this primitive. This is more
@@ -1496,6 +1503,14 @@ GeometryManager::tessellate(scene_rdl2::rdl2::Layer* layer,
     malloc_trim(0);
 
     mOptions.stats.logString("Tessellation finished.");
+    if (mTessellationCache) {
+        std::stringstream cacheMsg;
+        cacheMsg << "Tessellation cache " << mTessellationCache->getDirectory() << ": "
+                 << mTessellationCache->getHitCount() << " hits, "
+                 << mTessellationCache->getMissCount() << " misses, "
+                 << mTessellationCache->getStoreCount() << " stored";
+        mOptions.stats.logString(cacheMsg.str());
+    }
 
     if (tessellationCancelCondition) {
         mOptions.stats.mGeometryManagerExecTracker.finalizeTessellationItem(true); // cancel = true
@@ -1537,6 +1552,9 @@ void GeometryManager::updateAccelerator(const scene_rdl2::rdl2::Layer* layer,
     malloc_trim(0);
 
     mOptions.stats.logString("BVH build finished.");
+    mOptions.stats.mBuildProceduralTime = mEmbreeAccelerator->mBvhBuildProceduralTime;
+    mOptions.stats.mRtcCommitTime = mEmbreeAccelerator->mRtcCommitTime;
+    mOptions.stats.mPerGeometryBVHBuildTime = mEmbreeAccelerator->getBVHBuildStats();
 
     buildBVHTimer.stop();
 
@@ -14,6 +14,7 @@
 #include <moonray/rendering/geom/Primitive.h>
 #include <moonray/rendering/geom/prim/EmissiveRegion.h>
 #include <moonray/rendering/geom/prim/ShadowLinking.h>
+#include <moonray/rendering/geom/prim/TessellationCache.h>
 #include <scene_rdl2/common/grid_util/RenderPrepStats.h>
 #include <scene_rdl2/common/math/Xform.h>
 #include <scene_rdl2/common/platform/Platform.h>
@@ -51,6 +52,7 @@ struct GeometryManagerStats
     double mBuildProceduralTime;
     double mRtcCommitTime;
     std::vector<std::pair<geom::internal::NamedPrimitive*, double> > mPerPrimitiveTessellationTime;
+    std::vector<BVHBuildStat> mPerGeometryBVHBuildTime;
 
     GeometryManagerExecTracker mGeometryManagerExecTracker;
 
@@ -62,6 +64,7 @@ struct GeometryManagerStats
         mBuildProceduralTime = 0.0;
         mRtcCommitTime = 0.0;
         mPerPrimitiveTessellationTime.clear();
+        mPerGeometryBVHBuildTime.clear();
 
         mGeometryManagerExecTracker.initLoadGeometries(0);
         mGeometryManagerExecTracker.initFinalizeChange(0);
@@ -74,6 +77,8 @@ GeometryManagerOptions
 {
     GeometryManagerStats stats;
     AcceleratorOptions accelOptions;
+    // Directory of the on-disk tessellation cache, empty to disable it
+    std::string tessellationCacheDir;
 };
 
 /**
@@ -261,6 +266,8 @@ private:
     ChangeFlagAtomic mChangeStatus;
 
     std::unique_ptr<geom::internal::VolumeAssignmentTable> mVolumeAssignmentTable;
+
+    std::unique_ptr<geom::internal::TessellationCache> mTessellationCache;
 };
 
 // For use with shadow suppression between specified geometries
@@ -18,6 +18,13 @@
 namespace moonray {
 namespace rt {
 
+namespace {
+
+// Items are processed in parallel, one at a time per thread.
+thread_local mcrt_common::TraceEventTimer tTraceItem;
+
+} // namespace
+
 void
 GeometryManagerExecTracker::initLoadGeometries(int stageId)
 {
@@ -69,6 +76,7 @@ GeometryManagerExecTracker::setMsgHandlerCallBack(const MsgHandlerCallBack &call
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::startLoadGeometries(int totalGeometries)
 {
+    mTraceLoadGeometries.start();
     mRunLoadGeometriesTotal[mStageId] = totalGeometries;
     mRunLoadGeometriesProcessed[mStageId] = 0; // just in case
 
@@ -82,6 +90,7 @@ GeometryManagerExecTracker::startLoadGeometries(int totalGeometries)
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::startLoadGeometriesItem()
 {
+    tTraceItem.start();
     // We update mRunLoadGeometriesItem condition by special value (Condition::ETC)
     return updateRunStatus(CancelCodePos::LOADGEOMETRIES_ITEM_0_START,
                            CancelCodePos::LOADGEOMETRIES_ITEM_1_START,
@@ -93,6 +102,7 @@ GeometryManagerExecTracker::startLoadGeometriesItem()
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::endLoadGeometriesItem()
 {
+    tTraceItem.stop("Load geometry item");
     mRunLoadGeometriesProcessed[mStageId]++; // atomic operation
 
     return updateRunStatus(CancelCodePos::LOADGEOMETRIES_ITEM_0_END,
@@ -113,6 +123,7 @@ GeometryManagerExecTracker::finalizeLoadGeometriesItem(bool canceled)
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::endLoadGeometries()
 {
+    mTraceLoadGeometries.stop("Load geometries");
     return updateRunStatus(CancelCodePos::LOADGEOMETRIES_0_END,
                            CancelCodePos::LOADGEOMETRIES_1_END,
                            mRunLoadGeometries[mStageId],
@@ -125,6 +136,7 @@ GeometryManagerExecTracker::endLoadGeometries()
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::startFinalizeChange()
 {
+    mTraceFinalizeChange.start();
     return updateRunStatus(CancelCodePos::FINALIZE_CHANGE_0_START,
                            CancelCodePos::FINALIZE_CHANGE_1_START,
                            mRunFinalizeChange[mStageId],
@@ -135,6 +147,7 @@ GeometryManagerExecTracker::startFinalizeChange()
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::startTessellation(int totalTessellation)
 {
+    mTraceTessellation.start();
     mRunTessellationTotal[mStageId] = totalTessellation;
     mRunTessellationProcessed[mStageId] = 0; // just in case
 
@@ -148,6 +161,7 @@ GeometryManagerExecTracker::startTessellation(int totalTessellation)
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::startTessellationItem()
 {
+    tTraceItem.start();
     // We update mRunTessellationItem condition by special value (Condition::ETC)
     return updateRunStatus(CancelCodePos::TESSELLATION_ITEM_0_START,
                            CancelCodePos::TESSELLATION_ITEM_1_START,
@@ -159,6 +173,7 @@ GeometryManagerExecTracker::startTessellationItem()
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::endTessellationItem()
 {
+    tTraceItem.stop("Tessellation item");
     mRunTessellationProcessed[mStageId]++; // atomic operation
 
     return updateRunStatus(CancelCodePos::TESSELLATION_ITEM_0_END,
@@ -179,6 +194,7 @@ GeometryManagerExecTracker::finalizeTessellationItem(bool canceled)
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::endTessellation()
 {
+    mTraceTessellation.stop("Tessellation");
     return updateRunStatus(CancelCodePos::TESSELLATION_0_END,
                            CancelCodePos::TESSELLATION_1_END,
                            mRunTessellation[mStageId],
@@ -189,6 +205,7 @@ GeometryManagerExecTracker::endTessellation()
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::startBVHConstruction()
 {
+    mTraceBVHConstruction.start();
     return updateRunStatus(CancelCodePos::BVH_CONSTRUCTION_0_START,
                            CancelCodePos::BVH_CONSTRUCTION_1_START,
                            mRunBVHConstruction[mStageId],
@@ -199,6 +216,7 @@ GeometryManagerExecTracker::startBVHConstruction()
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::endBVHConstruction()
 {
+    mTraceBVHConstruction.stop("BVH construction");
     return updateRunStatus(CancelCodePos::BVH_CONSTRUCTION_0_END,
                            CancelCodePos::BVH_CONSTRUCTION_1_END,
                            mRunBVHConstruction[mStageId],
@@ -209,6 +227,7 @@ GeometryManagerExecTracker::endBVHConstruction()
 GeometryManagerExecTracker::RESULT
 GeometryManagerExecTracker::endFinalizeChange()
 {
+    mTraceFinalizeChange.stop("Finalize change geometry");
     return updateRunStatus(CancelCodePos::FINALIZE_CHANGE_0_END,
                            CancelCodePos::FINALIZE_CHANGE_1_END,
                            mRunFinalizeChange[mStageId],
@@ -5,6 +5,7 @@
 //
 #pragma once
 
+#include <moonray/rendering/mcrt_common/ProfileAccumulator.h>
 #include <scene_rdl2/common/grid_util/Parser.h>
 
 #include <atomic>
@@ -238,6 +239,12 @@ private:
     // internal of finalizeChange stage condition for BVH construction
     Condition mRunBVHConstruction[mStageMax];
 
+    // timeline of the stages for trace recording
+    mcrt_common::TraceEventTimer mTraceLoadGeometries;
+    mcrt_common::TraceEventTimer mTraceFinalizeChange;
+    mcrt_common::TraceEventTimer mTraceTessellation;
+    mcrt_common::TraceEventTimer mTraceBVHConstruction;
+
     //------------------------------
 
     Parser mParser;
@@ -74,6 +74,22 @@ originVolumeTest(uint32_t threadIdx,
     return false; // This volume is not a originVolume
 }
 
+static void
+assertNoVolumeQuery(const RTCFilterFunctionNArguments* args)
+{
+#ifdef DEBUG
+    const mcrt_common::IntersectContext* context =
+        (const mcrt_common::IntersectContext*)args->context;
+    for (unsigned int index = 0; index < args->N; ++index) {
+        if (args->valid[index] != 0) {
+            const int rayId = RTCRayN_id(args->ray, args->N, index);
+            MNRY_ASSERT(context->mRayExtension[rayId].geomTls == nullptr &&
+                "volume interval queries need single ray traversal");
+        }
+    }
+#endif
+}
+
 void
 vdbVolumeIntervalFilter(const RTCFilterFunctionNArguments* args)
 {
@@ -182,7 +198,9 @@ vdbVolumeIntervalFilter(const RTCFilterFunctionNArguments* args)
             volumeRayState.setVisited(volumeId, vdbVolume);
         }
     } else {
-        MNRY_ASSERT_REQUIRE(false, "vectorized volume is not available yet");
+        // Packets only come from EmbreeAccelerator::intersectN(), which
+        // traces rays collecting volume intervals one at a time.
+        assertNoVolumeQuery(args);
     }
 }
 
@@ -253,7 +271,9 @@ manifoldVolumeIntervalFilter(const RTCFilterFunctionNArguments* args)
             volumeRayState.setVisited(volumeId, primitive);
         }
     } else {
-        MNRY_ASSERT_REQUIRE(false, "vectorized volume is not available yet");
+        // Packets only come from EmbreeAccelerator::intersectN(), which
+        // traces rays collecting volume intervals one at a time.
+        assertNoVolumeQuery(args);
     }
 }
 
@@ -332,49 +352,51 @@ backFaceCullingFilter(const RTCFilterFunctionNArguments* args)
 void
 skipOcclusionFilter(const RTCFilterFunctionNArguments* args)
 {
-
-    // Although "args" points to a packet of N rays, in practice we always set N=1 (and there are parts of the code
-    // base which already rely on this assumption). So here we hardcode for that case - thus we only need to inspect
-    // valid[0] here, which we can write as *valid.
+    // "args" points to a packet of N rays. N is 1 for rtcOccluded1 and the
+    // packet width for the batched occlusion queries of the bundled ray handlers.
     int* valid = args->valid;
-    if (*valid == 0) {
-        return;
-    }
-
-    // We continue to assume N=1 here and cast the various data types to their single-ray counterparts.
+    unsigned int N = args->N;
+    RTCRayN* rays = args->ray;
+    RTCHitN* hits = args->hit;
     const geom::internal::BVHUserData* userData = static_cast<const geom::internal::BVHUserData*>(args->geometryUserPtr);
     const geom::internal::NamedPrimitive* prim  = static_cast<const geom::internal::NamedPrimitive*>(userData->mPrimitive);
-    RTCRay* ray = (RTCRay*)args->ray;
-    RTCHit* hit = (RTCHit*)args->hit;
     const mcrt_common::IntersectContext* context = reinterpret_cast<const mcrt_common::IntersectContext*>(args->context);
-    mcrt_common::RayExtension& rayExtension = context->mRayExtension[ray->id];
-    int casterId = prim->getIntersectionAssignmentId(hit->primID);
-    int receiverId = rayExtension.shadowReceiverId;
-
-    // If the occlusion ray was cast from a volume, suppress shadowing by the geometry it's assigned to (see
-    // MOONRAY-4130). This test reuses the volumeInstanceState member of RayExtension, which is otherwise unused
-    // in occlusion tests.
-    if (rayExtension.volumeInstanceState && (receiverId == casterId)) {
-        *valid = 0;
-        return;
-    }
 
     // Shadow linking
     // We currently don't support per instance shadow linking.
     MNRY_ASSERT(userData->mPrimitive->getType() != geom::internal::Primitive::INSTANCE);
-    const geom::internal::ShadowLinking* shadowLinking = prim->getShadowLinking(casterId);
-    if (shadowLinking != nullptr) {
-        // Suppress shadows if this light is marked as not casting shadows from the caster geometry
-        if (!shadowLinking->canCastShadow((const scene_rdl2::rdl2::Light*)rayExtension.instance0OrLight)) {
-            *valid = 0;
-            return;
+
+    for (unsigned int index = 0; index < N; ++index) {
+        if (valid[index] == 0) {
+            continue;
         }
 
-        // Suppress shadows if this receiver is marked as not receiving shadows from the caster geometry
-        // (See MOONRAY-4130 and MOONRAY-4663)
-        if (!shadowLinking->canReceiveShadow(receiverId)) {
-            *valid = 0;
-            return;
+        mcrt_common::RayExtension& rayExtension = context->mRayExtension[RTCRayN_id(rays, N, index)];
+        int casterId = prim->getIntersectionAssignmentId(RTCHitN_primID(hits, N, index));
+        int receiverId = rayExtension.shadowReceiverId;
+
+        // If the occlusion ray was cast from a volume, suppress shadowing by the geometry it's assigned to (see
+        // MOONRAY-4130). This test reuses the volumeInstanceState member of RayExtension, which is otherwise unused
+        // in occlusion tests.
+        if (rayExtension.volumeInstanceState && (receiverId == casterId)) {
+            valid[index] = 0;
+            continue;
+        }
+
+        const geom::internal::ShadowLinking* shadowLinking = prim->getShadowLinking(casterId);
+        if (shadowLinking != nullptr) {
+            // Suppress shadows if this light is marked as not casting shadows from the caster geometry
+            if (!shadowLinking->canCastShadow((const scene_rdl2::rdl2::Light*)rayExtension.instance0OrLight)) {
+                valid[index] = 0;
+                continue;
+            }
+
+            // Suppress shadows if this receiver is marked as not receiving shadows from the caster geometry
+            // (See MOONRAY-4130 and MOONRAY-4663)
+            if (!shadowLinking->canReceiveShadow(receiverId)) {
+                valid[index] = 0;
+                continue;
+            }
         }
     }
 }
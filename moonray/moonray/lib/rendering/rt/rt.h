@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string>
+
 namespace moonray {
 
 /**
@@ -41,6 +44,17 @@ struct AcceleratorOptions
     bool verbose = false;
 };
 
+/// Build statistics of one BVH committed by the accelerator: the shared
+/// scene of an instanced primitive, or the root scene.
+struct BVHBuildStat
+{
+    std::string mName;          // rdl geometry the BVH was built for
+    const char* mBuildQuality;  // embree build quality the BVH was built with
+    size_t mPrimitiveCount;     // primitives (faces, spans, instances...) in the BVH
+    size_t mReferenceCount;     // instances referencing the BVH
+    double mBuildTime;          // commit time in seconds
+};
+
 } // namespace rt
 } // namespace moonray
 
@@ -9,6 +9,7 @@
 
 #include <moonray/common/mcrt_macros/moonray_static_check.h>
 #include <moonray/rendering/bvh/shading/Intersection.h>
+#include <moonray/rendering/bvh/shading/MipSelector.h>
 #include <moonray/rendering/bvh/shading/ShadingTLState.h>
 #include <moonray/rendering/bvh/shading/ThreadLocalObjectState.h>
 #include <moonray/rendering/mcrt_common/ProfileAccumulatorHandles.h>
@@ -235,8 +236,14 @@ public:
         // dwa_texture *must* be given 4 floats for the result.
         ALIGN(16) float tmp[4];
 
+        texture::TextureHandle *textureHandle = const_cast<texture::TextureHandle *>(getTextureHandle());
+        texture::TextureTileCache *tileCache = texture::getTextureSampler()->getTileCache();
+        texture::TileLookup tileLookup(tileCache, textureHandle, st[0], st[1],
+            tileCache->isEnabled() ?
+            computeMipSelector(derivatives[0], derivatives[1], derivatives[2], derivatives[3]) : 0.f);
+
         bool res = texSys->texture(
-            const_cast<texture::TextureHandle *>(getTextureHandle()),
+            textureHandle,
             tls->mOIIOThreadData,
             const_cast<OIIO::TextureOpt&>(options),
             st[0], st[1],
@@ -403,6 +410,10 @@ void CPP_oiioTexture(const ispc::BASIC_TEXTURE_Data *tx,
     float dtdy = derivatives[3];
     const int nChannels = 4;
 
+    texture::TextureTileCache *tileCache = texture::getTextureSampler()->getTileCache();
+    texture::TileLookup tileLookup(tileCache, textureHandle, s, t,
+        tileCache->isEnabled() ? computeMipSelector(dsdx, dtdx, dsdy, dtdy) : 0.f);
+
     bool res = texSys->texture(textureHandle,
                                threadInfo,
                                options[index],
@@ -425,6 +436,23 @@ void CPP_oiioTexture(const ispc::BASIC_TEXTURE_Data *tx,
     }
 }
 
+void CPP_prefetchTextureTiles(const ispc::BASIC_TEXTURE_Data *tx,
+                              const int numLanes,
+                              const float *s,
+                              const float *t,
+                              const float *mipSelectors)
+{
+    texture::TextureTileCache *tileCache = texture::getTextureSampler()->getTileCache();
+    if (!tileCache->isEnabled() || !tx->mIsValid) {
+        return;
+    }
+
+    texture::TextureHandle *textureHandle = (reinterpret_cast<texture::TextureHandle **>(tx->mTextureHandles))[0];
+    for (int i = 0; i < numLanes; ++i) {
+        tileCache->prefetch(textureHandle, s[i], t[i], mipSelectors[i]);
+    }
+}
+
 } // end namespace shading
 } // end namespace moonray
 
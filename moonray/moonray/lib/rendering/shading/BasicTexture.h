@@ -59,6 +59,13 @@ void CPP_oiioTexture(const ispc::BASIC_TEXTURE_Data* tx,
                      const float* derivatives,
                      const float* st,
                      float* result);
+
+// Queue the texture tiles of a shade bundle's lookups for prefetching
+void CPP_prefetchTextureTiles(const ispc::BASIC_TEXTURE_Data* tx,
+                              const int numLanes,
+                              const float* s,
+                              const float* t,
+                              const float* mipSelectors);
 }
 
 } // namespace shading
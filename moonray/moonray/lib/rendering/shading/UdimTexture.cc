@@ -321,6 +321,12 @@ public:
             }
         }
 
+        texture::TextureTileCache *tileCache = texture::getTextureSampler()->getTileCache();
+        texture::TileLookup tileLookup(tileCache, const_cast<texture::TextureHandle *>(texHandle),
+            st[0], st[1],
+            tileCache->isEnabled() ?
+            computeMipSelector(derivatives[0], derivatives[1], derivatives[2], derivatives[3]) : 0.f);
+
         bool res = texSys->texture(
             const_cast<texture::TextureHandle *>(texHandle),
             tls->mOIIOThreadData,
@@ -789,6 +795,10 @@ void CPP_oiioUdimTexture(const ispc::UDIM_TEXTURE_Data *tx,
     float dtdy = derivatives[3];
     const int nChannels = 4;
 
+    texture::TextureTileCache *tileCache = texture::getTextureSampler()->getTileCache();
+    texture::TileLookup tileLookup(tileCache, const_cast<texture::TextureHandle *>(textureHandle), s, t,
+        tileCache->isEnabled() ? computeMipSelector(dsdx, dtdx, dsdy, dtdy) : 0.f);
+
     bool res = texSys->texture(const_cast<texture::TextureHandle *>(textureHandle),
                                threadInfo,
                                *options[udim * QualityCount + index],
@@ -810,6 +820,28 @@ void CPP_oiioUdimTexture(const ispc::UDIM_TEXTURE_Data *tx,
     }
 }
 
+void CPP_prefetchUdimTextureTiles(const ispc::UDIM_TEXTURE_Data *tx,
+                                  const int numLanes,
+                                  const int *udims,
+                                  const float *s,
+                                  const float *t,
+                                  const float *mipSelectors)
+{
+    texture::TextureTileCache *tileCache = texture::getTextureSampler()->getTileCache();
+    if (!tileCache->isEnabled() || !tx->mIsValid) {
+        return;
+    }
+
+    texture::TextureHandle * const *textureHandles =
+        reinterpret_cast<texture::TextureHandle * const *>(tx->mTextureHandles);
+    for (int i = 0; i < numLanes; ++i) {
+        if (udims[i] < 0 || udims[i] >= tx->mNumTextures || textureHandles[udims[i]] == nullptr) {
+            continue;
+        }
+        tileCache->prefetch(textureHandles[udims[i]], s[i], t[i], mipSelectors[i]);
+    }
+}
+
 } // namespace shading
 } // namespace moonray
 
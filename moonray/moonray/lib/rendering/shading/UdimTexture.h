@@ -72,6 +72,14 @@ void CPP_oiioUdimTexture(const ispc::UDIM_TEXTURE_Data* tx,
                          const int udim,
                          const float* st,
                          float* result);
+
+// Queue the texture tiles of a shade bundle's lookups for prefetching
+void CPP_prefetchUdimTextureTiles(const ispc::UDIM_TEXTURE_Data* tx,
+                                  const int numLanes,
+                                  const int* udims,
+                                  const float* s,
+                                  const float* t,
+                                  const float* mipSelectors);
 }
 
 } // namespace shading
@@ -71,11 +71,16 @@ TextureSampler::TextureSampler()
     // Convert single channel textures to grayscale (rather than r 0 0)
     mTextureSystem->attribute("gray_to_rgb", 1);
 
+    mTileCache.reset(new TextureTileCache(mTextureSystem));
+    mTileCache->setMemoryUsage(getMemoryUsage());
+
     parserConfigure();
 }
 
 TextureSampler::~TextureSampler()
 {
+    // stop the prefetch threads before the oiio cache goes away
+    mTileCache.reset();
     OIIO::TextureSystem::destroy(mTextureSystem, false);
 }
 
@@ -100,6 +105,8 @@ TextureSampler::getHandle(const std::string& fileName,
         return nullptr;
     }
 
+    mTileCache->registerTexture(textureHandle, fileName);
+
     return textureHandle;
 }
 
@@ -146,6 +153,8 @@ TextureSampler::getStatistics(const std::string& prepend, std::ostream& outs, bo
         outs << prepend << statsLine << std::endl;
         stats.erase(0, pos + delimiter.length());
     }
+
+    mTileCache->getStatistics(prepend, outs);
 }
 
 void
@@ -308,12 +317,15 @@ TextureSampler::getStatisticsForCsv(std::ostream& outs, bool athenaFormat) const
     moonray_stats::writeEqualityCSVTable(outs, icStatsTable, athenaFormat);
     moonray_stats::writeCSVTable(outs, imageFileTable, athenaFormat);
     moonray_stats::writeEqualityCSVTable(outs, summaryTable, athenaFormat);
+
+    mTileCache->getStatisticsForCsv(outs, athenaFormat);
 }
 
 void
 TextureSampler::resetStats() const
 {
     mTextureSystem->reset_stats();
+    mTileCache->resetStats();
 }
 
 float
@@ -410,6 +422,7 @@ void
 TextureSampler::setMemoryUsage(float megabytes)
 {
     mTextureSystem->attribute("max_memory_MB", OIIO::TypeDesc::FLOAT, &megabytes);
+    mTileCache->setMemoryUsage(megabytes);
 }
 
 float
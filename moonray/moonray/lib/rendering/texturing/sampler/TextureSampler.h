@@ -6,6 +6,7 @@
 ///
 #pragma once
 #include "TextureTLState.h"
+#include "TextureTileCache.h"
 
 #include <scene_rdl2/common/grid_util/Arg.h>
 #include <scene_rdl2/common/grid_util/Parser.h>
@@ -14,6 +15,7 @@
 #include <tbb/recursive_mutex.h>
 
 // system
+#include <memory>
 #include <string>
 #include <set>
 
@@ -91,6 +93,12 @@ public:
     // limits the number of open files OIIO uses.
     void setOpenFileLimit(int count);
 
+    // number of threads prefetching texture tiles ahead of shading,
+    // 0 disables the tile cache
+    void setTilePrefetchThreads(unsigned count) { mTileCache->setPrefetchThreads(count); }
+
+    TextureTileCache* getTileCache() const { return mTileCache.get(); }
+
     OIIO::TextureSystem* getTextureSystem() { return mTextureSystem; }
 
     void registerMapForInvalidation(const std::string &filename,
@@ -127,6 +135,9 @@ protected:
     // The oiio system.
     OIIO::TextureSystem*  mTextureSystem;
 
+    // Tile prefetching and residency stats in front of the oiio cache.
+    std::unique_ptr<TextureTileCache> mTileCache;
+
     //
     // Used to notify ImageMaps of invalidated textures.
     //
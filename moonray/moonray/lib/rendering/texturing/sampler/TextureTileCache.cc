@@ -0,0 +1,365 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TextureTileCache.cc
+///
+
+#include "TextureTileCache.h"
+
+#include <moonray/statistics/StatsTable.h>
+#include <moonray/statistics/StatsTableOutput.h>
+
+#include <OpenImageIO/imagecache.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace moonray {
+namespace texture {
+
+namespace {
+
+// Number of residency table slots per tile of texture cache memory. Oversizing
+// the table keeps collisions rare while it still roughly ages out tiles at the
+// rate the OIIO cache evicts them.
+constexpr uint64_t sSlotsPerCachedTile = 2;
+// Assumed size of a cached tile: 64x64 texels, 4 channels, 8 bit.
+constexpr uint64_t sTypicalTileBytes = 64 * 64 * 4;
+constexpr uint64_t sMinResidencySlots = 1 << 14;
+// Prefetches beyond this queue length are dropped rather than letting the
+// queue fall further behind the render threads.
+constexpr int sMaxQueuedPrefetches = 4096;
+
+inline uint64_t
+mixBits(uint64_t x)
+{
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+inline float
+wrapCoordinate(float c)
+{
+    return c - std::floor(c);
+}
+
+} // namespace
+
+TextureTileCache::TextureTileCache(OIIO::TextureSystem* textureSystem) :
+    mTextureSystem(textureSystem),
+    mResidencyMask(0)
+{
+    mQueue.set_capacity(sMaxQueuedPrefetches);
+    setMemoryUsage(0.0f);
+}
+
+TextureTileCache::~TextureTileCache()
+{
+    setPrefetchThreads(0);
+}
+
+void
+TextureTileCache::setPrefetchThreads(unsigned numThreads)
+{
+    if (numThreads == mThreads.size()) {
+        return;
+    }
+
+    // Stop the running threads, each one exits on its own empty request once
+    // the requests queued ahead of it are done.
+    for (size_t i = 0; i < mThreads.size(); ++i) {
+        mQueue.push(Request {nullptr, 0, 0, 0, 0});
+    }
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+    mThreads.clear();
+
+    for (unsigned i = 0; i < numThreads; ++i) {
+        mThreads.emplace_back(&TextureTileCache::prefetchThreadMain, this);
+    }
+}
+
+void
+TextureTileCache::setMemoryUsage(float megabytes)
+{
+    const uint64_t cachedTiles =
+        static_cast<uint64_t>(std::max(megabytes, 0.0f) * 1024.0f * 1024.0f) / sTypicalTileBytes;
+    uint64_t numSlots = sMinResidencySlots;
+    while (numSlots < cachedTiles * sSlotsPerCachedTile) {
+        numSlots <<= 1;
+    }
+    if (numSlots - 1 == mResidencyMask) {
+        return;
+    }
+
+    // prefetch threads write into the table, keep them off it while it is
+    // being replaced
+    const unsigned numThreads = getPrefetchThreads();
+    setPrefetchThreads(0);
+
+    mResidency.reset(new std::atomic<uint64_t>[numSlots]);
+    for (uint64_t i = 0; i < numSlots; ++i) {
+        mResidency[i].store(0, std::memory_order_relaxed);
+    }
+    mResidencyMask = numSlots - 1;
+
+    setPrefetchThreads(numThreads);
+}
+
+void
+TextureTileCache::registerTexture(TextureHandle* handle, const std::string& filename)
+{
+    if (!handle) {
+        return;
+    }
+
+    auto it = mTextures.find(handle);
+    if (it == mTextures.end()) {
+        it = mTextures.insert(std::make_pair(handle, std::unique_ptr<Texture>(new Texture))).first;
+    }
+    Texture& texture = *it->second;
+
+    texture.mFilename = OIIO::ustring(filename);
+
+    OIIO::ImageSpec spec;
+    int numMipLevels = 1;
+    if (mTextureSystem->get_imagespec(texture.mFilename, 0, spec)) {
+        mTextureSystem->get_texture_info(handle, mTextureSystem->get_perthread_info(), 0,
+                                         OIIO::ustring("miplevels"), OIIO::TypeDesc::TypeInt,
+                                         &numMipLevels);
+        texture.mWidth = spec.width;
+        texture.mHeight = spec.height;
+        // untiled textures are handled by OIIO as a single tile
+        texture.mTileWidth = spec.tile_width > 0 ? spec.tile_width : spec.width;
+        texture.mTileHeight = spec.tile_height > 0 ? spec.tile_height : spec.height;
+    }
+    texture.mNumMipLevels = std::max(numMipLevels, 1);
+}
+
+TextureTileCache::Texture*
+TextureTileCache::findTexture(TextureHandle* handle) const
+{
+    auto it = mTextures.find(handle);
+    if (it == mTextures.end() || it->second->mWidth <= 0) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+float
+TextureTileCache::getMipLevel(const Texture& texture, float mipSelector) const
+{
+    // The mip selector is the log2 of the texture resolution at which the
+    // lookup footprint covers a single texel.
+    const float finestLevel = std::log2(static_cast<float>(std::max(texture.mWidth, texture.mHeight)));
+    return std::min(std::max(finestLevel - mipSelector, 0.0f),
+                    static_cast<float>(texture.mNumMipLevels - 1));
+}
+
+uint64_t
+TextureTileCache::getTile(const Texture& texture, float s, float t, int mipLevel,
+                          int& x, int& y) const
+{
+    const int levelWidth = std::max(texture.mWidth >> mipLevel, 1);
+    const int levelHeight = std::max(texture.mHeight >> mipLevel, 1);
+    const int tileWidth = std::min(texture.mTileWidth, levelWidth);
+    const int tileHeight = std::min(texture.mTileHeight, levelHeight);
+
+    const int px = std::min(static_cast<int>(wrapCoordinate(s) * levelWidth), levelWidth - 1);
+    const int py = std::min(static_cast<int>(wrapCoordinate(t) * levelHeight), levelHeight - 1);
+    x = px - px % tileWidth;
+    y = py - py % tileHeight;
+
+    uint64_t key = mixBits(reinterpret_cast<uintptr_t>(&texture));
+    key = mixBits(key ^ (static_cast<uint64_t>(mipLevel) << 56) ^
+                  (static_cast<uint64_t>(x) << 28) ^ static_cast<uint64_t>(y));
+    // bit 0 is the pending flag, and 0 marks an empty slot
+    return (key & ~sPendingBit) | 2;
+}
+
+void
+TextureTileCache::queueTile(Texture& texture, float s, float t, int mipLevel)
+{
+    int x, y;
+    const uint64_t key = getTile(texture, s, t, mipLevel, x, y);
+    std::atomic<uint64_t>& slot = mResidency[(key >> 1) & mResidencyMask];
+
+    uint64_t current = slot.load(std::memory_order_relaxed);
+    if ((current & ~sPendingBit) == key) {
+        return; // already resident or queued
+    }
+    if (!slot.compare_exchange_strong(current, key | sPendingBit, std::memory_order_relaxed)) {
+        return; // somebody else is using the slot, don't fight over it
+    }
+    if (!mQueue.try_push(Request {&texture, mipLevel, x, y, key})) {
+        uint64_t pending = key | sPendingBit;
+        slot.compare_exchange_strong(pending, 0, std::memory_order_relaxed);
+    }
+}
+
+void
+TextureTileCache::prefetch(TextureHandle* handle, float s, float t, float mipSelector)
+{
+    Texture* texture = findTexture(handle);
+    if (!texture) {
+        return;
+    }
+
+    // trilinear filtering reads the two mip levels around the selected one
+    const float mipLevel = getMipLevel(*texture, mipSelector);
+    const int fineLevel = static_cast<int>(mipLevel);
+    queueTile(*texture, s, t, fineLevel);
+    if (fineLevel + 1 < texture->mNumMipLevels && mipLevel > static_cast<float>(fineLevel)) {
+        queueTile(*texture, s, t, fineLevel + 1);
+    }
+}
+
+bool
+TextureTileCache::lookup(TextureHandle* handle, float s, float t, float mipSelector)
+{
+    Texture* texture = findTexture(handle);
+    if (!texture) {
+        return true;
+    }
+
+    int x, y;
+    const uint64_t key = getTile(*texture, s, t,
+                                 static_cast<int>(getMipLevel(*texture, mipSelector)), x, y);
+    std::atomic<uint64_t>& slot = mResidency[(key >> 1) & mResidencyMask];
+
+    if (slot.load(std::memory_order_relaxed) == key) {
+        texture->mHits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // The OIIO lookup which follows brings the tile in, either by reading it
+    // or by waiting on a prefetch of it still in flight.
+    texture->mMisses.fetch_add(1, std::memory_order_relaxed);
+    slot.store(key, std::memory_order_relaxed);
+    return false;
+}
+
+void
+TextureTileCache::addStallTime(TextureHandle* handle, double seconds)
+{
+    Texture* texture = findTexture(handle);
+    if (texture) {
+        texture->mStallNanoseconds.fetch_add(static_cast<uint64_t>(seconds * 1e9),
+                                             std::memory_order_relaxed);
+    }
+}
+
+void
+TextureTileCache::prefetchThreadMain()
+{
+    OIIO::ImageCache* imageCache = mTextureSystem->imagecache();
+
+    while (true) {
+        Request request;
+        mQueue.pop(request);
+        if (!request.mTexture) {
+            break;
+        }
+
+        OIIO::ImageCache::Tile* tile = imageCache->get_tile(request.mTexture->mFilename,
+                                                            0 /* subimage */,
+                                                            request.mMipLevel,
+                                                            request.mX, request.mY, 0 /* z */);
+        if (tile) {
+            imageCache->release_tile(tile);
+        }
+
+        uint64_t pending = request.mKey | sPendingBit;
+        mResidency[(request.mKey >> 1) & mResidencyMask].compare_exchange_strong(
+            pending, tile ? request.mKey : 0, std::memory_order_relaxed);
+        request.mTexture->mPrefetches.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void
+TextureTileCache::resetStats()
+{
+    for (auto& entry : mTextures) {
+        Texture& texture = *entry.second;
+        texture.mHits = 0;
+        texture.mMisses = 0;
+        texture.mPrefetches = 0;
+        texture.mStallNanoseconds = 0;
+    }
+}
+
+namespace {
+
+template <typename TextureMap>
+moonray_stats::StatsTable<6>
+buildTileCacheTable(const TextureMap& textures)
+{
+    struct Row
+    {
+        std::string mFilename;
+        uint64_t mHits;
+        uint64_t mMisses;
+        uint64_t mPrefetches;
+        double mStallTime;
+    };
+    std::vector<Row> rows;
+    for (const auto& entry : textures) {
+        const auto& texture = *entry.second;
+        const uint64_t hits = texture.mHits.load();
+        const uint64_t misses = texture.mMisses.load();
+        if (hits + misses == 0) {
+            continue;
+        }
+        rows.push_back({texture.mFilename.string(), hits, misses, texture.mPrefetches.load(),
+                        static_cast<double>(texture.mStallNanoseconds.load()) * 1e-9});
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.mStallTime > b.mStallTime;
+    });
+
+    moonray_stats::StatsTable<6> table("Texture Tile Cache",
+                                       "File", "Hits", "Misses", "Miss rate",
+                                       "Prefetched tiles", "Stall Time (s)");
+    for (const Row& row : rows) {
+        const float missRatio = static_cast<float>(row.mMisses) /
+                                static_cast<float>(row.mHits + row.mMisses);
+        table.emplace_back(row.mFilename, row.mHits, row.mMisses,
+                           moonray_stats::percentage(missRatio),
+                           row.mPrefetches, moonray_stats::time(row.mStallTime));
+    }
+    return table;
+}
+
+} // namespace
+
+void
+TextureTileCache::getStatistics(const std::string& prepend, std::ostream& outs) const
+{
+    if (!isEnabled()) {
+        return;
+    }
+    const auto table = buildTileCacheTable(mTextures);
+    auto format = moonray_stats::getHumanColumnFlags(outs, table);
+    format.set(0).left();
+    moonray_stats::writeInfoTable(outs, prepend, table, format);
+}
+
+void
+TextureTileCache::getStatisticsForCsv(std::ostream& outs, bool athenaFormat) const
+{
+    if (!isEnabled()) {
+        return;
+    }
+    moonray_stats::writeCSVTable(outs, buildTileCacheTable(mTextures), athenaFormat);
+}
+
+} //  end of texture namespace
+} //  end of moonray namespace
+
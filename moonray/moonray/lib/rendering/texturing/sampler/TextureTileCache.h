@@ -0,0 +1,178 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+/// @file TextureTileCache.h
+///
+#pragma once
+
+#include <OpenImageIO/texture.h>
+#include <OpenImageIO/ustring.h>
+
+#include <tbb/concurrent_queue.h>
+#include <tbb/concurrent_unordered_map.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace moonray {
+namespace texture {
+
+/**
+ * TextureTileCache sits in front of the OIIO image cache and tracks which
+ * texture tiles the render threads are about to touch.
+ *
+ * The shaders hand it the mip selector (see shading::computeMipSelector) of
+ * every lane of a shade bundle before sampling. The tiles those lookups
+ * resolve to are loaded asynchronously into the OIIO cache by a small pool of
+ * prefetch threads, so the file I/O of one lane overlaps with the sampling of
+ * the other lanes instead of stalling the render thread lane after lane.
+ *
+ * Residency is tracked in a direct mapped table sized after the OIIO cache
+ * memory limit. It is only a hint: OIIO remains the owner of the tile memory
+ * and may evict a tile the table still reports as resident.
+ *
+ * Lookups are also classified as hits or misses, and the time render threads
+ * spend inside OIIO on a miss is accumulated per texture as stall time.
+ * Everything is disabled unless prefetch threads are requested.
+ */
+class TextureTileCache
+{
+public:
+    typedef OIIO::TextureSystem::TextureHandle TextureHandle;
+
+    explicit TextureTileCache(OIIO::TextureSystem* textureSystem);
+    ~TextureTileCache();
+
+    TextureTileCache(const TextureTileCache&) = delete;
+    TextureTileCache& operator=(const TextureTileCache&) = delete;
+
+    /// Start the given number of prefetch threads, 0 stops them and disables
+    /// the tile cache. Must not be called while rendering.
+    void setPrefetchThreads(unsigned numThreads);
+    unsigned getPrefetchThreads() const { return static_cast<unsigned>(mThreads.size()); }
+
+    bool isEnabled() const { return !mThreads.empty(); }
+
+    /// Size the residency table after the OIIO cache memory limit. Must not be
+    /// called while rendering.
+    void setMemoryUsage(float megabytes);
+
+    /// Make a texture known to the cache, called whenever a texture handle
+    /// is (re)acquired.
+    void registerTexture(TextureHandle* handle, const std::string& filename);
+
+    /// Queue the tiles of a lookup at (s, t) with the given mip selector for
+    /// asynchronous loading.
+    void prefetch(TextureHandle* handle, float s, float t, float mipSelector);
+
+    /// Account a lookup about to be issued to OIIO. Returns true if its tile
+    /// was resident.
+    bool lookup(TextureHandle* handle, float s, float t, float mipSelector);
+
+    /// Account time a render thread spent waiting on a missed lookup.
+    void addStallTime(TextureHandle* handle, double seconds);
+
+    void resetStats();
+
+    void getStatistics(const std::string& prepend, std::ostream& outs) const;
+    void getStatisticsForCsv(std::ostream& outs, bool athenaFormat) const;
+
+private:
+    struct Texture
+    {
+        OIIO::ustring mFilename;
+        int mWidth = 0;
+        int mHeight = 0;
+        int mTileWidth = 0;
+        int mTileHeight = 0;
+        int mNumMipLevels = 0;
+
+        std::atomic<uint64_t> mHits {0};
+        std::atomic<uint64_t> mMisses {0};
+        std::atomic<uint64_t> mPrefetches {0};
+        std::atomic<uint64_t> mStallNanoseconds {0};
+    };
+
+    struct Request
+    {
+        Texture* mTexture;
+        int mMipLevel;
+        int mX;
+        int mY;
+        uint64_t mKey;
+    };
+
+    Texture* findTexture(TextureHandle* handle) const;
+
+    // Origin of the tile a lookup at (s, t) reads on the given mip level,
+    // returns the tile key
+    uint64_t getTile(const Texture& texture, float s, float t, int mipLevel,
+                     int& x, int& y) const;
+
+    float getMipLevel(const Texture& texture, float mipSelector) const;
+
+    void queueTile(Texture& texture, float s, float t, int mipLevel);
+
+    void prefetchThreadMain();
+
+    OIIO::TextureSystem* mTextureSystem;
+
+    tbb::concurrent_unordered_map<TextureHandle*, std::unique_ptr<Texture>> mTextures;
+
+    // Direct mapped table of tile keys. A slot holds a tile key when the tile
+    // was loaded, or the key with sPendingBit set while a prefetch is queued.
+    std::unique_ptr<std::atomic<uint64_t>[]> mResidency;
+    uint64_t mResidencyMask;
+
+    tbb::concurrent_bounded_queue<Request> mQueue;
+    std::vector<std::thread> mThreads;
+
+    static constexpr uint64_t sPendingBit = 1;
+};
+
+/**
+ * Accounts one OIIO lookup in the tile cache for the duration of its scope:
+ * the lookup is classified as hit or miss up front, and on a miss the time
+ * until the end of the scope is charged to the texture as stall time.
+ */
+class TileLookup
+{
+public:
+    TileLookup(TextureTileCache* tileCache, TextureTileCache::TextureHandle* handle,
+               float s, float t, float mipSelector) :
+        mTileCache(nullptr),
+        mHandle(handle)
+    {
+        if (tileCache->isEnabled() && !tileCache->lookup(handle, s, t, mipSelector)) {
+            mTileCache = tileCache;
+            mStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TileLookup()
+    {
+        if (mTileCache) {
+            const std::chrono::duration<double> stall = std::chrono::steady_clock::now() - mStart;
+            mTileCache->addStallTime(mHandle, stall.count());
+        }
+    }
+
+    TileLookup(const TileLookup&) = delete;
+    TileLookup& operator=(const TileLookup&) = delete;
+
+private:
+    TextureTileCache* mTileCache;
+    TextureTileCache::TextureHandle* mHandle;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+} //  end of texture namespace
+} //  end of moonray namespace
+
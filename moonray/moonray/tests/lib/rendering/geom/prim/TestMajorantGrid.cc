@@ -0,0 +1,167 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TestMajorantGrid.cc
+///
+
+#include "TestMajorantGrid.h"
+
+#include <moonray/rendering/geom/prim/GridSampler.h>
+#include <moonray/rendering/geom/prim/MajorantGrid.h>
+#include <scene_rdl2/common/math/Math.h>
+
+#include <openvdb/openvdb.h>
+
+#include <vector>
+
+namespace moonray {
+namespace geom {
+namespace unittest {
+
+using namespace scene_rdl2::math;
+
+namespace {
+
+struct Piece
+{
+    float mTa;
+    float mTb;
+    geom::internal::MajorantGrid::Cell mCell;
+};
+
+openvdb::FloatGrid::Ptr
+createDensityGrid(RNG& rng)
+{
+    openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create(0.0f);
+    openvdb::math::Transform::Ptr xform = openvdb::math::Transform::createLinearTransform(0.25);
+    xform->postTranslate(openvdb::Vec3d(-1.0, 0.5, 2.0));
+    grid->setTransform(xform);
+    openvdb::FloatGrid::Accessor accessor = grid->getAccessor();
+    for (int i = 0; i < 2000; ++i) {
+        const openvdb::Coord ijk(static_cast<int>(rng.randomFloat() * 24.0f),
+                                 static_cast<int>(rng.randomFloat() * 24.0f),
+                                 static_cast<int>(rng.randomFloat() * 24.0f));
+        accessor.setValue(ijk, 4.0f * rng.randomFloat());
+    }
+    // an active tile one leaf node in size
+    grid->tree().addTile(1, openvdb::Coord(24, 0, 0), 2.0f, true);
+    return grid;
+}
+
+openvdb::Vec3SGrid::Ptr
+createBakedDensityGrid(RNG& rng)
+{
+    openvdb::Vec3SGrid::Ptr grid = openvdb::Vec3SGrid::create();
+    grid->setTransform(openvdb::math::Transform::createLinearTransform(0.4));
+    openvdb::Vec3SGrid::Accessor accessor = grid->getAccessor();
+    for (int z = 0; z < 20; ++z) {
+        for (int y = 0; y < 20; ++y) {
+            for (int x = 0; x < 20; ++x) {
+                accessor.setValue(openvdb::Coord(x, y, z),
+                    openvdb::Vec3f(rng.randomFloat(), rng.randomFloat(), rng.randomFloat()));
+            }
+        }
+    }
+    return grid;
+}
+
+std::vector<Piece>
+traverse(const geom::internal::MajorantGrid& majorantGrid,
+         const Vec3f& org, const Vec3f& dir, float t0, float t1)
+{
+    std::vector<Piece> pieces;
+    majorantGrid.traverse(org, dir, t0, t1,
+        [&](float ta, float tb, const geom::internal::MajorantGrid::Cell& cell) {
+            pieces.push_back(Piece{ta, tb, cell});
+            return true;
+        });
+    return pieces;
+}
+
+void
+randomRay(RNG& rng, Vec3f& org, Vec3f& dir)
+{
+    org = Vec3f(-4.0f, -2.0f, -1.0f) + 14.0f * rng.randomVec3f();
+    dir = normalize(rng.randomVec3f() - Vec3f(0.5f));
+}
+
+} // anonymous namespace
+
+void TestMajorantGrid::setUp()
+{
+    openvdb::initialize();
+}
+
+void TestMajorantGrid::tearDown()
+{
+}
+
+void TestMajorantGrid::testCoverage()
+{
+    RNG rng;
+    openvdb::FloatGrid::Ptr densityGrid = createDensityGrid(rng);
+    geom::internal::MajorantGrid majorantGrid(*densityGrid, nullptr, Color(1.0f));
+
+    for (int i = 0; i < 1000; ++i) {
+        Vec3f org, dir;
+        randomRay(rng, org, dir);
+        const float t0 = rng.randomFloat();
+        const float t1 = t0 + 20.0f * rng.randomFloat();
+        std::vector<Piece> pieces = traverse(majorantGrid, org, dir, t0, t1);
+        CPPUNIT_ASSERT(!pieces.empty());
+        CPPUNIT_ASSERT_EQUAL(t0, pieces.front().mTa);
+        CPPUNIT_ASSERT_EQUAL(t1, pieces.back().mTb);
+        for (size_t j = 0; j < pieces.size(); ++j) {
+            CPPUNIT_ASSERT(pieces[j].mTa <= pieces[j].mTb);
+            if (j > 0) {
+                CPPUNIT_ASSERT_EQUAL(pieces[j - 1].mTb, pieces[j].mTa);
+            }
+        }
+    }
+
+    // early out
+    int calls = 0;
+    majorantGrid.traverse(Vec3f(-2.0f, 1.0f, 3.0f), Vec3f(1.0f, 0.0f, 0.0f), 0.0f, 20.0f,
+        [&](float, float, const geom::internal::MajorantGrid::Cell&) {
+            ++calls;
+            return false;
+        });
+    CPPUNIT_ASSERT_EQUAL(1, calls);
+}
+
+void TestMajorantGrid::testBounds()
+{
+    RNG rng;
+    openvdb::FloatGrid::Ptr densityGrid = createDensityGrid(rng);
+    openvdb::Vec3SGrid::Ptr bakedDensityGrid = createBakedDensityGrid(rng);
+    geom::internal::MajorantGrid majorantGrid(*densityGrid, bakedDensityGrid.get(), Color(1.0f));
+
+    const geom::internal::GridSampler<openvdb::FloatGrid> densitySampler(*densityGrid);
+    const geom::internal::GridSampler<openvdb::Vec3SGrid> bakedDensitySampler(*bakedDensityGrid);
+
+    for (int i = 0; i < 1000; ++i) {
+        Vec3f org, dir;
+        randomRay(rng, org, dir);
+        for (const Piece& piece : traverse(majorantGrid, org, dir, 0.0f, 20.0f)) {
+            for (int j = 0; j < 4; ++j) {
+                const float t = lerp(piece.mTa, piece.mTb, rng.randomFloat());
+                const Vec3f p = org + t * dir;
+                const openvdb::Vec3d pd(p.x, p.y, p.z);
+                const float density = densitySampler.evalPoint(pd);
+                const openvdb::Vec3f baked = bakedDensitySampler.evalPoint(pd);
+                const Color sigmaT = density * Color(baked.x(), baked.y(), baked.z());
+                const Color residual = sigmaT - piece.mCell.mControl;
+                const float bound = piece.mCell.mResidualMajorant + 1e-4f;
+                CPPUNIT_ASSERT(scene_rdl2::math::abs(residual.r) <= bound);
+                CPPUNIT_ASSERT(scene_rdl2::math::abs(residual.g) <= bound);
+                CPPUNIT_ASSERT(scene_rdl2::math::abs(residual.b) <= bound);
+            }
+        }
+    }
+}
+
+} // namespace unittest
+} // namespace geom
+} // namespace moonray
+
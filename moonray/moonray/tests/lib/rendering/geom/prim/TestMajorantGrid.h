@@ -0,0 +1,37 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TestMajorantGrid.h
+///
+
+#pragma once
+#include "TestPrimUtils.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace moonray {
+namespace geom {
+namespace unittest {
+
+class TestMajorantGrid : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    CPPUNIT_TEST_SUITE(TestMajorantGrid);
+    CPPUNIT_TEST(testCoverage);
+    CPPUNIT_TEST(testBounds);
+    CPPUNIT_TEST_SUITE_END();
+
+    // traversal pieces are contiguous and cover the whole segment
+    void testCoverage();
+    // point lookups of density * baked density stay within the
+    // cell's control +/- residual majorant
+    void testBounds();
+};
+
+} // namespace unittest
+} // namespace geom
+} // namespace moonray
+
@@ -0,0 +1,167 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TestTessellationCache.cc
+///
+
+#include "TestTessellationCache.h"
+
+#include <moonray/rendering/geom/prim/TessellationCache.h>
+#include <moonray/rendering/geom/internal/InterleavedTraits.h>
+#include <scene_rdl2/common/math/Vec3fa.h>
+
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+namespace moonray {
+namespace geom {
+namespace unittest {
+
+using geom::internal::TessellationCache;
+using scene_rdl2::math::Vec3fa;
+
+namespace {
+
+typedef VertexBuffer<Vec3fa, InterleavedTraits> Vec3faBuffer;
+
+std::string
+hashOf(const std::vector<uint32_t>& indices, const Vec3faBuffer& vertices)
+{
+    TessellationCache::Hasher hasher;
+    hasher.add(indices);
+    hasher.add(vertices);
+    return hasher.getKey();
+}
+
+Vec3faBuffer
+createVertices()
+{
+    Vec3faBuffer vertices(5, 2);
+    for (size_t t = 0; t < 2; ++t) {
+        for (size_t i = 0; i < 5; ++i) {
+            const float f = static_cast<float>(i);
+            vertices(i, t) = Vec3fa(f, 2.0f * f + t, -f, 0.0f);
+        }
+    }
+    return vertices;
+}
+
+} // anonymous namespace
+
+void TestTessellationCache::setUp()
+{
+    char tmpl[] = "/tmp/moonray_tessellation_cache_XXXXXX";
+    const char* dir = mkdtemp(tmpl);
+    CPPUNIT_ASSERT(dir != nullptr);
+    mDirectory = dir;
+}
+
+void TestTessellationCache::tearDown()
+{
+    if (DIR* dir = opendir(mDirectory.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                std::remove((mDirectory + "/" + name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(mDirectory.c_str());
+}
+
+void TestTessellationCache::testKey()
+{
+    std::vector<uint32_t> indices = { 0, 1, 2, 2, 3, 4 };
+    Vec3faBuffer vertices = createVertices();
+
+    const std::string key = hashOf(indices, vertices);
+    CPPUNIT_ASSERT_EQUAL(size_t(32), key.size());
+    CPPUNIT_ASSERT_EQUAL(key, hashOf(indices, vertices));
+
+    indices.back() = 0;
+    CPPUNIT_ASSERT(key != hashOf(indices, vertices));
+    indices.back() = 4;
+
+    vertices(3, 1).y += 1e-3f;
+    CPPUNIT_ASSERT(key != hashOf(indices, vertices));
+
+    // the same bytes split differently hash differently
+    TessellationCache::Hasher a;
+    a.add(std::vector<uint32_t>{ 1, 2 });
+    a.add(std::vector<uint32_t>{ 3 });
+    TessellationCache::Hasher b;
+    b.add(std::vector<uint32_t>{ 1 });
+    b.add(std::vector<uint32_t>{ 2, 3 });
+    CPPUNIT_ASSERT(a.getKey() != b.getKey());
+}
+
+void TestTessellationCache::testRoundTrip()
+{
+    const std::vector<uint32_t> indices = { 0, 1, 2, 2, 3, 4, 7 };
+    const Vec3faBuffer vertices = createVertices();
+    const std::vector<float> empty;
+
+    TessellationCache cache(mDirectory);
+    const std::string key = hashOf(indices, vertices);
+    cache.store(key, [&](TessellationCache::Writer& writer) {
+        writer.write(vertices);
+        writer.write(indices);
+        writer.write(empty);
+    });
+    CPPUNIT_ASSERT_EQUAL(size_t(1), cache.getStoreCount());
+
+    std::unique_ptr<TessellationCache::Reader> reader = cache.load(key);
+    CPPUNIT_ASSERT(reader);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), cache.getHitCount());
+
+    Vec3faBuffer loadedVertices;
+    std::vector<uint32_t> loadedIndices;
+    std::vector<float> loadedEmpty = { 1.0f };
+    CPPUNIT_ASSERT(reader->read(loadedVertices));
+    CPPUNIT_ASSERT(reader->read(loadedIndices));
+    CPPUNIT_ASSERT(reader->read(loadedEmpty));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reader->peekSize());
+
+    CPPUNIT_ASSERT(loadedIndices == indices);
+    CPPUNIT_ASSERT(loadedEmpty.empty());
+    CPPUNIT_ASSERT_EQUAL(vertices.size(), loadedVertices.size());
+    CPPUNIT_ASSERT_EQUAL(vertices.get_time_steps(), loadedVertices.get_time_steps());
+    for (size_t t = 0; t < vertices.get_time_steps(); ++t) {
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            CPPUNIT_ASSERT(vertices(i, t) == loadedVertices(i, t));
+        }
+    }
+}
+
+void TestTessellationCache::testMiss()
+{
+    TessellationCache cache(mDirectory);
+    CPPUNIT_ASSERT(!cache.load("0123456789abcdef0123456789abcdef"));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), cache.getMissCount());
+
+    const std::vector<uint32_t> indices = { 0, 1, 2 };
+    cache.store("entry", [&](TessellationCache::Writer& writer) {
+        writer.write(indices);
+    });
+    std::unique_ptr<TessellationCache::Reader> reader = cache.load("entry");
+    CPPUNIT_ASSERT(reader);
+    // reading the blob as the wrong size fails without consuming it
+    uint32_t tooSmall[2];
+    CPPUNIT_ASSERT(!reader->read(tooSmall, sizeof(tooSmall)));
+    Vec3faBuffer vertices;
+    CPPUNIT_ASSERT(!reader->read(vertices));
+    cache.rejected();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), cache.getHitCount());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), cache.getMissCount());
+}
+
+} // namespace unittest
+} // namespace geom
+} // namespace moonray
+
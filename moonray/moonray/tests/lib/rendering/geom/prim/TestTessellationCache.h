@@ -0,0 +1,43 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TestTessellationCache.h
+///
+
+#pragma once
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+
+namespace moonray {
+namespace geom {
+namespace unittest {
+
+class TestTessellationCache : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    CPPUNIT_TEST_SUITE(TestTessellationCache);
+    CPPUNIT_TEST(testKey);
+    CPPUNIT_TEST(testRoundTrip);
+    CPPUNIT_TEST(testMiss);
+    CPPUNIT_TEST_SUITE_END();
+
+    // keys are deterministic and change with any input
+    void testKey();
+    // stored blobs read back unchanged and in order
+    void testRoundTrip();
+    // missing entries and mismatched reads are reported
+    void testMiss();
+
+private:
+    std::string mDirectory;
+};
+
+} // namespace unittest
+} // namespace geom
+} // namespace moonray
+
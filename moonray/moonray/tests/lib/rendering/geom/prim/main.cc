@@ -3,6 +3,8 @@
 
 #include "TestPrimAttr.h"
 #include "TestInterpolator.h"
+#include "TestMajorantGrid.h"
+#include "TestTessellationCache.h"
 #include <moonray/rendering/mcrt_common/ThreadLocalState.h>
 #include <scene_rdl2/pdevunit/pdevunit.h>
 #include <tbb/task_scheduler_init.h>
@@ -21,6 +23,8 @@ main(int argc, char *argv[])
 
     CPPUNIT_TEST_SUITE_REGISTRATION(moonray::geom::unittest::TestRenderingPrimAttr);
     CPPUNIT_TEST_SUITE_REGISTRATION(moonray::geom::unittest::TestInterpolator);
+    CPPUNIT_TEST_SUITE_REGISTRATION(moonray::geom::unittest::TestMajorantGrid);
+    CPPUNIT_TEST_SUITE_REGISTRATION(moonray::geom::unittest::TestTessellationCache);
 
     int result = pdevunit::run(argc, argv);
     moonray::mcrt_common::cleanUpTLS();
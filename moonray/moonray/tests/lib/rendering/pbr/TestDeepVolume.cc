@@ -0,0 +1,152 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TestDeepVolume.cc
+/// $Id$
+///
+
+#include "TestDeepVolume.h"
+
+#include <moonray/rendering/pbr/Types.h>
+
+#include <scene_rdl2/common/math/Color.h>
+
+#include <algorithm>
+#include <vector>
+
+
+namespace moonray {
+namespace pbr {
+
+
+using namespace scene_rdl2::math;
+
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+// Radiance samples of the hard surface path, e.g. direct lighting, emission
+// and a bounce. Scalar mode renders them without the volume in front.
+const std::vector<Color> sSurfaceRadiance = {
+    Color(0.5f, 0.25f, 0.125f),
+    Color(0.0625f, 0.5f, 0.25f),
+    Color(0.25f, 0.125f, 0.75f)
+};
+
+const Color sVolumeTransmittance(0.5f, 0.25f, 0.8f);
+const Color sVolumeRadiance(0.1f, 0.2f, 0.05f);
+
+void
+initVolume(DeepVolumeData &deepVolumeData, const Color &transmittance, const Color &radiance)
+{
+    deepVolumeData.init();
+    deepVolumeData.mHitVolume = 1;
+    deepVolumeData.mTransmittance = transmittance;
+    deepVolumeData.mRadiance = radiance;
+}
+
+// Sums the hard surface deep samples of the vector mode path, in the given
+// order. The volume radiance is added to the path at the hit, i.e. to the
+// first of its radiance samples.
+Color
+vectorDeepSample(DeepVolumeData &deepVolumeData, const std::vector<unsigned> &order)
+{
+    Color deepSample(0.f);
+    for (unsigned i : order) {
+        Color radiance = sSurfaceRadiance[i] * deepVolumeData.mTransmittance;
+        if (i == 0) {
+            radiance += deepVolumeData.mRadiance;
+        }
+        float vals[3] = { radiance.r, radiance.g, radiance.b };
+        deepVolumeData.removeFromRadiance(vals);
+        deepSample += Color(vals[0], vals[1], vals[2]);
+    }
+    return deepSample;
+}
+
+void
+checkColor(const Color &expected, const Color &actual)
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.r, actual.r, 1e-5f);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.g, actual.g, 1e-5f);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.b, actual.b, 1e-5f);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+void
+TestDeepVolume::testHardSurfaceSample()
+{
+    Color scalarDeepSample(0.f);
+    for (const Color &radiance : sSurfaceRadiance) {
+        scalarDeepSample += radiance;
+    }
+
+    // Film gets the radiance samples of a path in any order.
+    std::vector<unsigned> order = { 0, 1, 2 };
+    do {
+        DeepVolumeData deepVolumeData;
+        initVolume(deepVolumeData, sVolumeTransmittance, sVolumeRadiance);
+        const Color deepSample = vectorDeepSample(deepVolumeData, order);
+        checkColor(scalarDeepSample, deepSample);
+
+        // Compositing the volume segment over the hard surface must give the
+        // flat beauty, which has the transmittance applied once.
+        const Color flat = sVolumeRadiance + sVolumeTransmittance * scalarDeepSample;
+        checkColor(flat, sVolumeRadiance + sVolumeTransmittance * deepSample);
+    } while (std::next_permutation(order.begin(), order.end()));
+}
+
+void
+TestDeepVolume::testNoVolume()
+{
+    DeepVolumeData deepVolumeData;
+    deepVolumeData.init();
+
+    float vals[3] = { 0.5f, 0.25f, 0.125f };
+    deepVolumeData.removeFromRadiance(vals);
+    checkColor(Color(0.5f, 0.25f, 0.125f), Color(vals[0], vals[1], vals[2]));
+    CPPUNIT_ASSERT(deepVolumeData.mRadianceRemoved == 0);
+    CPPUNIT_ASSERT_EQUAL(0.75f, deepVolumeData.removeTransmittance(0.75f, 1));
+}
+
+void
+TestDeepVolume::testOpaqueVolume()
+{
+    // Nothing of the surface shows through a channel of zero transmittance,
+    // there is nothing to recover there.
+    DeepVolumeData deepVolumeData;
+    initVolume(deepVolumeData, Color(0.5f, 0.f, 0.25f), sVolumeRadiance);
+
+    const Color radiance = Color(0.5f, 0.25f, 0.125f) * deepVolumeData.mTransmittance + sVolumeRadiance;
+    float vals[3] = { radiance.r, radiance.g, radiance.b };
+    deepVolumeData.removeFromRadiance(vals);
+    checkColor(Color(0.5f, 0.f, 0.125f), Color(vals[0], vals[1], vals[2]));
+}
+
+void
+TestDeepVolume::testLightAov()
+{
+    // Light aovs have the transmittance, but not the volume radiance.
+    DeepVolumeData deepVolumeData;
+    initVolume(deepVolumeData, sVolumeTransmittance, sVolumeRadiance);
+
+    const Color aov(0.5f, 0.25f, 0.125f);
+    const Color vectorAov = aov * sVolumeTransmittance;
+    checkColor(aov, Color(deepVolumeData.removeTransmittance(vectorAov.r, 0),
+                          deepVolumeData.removeTransmittance(vectorAov.g, 1),
+                          deepVolumeData.removeTransmittance(vectorAov.b, 2)));
+    CPPUNIT_ASSERT(deepVolumeData.mRadianceRemoved == 0);
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace pbr
+} // namespace moonray
+
+CPPUNIT_TEST_SUITE_REGISTRATION(moonray::pbr::TestDeepVolume);
+
@@ -0,0 +1,46 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+///
+/// @file TestDeepVolume.h
+/// $Id$
+///
+
+#pragma once
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+namespace moonray {
+namespace pbr {
+
+//----------------------------------------------------------------------------
+
+///
+/// @class TestDeepVolume TestDeepVolume.h <pbr/TestDeepVolume.h>
+/// @brief Checks that the vector mode deep sample of a hard surface behind a
+/// volume matches the scalar mode one, which is rendered without the volume.
+///
+class TestDeepVolume : public CppUnit::TestFixture
+{
+public:
+    CPPUNIT_TEST_SUITE(TestDeepVolume);
+#if 1
+    CPPUNIT_TEST(testHardSurfaceSample);
+    CPPUNIT_TEST(testNoVolume);
+    CPPUNIT_TEST(testOpaqueVolume);
+    CPPUNIT_TEST(testLightAov);
+#endif
+    CPPUNIT_TEST_SUITE_END();
+
+    void testHardSurfaceSample();
+    void testNoVolume();
+    void testOpaqueVolume();
+    void testLightAov();
+};
+
+//----------------------------------------------------------------------------
+
+} // namespace pbr
+} // namespace moonray
+
@@ -170,6 +170,8 @@ TestDistribution::testImage(const std::string &path, const std::string &filename
 
         CPPUNIT_ASSERT(equal);
 
+        testCosineProduct(dist);
+
     } catch (std::exception &e) {
         std::cout << "Error: " << e.what() << std::endl;
         CPPUNIT_ASSERT(0);
@@ -178,6 +180,53 @@ TestDistribution::testImage(const std::string &path, const std::string &filename
 }
 
 
+void
+TestDistribution::testCosineProduct(const ImageDistribution &dist)
+{
+    CosineProductDistribution product(dist, false);
+    const uint32_t sizeU = product.getSizeU();
+    const uint32_t sizeV = product.getSizeV();
+
+    static const int maxPower = 10;
+    uint32_t size = 1 << maxPower;
+    FloatArray r1, r2;
+    generate2DSequence(size, r1, r2);
+
+    for (int bin = 0; bin < COSINE_PRODUCT_NORMAL_BINS * COSINE_PRODUCT_NORMAL_BINS; ++bin) {
+        if (!product.canSample(bin)) {
+            continue;
+        }
+
+        // The pdf integrates to one over the image
+        double integral = 0.0;
+        for (uint32_t y = 0; y < sizeV; ++y) {
+            for (uint32_t x = 0; x < sizeU; ++x) {
+                integral += product.pdf(bin, (x + 0.5f) / sizeU, (y + 0.5f) / sizeV);
+            }
+        }
+        integral /= double(sizeU) * double(sizeV);
+        CPPUNIT_ASSERT(isEqual(float(integral), 1.0f, 1e-3f));
+
+        // The sampled pdf is the one returned by pdf(), except on texel
+        // boundaries where rounding may move the sample to a neighbor texel
+        FloatArray u(size), v(size);
+        for (uint32_t i = 0; i < size; ++i) {
+            Vec2f uv;
+            float pdf;
+            product.sample(bin, r1[i], r2[i], &uv, &pdf);
+            CPPUNIT_ASSERT(isEqual(pdf, product.pdf(bin, uv.x, uv.y), pdf * 1e-3f) ||
+                           uv.x * sizeU - floor(uv.x * sizeU) < 1e-3f ||
+                           uv.y * sizeV - floor(uv.y * sizeV) < 1e-3f);
+            u[i] = uv.x;
+            v[i] = uv.y;
+        }
+
+        CPPUNIT_ASSERT(asCppBool(ispc::sampleCosineProductDistribution(product.asIspc(), bin, size,
+                &(r1[0]), &(r2[0]), &(u[0]), &(v[0]))));
+    }
+}
+
+
 void
 TestDistribution::testImages()
 {
@@ -17,6 +17,8 @@
 namespace moonray {
 namespace pbr {
 
+class ImageDistribution;
+
 
 //----------------------------------------------------------------------------
 
@@ -43,6 +45,7 @@ public:
 
 private:
     void testImage(const std::string &path, const std::string &filename);
+    void testCosineProduct(const ImageDistribution &dist);
 };
 
 
@@ -2,9 +2,18 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "TestLightTree.h"
+#include "TestUtil.h"
 
+#include <moonray/rendering/pbr/light/LightTree.h>
 #include <moonray/rendering/pbr/light/LightTreeUtil.h>
 #include <moonray/rendering/pbr/light/LightTreeUtil.cc>
+#include <moonray/rendering/pbr/light/SphereLight.h>
+
+#include <scene_rdl2/scene/rdl2/rdl2.h>
+
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace moonray {
 namespace pbr {
@@ -29,6 +38,16 @@ static void printCone(const char* nameOfCone, const LightTreeCone& cone)
               << ", mTwoSided: " << cone.mTwoSided << ")\n";
 }
 
+void TestLightTree::setUp()
+{
+    setupThreadLocalData();
+}
+
+void TestLightTree::tearDown()
+{
+    cleanupThreadLocalData();
+}
+
 void TestLightTree::testCone()
 {
     fprintf(stderr, "=========================== Testing LightTree Cone ==============================\n");
@@ -107,6 +126,123 @@ void TestLightTree::testCone()
     }
 }
 
+void TestLightTree::testSelectionCache()
+{
+    fprintf(stderr, "====================== Testing LightTree Selection Cache ========================\n");
+    LightSelectionCache cache;
+    cache.startFrame(BBox3f(Vec3f(0.f), Vec3f(10.f)), true);
+    CPPUNIT_ASSERT(cache.isEnabled());
+    CPPUNIT_ASSERT(!cache.canSample());
+
+    const Vec3f n(0.f, 1.f, 0.f);
+    const LightSelectionCache::Cell cell(&cache, nullptr, Vec3f(1.f, 1.f, 1.f), &n);
+    const LightSelectionCache::Cell nearbyCell(&cache, nullptr, Vec3f(1.01f, 1.f, 1.f), &n);
+    const LightSelectionCache::Cell farCell(&cache, nullptr, Vec3f(9.f, 9.f, 9.f), &n);
+
+    // node 1 is always occluded, node 2 never is
+    for (int i = 0; i < 16; ++i) {
+        cell.recordNode(1, 1.f, 0.f);
+        cell.recordNode(2, 1.f, 1.f);
+    }
+
+    // nothing is learned until the pass is over
+    CPPUNIT_ASSERT(equal(cell.getNodeWeight(1), 1.f));
+    cache.passReset();
+    CPPUNIT_ASSERT(cache.canSample());
+
+    std::cerr << "occluded node weight: " << cell.getNodeWeight(1) << "\n";
+    CPPUNIT_ASSERT(cell.getNodeWeight(1) > 0.f);
+    CPPUNIT_ASSERT(cell.getNodeWeight(1) < 0.1f);
+    CPPUNIT_ASSERT(equal(cell.getNodeWeight(2), 1.f));
+    CPPUNIT_ASSERT(equal(nearbyCell.getNodeWeight(1), cell.getNodeWeight(1)));
+
+    // unknown nodes and cells keep their importance
+    CPPUNIT_ASSERT(equal(cell.getNodeWeight(3), 1.f));
+    CPPUNIT_ASSERT(equal(farCell.getNodeWeight(1), 1.f));
+
+    // the next pass only sees what was recorded during this one
+    cache.passReset();
+    CPPUNIT_ASSERT(equal(cell.getNodeWeight(1), 1.f));
+}
+
+void TestLightTree::testSamplePmf()
+{
+    fprintf(stderr, "========================= Testing LightTree Sample Pmf ==========================\n");
+
+    // a row of sphere lights of varying size and brightness, above a cluster of smaller lights
+    scene_rdl2::rdl2::SceneContext context;
+    std::vector<std::unique_ptr<Light>> lights;
+    std::vector<const Light*> lightPtrs;
+    for (int i = 0; i < 12; ++i) {
+        const Vec3f position = i < 8  ?  Vec3f(3.f * i - 10.f, 5.f, 0.5f * i)  :
+                                         Vec3f(0.3f * i, -2.f, 4.f - 0.2f * i);
+        const Mat4f xform = Mat4f::translate(Vec4f(position.x, position.y, position.z, 0.f));
+        const Color color = Color(1.f + 0.5f * i);
+        const std::string name = "SphereLight" + std::to_string(i);
+        lights.emplace_back(new SphereLight(makeSphereLightSceneObject(name.c_str(), &context, xform, color,
+                                                                       0.1f + 0.05f * i, nullptr, false)));
+        lights.back()->update(Mat4d(one));
+        lightPtrs.push_back(lights.back().get());
+    }
+    const int lightCount = static_cast<int>(lightPtrs.size());
+
+    const Vec3f points[] = { Vec3f(0.f, 0.f, 0.f), Vec3f(-8.f, 4.f, 1.f), Vec3f(2.f, -1.5f, 2.5f) };
+    const Vec3f normal(0.f, 1.f, 0.f);
+    const float thresholds[] = { 0.f, 0.5f, 1.f };
+    const int sampleCount = 20000;
+
+    std::vector<int> chosen(lightCount);
+    std::vector<float> pmfs(lightCount);
+    for (const float threshold : thresholds) {
+        LightTree tree(/* sceneDiameter */ 40.f, threshold);
+        tree.build(lightPtrs.data(), lightCount, nullptr, 0);
+        CPPUNIT_ASSERT(!tree.isEmpty());
+        CPPUNIT_ASSERT(tree.getBoundedLightCount() == static_cast<unsigned>(lightCount));
+
+        for (const Vec3f& p : points) {
+            for (const Vec3f* n : { static_cast<const Vec3f*>(nullptr), &normal }) {
+                std::cerr << "---- threshold " << threshold << ", p (" << p.x << ", " << p.y << ", " << p.z
+                          << ")" << (n  ?  ", with normal"  :  "") << " ----\n";
+
+                // Without splitting, a single light is chosen with probability one
+                if (threshold == 0.f) {
+                    float pmfSum = 0.f;
+                    for (int l = 0; l < lightCount; ++l) {
+                        pmfSum += tree.getPmf(p, n, l);
+                    }
+                    std::cerr << "pmf sum: " << pmfSum << "\n";
+                    CPPUNIT_ASSERT(scene_rdl2::math::abs(pmfSum - 1.f) < 1e-5f);
+                }
+
+                // The pmf returned by sample() is the one getPmf() computes, and it is
+                // the frequency at which sample() chooses the light
+                std::vector<int> counts(lightCount, 0);
+                for (int s = 0; s < sampleCount; ++s) {
+                    const float u = (s + 0.5f) / sampleCount;
+                    const int choiceCount = tree.sample(p, n, u, chosen.data(), pmfs.data());
+                    CPPUNIT_ASSERT(choiceCount >= 1 && choiceCount <= lightCount);
+                    for (int c = 0; c < choiceCount; ++c) {
+                        const int l = chosen[c];
+                        CPPUNIT_ASSERT(l >= 0 && l < lightCount);
+                        CPPUNIT_ASSERT(pmfs[c] > 0.f);
+                        CPPUNIT_ASSERT(scene_rdl2::math::abs(pmfs[c] - tree.getPmf(p, n, l)) < 1e-5f);
+                        ++counts[l];
+                    }
+                }
+                for (int l = 0; l < lightCount; ++l) {
+                    const float frequency = float(counts[l]) / sampleCount;
+                    const float pmf = tree.getPmf(p, n, l);
+                    CPPUNIT_ASSERT(scene_rdl2::math::abs(frequency - pmf) < 1e-3f);
+                    // splitting every node chooses every light that can contribute
+                    if (threshold == 1.f) {
+                        CPPUNIT_ASSERT(pmf == 0.f || pmf == 1.f);
+                    }
+                }
+            }
+        }
+    }
+}
+
 }
 }
 CPPUNIT_TEST_SUITE_REGISTRATION(moonray::pbr::TestLightTree);
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <moonray/rendering/pbr/light/LightSelectionCache.h>
 #include <moonray/rendering/pbr/light/LightTreeUtil.h>
 
 #include <cppunit/extensions/HelperMacros.h>
@@ -18,11 +19,18 @@ class TestLightTree : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE(TestLightTree);
 
     CPPUNIT_TEST(testCone);
+    CPPUNIT_TEST(testSelectionCache);
+    CPPUNIT_TEST(testSamplePmf);
 
     CPPUNIT_TEST_SUITE_END();
 
 public:
+    void setUp();
+    void tearDown();
+
     void testCone();
+    void testSelectionCache();
+    void testSamplePmf();
 };
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestSnapshotDeltaUntiled.h"
+#include <moonray/rendering/rndr/RenderDriver.h>
+
+#include <vector>
+
+namespace moonray {
+namespace rndr {
+namespace unittest {
+
+namespace {
+
+using scene_rdl2::fb_util::FloatBuffer;
+using scene_rdl2::fb_util::RenderBuffer;
+using scene_rdl2::fb_util::RenderColor;
+using scene_rdl2::fb_util::Tiler;
+
+// not a multiple of the 8x8 tile size, so the last tile row and column are partial
+constexpr unsigned sWidth = 37;
+constexpr unsigned sHeight = 21;
+
+// Adds a sample to the tiled film buffers at pixel (x, y)
+void addSample(const Tiler& tiler, RenderBuffer& film, FloatBuffer& filmWeight,
+               unsigned x, unsigned y, const RenderColor& color)
+{
+    const unsigned offset = tiler.linearCoordsToTiledOffset(x, y);
+    film.getData()[offset] += color;
+    filmWeight.getData()[offset] += 1.f;
+}
+
+// Full resolve : normalizes and untiles every pixel of the film buffers
+void fullResolve(const Tiler& tiler, const RenderBuffer& film, const FloatBuffer& filmWeight,
+                 RenderBuffer& out)
+{
+    out.init(sWidth, sHeight);
+    for (unsigned y = 0; y < sHeight; ++y) {
+        for (unsigned x = 0; x < sWidth; ++x) {
+            const unsigned offset = tiler.linearCoordsToTiledOffset(x, y);
+            const float weight = filmWeight.getData()[offset];
+            out.getRow(y)[x] = (weight > 0.f) ?
+                film.getData()[offset] * (1.f / weight) :
+                RenderColor(scene_rdl2::math::zero);
+        }
+    }
+}
+
+bool equal(const RenderBuffer& a, const RenderBuffer& b)
+{
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()) return false;
+    for (unsigned y = 0; y < a.getHeight(); ++y) {
+        for (unsigned x = 0; x < a.getWidth(); ++x) {
+            if (!(a.getRow(y)[x] == b.getRow(y)[x])) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void
+TestSnapshotDeltaUntiled::testPartialUpdate()
+{
+    const Tiler tiler(sWidth, sHeight);
+    const unsigned numTilesX = tiler.mAlignedW >> 3;
+
+    RenderBuffer film;
+    FloatBuffer filmWeight;
+    film.init(tiler.mAlignedW, tiler.mAlignedH);
+    filmWeight.init(tiler.mAlignedW, tiler.mAlignedH);
+    film.clear();
+    filmWeight.clear();
+
+    // the first pass leaves a few pixels without samples
+    for (unsigned y = 0; y < sHeight; ++y) {
+        for (unsigned x = 0; x < sWidth; ++x) {
+            if ((x + y * 5) % 11 == 0) continue;
+            addSample(tiler, film, filmWeight, x, y,
+                      RenderColor(float(x), float(y), float(x ^ y), 1.f));
+        }
+    }
+
+    // persistent state of the incremental resolve, like hdMoonray keeps it between resolves
+    RenderBuffer output;
+    RenderBuffer tiledCopy;
+    FloatBuffer tiledWeight;
+    std::vector<unsigned> updatedTiles;
+    RenderBuffer reference;
+
+    // the first call updates everything
+    RenderDriver::snapshotDeltaUntiledTiles(tiler, sWidth, sHeight, film, filmWeight,
+                                            &output, &tiledCopy, &tiledWeight, updatedTiles, true);
+    CPPUNIT_ASSERT(updatedTiles.size() == tiler.mNumTiles);
+    fullResolve(tiler, film, filmWeight, reference);
+    CPPUNIT_ASSERT(equal(output, reference));
+
+    // nothing changed
+    RenderDriver::snapshotDeltaUntiledTiles(tiler, sWidth, sHeight, film, filmWeight,
+                                            &output, &tiledCopy, &tiledWeight, updatedTiles, true);
+    CPPUNIT_ASSERT(updatedTiles.empty());
+    CPPUNIT_ASSERT(equal(output, reference));
+
+    // Partial tile updates : a single pixel of an inner tile, a whole row of another one,
+    // and the bottom right tile which is partially outside of the image.
+    addSample(tiler, film, filmWeight, 10, 9, RenderColor(0.5f, 0.25f, 0.125f, 1.f));
+    for (unsigned x = 24; x < 32; ++x) {
+        addSample(tiler, film, filmWeight, x, 3, RenderColor(2.f, 4.f, 8.f, 0.5f));
+    }
+    addSample(tiler, film, filmWeight, sWidth - 1, sHeight - 1, RenderColor(1.f, 1.f, 1.f, 1.f));
+    const std::vector<unsigned> changedTiles = {
+        (3 / 8) * numTilesX + 24 / 8,
+        (9 / 8) * numTilesX + 10 / 8,
+        ((sHeight - 1) / 8) * numTilesX + (sWidth - 1) / 8
+    };
+
+    // unchanged tiles are not touched by the incremental resolve
+    const RenderColor sentinel(-1.f, -1.f, -1.f, -1.f);
+    output.getRow(0)[0] = sentinel;
+
+    RenderDriver::snapshotDeltaUntiledTiles(tiler, sWidth, sHeight, film, filmWeight,
+                                            &output, &tiledCopy, &tiledWeight, updatedTiles, true);
+    CPPUNIT_ASSERT(updatedTiles == changedTiles);
+    CPPUNIT_ASSERT(output.getRow(0)[0] == sentinel);
+    output.getRow(0)[0] = reference.getRow(0)[0];
+
+    // the incrementally updated output matches a full resolve
+    fullResolve(tiler, film, filmWeight, reference);
+    CPPUNIT_ASSERT(equal(output, reference));
+
+    // and a full update from scratch
+    RenderBuffer fullOutput;
+    RenderBuffer fullTiledCopy;
+    FloatBuffer fullTiledWeight;
+    RenderDriver::snapshotDeltaUntiledTiles(tiler, sWidth, sHeight, film, filmWeight,
+                                            &fullOutput, &fullTiledCopy, &fullTiledWeight,
+                                            updatedTiles, false);
+    CPPUNIT_ASSERT(updatedTiles.size() == tiler.mNumTiles);
+    CPPUNIT_ASSERT(equal(output, fullOutput));
+}
+
+} // namespace unittest
+} // namespace rndr
+} // namespace moonray
@@ -0,0 +1,26 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace moonray {
+namespace rndr {
+namespace unittest {
+
+class TestSnapshotDeltaUntiled : public CppUnit::TestFixture
+{
+public:
+    void testPartialUpdate();
+
+    CPPUNIT_TEST_SUITE(TestSnapshotDeltaUntiled);
+    CPPUNIT_TEST(testPartialUpdate);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace rndr
+} // namespace moonray
@@ -0,0 +1,98 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestTileWorkQueue.h"
+#include <moonray/rendering/rndr/TileWorkQueue.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace moonray {
+namespace rndr {
+namespace unittest {
+
+namespace {
+
+constexpr unsigned sNumTiles = 997; // not a multiple of any group size
+constexpr unsigned sNumThreads = 8;
+
+std::vector<Pass> makePasses()
+{
+    // a coarse pass followed by fine passes of increasing size, so the passes
+    // end up with different numbers of tiles per group
+    std::vector<Pass> passes;
+    passes.push_back(Pass{0, 16, 0, 1});
+    passes.push_back(Pass{16, 64, 0, 1});
+    for (unsigned s = 1; s < 64; s *= 2) {
+        passes.push_back(Pass{0, 64, s, 2 * s});
+    }
+    return passes;
+}
+
+// Drains queue from sNumThreads threads and checks that every tile of every
+// pass was handed out exactly once.
+void checkDealOnce(TileWorkQueue& queue, unsigned numPasses)
+{
+    std::unique_ptr<std::atomic<unsigned>[]> dealt(new std::atomic<unsigned>[numPasses * sNumTiles]);
+    for (unsigned i = 0; i < numPasses * sNumTiles; ++i) {
+        dealt[i] = 0;
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < sNumThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            TileGroup group;
+            while (queue.getNextTileGroup(t, &group, 0)) {
+                for (unsigned i = group.mStartTileIdx; i < group.mEndTileIdx; ++i) {
+                    const unsigned tileIdx = group.getTileIdx(i);
+                    if (group.mPassIdx < numPasses && tileIdx < sNumTiles) {
+                        ++dealt[group.mPassIdx * sNumTiles + tileIdx];
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned i = 0; i < numPasses * sNumTiles; ++i) {
+        CPPUNIT_ASSERT_EQUAL(1u, dealt[i].load());
+    }
+}
+
+} // anonymous namespace
+
+void
+TestTileWorkQueue::testDealOnce()
+{
+    const std::vector<Pass> passes = makePasses();
+    TileWorkQueue queue;
+    queue.init(RenderMode::BATCH, sNumTiles, passes.size(), sNumThreads, passes.data());
+
+    for (int run = 0; run < 8; ++run) {
+        queue.reset();
+        checkDealOnce(queue, passes.size());
+    }
+}
+
+void
+TestTileWorkQueue::testDealOnceWorkStealing()
+{
+    const std::vector<Pass> passes = makePasses();
+    TileWorkQueue queue;
+    queue.init(RenderMode::BATCH, sNumTiles, passes.size(), sNumThreads, passes.data());
+    queue.setWorkStealing(true, nullptr);
+
+    for (int run = 0; run < 8; ++run) {
+        queue.reset();
+        checkDealOnce(queue, passes.size());
+    }
+}
+
+} // namespace unittest
+} // namespace rndr
+} // namespace moonray
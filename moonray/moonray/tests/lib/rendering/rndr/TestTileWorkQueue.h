@@ -0,0 +1,28 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace moonray {
+namespace rndr {
+namespace unittest {
+
+class TestTileWorkQueue : public CppUnit::TestFixture
+{
+public:
+    void testDealOnce();
+    void testDealOnceWorkStealing();
+
+    CPPUNIT_TEST_SUITE(TestTileWorkQueue);
+    CPPUNIT_TEST(testDealOnce);
+    CPPUNIT_TEST(testDealOnceWorkStealing);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace rndr
+} // namespace moonray
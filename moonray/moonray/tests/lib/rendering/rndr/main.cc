@@ -5,7 +5,9 @@
 #include "TestActivePixelMask.h"
 #include "TestCheckpoint.h"
 #include "TestOverlappingRegions.h"
+#include "TestSnapshotDeltaUntiled.h"
 #include "TestSocketStream.h"
+#include "TestTileWorkQueue.h"
 
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
@@ -20,6 +22,8 @@ main(int argc, char* argv[])
     CPPUNIT_TEST_SUITE_REGISTRATION(TestOverlappingRegions);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestCheckpoint);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestActivePixelMask);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestTileWorkQueue);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestSnapshotDeltaUntiled);
 
     return pdevunit::run(argc, argv);
 }
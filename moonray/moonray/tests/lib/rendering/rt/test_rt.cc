@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "test_rt.h"
+#include <moonray/rendering/rt/BVHBuildPlanner.h>
 #include <moonray/rendering/rt/EmbreeAccelerator.h>
 #include <moonray/rendering/rt/GeomContext.h>
 #include <moonray/rendering/geom/PrimitiveGroup.h>
@@ -523,3 +524,25 @@ void TestRenderingRT::testIntersectNestedInstances()
     CPPUNIT_ASSERT(correctRay14);
 }
 
+
+void TestRenderingRT::testBVHBuildPlanner()
+{
+    const BVHBuildPlanner offline(OptimizationTarget::HIGH_QUALITY_BVH_BUILD);
+    const BVHBuildPlanner interactive(OptimizationTarget::FAST_BVH_BUILD);
+    const size_t large = BVHBuildPlanner::sLargePrimitiveCount + 1;
+    const size_t manyRefs = BVHBuildPlanner::sHighRayLoadReferenceCount;
+
+    // dynamic geometry always gets the cheapest build
+    CPPUNIT_ASSERT(offline.planSceneBuildQuality(100, manyRefs, false) == RTC_BUILD_QUALITY_LOW);
+    CPPUNIT_ASSERT(interactive.planSceneBuildQuality(100, 1, false) == RTC_BUILD_QUALITY_LOW);
+
+    // static geometry gets a spatial split build unless it is large and
+    // not referenced often enough to pay for it
+    CPPUNIT_ASSERT(offline.planSceneBuildQuality(100, 1, true) == RTC_BUILD_QUALITY_HIGH);
+    CPPUNIT_ASSERT(offline.planSceneBuildQuality(large, 1, true) == RTC_BUILD_QUALITY_MEDIUM);
+    CPPUNIT_ASSERT(offline.planSceneBuildQuality(large, manyRefs, true) == RTC_BUILD_QUALITY_HIGH);
+
+    // interactive builds only pay for HIGH quality on heavily instanced geometry
+    CPPUNIT_ASSERT(interactive.planSceneBuildQuality(100, 1, true) == RTC_BUILD_QUALITY_MEDIUM);
+    CPPUNIT_ASSERT(interactive.planSceneBuildQuality(100, manyRefs, true) == RTC_BUILD_QUALITY_HIGH);
+}
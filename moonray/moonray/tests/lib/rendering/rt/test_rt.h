@@ -13,12 +13,14 @@ public:
     CPPUNIT_TEST(testIntersectPolygon);
     CPPUNIT_TEST(testIntersectInstances);
     CPPUNIT_TEST(testIntersectNestedInstances);
+    CPPUNIT_TEST(testBVHBuildPlanner);
     CPPUNIT_TEST_SUITE_END();
 
     void testRay();
     void testIntersectPolygon();
     void testIntersectInstances();
     void testIntersectNestedInstances();
+    void testBVHBuildPlanner();
 };
 
 
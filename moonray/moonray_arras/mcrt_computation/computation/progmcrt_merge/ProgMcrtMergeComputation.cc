@@ -11,6 +11,7 @@
 
 #include <mcrt_dataio/engine/mcrt/McrtControl.h>
 #include <mcrt_dataio/engine/merger/FbMsgSingleFrame.h>
+#include <mcrt_dataio/share/codec/BuffCompressor.h>
 #include <mcrt_messages/CreditUpdate.h>
 #include <mcrt_messages/ProgressiveFeedback.h>
 #include <mcrt_messages/ProgressiveFrame.h>
@@ -133,6 +134,20 @@ ProgMcrtMergeComputation::configure(const std::string& op,
         }
     }
 
+    if (aConfig["compression"].isBool()) {
+        mCompression = aConfig["compression"].asBool();
+        if (mCompression) {
+            ARRAS_LOG_INFO("ProgressiveFrame compression on");
+        }
+    }
+    if (aConfig[mcrt_dataio::BuffCompressor::sClientDecodeConfigKey].isBool()) {
+        mClientDecodeCompressed = aConfig[mcrt_dataio::BuffCompressor::sClientDecodeConfigKey].asBool();
+    }
+    if (mCompression && !mClientDecodeCompressed) {
+        ARRAS_LOG_WARN("ProgressiveFrame compression is requested but the client does not advertise"
+                       " compressed buffer decode support. Image buffers are sent uncompressed");
+    }
+
     if (aConfig["initialCredit"].isIntegral()) {
         mInitialCredit = aConfig["initialCredit"].asInt();
     }
@@ -701,6 +716,8 @@ ProgMcrtMergeComputation::sendProgressiveFrame(std::vector<std::string>& infoDat
     //------------------------------
 
     mFbSender.setPrecisionControl(mPackTilePrecisionMode);
+    mFbSender.setCompression(mCompression);
+    mFbSender.setClientDecodeCompressed(mClientDecodeCompressed);
 
     mFbSender.addBeautyBuff(frameMsg);
 
@@ -729,9 +746,13 @@ ProgMcrtMergeComputation::sendProgressiveFrame(std::vector<std::string>& infoDat
 
     //------------------------------
 
+    size_t imageRawByte, imageCompressedByte;
+    float encodeSec;
+    mFbSender.takeCompressionStat(imageRawByte, imageCompressedByte, encodeSec);
+
     ARRAS_LOG_DEBUG("Sending ProgressiveFrame");
     for (int i = 0; i < mSendDup; ++i) {
-        sendBpsUpdate(frameMsg->serializedLength());
+        sendBpsUpdate(frameMsg->serializedLength(), imageRawByte, imageCompressedByte, encodeSec);
         send(frameMsg, arras4::api::withSource(mSource));
         if (mCredit > 0) mCredit--;
     }
@@ -991,9 +1012,14 @@ ProgMcrtMergeComputation::recvBpsUpdate(mcrt::ProgressiveFrame::ConstPtr frameMs
 }
 
 void
-ProgMcrtMergeComputation::sendBpsUpdate(size_t messageSerializedByte)
+ProgMcrtMergeComputation::sendBpsUpdate(size_t messageSerializedByte,
+                                        size_t imageRawByte, size_t imageCompressedByte, float encodeSec)
 {
-    mSendBandwidthTracker.set(messageSerializedByte);
+    // Track the message size as if it was not compressed as well in order to
+    // report the compression ratio.
+    mSendBandwidthTracker.set(messageSerializedByte,
+                              messageSerializedByte - imageCompressedByte + imageRawByte,
+                              encodeSec);
 }
 
 uint64_t    
@@ -1116,6 +1142,17 @@ ProgMcrtMergeComputation::parserConfigureDebugCommand()
                [&](Arg& arg) -> bool {
                    return mFbMsgMultiFrames->getDisplayFbMsgSingleFrame()->getParser().main(arg.childArg());
                });
+    parser.opt("compression", "<on|off|show>",
+               "enable/disable lossless compression of ProgressiveFrame image buffers",
+               [&](Arg& arg) -> bool {
+                   if ((arg)() == "show") arg++;
+                   else                   mCompression = (arg++).as<bool>(0);
+                   return arg.msg(std::string("compression:") + str_util::boolStr(mCompression) +
+                                  " clientDecodeCompressed:" + str_util::boolStr(mClientDecodeCompressed) +
+                                  '\n');
+               });
+    parser.opt("sendBandwidth", "", "show send bandwidth info",
+               [&](Arg& arg) { return arg.msg(mSendBandwidthTracker.show() + '\n'); });
     parser.opt("numMachines", "", "show numMachines count",
                [&](Arg& arg) { return arg.msg(std::to_string(mNumMachines) + '\n'); });
 }
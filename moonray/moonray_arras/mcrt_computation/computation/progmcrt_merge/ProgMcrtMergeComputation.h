@@ -81,7 +81,8 @@ private:
 
     void updateNetIO();
     void recvBpsUpdate(mcrt::ProgressiveFrame::ConstPtr frameMsg);
-    void sendBpsUpdate(size_t messageSerializedByte);
+    void sendBpsUpdate(size_t messageSerializedByte,
+                       size_t imageRawByte = 0, size_t imageCompressedByte = 0, float encodeSec = 0.0f);
     void piggyBackInfo(std::vector<std::string>& infoDataArray);
     bool decodeMergeSendProgressiveFrame(std::vector<std::string>& infoDataArray);
     void sendProgressiveFrame(std::vector<std::string>& infoDataArray);
@@ -119,6 +120,8 @@ private:
     // for ProgressiveFrame message
     using PackTilePrecisionMode = mcrt_dataio::MergeFbSender::PrecisionControl;
     PackTilePrecisionMode mPackTilePrecisionMode {PackTilePrecisionMode::AUTO16};
+    bool mCompression {false}; // lossless compression stage on top of PackTiles encoding
+    bool mClientDecodeCompressed {false}; // client advertised compressed buffer decode support
     std::unique_ptr<mcrt_dataio::FbMsgMultiFrames> mFbMsgMultiFrames;
     scene_rdl2::grid_util::Fb mFb;   // for combine all MCRT result into one image
     mcrt_dataio::MergeFbSender mFbSender; // for ProgressiveFrame message
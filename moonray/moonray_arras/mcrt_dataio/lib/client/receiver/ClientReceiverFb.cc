@@ -11,7 +11,9 @@
 #include "TimingRecorderHydra.h"
 
 #include <mcrt_dataio/engine/merger/GlobalNodeInfo.h>
+#include <mcrt_dataio/share/codec/BuffCompressor.h>
 #include <mcrt_dataio/share/codec/InfoRec.h>
+#include <mcrt_dataio/share/util/BandwidthTracker.h>
 #include <mcrt_dataio/share/util/FpsTracker.h>
 #include <mcrt_dataio/share/util/MiscUtil.h>
 #include <mcrt_dataio/share/util/SysUsage.h>
@@ -22,6 +24,7 @@
 #include <scene_rdl2/render/util/StrUtil.h>
 
 #include <algorithm> // std::max()
+#include <atomic>
 #include <cstdlib> // getenv()
 #include <iomanip>
 #include <json/json.h>
@@ -312,6 +315,12 @@ private:
 
     uint64_t mRecvMsgSize {0};      // last message's size
 
+    // compression statistics of the last message. Updated by parallel buffer decoding
+    std::atomic<uint64_t> mRecvCompressedSize {0}; // total size of compressed buffers
+    std::atomic<uint64_t> mRecvRawSize {0};        // total size of compressed buffers after decompression
+    std::atomic<uint64_t> mRecvDecompressMicroSec {0};
+    BandwidthTracker mRecvBandwidthTracker {2.0f}; // keepInterval sec
+
     //------------------------------
 
     ClientReceiverStats mStats;
@@ -364,6 +373,8 @@ private:
     void updateNetIO();
 
     bool decodeProgressiveFrameBuff(const mcrt::BaseFrame::DataBuffer& buffer);
+    bool decodeCompressedProgressiveFrameBuff(const mcrt::BaseFrame::DataBuffer& buffer);
+    void updateRecvBandwidth();
     void decodeAuxInfo(const mcrt::BaseFrame::DataBuffer& buffer);
     void afterDecode(const CallBackGenericComment& callBackFuncForGenericComment);
     void processGenericComment(const CallBackGenericComment& callBackFuncForGenericComment);
@@ -569,6 +580,9 @@ ClientReceiverFb::Impl::decodeProgressiveFrame(const mcrt::ProgressiveFrame &mes
     // decode buffer data from message
     //
     mRecvMsgSize = 0;
+    mRecvCompressedSize = 0;
+    mRecvRawSize = 0;
+    mRecvDecompressMicroSec = 0;
     if (!doParallel) {
         for (const mcrt::BaseFrame::DataBuffer &buffer: message.mBuffers) {
             mRecvMsgSize += buffer.mDataLength;
@@ -598,6 +612,7 @@ ClientReceiverFb::Impl::decodeProgressiveFrame(const mcrt::ProgressiveFrame &mes
             if (error) return false;
         }
     }
+    updateRecvBandwidth();
     afterDecode(callBackFuncForGenericComment);
     return true;
 }
@@ -1735,6 +1750,10 @@ ClientReceiverFb::Impl::decodeProgressiveFrameBuff(const mcrt::BaseFrame::DataBu
 {
     if (!buffer.mDataLength) return true; // empty data somehow -> skip
 
+    if (buffer.mType == mcrt::BaseFrame::ENCODING_COMPRESSED) {
+        return decodeCompressedProgressiveFrameBuff(buffer);
+    }
+
     if (!std::strcmp(buffer.mName, "latencyLog")) {
         mLatencyLog.decode(buffer.mData.get(), buffer.mDataLength);
 
@@ -1991,6 +2010,41 @@ ClientReceiverFb::Impl::decodeProgressiveFrameBuff(const mcrt::BaseFrame::DataBu
     return true;
 }
 
+bool
+ClientReceiverFb::Impl::decodeCompressedProgressiveFrameBuff(const mcrt::BaseFrame::DataBuffer& buffer)
+//
+// Decompresses the buffer which is compressed by the back-end (see MergeFbSender::addImageBuffer())
+// and decodes it as a regular buffer. This function is called from multiple threads in parallel.
+//
+{
+    scene_rdl2::rec_time::RecTime recTime;
+    recTime.start();
+
+    std::string work;
+    if (!BuffCompressor::decompress(buffer.mData.get(), buffer.mDataLength, work)) {
+        std::cerr << ">> ClientReceiverFb.cc decompress failed. name:" << buffer.mName << '\n';
+        return false;
+    }
+
+    mRecvCompressedSize += buffer.mDataLength;
+    mRecvRawSize += work.size();
+    mRecvDecompressMicroSec += static_cast<uint64_t>(recTime.end() * 1000000.0f);
+
+    mcrt::BaseFrame::DataBuffer rawBuffer(mcrt::makeRefPtr(reinterpret_cast<uint8_t*>(&work[0])),
+                                          work.size(),
+                                          buffer.mName,
+                                          mcrt::BaseFrame::ENCODING_UNKNOWN);
+    return decodeProgressiveFrameBuff(rawBuffer);
+}
+
+void
+ClientReceiverFb::Impl::updateRecvBandwidth()
+{
+    mRecvBandwidthTracker.set(mRecvMsgSize,
+                              mRecvMsgSize - mRecvCompressedSize + mRecvRawSize,
+                              static_cast<float>(mRecvDecompressMicroSec) * 0.000001f);
+}
+
 void
 ClientReceiverFb::Impl::decodeAuxInfo(const mcrt::BaseFrame::DataBuffer& buffer)
 {
@@ -2513,6 +2567,8 @@ ClientReceiverFb::Impl::parserConfigure()
                     else mResetFbWithColorMode = (arg++).as<bool>(0);
                     return arg.fmtMsg("resetFbWithColMode %s\n", boolStr(mResetFbWithColorMode).c_str());
                 });
+    mParser.opt("recvBandwidth", "", "show receive bandwidth and decompression info",
+                [&](Arg& arg) { return arg.msg(mRecvBandwidthTracker.show() + '\n'); });
     mParser.opt("backendStat", "", "show backend computation status",
                 [&](Arg& arg) { return arg.msg(ClientReceiverFb::showBackendStat(getBackendStat()) + '\n'); });
     mParser.opt("timingAnalysis", "...command...", "timingAnalysis command",
@@ -3157,6 +3213,14 @@ ClientReceiverFb::showBackendStat(const BackendStat& stat)
     return "?";
 }
 
+// static function
+void
+ClientReceiverFb::advertiseDecodeCapability(arras4::api::ObjectRef mergeConfig)
+{
+    // decodeProgressiveFrameBuff() decompresses ENCODING_COMPRESSED buffers
+    mergeConfig[BuffCompressor::sClientDecodeConfigKey] = true;
+}
+
 void
 ClientReceiverFb::setTimingRecorderHydra(std::shared_ptr<TimingRecorderHydra> ptr)
 {
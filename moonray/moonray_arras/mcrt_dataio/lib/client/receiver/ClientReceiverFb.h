@@ -15,6 +15,7 @@
 #pragma once
 
 #include <mcrt_messages/ProgressiveFrame.h>
+#include <message_api/Object.h>
 #include <scene_rdl2/common/grid_util/Fb.h>
 #include <scene_rdl2/common/grid_util/LatencyLog.h>
 #include <scene_rdl2/common/grid_util/Parser.h>
@@ -1173,6 +1174,16 @@ public:
     /// Return string representation of BackendStat and this might be useful for message output
     static std::string showBackendStat(const BackendStat& stat);
 
+    /// @brief Advertise decode capabilities of this ClientReceiverFb to the merge computation
+    /// @param mergeConfig merge computation config of the session definition
+    ///
+    /// @detail
+    /// Call this for the merge computation config of the session definition before creating
+    /// the session. The merge computation only sends compressed image buffers
+    /// (mcrt::BaseFrame::ENCODING_COMPRESSED) to a client which advertises that it can decode
+    /// them, so older clients keep receiving uncompressed buffers.
+    static void advertiseDecodeCapability(arras4::api::ObjectRef mergeConfig);
+
     //------------------------------
 
     /// @brief Set TimingRecorderHydra data point for performance analysis for hdMoonray.
@@ -3,6 +3,8 @@
 
 #include "MergeFbSender.h"
 
+#include <mcrt_dataio/share/codec/BuffCompressor.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
 #include <scene_rdl2/common/grid_util/FbReferenceType.h>
 #include <scene_rdl2/common/grid_util/PackTiles.h>
 #include <scene_rdl2/common/grid_util/ProgressiveFrameBufferName.h>
@@ -111,10 +113,9 @@ MergeFbSender::addBeautyBuff(mcrt::BaseFrame::Ptr message)
               << std::endl;
     */
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastBeautyBufferSize,
-                       scene_rdl2::grid_util::ProgressiveFrameBufferName::Beauty,
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastBeautyBufferSize,
+                   scene_rdl2::grid_util::ProgressiveFrameBufferName::Beauty);
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_BEAUTY);
     mLatencyLog.addDataSize(mLastBeautyBufferSize);
 }
@@ -147,10 +148,9 @@ MergeFbSender::MergeFbSender::addBeautyBuffWithNumSample(mcrt::BaseFrame::Ptr me
     }
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ENCODE_END_BEAUTY_NUMSAMPLE);
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastBeautyBufferNumSampleSize,
-                       scene_rdl2::grid_util::ProgressiveFrameBufferName::Beauty,
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastBeautyBufferNumSampleSize,
+                   scene_rdl2::grid_util::ProgressiveFrameBufferName::Beauty);
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_BEAUTY_NUMSAMPLE);
     mLatencyLog.addDataSize(mLastBeautyBufferNumSampleSize);
 }
@@ -178,10 +178,9 @@ MergeFbSender::addPixelInfo(mcrt::BaseFrame::Ptr message)
     }
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ENCODE_END_PIXELINFO);
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastPixelInfoSize,
-                       mFb.getPixelInfoName().c_str(),
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastPixelInfoSize,
+                   mFb.getPixelInfoName().c_str());
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_PIXELINFO);
     mLatencyLog.addDataSize(mLastPixelInfoSize);
 }
@@ -203,10 +202,9 @@ MergeFbSender::addHeatMap(mcrt::BaseFrame::Ptr message)
     }
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ENCODE_END_HEATMAP);
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastHeatMapSize,
-                       mFb.getHeatMapName().c_str(),
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastHeatMapSize,
+                   mFb.getHeatMapName().c_str());
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_HEATMAP);
     mLatencyLog.addDataSize(mLastHeatMapSize);
 }
@@ -230,10 +228,9 @@ MergeFbSender::addHeatMapWithNumSample(mcrt::BaseFrame::Ptr message)
     }
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ENCODE_END_HEATMAP_NUMSAMPLE);
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastHeatMapNumSampleSize,
-                       mFb.getHeatMapName().c_str(),
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastHeatMapNumSampleSize,
+                   mFb.getHeatMapName().c_str());
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_HEATMAP_NUMSAMPLE);
     mLatencyLog.addDataSize(mLastHeatMapNumSampleSize);
 }
@@ -261,10 +258,9 @@ MergeFbSender::addWeightBuffer(mcrt::BaseFrame::Ptr message)
     }
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ENCODE_END_WEIGHTBUFFER);
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastWeightBufferSize,
-                       mFb.getWeightBufferName().c_str(),
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastWeightBufferSize,
+                   mFb.getWeightBufferName().c_str());
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_WEIGHTBUFFER);
     mLatencyLog.addDataSize(mLastWeightBufferSize);
 }
@@ -297,10 +293,9 @@ MergeFbSender::addRenderBufferOdd(mcrt::BaseFrame::Ptr message)
     }
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ENCODE_END_RENDERBUFFERODD);
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastRenderBufferOddSize,
-                       scene_rdl2::grid_util::ProgressiveFrameBufferName::RenderBufferOdd,
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastRenderBufferOddSize,
+                   scene_rdl2::grid_util::ProgressiveFrameBufferName::RenderBufferOdd);
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_RENDERBUFFERODD);
     mLatencyLog.addDataSize(mLastRenderBufferOddSize);
 }
@@ -335,10 +330,9 @@ MergeFbSender::addRenderBufferOddWithNumSample(mcrt::BaseFrame::Ptr message)
     }
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ENCODE_END_RENDERBUFFERODD_NUMSAMPLE);
 
-    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                       mLastRenderBufferOddNumSampleSize,
-                       scene_rdl2::grid_util::ProgressiveFrameBufferName::RenderBufferOdd,
-                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+    addImageBuffer(message,
+                   mLastRenderBufferOddNumSampleSize,
+                   scene_rdl2::grid_util::ProgressiveFrameBufferName::RenderBufferOdd);
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_RENDERBUFFERODD_NUMSAMPLE);
     mLatencyLog.addDataSize(mLastRenderBufferOddNumSampleSize);
 }
@@ -398,10 +392,9 @@ MergeFbSender::addRenderOutput(mcrt::BaseFrame::Ptr message)
             // for performance analyze
             mLastRenderOutputSize += dataSize;
 
-            message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
-                               dataSize,
-                               fbAov->getAovName().c_str(),
-                               mcrt::BaseFrame::ENCODING_UNKNOWN);
+            addImageBuffer(message,
+                           dataSize,
+                           fbAov->getAovName().c_str());
             mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_ADDBUFFER_END_RENDEROUTPUT);
             mLatencyLog.addDataSize(dataSize);
         });
@@ -512,6 +505,18 @@ MergeFbSender::addAuxInfo(mcrt::BaseFrame::Ptr message,
                        mcrt::BaseFrame::ENCODING_UNKNOWN);
 }
 
+void
+MergeFbSender::takeCompressionStat(size_t &rawSize, size_t &compressedSize, float &encodeSec)
+{
+    rawSize = mCompressRawSize;
+    compressedSize = mCompressedSize;
+    encodeSec = mCompressSec;
+
+    mCompressRawSize = 0;
+    mCompressedSize = 0;
+    mCompressSec = 0.0f;
+}
+
 void
 MergeFbSender::fbReset()
 //
@@ -523,6 +528,39 @@ MergeFbSender::fbReset()
     mLatencyLog.enq(scene_rdl2::grid_util::LatencyItem::Key::MERGE_FBRESET_END);
 }
 
+void
+MergeFbSender::addImageBuffer(mcrt::BaseFrame::Ptr message, const size_t dataSize, const char *name)
+//
+// Adds the current PackTiles encoded data (= mWork) to the message. Data is compressed when the
+// compression stage is enabled, the client can decode compressed buffers and compression actually
+// reduces the size. Otherwise data is sent as is and the receiver can distinguish them by the
+// buffer's encoding type.
+//
+{
+    if (mCompression && mClientDecodeCompressed) {
+        scene_rdl2::rec_time::RecTime recTime;
+        recTime.start();
+        bool compressed = BuffCompressor::compress(mWork.data(), dataSize, mCompressWork);
+        mCompressSec += recTime.end();
+        mCompressRawSize += dataSize;
+
+        if (compressed) {
+            mCompressedSize += mCompressWork.size();
+            message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mCompressWork)),
+                               mCompressWork.size(),
+                               name,
+                               mcrt::BaseFrame::ENCODING_COMPRESSED);
+            return;
+        }
+        mCompressedSize += dataSize;
+    }
+
+    message->addBuffer(mcrt::makeValPtr(duplicateWorkData(mWork)),
+                       dataSize,
+                       name,
+                       mcrt::BaseFrame::ENCODING_UNKNOWN);
+}
+
 MergeFbSender::PackTilePrecision
 MergeFbSender::getBeautyHDRITestResult()
 //
@@ -59,6 +59,21 @@ public:
 
     void setPrecisionControl(PrecisionControl &precisionControl) { mPrecisionControl = precisionControl; }
 
+    // Optional lossless compression stage on top of the PackTiles encoding for image buffers.
+    // Compressed buffers are sent as mcrt::BaseFrame::ENCODING_COMPRESSED and
+    // ClientReceiverFb decompresses them transparently. Buffers are only compressed when
+    // the client has advertised that it can decode them (see BuffCompressor), otherwise
+    // they are sent as is even if compression is enabled.
+    void setCompression(bool flag) { mCompression = flag; }
+    bool getCompression() const { return mCompression; }
+    void setClientDecodeCompressed(bool flag) { mClientDecodeCompressed = flag; }
+    bool getClientDecodeCompressed() const { return mClientDecodeCompressed; }
+
+    // Returns the accumulated compression statistics since the last call and resets them.
+    // rawSize and compressedSize are total byte sizes of image buffers and encodeSec is the
+    // total compression time.
+    void takeCompressionStat(size_t &rawSize, size_t &compressedSize, float &encodeSec);
+
     // w, h are original size and not need to be tile size aligned
     void init(const scene_rdl2::math::Viewport &rezedViewport);
 
@@ -125,6 +140,15 @@ protected:
 
     //------------------------------
 
+    bool mCompression {false};
+    bool mClientDecodeCompressed {false}; // client advertised ENCODING_COMPRESSED decode support
+    std::string mCompressWork;      // work memory for compression
+    size_t mCompressRawSize {0};    // total image buffer size before compression
+    size_t mCompressedSize {0};     // total image buffer size after compression
+    float mCompressSec {0.0f};      // total compression time
+
+    //------------------------------
+
     bool mStartCondition {false};
     scene_rdl2::grid_util::LatencyLog mLatencyLog;
 
@@ -154,6 +178,8 @@ protected:
 
     void fbReset();
 
+    void addImageBuffer(mcrt::BaseFrame::Ptr message, const size_t dataSize, const char *name);
+
     PackTilePrecision getBeautyHDRITestResult();
     bool beautyHDRITest() const;
     bool renderOutputHDRITest(const scene_rdl2::grid_util::Fb::FbAovShPtr fbAov) const;
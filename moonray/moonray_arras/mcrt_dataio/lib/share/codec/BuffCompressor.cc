@@ -0,0 +1,165 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BuffCompressor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+namespace {
+
+constexpr char sMagic[4] = {'B', 'C', 'M', 'P'};
+
+constexpr size_t sMaxLiteralRun = 128;
+constexpr size_t sMinRepeatRun = 3;
+constexpr size_t sMaxRepeatRun = 130;
+
+void
+shuffle(const unsigned char* src, size_t size, size_t stride, unsigned char* dst)
+{
+    const size_t numElem = size / stride;
+    for (size_t b = 0; b < stride; ++b) {
+        unsigned char* plane = dst + b * numElem;
+        for (size_t i = 0; i < numElem; ++i) {
+            plane[i] = src[i * stride + b];
+        }
+    }
+    std::memcpy(dst + numElem * stride, src + numElem * stride, size - numElem * stride);
+}
+
+void
+unshuffle(const unsigned char* src, size_t size, size_t stride, unsigned char* dst)
+{
+    const size_t numElem = size / stride;
+    for (size_t b = 0; b < stride; ++b) {
+        const unsigned char* plane = src + b * numElem;
+        for (size_t i = 0; i < numElem; ++i) {
+            dst[i * stride + b] = plane[i];
+        }
+    }
+    std::memcpy(dst + numElem * stride, src + numElem * stride, size - numElem * stride);
+}
+
+void
+runLengthEncode(const unsigned char* src, size_t size, std::string& out)
+{
+    size_t literalStart = 0;
+    auto flushLiteral = [&](size_t end) {
+        while (literalStart < end) {
+            size_t len = std::min(end - literalStart, sMaxLiteralRun);
+            out.push_back(static_cast<char>(len - 1));
+            out.append(reinterpret_cast<const char*>(src + literalStart), len);
+            literalStart += len;
+        }
+    };
+
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < sMaxRepeatRun && src[i + run] == src[i]) ++run;
+        if (run >= sMinRepeatRun) {
+            flushLiteral(i);
+            out.push_back(static_cast<char>(0x80 + run - sMinRepeatRun));
+            out.push_back(static_cast<char>(src[i]));
+            i += run;
+            literalStart = i;
+        } else {
+            i += run;
+        }
+    }
+    flushLiteral(size);
+}
+
+bool
+runLengthDecode(const unsigned char* src, size_t size, unsigned char* dst, size_t dstSize)
+{
+    size_t i = 0;
+    size_t o = 0;
+    while (i < size) {
+        const unsigned char control = src[i++];
+        if (control < 0x80) {
+            const size_t len = static_cast<size_t>(control) + 1;
+            if (i + len > size || o + len > dstSize) return false;
+            std::memcpy(dst + o, src + i, len);
+            i += len;
+            o += len;
+        } else {
+            const size_t len = static_cast<size_t>(control - 0x80) + sMinRepeatRun;
+            if (i >= size || o + len > dstSize) return false;
+            std::memset(dst + o, src[i++], len);
+            o += len;
+        }
+    }
+    return o == dstSize;
+}
+
+} // namespace
+
+namespace mcrt_dataio {
+
+// static function
+bool
+BuffCompressor::compress(const void* data, size_t dataSize, std::string& out)
+{
+    if (dataSize <= sHeaderSize) return false; // too small to be worth it
+
+    std::string shuffled(dataSize, '\0');
+    shuffle(static_cast<const unsigned char*>(data), dataSize, sStride,
+            reinterpret_cast<unsigned char*>(&shuffled[0]));
+
+    out.clear();
+    out.reserve(dataSize);
+    out.append(sMagic, sizeof(sMagic));
+    out.push_back(static_cast<char>(sVersion));
+    out.push_back(static_cast<char>(sStride));
+    out.append(2, '\0'); // reserved
+    const uint64_t rawSize = static_cast<uint64_t>(dataSize);
+    out.append(reinterpret_cast<const char*>(&rawSize), sizeof(rawSize));
+
+    runLengthEncode(reinterpret_cast<const unsigned char*>(shuffled.data()), dataSize, out);
+    return out.size() < dataSize;
+}
+
+// static function
+bool
+BuffCompressor::decompress(const void* data, size_t dataSize, std::string& out)
+{
+    const size_t rawSize = getRawSize(data, dataSize);
+    if (!rawSize) return false;
+
+    // No encoded byte expands to more than sMaxRepeatRun bytes. Don't allocate for a corrupted
+    // rawSize which could not possibly be decoded from this data.
+    if (rawSize > (dataSize - sHeaderSize) * sMaxRepeatRun) return false;
+
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    const size_t stride = src[5];
+    if (!stride) return false;
+
+    std::string shuffled(rawSize, '\0');
+    if (!runLengthDecode(src + sHeaderSize, dataSize - sHeaderSize,
+                         reinterpret_cast<unsigned char*>(&shuffled[0]), rawSize)) {
+        return false;
+    }
+
+    out.resize(rawSize);
+    unshuffle(reinterpret_cast<const unsigned char*>(shuffled.data()), rawSize, stride,
+              reinterpret_cast<unsigned char*>(&out[0]));
+    return true;
+}
+
+// static function
+size_t
+BuffCompressor::getRawSize(const void* data, size_t dataSize)
+{
+    if (dataSize < sHeaderSize) return 0;
+
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    if (std::memcmp(src, sMagic, sizeof(sMagic)) != 0 || src[4] != sVersion) return 0;
+
+    uint64_t rawSize;
+    std::memcpy(&rawSize, src + 8, sizeof(rawSize));
+    return static_cast<size_t>(rawSize);
+}
+
+} // namespace mcrt_dataio
@@ -0,0 +1,64 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>              // size_t
+#include <string>
+
+namespace mcrt_dataio {
+
+class BuffCompressor
+//
+// This class provides a lossless compression stage for the ProgressiveFrame message
+// buffers (i.e. PackTiles encoded data) in order to reduce the bandwidth between the
+// back-end computation and the client. This is an optional stage on top of the PackTiles
+// precision control and is only applied when the sender enables it. Compressed buffers
+// are marked as mcrt::BaseFrame::ENCODING_COMPRESSED, so the receiver can decide how to
+// decode each buffer.
+//
+// Older clients don't know ENCODING_COMPRESSED and would misdecode such buffers. So a
+// client advertises that it can decode them by setting sClientDecodeConfigKey to true in
+// the merge computation config of its session definition
+// (see ClientReceiverFb::advertiseDecodeCapability()). The merge computation only sends
+// compressed buffers to a client which did so.
+//
+// Data is compressed by a byte-plane shuffle (all the 1st bytes of every 4 byte word,
+// then all the 2nd bytes and so on) followed by a run-length encoding of the shuffled
+// bytes. Frame buffer data is mostly 32bit or 16bit values and their high order bytes
+// (sign, exponent) and the zero padding are highly redundant, which is what the shuffle
+// exposes to the run-length encoding. This is quite cheap in both directions and there is
+// no dependency on an external compression library.
+//
+// Encoded data format
+//   magic (4 byte) : 'B' 'C' 'M' 'P'
+//   version (1 byte)
+//   stride (1 byte) : byte-plane shuffle stride
+//   reserved (2 byte)
+//   rawSize (8 byte) : original data size
+//   run-length encoded byte-plane shuffled data
+//     control byte 0x00 ~ 0x7f : (control + 1) literal bytes follow
+//     control byte 0x80 ~ 0xff : next byte is repeated (control - 0x80 + 3) times
+//
+{
+public:
+    // Returns false when the data does not shrink by compression. In this case, out is
+    // undefined and the caller should send the original data as is.
+    static bool compress(const void* data, size_t dataSize, std::string& out);
+
+    // Returns false if data is not properly encoded by compress().
+    static bool decompress(const void* data, size_t dataSize, std::string& out);
+
+    // Returns the original data size of compressed data or 0 if data is not compressed data.
+    static size_t getRawSize(const void* data, size_t dataSize);
+
+    // merge computation config item by which the client advertises decode support
+    static constexpr const char* sClientDecodeConfigKey = "clientDecodeCompressed";
+
+private:
+    static constexpr size_t sHeaderSize = 16;
+    static constexpr unsigned char sVersion = 1;
+    static constexpr unsigned char sStride = 4;
+};
+
+} // namespace mcrt_dataio
@@ -8,9 +8,9 @@
 namespace mcrt_dataio {
     
 void
-BandwidthTracker::set(size_t dataSize)
+BandwidthTracker::set(size_t dataSize, size_t rawDataSize, float codecSec)
 {
-    mEventList.emplace_front(std::make_shared<BandwidthEvent>(dataSize));
+    mEventList.emplace_front(std::make_shared<BandwidthEvent>(dataSize, rawDataSize, codecSec));
 
     while (mEventList.size() > 10) {
         if (getDeltaSecWhole() > static_cast<double>(mKeepIntervalSec)) {
@@ -34,6 +34,26 @@ BandwidthTracker::getBps() const
     return static_cast<float>(static_cast<double>(sum) / wholeSec);
 }
 
+float
+BandwidthTracker::getCompressionRatio() const
+{
+    size_t raw = getRawDataSizeWhole();
+    if (raw == 0) return 1.0f;
+    return static_cast<float>(static_cast<double>(getDataSizeWhole()) / static_cast<double>(raw));
+}
+
+float
+BandwidthTracker::getCodecSecAverage() const
+{
+    if (mEventList.empty()) return 0.0f;
+
+    float sum = 0.0f;
+    for (auto& itr : mEventList) {
+        sum += itr->getCodecSec();
+    }
+    return sum / static_cast<float>(mEventList.size());
+}
+
 size_t
 BandwidthTracker::getMaxSize() const
 {
@@ -54,6 +74,16 @@ BandwidthTracker::getDataSizeWhole() const
     return sum;
 }
 
+size_t
+BandwidthTracker::getRawDataSizeWhole() const
+{
+    size_t sum = 0;
+    for (auto& itr : mEventList) {
+        sum += itr->getRawDataSize();
+    }
+    return sum;
+}
+
 double
 BandwidthTracker::getDeltaSecWhole() const
 {
@@ -81,13 +111,18 @@ BandwidthTracker::show() const
         for (auto& itr : mEventList) {
             ostr << "  i:" << std::setw(w0) << i
                  << " mDataSize:" << std::setw(w1) << itr->getDataSize()
+                 << " mRawDataSize:" << std::setw(w1) << itr->getRawDataSize()
+                 << " mCodecSec:" << itr->getCodecSec()
                  << " mTimeStamp:" << MiscUtil::timeFromEpochStr(itr->getTimeStamp()) << '\n';
             i++;
         }
         ostr
         << "}"
         << " getDataSizeWhole():" << byteStr(getDataSizeWhole())
-        << " getDeltaSecWhole():" << getDeltaSecWhole() << " sec";
+        << " getDeltaSecWhole():" << getDeltaSecWhole() << " sec\n"
+        << "getBps():" << byteStr(static_cast<size_t>(getBps())) << "/sec"
+        << " getCompressionRatio():" << getCompressionRatio()
+        << " getCodecSecAverage():" << getCodecSecAverage() << " sec";
         return ostr.str();
     };
 
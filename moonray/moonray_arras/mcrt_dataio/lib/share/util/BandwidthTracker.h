@@ -19,17 +19,23 @@ class BandwidthEvent
 //
 {
 public:
-    BandwidthEvent(size_t size) :
+    BandwidthEvent(size_t size, size_t rawSize, float codecSec) :
         mTimeStamp(MiscUtil::getCurrentMicroSec()),
-        mDataSize(size)
+        mDataSize(size),
+        mRawDataSize(rawSize),
+        mCodecSec(codecSec)
     {}
 
     uint64_t getTimeStamp() const { return mTimeStamp; }
     size_t getDataSize() const { return mDataSize; }
+    size_t getRawDataSize() const { return mRawDataSize; }
+    float getCodecSec() const { return mCodecSec; }
 
 private:
     uint64_t mTimeStamp;
     size_t mDataSize;
+    size_t mRawDataSize; // data size before compression. same as mDataSize if not compressed
+    float mCodecSec;     // compression or decompression time
 };
 
 class BandwidthTracker
@@ -45,6 +51,9 @@ class BandwidthTracker
 // API. If set() API is called 1, 2 times during keepIntervalSec, This case bandwidth
 // estimation is not so high precision enough. 10~15 set() calls during keepIntervalSec
 // might better and return accurate results.
+// When the data is compressed, the original data size and the compression (or decompression)
+// time can be set as well, and this class reports the compression ratio and average codec time
+// over the same interval.
 //
 {
 public:
@@ -54,9 +63,13 @@ public:
 
     void setKeepIntervalSec(float sec) { mKeepIntervalSec = sec; }
 
-    void set(size_t dataSize); // byte
+    void set(size_t dataSize) { set(dataSize, dataSize, 0.0f); } // byte
+    void set(size_t dataSize, size_t rawDataSize, float codecSec); // byte, byte, sec
     float getBps() const; // byte/sec
 
+    float getCompressionRatio() const; // compressed / raw : return 1.0 if not compressed
+    float getCodecSecAverage() const; // sec
+
     std::string show() const;
 
 private:
@@ -71,6 +84,7 @@ private:
 
     size_t getMaxSize() const;
     size_t getDataSizeWhole() const;
+    size_t getRawDataSizeWhole() const;
     double getDeltaSecWhole() const;
     static double getDeltaSec(const uint64_t currTime, const uint64_t oldTime); // both microSec
 };
@@ -0,0 +1,148 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TestBuffCompressor.h"
+
+#include <cstring>
+#include <random>
+#include <stdint.h>
+
+namespace mcrt_dataio {
+namespace unittest {
+
+void
+TestBuffCompressor::testSmall()
+{
+    // Data up to the header size is never compressed
+    std::string out;
+    const std::string empty;
+    CPPUNIT_ASSERT("testSmall compress empty" && !BuffCompressor::compress(empty.data(), 0, out));
+    for (size_t size = 1; size <= 16; ++size) {
+        const std::string data(size, '\0');
+        CPPUNIT_ASSERT("testSmall compress small" && !BuffCompressor::compress(data.data(), size, out));
+    }
+
+    // ... nor can it be decompressed
+    CPPUNIT_ASSERT("testSmall decompress empty" && !BuffCompressor::decompress(empty.data(), 0, out));
+    CPPUNIT_ASSERT("testSmall getRawSize empty" && BuffCompressor::getRawSize(empty.data(), 0) == 0);
+
+    // A single repeat run encodes to 2 bytes after the header : 19 bytes is the smallest
+    // data which shrinks
+    for (size_t size : {17, 18}) {
+        const std::string data(size, '\0');
+        CPPUNIT_ASSERT("testSmall no gain" && !BuffCompressor::compress(data.data(), size, out));
+    }
+    CPPUNIT_ASSERT("testSmall 19 bytes" && roundTrip(std::string(19, '\0')));
+    CPPUNIT_ASSERT("testSmall 20 bytes" && roundTrip(std::string(20, 'a')));
+}
+
+void
+TestBuffCompressor::testUnalignedSize()
+{
+    // The tail of data which isn't a multiple of the 4 byte shuffle stride is kept as is
+    for (size_t size : {19, 21, 22, 23}) {
+        CPPUNIT_ASSERT("testUnalignedSize zero" && roundTrip(std::string(size, '\0')));
+    }
+    for (size_t size : {1001, 1002, 1003, 4097, 65535}) {
+        CPPUNIT_ASSERT("testUnalignedSize zero" && roundTrip(std::string(size, '\0')));
+        CPPUNIT_ASSERT("testUnalignedSize frame" && roundTrip(framebufferLikeData(size)));
+    }
+}
+
+void
+TestBuffCompressor::testLongRun()
+{
+    // A repeat run encodes 130 bytes at most, longer runs are split
+    for (size_t run : {129, 130, 131, 132, 133, 260, 261, 1000}) {
+        std::string data(run * 4, '\x7f');
+        CPPUNIT_ASSERT("testLongRun single" && roundTrip(data));
+
+        // runs between literals
+        data = framebufferLikeData(256) + std::string(run * 4, '\0') + framebufferLikeData(260);
+        CPPUNIT_ASSERT("testLongRun between literals" && roundTrip(data));
+    }
+}
+
+void
+TestBuffCompressor::testCorrupted()
+{
+    const std::string data = framebufferLikeData(8000);
+    std::string compressed;
+    CPPUNIT_ASSERT(BuffCompressor::compress(data.data(), data.size(), compressed));
+    CPPUNIT_ASSERT(BuffCompressor::getRawSize(compressed.data(), compressed.size()) == data.size());
+
+    std::string out;
+
+    // truncated at any length, header included
+    for (size_t size = 0; size < compressed.size(); ++size) {
+        CPPUNIT_ASSERT("testCorrupted truncated" && !BuffCompressor::decompress(compressed.data(), size, out));
+    }
+
+    // original data is not compressed data
+    CPPUNIT_ASSERT("testCorrupted raw" && !BuffCompressor::decompress(data.data(), data.size(), out));
+
+    // bad magic, version and stride
+    for (size_t offset : {0, 3, 4}) {
+        std::string bad = compressed;
+        bad[offset] ^= 0x01;
+        CPPUNIT_ASSERT("testCorrupted header" && !BuffCompressor::decompress(bad.data(), bad.size(), out));
+    }
+    {
+        std::string bad = compressed;
+        bad[5] = 0; // stride
+        CPPUNIT_ASSERT("testCorrupted stride" && !BuffCompressor::decompress(bad.data(), bad.size(), out));
+    }
+
+    // raw size which doesn't match the encoded data, including one too large to allocate
+    for (uint64_t rawSize : {uint64_t(data.size() - 1), uint64_t(data.size() + 1), uint64_t(1) << 62}) {
+        std::string bad = compressed;
+        std::memcpy(&bad[8], &rawSize, sizeof(rawSize));
+        CPPUNIT_ASSERT("testCorrupted rawSize" && !BuffCompressor::decompress(bad.data(), bad.size(), out));
+    }
+
+    // trailing garbage
+    {
+        const std::string bad = compressed + '\x05';
+        CPPUNIT_ASSERT("testCorrupted trailing" && !BuffCompressor::decompress(bad.data(), bad.size(), out));
+    }
+
+    // the untouched data still decodes
+    CPPUNIT_ASSERT(BuffCompressor::decompress(compressed.data(), compressed.size(), out));
+    CPPUNIT_ASSERT(out == data);
+}
+
+std::string
+TestBuffCompressor::framebufferLikeData(size_t size) const
+//
+// RGBA float pixels of 8bit precision color values and an opaque alpha : the low order bytes
+// are zero, so this compresses, but there are only short runs in the other bytes
+//
+{
+    std::mt19937 rng(static_cast<unsigned>(size));
+
+    std::string data(size, '\0');
+    for (size_t i = 0; i + sizeof(float) <= size; i += sizeof(float)) {
+        const float v = ((i / sizeof(float)) % 4 == 3) ? 1.0f : static_cast<float>(rng() % 256) / 256.0f;
+        std::memcpy(&data[i], &v, sizeof(float));
+    }
+    for (size_t i = size / sizeof(float) * sizeof(float); i < size; ++i) {
+        data[i] = static_cast<char>(rng());
+    }
+    return data;
+}
+
+bool
+TestBuffCompressor::roundTrip(const std::string& data) const
+{
+    std::string compressed;
+    if (!BuffCompressor::compress(data.data(), data.size(), compressed)) return false;
+    if (compressed.size() >= data.size()) return false;
+    if (BuffCompressor::getRawSize(compressed.data(), compressed.size()) != data.size()) return false;
+
+    std::string out;
+    if (!BuffCompressor::decompress(compressed.data(), compressed.size(), out)) return false;
+    return out == data;
+}
+
+} // namespace unittest
+} // namespace mcrt_dataio
@@ -0,0 +1,40 @@
+// Copyright 2023-2024 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <mcrt_dataio/share/codec/BuffCompressor.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+#include <string>
+
+namespace mcrt_dataio {
+namespace unittest {
+
+class TestBuffCompressor : public CppUnit::TestFixture
+{
+public:
+    void setUp() {}
+    void tearDown() {}
+
+    void testSmall();
+    void testUnalignedSize();
+    void testLongRun();
+    void testCorrupted();
+
+    CPPUNIT_TEST_SUITE(TestBuffCompressor);
+    CPPUNIT_TEST(testSmall);
+    CPPUNIT_TEST(testUnalignedSize);
+    CPPUNIT_TEST(testLongRun);
+    CPPUNIT_TEST(testCorrupted);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    std::string framebufferLikeData(size_t size) const;
+    bool roundTrip(const std::string& data) const;
+};
+
+} // namespace unittest
+} // namespace mcrt_dataio
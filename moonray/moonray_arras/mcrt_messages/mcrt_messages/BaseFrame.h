@@ -132,6 +132,7 @@ public:
         ENCODING_FLOAT,         /// X    (4 Bytes)  1 32-bit float channel, 32-bits per pixel
         ENCODING_FLOAT2,        /// XY   (8 bytes)  2 32-bit float channels, 64-bits per pixel
         ENCODING_FLOAT3,        /// XYZ  (12 bytes) 3 32-bit float channels, 96-bits per pixel
+        ENCODING_COMPRESSED,    /// Lossless compressed data (see mcrt_dataio::BuffCompressor)
 
         ENCODING_MAX,
         ENCODING_SIZE=0xFFFFFFFF